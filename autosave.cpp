@@ -0,0 +1,709 @@
+/*
+ * File:	autosave.cpp
+ * Author:	agent
+ * Date:	2026-10-18
+ * Version:	1.2
+ *
+ * Purpose:	Save the canvas every so often, so that a crash doesn't
+ *		lose everything since the last save_Graph().
+ *
+ *		Each tick of the timer, the entries for the nodes and
+ *		edges which changed since the last tick are rewritten
+ *		in a description (see graphloader.h) of the canvas.
+ *		The items say when they change (see nodeChanged() and
+ *		friends), so when the user has only moved a few nodes
+ *		only those are looked at, and a tick with no changes
+ *		does nothing at all; editing never pauses.  The
+ *		description, which is a plain copy of the values, is
+ *		then given to a worker thread which writes it out as a
+ *		.grphc file (straight from the description, so that no
+ *		QGraphicsItems are made off the GUI thread) through a
+ *		QSaveFile,
+ *		so that a crash in the middle of a save leaves the
+ *		previous autosave file intact.
+ *
+ *		The autosave file is in the user's data directory,
+ *		guarded by a QLockFile so that only one Graphic at a
+ *		time uses it.  It is removed (by discard()) when
+ *		Graphic exits normally, so if it is there at startup
+ *		the previous session crashed, and hasRecovery() says
+ *		so.
+ *
+ * Modification history:
+ * Oct 18, 2026 (agent V1.0)
+ *  (a) Initial version.
+ * Oct 18, 2026 (agent V1.1)
+ *  (a) writeSnapshot() writes the snapshot itself, rather than
+ *	building the graph with a GraphBuilder in a private scene
+ *	(every minute) only to write and destroy it.
+ * Oct 18, 2026 (agent V1.2)
+ *  (a) The items now tell the autosaver when they change (see
+ *	nodeChanged(), edgeChanged(), graphMoved() and itemsChanged()),
+ *	and updateSnapshot() only describes those, rather than
+ *	getting (and so sorting) every item of the scene and
+ *	describing each of them every tick.  The whole scene is only
+ *	rescanned (by rescanSnapshot()) when items come or go.
+ */
+
+#include "autosave.h"
+#include "defuns.h"
+#include "edge.h"
+#include "edgebundle.h"
+#include "graph.h"
+#include "mainwindow.h"
+#include "node.h"
+
+#include <QDir>
+#include <QFile>
+#include <QHash>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QTextStream>
+#include <QThread>
+#include <QtConcurrent>
+
+#define AUTOSAVE_FILE	"autosave." GRAPHiCS_FILE_EXTENSION
+#define LOCK_FILE	"autosave.lock"
+
+AutoSaver * AutoSaver::tracker = nullptr;
+
+
+
+/*
+ * Name:	sameNode(), sameEdge(), sameBundle()
+ * Purpose:	Compare two node (edge, compact edge) descriptions.
+ * Arguments:	The descriptions.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	True iff they describe the same thing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	None.
+ */
+
+static bool
+sameNode(const Node_Description &a, const Node_Description &b)
+{
+    return a.x == b.x && a.y == b.y && a.diameter == b.diameter
+	&& a.penWidth == b.penWidth && a.rotation == b.rotation
+	&& a.fillColour == b.fillColour && a.lineColour == b.lineColour
+	&& a.labelSize == b.labelSize && a.label == b.label;
+}
+
+
+
+static bool
+sameEdge(const Edge_Description &a, const Edge_Description &b)
+{
+    return a.source == b.source && a.dest == b.dest
+	&& a.destRadius == b.destRadius && a.sourceRadius == b.sourceRadius
+	&& a.rotation == b.rotation && a.penWidth == b.penWidth
+	&& a.colour == b.colour && a.labelSize == b.labelSize
+	&& a.label == b.label;
+}
+
+
+
+static bool
+sameBundle(const Bundle_Signature &a, const Bundle_Signature &b)
+{
+    return a.bundle == b.bundle && a.count == b.count
+	&& a.penWidth == b.penWidth && a.colour == b.colour
+	&& a.labelSize == b.labelSize;
+}
+
+
+
+/*
+ * Name:	AutoSaver()
+ * Purpose:	Constructor.
+ * Arguments:	The scene to save and the parent object.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	If another Graphic holds the lock, this one doesn't
+ *		autosave at all, rather than have two of them fight
+ *		over the same file.
+ */
+
+AutoSaver::AutoSaver(QGraphicsScene * scene, QObject * parent)
+    : QObject(parent)
+{
+    QString directory = QStandardPaths::writableLocation(
+	QStandardPaths::GenericDataLocation) + "/Acadia/Graphic";
+
+    this->scene = scene;
+    recovery = false;
+    dirty = false;
+    rescan = true;
+    QDir().mkpath(directory);
+    autosaveFile = directory + "/" AUTOSAVE_FILE;
+
+    connect(&saveWatcher, SIGNAL(finished()), this, SLOT(saveDone()));
+
+    lock.reset(new QLockFile(directory + "/" LOCK_FILE));
+    // A lock left by a crashed Graphic is stale, and is taken over.
+    if (!lock->tryLock(0))
+    {
+	qDeb() << "AS::AS(): " << directory << " is locked; no autosave";
+	lock.reset();
+	return;
+    }
+
+    recovery = QFile::exists(autosaveFile);
+    tracker = this;
+
+    timer.setInterval(AUTOSAVE_INTERVAL);
+    connect(&timer, SIGNAL(timeout()), this, SLOT(save()));
+    timer.start();
+}
+
+
+
+/*
+ * Name:	~AutoSaver()
+ * Purpose:	Destructor.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	Waits for a save in progress, so that the file is
+ *		either committed or left as it was.
+ */
+
+AutoSaver::~AutoSaver()
+{
+    if (tracker == this)
+	tracker = nullptr;
+    saveWatcher.waitForFinished();
+}
+
+
+
+QString
+AutoSaver::fileName() const
+{
+    return autosaveFile;
+}
+
+
+
+/*
+ * Name:	hasRecovery()
+ * Purpose:	Say whether the previous session left an autosave.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	True iff fileName() is from a session which crashed.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	This stays true until discard() is called or the
+ *		first autosave of this session replaces the file.
+ */
+
+bool
+AutoSaver::hasRecovery() const
+{
+    return recovery;
+}
+
+
+
+/*
+ * Name:	isTracking()
+ * Purpose:	Say whether the changes to a scene are to be recorded.
+ * Arguments:	The scene (which may be null).
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	True iff it is the scene being autosaved, and this is
+ *		the GUI thread.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	Graphs are also built off the GUI thread (e.g., by
+ *		"Export all"), in scenes of their own; the sets of
+ *		changed items must not be touched there.
+ */
+
+bool
+AutoSaver::isTracking(QGraphicsScene * scene)
+{
+    return tracker != nullptr && scene != nullptr
+	&& QThread::currentThread() == tracker->thread()
+	&& scene == tracker->scene;
+}
+
+
+
+/*
+ * Name:	nodeChanged(), edgeChanged()
+ * Purpose:	Note that a node (edge) has changed, so that the next
+ *		tick describes it again.
+ * Arguments:	The node (edge).
+ * Outputs:	Nothing.
+ * Modifies:	tracker->changedNodes (changedEdges).
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	Called by the item's setters and itemChange().  Items
+ *		which are not (yet) on the canvas are ignored; when
+ *		they are added, itemsChanged() is called.
+ */
+
+void
+AutoSaver::nodeChanged(Node * node)
+{
+    if (isTracking(node->scene()))
+	tracker->changedNodes.insert(node);
+}
+
+
+
+void
+AutoSaver::edgeChanged(Edge * edge)
+{
+    if (isTracking(edge->scene()))
+	tracker->changedEdges.insert(edge);
+}
+
+
+
+/*
+ * Name:	graphMoved()
+ * Purpose:	Note that a graph has moved (or been rotated, or
+ *		reparented), and so have all the nodes in it.
+ * Arguments:	The graph.
+ * Outputs:	Nothing.
+ * Modifies:	tracker->movedGraphs.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	The graph's nodes are found at the next tick, rather
+ *		than for every step of a drag.  A graph which is
+ *		deleted before then is forgotten by its QPointer.
+ */
+
+void
+AutoSaver::graphMoved(Graph * graph)
+{
+    if (isTracking(graph->scene()) && !tracker->movedGraphs.contains(graph))
+	tracker->movedGraphs.append(graph);
+}
+
+
+
+/*
+ * Name:	itemsChanged()
+ * Purpose:	Note that items have been added to or removed from a
+ *		scene (or an edge's nodes have changed).
+ * Arguments:	The scene.
+ * Outputs:	Nothing.
+ * Modifies:	tracker->rescan.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	The next tick rescans the whole scene, since the
+ *		indices of the nodes in the snapshot (which the edges
+ *		refer to) may have changed.
+ */
+
+void
+AutoSaver::itemsChanged(QGraphicsScene * scene)
+{
+    if (isTracking(scene))
+	tracker->rescan = true;
+}
+
+
+
+/*
+ * Name:	save()
+ * Purpose:	Start saving the canvas, if it has changed.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	The snapshot.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	Called by the timer.  If the previous save is still
+ *		being written, this tick is skipped (the changes are
+ *		picked up by the next one).  An empty canvas is not
+ *		saved, so that a recovery file which the user has not
+ *		yet dealt with is not replaced by nothing.
+ */
+
+void
+AutoSaver::save()
+{
+    if (lock.isNull() || saveWatcher.isRunning())
+	return;
+
+    if (updateSnapshot())
+	dirty = true;
+    if (!dirty || snapshot.nodes.isEmpty())
+	return;
+
+    job.reset(new Save_Job);
+    job->snapshot = snapshot;		// Shared until the next change.
+    job->fileName = autosaveFile;
+    job->ok = false;
+    dirty = false;
+    saveWatcher.setFuture(QtConcurrent::run(writeSnapshot, job));
+}
+
+
+
+/*
+ * Name:	discard()
+ * Purpose:	Remove the autosave file.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	The file system; recovery.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	Called when the user declines to recover the previous
+ *		session, and when Graphic exits normally.  Changes
+ *		made since the last tick are saved at the next one.
+ */
+
+void
+AutoSaver::discard()
+{
+    if (lock.isNull())
+	return;
+
+    saveWatcher.waitForFinished();
+    QFile::remove(autosaveFile);
+    recovery = false;
+    dirty = true;
+}
+
+
+
+/*
+ * Name:	saveDone()
+ * Purpose:	Note the end of a save.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	recovery, dirty, job.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	The user is not bothered with a failed autosave
+ *		(writeSnapshot() logs it); the next tick tries again.
+ */
+
+void
+AutoSaver::saveDone()
+{
+    if (job.isNull())
+	return;
+    if (job->ok)
+	recovery = false;
+    else
+	dirty = true;
+    job.clear();
+}
+
+
+
+/*
+ * Name:	nodesOf()
+ * Purpose:	Find the nodes in a graph, and in its subgraphs.
+ * Arguments:	The graph and the set to add them to.
+ * Outputs:	Nothing.
+ * Modifies:	nodes.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	None.
+ */
+
+static void
+nodesOf(QGraphicsItem * graph, QSet<Node *> &nodes)
+{
+    foreach (QGraphicsItem * item, graph->childItems())
+    {
+	if (item->type() == Node::Type)
+	    nodes.insert(qgraphicsitem_cast<Node *>(item));
+	else if (item->type() == Graph::Type)
+	    nodesOf(item, nodes);
+    }
+}
+
+
+
+/*
+ * Name:	updateSnapshot()
+ * Purpose:	Bring the snapshot up to date with the canvas.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	snapshot, and the record of what has changed.
+ * Returns:	True iff anything changed.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	Only the nodes and edges which have said they changed
+ *		(and the nodes of the graphs which moved) are
+ *		described again; if nothing has, the scene is not
+ *		looked at at all.  The nodes and edges keep their
+ *		places in the snapshot, so their entries are simply
+ *		overwritten.  When items have come or gone, the whole
+ *		scene is rescanned by rescanSnapshot() instead.
+ *		So if nothing changed, the snapshot still shares its
+ *		data with the one the last save used.
+ */
+
+bool
+AutoSaver::updateSnapshot()
+{
+    if (rescan)
+	return rescanSnapshot();
+    if (changedNodes.isEmpty() && changedEdges.isEmpty()
+	&& movedGraphs.isEmpty())
+	return false;
+
+    foreach (QPointer<Graph> graph, movedGraphs)
+	if (!graph.isNull())
+	    nodesOf(graph, changedNodes);
+
+    bool changed = false;
+    bool resized = false;
+    foreach (Node * node, changedNodes)
+    {
+	int i = nodeIndex.value(node, -1);
+	if (i < 0)
+	    return rescanSnapshot() || changed;
+	Node_Description d;
+	describeNode(node, d);
+	if (!sameNode(d, snapshot.nodes.at(i)))
+	{
+	    resized = resized || d.diameter != snapshot.nodes.at(i).diameter;
+	    snapshot.nodes[i] = d;
+	    changed = true;
+	}
+    }
+
+    foreach (Edge * edge, changedEdges)
+    {
+	int i = edgeIndex.value(edge, -1);
+	if (i < 0)
+	    return rescanSnapshot() || changed;
+	Edge_Description d;
+	const Edge_Description &old = snapshot.edges.at(i);
+	describeEdge(edge, old.source, old.dest, d);
+	if (!sameEdge(d, old))
+	{
+	    snapshot.edges[i] = d;
+	    changed = true;
+	}
+    }
+
+    // The compact edges' radii come from their nodes (see below).
+    if (resized)
+    {
+	for (int i = edgeIndex.count(); i < snapshot.edges.count(); i++)
+	{
+	    Edge_Description &d = snapshot.edges[i];
+	    d.destRadius = d.sourceRadius
+		= snapshot.nodes.at(d.dest).diameter / 2.;
+	}
+    }
+
+    changedNodes.clear();
+    changedEdges.clear();
+    movedGraphs.clear();
+    return changed;
+}
+
+
+
+/*
+ * Name:	rescanSnapshot()
+ * Purpose:	Bring the snapshot up to date with the whole canvas.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	snapshot, nodeItems, edgeItems, bundleItems, nodeIndex,
+ *		edgeIndex, and the record of what has changed.
+ * Returns:	True iff anything changed.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	The node (edge) descriptions are redone from scratch
+ *		only when the set of nodes (edges) has changed;
+ *		otherwise each item is compared with its description
+ *		and only the descriptions which differ are written.
+ *		The compact edges (see edgebundle.cpp) come after the
+ *		other edges, as in snapshotScene() in mainwindow.cpp.
+ */
+
+bool
+AutoSaver::rescanSnapshot()
+{
+    QVector<Node *> nodes;
+    QVector<Edge *> edges;
+    QVector<EdgeBundle *> bundles;
+    QVector<Bundle_Signature> signatures;
+    bool changed = false;
+
+    rescan = false;
+    changedNodes.clear();
+    changedEdges.clear();
+    movedGraphs.clear();
+
+    foreach (QGraphicsItem * item, scene->items())
+    {
+	if (item->type() == Node::Type)
+	    nodes.append(qgraphicsitem_cast<Node *>(item));
+	else if (item->type() == EdgeBundle::Type)
+	    bundles.append(qgraphicsitem_cast<EdgeBundle *>(item));
+    }
+    // Each Edge is in the edgeList of both of its nodes.
+    foreach (Node * node, nodes)
+	foreach (Edge * edge, node->edgeList)
+	    if (edge->sourceNode() == node)
+		edges.append(edge);
+    foreach (EdgeBundle * bundle, bundles)
+    {
+	Bundle_Signature s;
+	s.bundle = bundle;
+	s.count = bundle->count();
+	s.penWidth = bundle->getPenWidth();
+	s.colour = bundle->getColour().rgba();
+	s.labelSize = bundle->getLabelSize();
+	signatures.append(s);
+    }
+
+    bool nodesRebuilt = nodes != nodeItems;
+    if (nodesRebuilt)
+    {
+	snapshot.nodes.resize(nodes.count());
+	nodeIndex.clear();
+	for (int i = 0; i < nodes.count(); i++)
+	{
+	    describeNode(nodes.at(i), snapshot.nodes[i]);
+	    nodeIndex.insert(nodes.at(i), i);
+	}
+	nodeItems = nodes;
+	changed = true;
+    }
+    else
+    {
+	for (int i = 0; i < nodes.count(); i++)
+	{
+	    Node_Description d;
+	    describeNode(nodes.at(i), d);
+	    if (!sameNode(d, snapshot.nodes.at(i)))
+	    {
+		snapshot.nodes[i] = d;
+		changed = true;
+	    }
+	}
+    }
+
+    bool bundlesChanged = signatures.count() != bundleItems.count();
+    for (int i = 0; !bundlesChanged && i < signatures.count(); i++)
+	bundlesChanged = !sameBundle(signatures.at(i), bundleItems.at(i));
+
+    // A new node moves the indices the edges refer to.  (So does a
+    // new diameter, for the compact edges' radii.)
+    if (nodesRebuilt || bundlesChanged || edges != edgeItems
+	|| (changed && !bundles.isEmpty()))
+    {
+	snapshot.edges.clear();
+	edgeIndex.clear();
+	foreach (Edge * edge, edges)
+	{
+	    int dest = nodeIndex.value(edge->destNode(), -1);
+	    if (dest < 0)
+		continue;
+	    Edge_Description d;
+	    describeEdge(edge, nodeIndex.value(edge->sourceNode()), dest, d);
+	    edgeIndex.insert(edge, snapshot.edges.count());
+	    snapshot.edges.append(d);
+	}
+	foreach (EdgeBundle * bundle, bundles)
+	{
+	    for (int i = 0; i < bundle->count(); i++)
+	    {
+		Edge_Description d;
+		d.source = nodeIndex.value(bundle->sourceAt(i), -1);
+		d.dest = nodeIndex.value(bundle->destAt(i), -1);
+		if (d.source < 0 || d.dest < 0)
+		    continue;
+		// As the Edge constructor does.
+		d.destRadius = d.sourceRadius
+		    = snapshot.nodes.at(d.dest).diameter / 2.;
+		d.rotation = 0;
+		d.penWidth = bundle->getPenWidth();
+		d.colour = bundle->getColour();
+		d.hasLabel = false;
+		d.labelSize = bundle->getLabelSize();
+		snapshot.edges.append(d);
+	    }
+	}
+	edgeItems = edges;
+	bundleItems = signatures;
+	return true;
+    }
+
+    // Same edges, same nodes: the indices are the same as last time.
+    for (auto it = edgeIndex.constBegin(); it != edgeIndex.constEnd(); ++it)
+    {
+	Edge_Description d;
+	const Edge_Description &old = snapshot.edges.at(it.value());
+	describeEdge(it.key(), old.source, old.dest, d);
+	if (!sameEdge(d, old))
+	{
+	    snapshot.edges[it.value()] = d;
+	    changed = true;
+	}
+    }
+
+    return changed;
+}
+
+
+
+/*
+ * Name:	writeSnapshot()
+ * Purpose:	Write one autosave file.
+ * Arguments:	The job.
+ * Outputs:	The file.
+ * Modifies:	job->ok and job->errorMessage.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Called on a pool thread.  Only the (read-only)
+ *		snapshot is shared with the GUI thread, and it is
+ *		written as it is: no items are made here.  Nothing
+ *		replaces the old file unless the whole new one was
+ *		written.
+ */
+
+void
+AutoSaver::writeSnapshot(QSharedPointer<Save_Job> job)
+{
+    QSaveFile file(job->fileName);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+	job->errorMessage = file.errorString();
+	qDeb() << "AS::writeSnapshot(): " << job->errorMessage;
+	return;
+    }
+
+    QTextStream outStream(&file);
+    bool ok = saveGraphIc(outStream, job->snapshot, false);
+    outStream.flush();
+    if (!ok || outStream.status() != QTextStream::Ok)
+	file.cancelWriting();
+    job->ok = file.commit();
+    if (!job->ok)
+    {
+	job->errorMessage = file.errorString();
+	qDeb() << "AS::writeSnapshot(): can't write " << job->fileName
+	       << ": " << job->errorMessage;
+    }
+}
@@ -0,0 +1,121 @@
+/*
+ * File:	autosave.h
+ * Author:	agent
+ * Date:	2026-10-18
+ * Version:	1.1
+ *
+ * Purpose:	Declare the class which periodically saves the canvas
+ *		in the background.
+ *
+ * Modification history:
+ * Oct 18, 2026 (agent V1.0)
+ *  (a) Initial version.
+ * Oct 18, 2026 (agent V1.1)
+ *  (a) Add nodeChanged(), edgeChanged(), graphMoved() and
+ *	itemsChanged(), which the items call when they change, so
+ *	that a tick only looks at what changed.
+ */
+
+#ifndef AUTOSAVE_H
+#define AUTOSAVE_H
+
+#include "graphloader.h"
+
+#include <QFutureWatcher>
+#include <QGraphicsScene>
+#include <QLockFile>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QRgb>
+#include <QScopedPointer>
+#include <QSet>
+#include <QSharedPointer>
+#include <QString>
+#include <QTimer>
+#include <QVector>
+
+// How often (in ms) the canvas is saved, if it has changed.
+#define AUTOSAVE_INTERVAL	60000
+
+class Edge;
+class EdgeBundle;
+class Graph;
+class Node;
+
+// One autosave being written by a worker thread.
+typedef struct saveJob
+{
+    Graph_Description	snapshot;
+    QString		fileName;
+    bool		ok;
+    QString		errorMessage;
+} Save_Job;
+
+// What a tick compares to see if the compact edges have changed.
+typedef struct bundleSignature
+{
+    EdgeBundle *	bundle;
+    int			count;
+    qreal		penWidth;
+    QRgb		colour;
+    qreal		labelSize;
+} Bundle_Signature;
+
+class AutoSaver : public QObject
+{
+    Q_OBJECT
+
+  public:
+    explicit AutoSaver(QGraphicsScene * scene, QObject * parent = 0);
+    ~AutoSaver();
+
+    QString fileName() const;
+    bool hasRecovery() const;
+
+    // Called by the items of a scene when they change.
+    static void nodeChanged(Node * node);
+    static void edgeChanged(Edge * edge);
+    static void graphMoved(Graph * graph);
+    static void itemsChanged(QGraphicsScene * scene);
+
+  public slots:
+    void save();
+    void discard();
+
+  private slots:
+    void saveDone();
+
+  private:
+    bool updateSnapshot();
+    bool rescanSnapshot();
+    static bool isTracking(QGraphicsScene * scene);
+    static void writeSnapshot(QSharedPointer<Save_Job> job);
+
+    QGraphicsScene *		scene;
+    QString			autosaveFile;
+    QScopedPointer<QLockFile>	lock;
+    bool			recovery;
+    QTimer			timer;
+    QFutureWatcher<void>	saveWatcher;
+    QSharedPointer<Save_Job>	job;		// The one being written.
+
+    // The last snapshot, and the items it describes.
+    Graph_Description		snapshot;
+    QVector<Node *>		nodeItems;
+    QVector<Edge *>		edgeItems;
+    QVector<Bundle_Signature>	bundleItems;
+    QHash<Node *, int>		nodeIndex;	// Into nodeItems.
+    QHash<Edge *, int>		edgeIndex;	// Into edgeItems.
+    bool			dirty;
+
+    // What has changed since the last tick.
+    static AutoSaver *		tracker;	// The saver being told.
+    QSet<Node *>		changedNodes;
+    QSet<Edge *>		changedEdges;
+    QList<QPointer<Graph>>	movedGraphs;
+    bool			rescan;		// Items came or went.
+};
+
+#endif // AUTOSAVE_H
@@ -2,7 +2,7 @@
  * File:	basicgraphs.cpp
  * Author:	Rachel Bood
  * Date:	Dec 31, 2015 (?)
- * Version:	1.6
+ * Version:	1.7
  *
  * Purpose:	Implement functions which draw all the "known" graph types.
  *
@@ -57,12 +57,18 @@
  * Aug 25, 2020 (IC V1.6)
  *  (a) Added a new basicGraphs category, circulant graph which creates
  *      a cycle along with edges based on a list of offsets.
+
+ * Oct 18, 2026 (agent V1.7)
+ *  (a) generate_complete() and generate_bipartite() put their edges
+ *	in the graph's EdgeBundle rather than creating an Edge (and
+ *	HTML_Label) for each one.
  */
 
 #include "basicgraphs.h"
 #include "defuns.h"
 #include "node.h"
 #include "edge.h"
+#include "edgebundle.h"
 #include <qmath.h>
 #include <QDebug>
 
@@ -413,13 +419,12 @@ BasicGraphs::generate_bipartite(Graph * g, int topNodes, int bottomNodes,
     if (! drawEdges)
 	return;
 
+    // These graphs are dense, so use compact edges.
+    EdgeBundle * bundle = g->getEdgeBundle(true);
     for (int i = 0; i < topNodes; i++)
 	for (int j = 0; j < bottomNodes; j++)
-	{
-	    Edge * edge = new Edge(g->nodes.bipartite_top.at(i),
-				   g->nodes.bipartite_bottom.at(j));
-	    edge->setParentItem(g);
-	}
+	    bundle->addEdge(g->nodes.bipartite_top.at(i),
+			    g->nodes.bipartite_bottom.at(j));
 }
 
 
@@ -517,13 +522,11 @@ BasicGraphs::generate_complete(Graph * g, int numOfNodes, bool drawEdges)
     if (!drawEdges)
 	return;
 
+    // These graphs are dense, so use compact edges.
+    EdgeBundle * bundle = g->getEdgeBundle(true);
     for (int i = 0; i < g->nodes.cycle.count(); i++)
 	for (int j = i + 1; j < g->nodes.cycle.count(); j++)
-	{
-	    Edge * edge = new Edge(g->nodes.cycle.at(i),
-				   g->nodes.cycle.at(j));
-	    edge->setParentItem(g);
-	}
+	    bundle->addEdge(g->nodes.cycle.at(i), g->nodes.cycle.at(j));
 }
 
 
@@ -0,0 +1,458 @@
+/*
+ * File:	batchrender.cpp
+ * Author:	agent
+ * Date:	2026-10-18
+ * Version:	1.5
+ *
+ * Purpose:	A headless batch renderer for .grphc files.  When Graphic
+ *		is run as
+ *		    Graphic --batch [options] file.grphc ...
+ *		no windows are created (the "offscreen" Qt platform is
+ *		used), each input file is read with readGraphIc() and
+ *		written out in the requested format(s) with the same
+ *		functions that MainWindow::save_Graph() uses.  The
+ *		input files are processed in parallel, one per thread.
+ *
+ * Modification history:
+ * Oct 18, 2026 (agent V1.0)
+ *  (a) Initial version.
+ * Oct 18, 2026 (agent V1.1)
+ *  (a) Accept .grphb input files and a grphb output format, so that
+ *	the batch renderer is also the converter between .grphc files
+ *	and their binary companions.
+ * Oct 18, 2026 (agent V1.2)
+ *  (a) Read .grphc input files through a CompressedFile, so they
+ *	may be gzipped (foo.grphc.gz).
+ * Oct 18, 2026 (agent V1.3)
+ *  (a) writeImageFile() marks the scene as exporting (see
+ *	isExporting()), so that the items are drawn in full.
+ * Oct 18, 2026 (agent V1.4)
+ *  (a) Use Graph::setExporting(), so that the graphs are not drawn
+ *	from their caches.
+ * Oct 18, 2026 (agent V1.5)
+ *  (a) A .grphb file made from a (plain) .grphc file records the
+ *	.grphc file's size, time and CRC, so that it serves as that
+ *	file's companion.
+ */
+
+#include "batchrender.h"
+#include "binaryformat.h"
+#include "compressedfile.h"
+#include "defuns.h"
+#include "edge.h"
+#include "graph.h"
+#include "mainwindow.h"
+#include "node.h"
+
+#include <QCommandLineParser>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QGraphicsScene>
+#include <QImage>
+#include <QImageWriter>
+#include <QPainter>
+#include <QTextStream>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <QtSvg/QSvgGenerator>
+#include <string.h>
+
+// The offscreen platform has no meaningful screen DPI, so unless the
+// user says otherwise (or has set a custom resolution in the settings
+// dialog), use this many pixels per inch for the output.
+#define DEFAULT_BATCH_DPI   96
+
+typedef struct batchJob
+{
+    QString	inputFile;
+    QStringList	formats;	// Output file extensions, e.g. "tikz".
+    QString	outputDir;	// Empty means "same dir as the input".
+    QColor	imageBgColour;	// Background of non-JPG raster output.
+    QColor	jpgBgColour;	// Background of JPG output.
+    bool	ok;
+    QString	messages;
+} Batch_Job;
+
+
+
+/*
+ * Name:	isBatchInvocation()
+ * Purpose:	Look for the --batch (-b) option.
+ * Arguments:	main()'s argc and argv.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	True iff the batch renderer was asked for.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	This must be known before the QApplication is created,
+ *		since the Qt platform plugin is chosen at that time, so
+ *		QCommandLineParser can not (yet) be used.
+ */
+
+bool
+isBatchInvocation(int argc, char * argv[])
+{
+    for (int i = 1; i < argc; i++)
+    {
+	if (strcmp(argv[i], "--") == 0)
+	    break;
+	if (strcmp(argv[i], "--batch") == 0 || strcmp(argv[i], "-b") == 0)
+	    return true;
+    }
+    return false;
+}
+
+
+
+/*
+ * Name:	writeTextFile()
+ * Purpose:	Write the given nodes out in one of the text formats.
+ * Arguments:	The output file name, its extension and the nodes.
+ * Outputs:	The file.
+ * Modifies:	Nothing.
+ * Returns:	True on success.
+ * Assumptions:	The nodes' IDs are 0, 1, ..., in order.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+static bool
+writeTextFile(QString fileName, QString format, QVector<Node *> nodes)
+{
+    QFile outputFile(fileName);
+    if (!outputFile.open(QIODevice::WriteOnly))
+	return false;
+
+    QTextStream outStream(&outputFile);
+    bool success;
+    if (format == "tikz")
+	success = saveTikZ(outStream, nodes);
+    else if (format == "edges")
+	success = saveEdgelist(outStream, nodes);
+    else
+	success = saveGraphIc(outStream, nodes, false);
+    outStream.flush();
+    outputFile.close();
+
+    return success && outStream.status() == QTextStream::Ok;
+}
+
+
+
+/*
+ * Name:	writeImageFile()
+ * Purpose:	Render the given scene to an SVG or raster image file.
+ * Arguments:	The output file name, its extension, the scene and
+ *		the job (for the background colours).
+ * Outputs:	The file.
+ * Modifies:	Nothing.
+ * Returns:	True on success.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	This mirrors what save_Graph() does, except that a
+ *		QImage is used rather than a QPixmap, since the latter
+ *		may only be used on the GUI thread.
+ */
+
+static bool
+writeImageFile(QString fileName, QString format, QGraphicsScene * scene,
+	       const Batch_Job &job)
+{
+    QRectF bounds = scene->itemsBoundingRect();
+    QRectF target(0, 0, bounds.width(), bounds.height());
+
+    // The scene is only ever drawn into this file.
+    Graph::setExporting(scene, true);
+    if (format == "svg")
+    {
+	QSvgGenerator svgGen;
+	svgGen.setFileName(fileName);
+	svgGen.setSize(bounds.size().toSize());
+	QPainter painter(&svgGen);
+	scene->render(&painter, target, bounds, Qt::IgnoreAspectRatio);
+	return painter.end();
+    }
+
+    QImage image(bounds.size().toSize(), QImage::Format_ARGB32_Premultiplied);
+    if (image.isNull())
+	return false;
+    if (format == "jpg" || format == "jpeg")
+	image.fill(job.jpgBgColour);
+    else
+	image.fill(job.imageBgColour);
+
+    QPainter painter(&image);
+    painter.setRenderHints(QPainter::Antialiasing
+			   | QPainter::TextAntialiasing
+			   | QPainter::HighQualityAntialiasing
+			   | QPainter::NonCosmeticDefaultPen, true);
+    scene->render(&painter, target, bounds, Qt::IgnoreAspectRatio);
+    painter.end();
+
+    return image.save(fileName);
+}
+
+
+
+/*
+ * Name:	renderOne()
+ * Purpose:	Read one .grphc (or .grphb) file and write it out in each of the
+ *		job's formats.
+ * Arguments:	The job.
+ * Outputs:	The output files.
+ * Modifies:	job.ok and job.messages.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Called (via QtConcurrent) on a pool thread, so this
+ *		must not touch anything shared except read-only globals.
+ *		Each job gets its own scene, so nothing in Qt's graphics
+ *		view code is shared between threads.
+ */
+
+static void
+renderOne(Batch_Job &job)
+{
+    job.ok = false;
+
+    QString errorMessage;
+    Graph * graph;
+    if (QFileInfo(job.inputFile).suffix() == GRAPHiCS_BIN_EXTENSION)
+	graph = readGraphBin(job.inputFile, errorMessage);
+    else
+    {
+	CompressedFile file(job.inputFile);
+	if (!file.open(QIODevice::ReadOnly))
+	{
+	    job.messages = job.inputFile + ": " + file.errorString();
+	    return;
+	}
+
+	QTextStream in(&file);
+	graph = readGraphIc(in, job.inputFile, errorMessage);
+	file.close();
+    }
+    if (graph == nullptr)
+    {
+	job.messages = errorMessage;
+	return;
+    }
+
+    QGraphicsScene scene;
+    scene.setItemIndexMethod(QGraphicsScene::NoIndex);
+    scene.addItem(graph);
+    Edge::adjustQueuedEdges();
+
+    QVector<Node *> nodes;
+    int numOfNodes = 0;
+    foreach (QGraphicsItem * item, scene.items())
+    {
+	if (item->type() == Node::Type)
+	{
+	    Node * node = qgraphicsitem_cast<Node *>(item);
+	    node->setID(numOfNodes++);
+	    nodes.append(node);
+	}
+    }
+
+    QFileInfo inputInfo(job.inputFile);
+    QString dir = job.outputDir.isEmpty()
+	? inputInfo.absolutePath() : job.outputDir;
+    QString baseName = inputInfo.completeBaseName();
+    // foo.grphc.gz makes foo.png, not foo.grphc.png.
+    if (inputInfo.suffix() == GZIP_FILE_EXTENSION)
+	baseName = QFileInfo(baseName).completeBaseName();
+
+    job.ok = true;
+    foreach (QString format, job.formats)
+    {
+	QString outName = dir + "/" + baseName + "." + format;
+	bool success;
+
+	if (QFileInfo(outName).absoluteFilePath()
+	    == inputInfo.absoluteFilePath())
+	{
+	    job.messages += job.inputFile
+		+ ": refusing to overwrite the input file\n";
+	    job.ok = false;
+	    continue;
+	}
+
+	if (format == "tikz" || format == "edges"
+	    || format == GRAPHiCS_FILE_EXTENSION)
+	    success = writeTextFile(outName, format, nodes);
+	else if (format == GRAPHiCS_BIN_EXTENSION)
+	{
+	    success = saveGraphBin(outName, nodes, errorMessage,
+				   inputInfo.suffix() == GRAPHiCS_FILE_EXTENSION
+				   ? job.inputFile : QString());
+	    if (!success)
+		job.messages += errorMessage + "\n";
+	}
+	else
+	    success = writeImageFile(outName, format, &scene, job);
+
+	if (success)
+	    job.messages += job.inputFile + " -> " + outName + "\n";
+	else
+	{
+	    job.messages += job.inputFile + ": unable to write "
+		+ outName + "\n";
+	    job.ok = false;
+	}
+    }
+    job.messages.chop(1);
+}
+
+
+
+/*
+ * Name:	batchRender()
+ * Purpose:	Parse the command line and convert all the named files.
+ * Arguments:	The application's arguments.
+ * Outputs:	The output files, and a line per output (or error)
+ *		on stderr.
+ * Modifies:	currentPhysicalDPI{,_X,_Y}
+ * Returns:	The program's exit status: 0 if everything was
+ *		converted, 1 if anything went wrong.
+ * Assumptions:	The QApplication exists and the fonts have been loaded.
+ * Bugs:	None known.
+ * Notes:	The options are
+ *		  -f, --format <ext>	output format (may be repeated or
+ *					comma-separated); default tikz
+ *		  -o, --output-dir <d>	where to put the output files
+ *		  -j, --jobs <n>	number of threads to use
+ *		  --dpi <n>		pixels per inch of raster output
+ *		The DPI is also what the node coordinates are scaled
+ *		by (as on the canvas), so it does not affect the text
+ *		formats.
+ */
+
+int
+batchRender(QStringList arguments)
+{
+    QTextStream err(stderr);
+    QCommandLineParser parser;
+
+    parser.setApplicationDescription("Convert graph-ic files to other "
+				     "formats without opening a window.");
+    parser.addHelpOption();
+    parser.addOption(QCommandLineOption(QStringList() << "b" << "batch",
+					"Run the batch renderer."));
+    parser.addOption(QCommandLineOption(QStringList() << "f" << "format",
+					"Output format: tikz, edges, "
+					GRAPHiCS_FILE_EXTENSION ", "
+					GRAPHiCS_BIN_EXTENSION
+					", svg or an image format such "
+					"as png.", "format"));
+    parser.addOption(QCommandLineOption(QStringList() << "o" << "output-dir",
+					"Directory for the output files "
+					"(default: beside each input).",
+					"dir"));
+    parser.addOption(QCommandLineOption(QStringList() << "j" << "jobs",
+					"Number of files to convert at once "
+					"(default: number of CPUs).", "n"));
+    parser.addOption(QCommandLineOption("dpi",
+					"Pixels per inch for image output.",
+					"dpi"));
+    parser.addPositionalArgument("files", "The ." GRAPHiCS_FILE_EXTENSION
+				 " (or ." GRAPHiCS_BIN_EXTENSION
+				 ") files to convert.", "file...");
+    parser.process(arguments);
+
+    QStringList inputs = parser.positionalArguments();
+    if (inputs.isEmpty())
+    {
+	err << "No input files given.\n";
+	return 1;
+    }
+
+    QStringList knownFormats;
+    knownFormats << "tikz" << "edges" << GRAPHiCS_FILE_EXTENSION
+		 << GRAPHiCS_BIN_EXTENSION << "svg";
+    foreach (QByteArray format, QImageWriter::supportedImageFormats())
+	knownFormats << QString(format).toLower();
+
+    QStringList formats;
+    foreach (QString value, parser.values("format"))
+	foreach (QString format, value.split(",", QString::SkipEmptyParts))
+	    formats << format.trimmed().toLower();
+    if (formats.isEmpty())
+	formats << "tikz";
+    foreach (QString format, formats)
+    {
+	if (!knownFormats.contains(format))
+	{
+	    err << "Unknown output format '" << format << "'.\n";
+	    return 1;
+	}
+    }
+
+    QString outputDir;
+    if (parser.isSet("output-dir"))
+    {
+	outputDir = QDir(parser.value("output-dir")).absolutePath();
+	if (!QDir().mkpath(outputDir))
+	{
+	    err << "Unable to create the directory " << outputDir << ".\n";
+	    return 1;
+	}
+    }
+
+    qreal dpi = DEFAULT_BATCH_DPI;
+    if (settings.value("useDefaultResolution") == false)
+	dpi = settings.value("customResolution").toReal();
+    if (parser.isSet("dpi"))
+    {
+	bool ok;
+	dpi = parser.value("dpi").toDouble(&ok);
+	if (!ok || dpi <= 0)
+	{
+	    err << "Invalid DPI '" << parser.value("dpi") << "'.\n";
+	    return 1;
+	}
+    }
+    currentPhysicalDPI = currentPhysicalDPI_X = currentPhysicalDPI_Y = dpi;
+
+    if (parser.isSet("jobs"))
+    {
+	int jobs = parser.value("jobs").toInt();
+	if (jobs > 0)
+	    QThreadPool::globalInstance()->setMaxThreadCount(jobs);
+    }
+
+    // Same defaults as save_Graph().
+    QColor imageBgColour = Qt::transparent;
+    QColor jpgBgColour = Qt::white;
+    if (settings.contains("otherImageBgColour"))
+	imageBgColour = QColor(settings.value("otherImageBgColour").toString());
+    if (settings.contains("jpgBgColour"))
+	jpgBgColour = QColor(settings.value("jpgBgColour").toString());
+
+    QVector<Batch_Job> jobs;
+    foreach (QString input, inputs)
+    {
+	Batch_Job job;
+	job.inputFile = input;
+	job.formats = formats;
+	job.outputDir = outputDir;
+	job.imageBgColour = imageBgColour;
+	job.jpgBgColour = jpgBgColour;
+	job.ok = false;
+	jobs.append(job);
+    }
+
+    QtConcurrent::blockingMap(jobs, renderOne);
+
+    int failures = 0;
+    foreach (const Batch_Job &job, jobs)
+    {
+	err << job.messages << "\n";
+	if (!job.ok)
+	    failures++;
+    }
+    err.flush();
+
+    return failures == 0 ? 0 : 1;
+}
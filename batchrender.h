@@ -0,0 +1,24 @@
+/*
+ * File:	batchrender.h
+ * Author:	agent
+ * Date:	2026-10-18
+ * Version:	1.0
+ *
+ * Purpose:	Declare the entry point of the headless (command-line)
+ *		batch renderer, which converts .grphc files to other
+ *		formats without bringing up the MainWindow.
+ *
+ * Modification history:
+ * Oct 18, 2026 (agent V1.0)
+ *  (a) Initial version.
+ */
+
+#ifndef BATCHRENDER_H
+#define BATCHRENDER_H
+
+#include <QStringList>
+
+bool isBatchInvocation(int argc, char * argv[]);
+int batchRender(QStringList arguments);
+
+#endif // BATCHRENDER_H
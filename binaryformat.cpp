@@ -0,0 +1,782 @@
+/*
+ * File:	binaryformat.cpp
+ * Author:	agent
+ * Date:	2026-10-18
+ * Version:	1.3
+ *
+ * Purpose:	Read and write the binary companion (.grphb) of the
+ *		graph-ic (.grphc) format.
+ *
+ *		Reading a .grphc file means splitting every line into
+ *		QStrings and converting each field with toDouble(),
+ *		which is slow for big graphs.  A .grphb file holds the
+ *		same information in flat little-endian arrays, so it can
+ *		be mapped into memory and read with nothing more than
+ *		a bounds check and one pass to build the items.  The
+ *		text file remains the master copy: MainWindow writes the
+ *		companion beside a (not gzipped) .grphc file in the
+ *		library when it is saved, and only uses the companion if
+ *		it was made from a file with the same size and contents
+ *		as the text file (see binaryCompanionIsCurrent()).  The
+ *		batch renderer converts either way (Graphic --batch
+ *		-f grphb x.grphc, or -f grphc x.grphb).
+ *
+ *		The layout of version 2 is (all numbers little-endian,
+ *		u32/u64 unsigned integers, i64 signed, f64 IEEE doubles,
+ *		colours the QRgba64 value as a u64, lengths in inches
+ *		as in .grphc):
+ *
+ *		  header (56 bytes):
+ *		    char magic[8]	GRPHB_MAGIC
+ *		    u32 version, nodeCount, edgeCount,
+ *			nodeStyleCount, edgeStyleCount,
+ *			stringCount, stringBytes,
+ *			textCRC (the zlib CRC-32 of the .grphc file)
+ *		    u64 textSize (of the .grphc file, in bytes)
+ *		    i64 textMTime (of the .grphc file, in ms since the
+ *			epoch; 0 if the file was not made from one)
+ *		  node styles (40 bytes each):
+ *		    f64 diameter, penWidth, labelSize; u64 fill, line
+ *		  edge styles (24 bytes each):
+ *		    f64 penWidth, labelSize; u64 colour
+ *		  nodes (32 bytes each):
+ *		    f64 x, y, rotation; u32 style, label
+ *		  edges (40 bytes each):
+ *		    u32 source, dest; f64 destRadius, sourceRadius,
+ *		    rotation; u32 style, label
+ *		  string offsets:
+ *		    u32 offset[stringCount + 1], padded to 8 bytes
+ *		  strings:
+ *		    stringBytes bytes of UTF-8; string i is the bytes
+ *		    [offset[i], offset[i + 1])
+ *
+ *		A label of GRPHB_NO_LABEL means "no label".  The node
+ *		coordinates are centred on (0, 0), as in .grphc files.
+ *		Version 1 files, whose header is the first 40 bytes of
+ *		the above (with textCRC always 0), can still be read,
+ *		but are never taken to be up to date.
+ *
+ * Modification history:
+ * Oct 18, 2026 (agent V1.0)
+ *  (a) Initial version.
+ * Oct 18, 2026 (agent V1.1)
+ *  (a) saveGraphBin() gets the edges from describeEdges(), so
+ *	compact edges are written without expanding them first, and
+ *	writes one edge style record per distinct set of values
+ *	(compact edges are not Edges, so have no style entry).
+ * Oct 18, 2026 (agent V1.2)
+ *  (a) Version 2 of the format records the size, modification time
+ *	and CRC-32 of the .grphc file the companion was made from;
+ *	added binaryCompanionIsCurrent() to check them, since the
+ *	modification times alone can't be trusted (copies, coarse
+ *	timestamps, clocks which differ).
+ *  (b) binaryCompanion() returns a null string for gzipped files,
+ *	rather than turning x.grphc.gz into x.grphc.grphb.
+ *  (c) readGraphBin() picks the edges to bundle with chooseBundle()
+ *	(see graphloader.cpp), as a GraphBuilder now does.
+ * Oct 18, 2026 (agent V1.3)
+ *  (a) Add a saveGraphBin() which writes a Graph_Description, so
+ *	that "Export all" needs no items; the old one describes the
+ *	nodes and calls it.  Node style records are now one per
+ *	distinct set of values, as for edges.
+ */
+
+#include "binaryformat.h"
+#include "defuns.h"
+#include "edge.h"
+#include "edgebundle.h"
+#include "graph.h"
+#include "graphloader.h"
+#include "node.h"
+#include "styletable.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QRgba64>
+#include <QtEndian>
+#include <limits.h>
+#include <string.h>
+#include <zlib.h>
+
+#define GRPHB_MAGIC	"GRPHB\r\n\032"	// 8 bytes, without the NUL.
+#define GRPHB_VERSION	2
+#define GRPHB_NO_LABEL	0xFFFFFFFFu
+
+#define HEADER_SIZE	56
+#define HEADER_SIZE_V1	40
+#define NODE_STYLE_SIZE	40
+#define EDGE_STYLE_SIZE	24
+#define NODE_SIZE	32
+#define EDGE_SIZE	40
+
+// Nodes with the same diameter, pen width, label size and fill and line
+// colours share a style record.
+typedef QPair<QPair<qreal, qreal>, QPair<qreal, QPair<quint64, quint64>>>
+    Node_Style_Key;
+
+// Edges with the same pen width, label size and colour share a style
+// record.
+typedef QPair<QPair<qreal, qreal>, quint64> Edge_Style_Key;
+
+
+
+static inline quint32
+u32At(const uchar * p)
+{
+    return qFromLittleEndian<quint32>(p);
+}
+
+
+
+static inline quint64
+u64At(const uchar * p)
+{
+    return qFromLittleEndian<quint64>(p);
+}
+
+
+
+static inline qreal
+f64At(const uchar * p)
+{
+    quint64 bits = qFromLittleEndian<quint64>(p);
+    double d;
+
+    memcpy(&d, &bits, sizeof(d));
+    return d;
+}
+
+
+
+/*
+ * Name:	binaryCompanion()
+ * Purpose:	Find the name of the binary companion of a file.
+ * Arguments:	The name of a .grphc file.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The same name with a .grphb extension, or a null
+ *		string if the file is not a (plain) .grphc file.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	Only plain .grphc files have companions: a gzipped file
+ *		is kept small on purpose, and its companion would not
+ *		be.
+ */
+
+QString
+binaryCompanion(QString fileName)
+{
+    QFileInfo fi(fileName);
+
+    if (fi.suffix() != GRAPHiCS_FILE_EXTENSION)
+	return QString();
+
+    return fi.path() + "/" + fi.completeBaseName()
+	+ "." GRAPHiCS_BIN_EXTENSION;
+}
+
+
+
+/*
+ * Name:	stampTextFile()
+ * Purpose:	Find the size, modification time and CRC-32 of a file.
+ * Arguments:	The file name, and the variables to set.
+ * Outputs:	Nothing.
+ * Modifies:	size, mtime and crc.
+ * Returns:	True on success.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	The file is read a block at a time, which is much
+ *		quicker than parsing it.
+ */
+
+static bool
+stampTextFile(QString fileName, quint64 &size, qint64 &mtime, quint32 &crc)
+{
+    QFile file(fileName);
+
+    if (!file.open(QIODevice::ReadOnly))
+	return false;
+
+    QByteArray block(1024 * 1024, 0);
+    uLong sum = crc32(0L, Z_NULL, 0);
+    qint64 n;
+    size = 0;
+    while ((n = file.read(block.data(), block.size())) > 0)
+    {
+	sum = crc32(sum, (const Bytef *)block.constData(), n);
+	size += n;
+    }
+    if (n < 0)
+	return false;
+
+    crc = quint32(sum);
+    mtime = QFileInfo(file).lastModified().toMSecsSinceEpoch();
+    return true;
+}
+
+
+
+/*
+ * Name:	binaryCompanionIsCurrent()
+ * Purpose:	Tell whether a .grphb file was made from (what is now
+ *		in) a .grphc file.
+ * Arguments:	The names of the two files.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	True iff the companion can be read in place of the
+ *		text file.
+ * Assumptions:	None.
+ * Bugs:	A change to the text file which keeps its size and its
+ *		CRC-32 is not noticed.
+ * Notes:	The size is checked first, since that is cheap; then
+ *		the whole text file is read to compare the CRC.  The
+ *		modification time is only reported: copying a file, or
+ *		saving it twice within the filesystem's timestamp
+ *		granularity, makes it wrong in either direction.
+ */
+
+bool
+binaryCompanionIsCurrent(QString binFileName, QString textFileName)
+{
+    QFile file(binFileName);
+    QFileInfo textInfo(textFileName);
+
+    if (!textInfo.isFile() || !file.open(QIODevice::ReadOnly))
+	return false;
+
+    QByteArray header = file.read(HEADER_SIZE);
+    if (header.size() < HEADER_SIZE
+	|| memcmp(header.constData(), GRPHB_MAGIC, 8) != 0)
+	return false;
+
+    const uchar * h = reinterpret_cast<const uchar *>(header.constData());
+    qint64 textMTime = qint64(u64At(h + 48));
+    if (u32At(h + 8) != GRPHB_VERSION || textMTime == 0
+	|| u64At(h + 40) != quint64(textInfo.size()))
+	return false;
+
+    quint64 size;
+    qint64 mtime;
+    quint32 crc;
+    if (!stampTextFile(textFileName, size, mtime, crc)
+	|| size != u64At(h + 40) || crc != u32At(h + 36))
+	return false;
+
+    if (mtime != textMTime)
+	qDeb() << "binaryCompanionIsCurrent(" << binFileName
+	       << "): contents match, but the mtime does not";
+    return true;
+}
+
+
+
+static inline Node_Style_Key
+nodeStyleKey(const Node_Description &d)
+{
+    return qMakePair(qMakePair(d.diameter, d.penWidth),
+		     qMakePair(d.labelSize,
+			       qMakePair(quint64(d.fillColour.rgba64()),
+					 quint64(d.lineColour.rgba64()))));
+}
+
+
+
+static inline Edge_Style_Key
+edgeStyleKey(const Edge_Description &e)
+{
+    return qMakePair(qMakePair(e.penWidth, e.labelSize),
+		     quint64(e.colour.rgba64()));
+}
+
+
+
+/*
+ * Name:	saveGraphBin()
+ * Purpose:	Write the given nodes and their edges in .grphb format.
+ * Arguments:	The output file name, the nodes, a string to hold an
+ *		error message, and the name of the .grphc file the
+ *		nodes were just saved to (or a null string).
+ * Outputs:	The file.
+ * Modifies:	errorMessage, if there is an error.
+ * Returns:	True on success.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Describes the nodes and their edges (including compact
+ *		edges) and writes the description with the
+ *		saveGraphBin() below.
+ */
+
+bool
+saveGraphBin(QString fileName, QVector<Node *> nodes, QString &errorMessage,
+	     QString textFileName)
+{
+    Graph_Description description;
+
+    describeGraph(nodes, description);
+    return saveGraphBin(fileName, description, errorMessage, textFileName);
+}
+
+
+
+/*
+ * Name:	saveGraphBin()
+ * Purpose:	Write a graph description in .grphb format.
+ * Arguments:	The output file name, the description, a string to
+ *		hold an error message, and the name of the .grphc file
+ *		the graph was just saved to (or a null string).
+ * Outputs:	The file.
+ * Modifies:	errorMessage, if there is an error.
+ * Returns:	True on success.
+ * Assumptions:	The node positions are scene positions in inches, as
+ *		describeNode() gives them.
+ * Bugs:	None known.
+ * Notes:	One node style record is written per distinct diameter,
+ *		pen width, label size and colours, and one edge style
+ *		record per distinct pen width, label size and colour,
+ *		so a graph whose items share their styles has one or
+ *		two of each.
+ *		As in saveGraphIc(), edges from a node to itself are
+ *		not in the description (see describeEdges()).  Unlike
+ *		saveGraphIc(), each edge keeps its direction (which
+ *		matters for the two radii).
+ *		If a .grphc file is given, its size, modification time
+ *		and CRC-32 go in the header, so that the result is a
+ *		companion which binaryCompanionIsCurrent() accepts.
+ *		This touches no QGraphicsItems, so it may be called on
+ *		any thread.
+ */
+
+bool
+saveGraphBin(QString fileName, const Graph_Description &description,
+	     QString &errorMessage, QString textFileName)
+{
+    const QVector<Node_Description> &nodes = description.nodes;
+    const QVector<Edge_Description> &edges = description.edges;
+    QHash<Node_Style_Key, quint32> nodeStyleIndex;
+    QHash<Edge_Style_Key, quint32> edgeStyleIndex;
+    QVector<int> nodeStyleOwners;	// A node using each node style.
+    QVector<int> edgeStyleOwners;	// Likewise, indices into edges.
+    QVector<quint32> nodeStyles;	// The style index of each node.
+    QVector<quint32> edgeStyles;	// The style index of each edge.
+    QVector<quint32> stringOffsets;
+    QByteArray strings;
+    quint64 textSize = 0;
+    qint64 textMTime = 0;
+    quint32 textCRC = 0;
+
+    if (!textFileName.isNull()
+	&& !stampTextFile(textFileName, textSize, textMTime, textCRC))
+    {
+	errorMessage = "Unable to read " + textFileName + ".";
+	return false;
+    }
+
+    // Centre the graph on (0, 0), as saveGraphIc() does.
+    QPointF mid = centreInInches(nodes);
+
+    nodeStyles.reserve(nodes.count());
+    for (int i = 0; i < nodes.count(); i++)
+    {
+	Node_Style_Key key = nodeStyleKey(nodes.at(i));
+	if (!nodeStyleIndex.contains(key))
+	{
+	    nodeStyleIndex.insert(key, nodeStyleOwners.count());
+	    nodeStyleOwners.append(i);
+	}
+	nodeStyles.append(nodeStyleIndex.value(key));
+    }
+
+    edgeStyles.reserve(edges.count());
+    for (int i = 0; i < edges.count(); i++)
+    {
+	Edge_Style_Key key = edgeStyleKey(edges.at(i));
+	if (!edgeStyleIndex.contains(key))
+	{
+	    edgeStyleIndex.insert(key, edgeStyleOwners.count());
+	    edgeStyleOwners.append(i);
+	}
+	edgeStyles.append(edgeStyleIndex.value(key));
+    }
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+	errorMessage = fileName + ": " + file.errorString();
+	return false;
+    }
+
+    QDataStream out(&file);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out.setFloatingPointPrecision(QDataStream::DoublePrecision);
+
+    // The labels are collected as the nodes and edges are written,
+    // but the header needs their number and size, so count them first.
+    quint32 stringCount = 0;
+    foreach (const Node_Description &d, nodes)
+	if (d.hasLabel)
+	    stringCount++;
+    foreach (const Edge_Description &e, edges)
+	if (e.hasLabel)
+	    stringCount++;
+
+    out.writeRawData(GRPHB_MAGIC, 8);
+    out << quint32(GRPHB_VERSION) << quint32(nodes.count())
+	<< quint32(edges.count()) << quint32(nodeStyleOwners.count())
+	<< quint32(edgeStyleOwners.count()) << stringCount;
+    qint64 stringBytesPos = file.pos();
+    // stringBytes (filled in at the end), then the text file's stamp.
+    out << quint32(0) << textCRC << textSize << textMTime;
+
+    foreach (int i, nodeStyleOwners)
+	out << nodes.at(i).diameter << nodes.at(i).penWidth
+	    << nodes.at(i).labelSize
+	    << quint64(nodes.at(i).fillColour.rgba64())
+	    << quint64(nodes.at(i).lineColour.rgba64());
+
+    foreach (int i, edgeStyleOwners)
+	out << edges.at(i).penWidth << edges.at(i).labelSize
+	    << quint64(edges.at(i).colour.rgba64());
+
+    stringOffsets.append(0);
+    for (int i = 0; i < nodes.count(); i++)
+    {
+	const Node_Description &d = nodes.at(i);
+	quint32 label = GRPHB_NO_LABEL;
+	if (d.hasLabel)
+	{
+	    label = stringOffsets.count() - 1;
+	    strings += d.label.toUtf8();
+	    stringOffsets.append(strings.size());
+	}
+	out << d.x - mid.x() << d.y - mid.y() << d.rotation
+	    << nodeStyles.at(i) << label;
+    }
+
+    for (int i = 0; i < edges.count(); i++)
+    {
+	const Edge_Description &e = edges.at(i);
+	quint32 label = GRPHB_NO_LABEL;
+	if (e.hasLabel)
+	{
+	    label = stringOffsets.count() - 1;
+	    strings += e.label.toUtf8();
+	    stringOffsets.append(strings.size());
+	}
+	out << quint32(e.source) << quint32(e.dest)
+	    << e.destRadius << e.sourceRadius << e.rotation
+	    << edgeStyles.at(i) << label;
+    }
+
+    foreach (quint32 offset, stringOffsets)
+	out << offset;
+    if (stringOffsets.count() % 2 != 0)
+	out << quint32(0);
+    out.writeRawData(strings.constData(), strings.size());
+
+    file.seek(stringBytesPos);
+    out << quint32(strings.size());
+
+    bool ok = out.status() == QDataStream::Ok;
+    file.close();
+    if (!ok || file.error() != QFileDevice::NoError)
+    {
+	errorMessage = "Unable to write " + fileName + ": "
+	    + file.errorString();
+	file.remove();
+	return false;
+    }
+    return true;
+}
+
+
+
+/*
+ * Name:	readGraphBin()
+ * Purpose:	Create a graph from a .grphb file.
+ * Arguments:	The name of the file and a string to hold an error
+ *		message.
+ * Outputs:	Nothing.
+ * Modifies:	errorMessage, if there is an error.
+ * Returns:	The new graph (not yet in any scene), or nullptr if the
+ *		file can not be read or is not valid.
+ * Assumptions:	currentPhysicalDPI_{X,Y} are set.
+ * Bugs:	None known.
+ * Notes:	The file is mapped into memory (or read in one go if it
+ *		can not be mapped).  Every count, index and offset in it
+ *		is checked before any item is created, so the second
+ *		pass can not fail.
+ *		Each style record becomes one shared style entry.  The
+ *		result is otherwise the same as what readGraphIc() makes
+ *		from the equivalent .grphc file, including which edges
+ *		are put in the graph's EdgeBundle (see chooseBundle()).
+ */
+
+Graph *
+readGraphBin(QString fileName, QString &errorMessage)
+{
+    QFile file(fileName);
+
+    if (!file.open(QIODevice::ReadOnly))
+    {
+	errorMessage = "File: " + fileName + ": " + file.errorString();
+	return nullptr;
+    }
+
+    qint64 size = file.size();
+    QByteArray contents;
+    const uchar * data = size > 0 ? file.map(0, size) : nullptr;
+    if (data == nullptr)
+    {
+	contents = file.readAll();
+	data = reinterpret_cast<const uchar *>(contents.constData());
+	size = contents.size();
+    }
+
+    QString invalid = "The file " + fileName + " is not a valid ."
+	GRAPHiCS_BIN_EXTENSION " file (%1).  "
+	"Thus I can not read this file.";
+
+    if (size < HEADER_SIZE_V1 || memcmp(data, GRPHB_MAGIC, 8) != 0)
+    {
+	errorMessage = invalid.arg("bad header");
+	return nullptr;
+    }
+    quint32 version = u32At(data + 8);
+    qint64 headerSize = version == 1 ? HEADER_SIZE_V1 : HEADER_SIZE;
+    if (version != 1 && version != GRPHB_VERSION)
+    {
+	errorMessage = "The file " + fileName + " is version "
+	    + QString::number(u32At(data + 8)) + " of the ."
+	    GRAPHiCS_BIN_EXTENSION " format, which this version of "
+	    "Graphic does not know.  Thus I can not read this file.";
+	return nullptr;
+    }
+
+    quint32 nodeCount = u32At(data + 12);
+    quint32 edgeCount = u32At(data + 16);
+    quint32 nodeStyleCount = u32At(data + 20);
+    quint32 edgeStyleCount = u32At(data + 24);
+    quint32 stringCount = u32At(data + 28);
+    quint32 stringBytes = u32At(data + 32);
+
+    // The counts are 32 bits, so none of these can overflow.
+    qint64 nodeStyleBase = headerSize;
+    qint64 edgeStyleBase = nodeStyleBase + qint64(nodeStyleCount)
+	* NODE_STYLE_SIZE;
+    qint64 nodeBase = edgeStyleBase + qint64(edgeStyleCount) * EDGE_STYLE_SIZE;
+    qint64 edgeBase = nodeBase + qint64(nodeCount) * NODE_SIZE;
+    qint64 offsetBase = edgeBase + qint64(edgeCount) * EDGE_SIZE;
+    qint64 stringBase = offsetBase + ((qint64(stringCount) + 2) & ~1) * 4;
+    if (size < headerSize || size < stringBase + stringBytes
+	|| nodeCount > INT_MAX || edgeCount > INT_MAX)
+    {
+	errorMessage = invalid.arg("truncated");
+	return nullptr;
+    }
+
+    // Pass 1: check every index and offset.
+    for (quint32 i = 0; i <= stringCount; i++)
+    {
+	quint32 offset = u32At(data + offsetBase + 4 * i);
+	if (offset > stringBytes
+	    || (i > 0 && offset < u32At(data + offsetBase + 4 * (i - 1))))
+	{
+	    errorMessage = invalid.arg("bad string table");
+	    return nullptr;
+	}
+    }
+    for (quint32 i = 0; i < nodeCount; i++)
+    {
+	const uchar * n = data + nodeBase + qint64(i) * NODE_SIZE;
+	quint32 label = u32At(n + 28);
+	if (u32At(n + 24) >= nodeStyleCount
+	    || (label != GRPHB_NO_LABEL && label >= stringCount))
+	{
+	    errorMessage = invalid.arg("bad node " + QString::number(i));
+	    return nullptr;
+	}
+    }
+    for (quint32 i = 0; i < edgeCount; i++)
+    {
+	const uchar * e = data + edgeBase + qint64(i) * EDGE_SIZE;
+	quint32 label = u32At(e + 36);
+	if (u32At(e) >= nodeCount || u32At(e + 4) >= nodeCount
+	    || u32At(e + 32) >= edgeStyleCount
+	    || (label != GRPHB_NO_LABEL && label >= stringCount))
+	{
+	    errorMessage = invalid.arg("bad edge " + QString::number(i));
+	    return nullptr;
+	}
+    }
+
+    // Pass 2: build the graph.
+    QVector<NodeStylePtr> nodeStyles(nodeStyleCount);
+    QVector<qreal> diameters(nodeStyleCount);
+    for (quint32 i = 0; i < nodeStyleCount; i++)
+    {
+	const uchar * s = data + nodeStyleBase + qint64(i) * NODE_STYLE_SIZE;
+	NodeStyle * style = new NodeStyle();
+	diameters[i] = f64At(s);
+	style->diameter = diameters[i] * style->physicalDPI;
+	style->penWidth = f64At(s + 8);
+	style->labelSize = f64At(s + 16);
+	style->fillColour = QColor(QRgba64::fromRgba64(u64At(s + 24)));
+	style->lineColour = QColor(QRgba64::fromRgba64(u64At(s + 32)));
+	nodeStyles[i] = NodeStylePtr(style);
+    }
+
+    QVector<EdgeStylePtr> edgeStyles(edgeStyleCount);
+    for (quint32 i = 0; i < edgeStyleCount; i++)
+    {
+	const uchar * s = data + edgeStyleBase + qint64(i) * EDGE_STYLE_SIZE;
+	EdgeStyle * style = new EdgeStyle();
+	style->penWidth = f64At(s);
+	style->labelSize = f64At(s + 8);
+	style->colour = QColor(QRgba64::fromRgba64(u64At(s + 16)));
+	edgeStyles[i] = EdgeStylePtr(style);
+    }
+
+    const uchar * offsets = data + offsetBase;
+    const char * strings = reinterpret_cast<const char *>(data + stringBase);
+
+    Graph * graph = new Graph();
+    QVector<Node *> nodes(nodeCount);
+    QVector<qreal> radii(nodeCount);
+    // As in readGraphIc(): the extremal positions actually drawn, and
+    // the radii of the nodes which give them.
+    qreal minX = 1E10, maxX = -1E10, minY = 1E10, maxY = -1E10;
+    qreal minXr = 0, maxXr = 0, minYr = 0, maxYr = 0;
+
+    for (quint32 i = 0; i < nodeCount; i++)
+    {
+	const uchar * n = data + nodeBase + qint64(i) * NODE_SIZE;
+	qreal x = f64At(n);
+	qreal y = f64At(n + 8);
+	qreal rotation = f64At(n + 16);
+	quint32 style = u32At(n + 24);
+	quint32 label = u32At(n + 28);
+	qreal r = diameters.at(style) / 2.;
+
+	Node * node = new Node();
+	node->setStyle(nodeStyles.at(style));
+	node->setPos(x * currentPhysicalDPI_X, y * currentPhysicalDPI_Y);
+	if (rotation != 0)
+	    node->setRotation(rotation);
+	node->setID(i);
+	if (label != GRPHB_NO_LABEL)
+	{
+	    quint32 start = u32At(offsets + 4 * label);
+	    node->setNodeLabel(QString::fromUtf8(strings + start,
+				   u32At(offsets + 4 * (label + 1)) - start));
+	}
+	node->setParentItem(graph);
+	nodes[i] = node;
+	radii[i] = r;
+
+	if (x - r < minX)
+	{
+	    minX = x - r;
+	    minXr = r;
+	}
+	if (x + r > maxX)
+	{
+	    maxX = x + r;
+	    maxXr = r;
+	}
+	if (y - r < minY)
+	{
+	    minY = y - r;
+	    minYr = r;
+	}
+	if (y + r > maxY)
+	{
+	    maxY = y + r;
+	    maxYr = r;
+	}
+    }
+
+    // Pick the edges for the bundle as a GraphBuilder does.
+    QVector<bool> plain(edgeCount);
+    QVector<bool> bundled(edgeCount);
+    QVector<Bundle_Key> styleKeys(edgeStyleCount);
+    QHash<Bundle_Key, int> plainCounts;
+    for (quint32 i = 0; i < edgeStyleCount; i++)
+	styleKeys[i] = bundleKey(edgeStyles.at(i)->penWidth,
+				 edgeStyles.at(i)->colour);
+    for (quint32 i = 0; i < edgeCount; i++)
+    {
+	const uchar * e = data + edgeBase + qint64(i) * EDGE_SIZE;
+	plain[i] = isPlainEdge(u32At(e + 36) != GRPHB_NO_LABEL,
+			       f64At(e + 24), f64At(e + 8), f64At(e + 16),
+			       2 * radii.at(u32At(e + 4)));
+	if (plain.at(i))
+	    plainCounts[styleKeys.at(u32At(e + 32))]++;
+    }
+    EdgeBundle * bundle = nullptr;
+    Bundle_Key key;
+    if (chooseBundle(plainCounts, key))
+    {
+	for (quint32 i = 0; i < edgeCount; i++)
+	{
+	    const uchar * e = data + edgeBase + qint64(i) * EDGE_SIZE;
+	    quint32 style = u32At(e + 32);
+	    bundled[i] = plain.at(i) && styleKeys.at(style) == key;
+	    if (bundled.at(i) && bundle == nullptr)
+	    {
+		bundle = graph->getEdgeBundle(true);
+		bundle->setStyle(edgeStyles.at(style));
+	    }
+	}
+    }
+
+    for (quint32 i = 0; i < edgeCount; i++)
+    {
+	const uchar * e = data + edgeBase + qint64(i) * EDGE_SIZE;
+	Node * source = nodes.at(u32At(e));
+	Node * dest = nodes.at(u32At(e + 4));
+	quint32 style = u32At(e + 32);
+
+	if (bundled.at(i))
+	{
+	    bundle->addEdge(source, dest);
+	    continue;
+	}
+
+	Edge * edge = new Edge(source, dest);
+	qreal destRadius = f64At(e + 8);
+	qreal sourceRadius = f64At(e + 16);
+	qreal rotation = f64At(e + 24);
+	quint32 label = u32At(e + 36);
+	if (destRadius != edge->getDestRadius())
+	    edge->setDestRadius(destRadius);
+	if (sourceRadius != edge->getSourceRadius())
+	    edge->setSourceRadius(sourceRadius);
+	if (rotation != 0)
+	    edge->setRotation(rotation);
+	edge->setStyle(edgeStyles.at(style));
+	if (label != GRPHB_NO_LABEL)
+	{
+	    quint32 start = u32At(offsets + 4 * label);
+	    edge->setEdgeLabel(QString::fromUtf8(strings + start,
+				   u32At(offsets + 4 * (label + 1)) - start));
+	}
+	edge->setParentItem(graph);
+	Edge::queueAdjust(edge);
+    }
+
+    // Scale the node centres to a 1"x1" square, as readGraphIc() does.
+    qreal width = (maxX - maxXr) - (minX + minXr);
+    qreal height = (maxY - maxYr) - (minY + minYr);
+    foreach (Node * n, nodes)
+	n->setPreviewCoords(n->x() / width / currentPhysicalDPI_X,
+			    n->y() / height / currentPhysicalDPI_Y);
+
+    qDeb() << "readGraphBin(" << fileName << "): " << nodeCount
+	   << " nodes, " << edgeCount << " edges ("
+	   << (bundle == nullptr ? 0 : bundle->count()) << " compact)";
+    return graph;
+}
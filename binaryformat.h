@@ -0,0 +1,39 @@
+/*
+ * File:	binaryformat.h
+ * Author:	agent
+ * Date:	2026-10-18
+ * Version:	1.2
+ *
+ * Purpose:	Declare the functions which read and write the binary
+ *		(.grphb) companion of the graph-ic (.grphc) format.
+ *
+ * Modification history:
+ * Oct 18, 2026 (agent V1.0)
+ *  (a) Initial version.
+ * Oct 18, 2026 (agent V1.1)
+ *  (a) Add binaryCompanionIsCurrent(), and the name of the .grphc
+ *	file to saveGraphBin().
+ * Oct 18, 2026 (agent V1.2)
+ *  (a) Declare the saveGraphBin() which writes a Graph_Description.
+ */
+
+#ifndef BINARYFORMAT_H
+#define BINARYFORMAT_H
+
+#include "graphloader.h"
+
+#include <QString>
+#include <QVector>
+
+class Graph;
+class Node;
+
+QString binaryCompanion(QString fileName);
+bool binaryCompanionIsCurrent(QString binFileName, QString textFileName);
+bool saveGraphBin(QString fileName, QVector<Node *> nodes,
+		  QString &errorMessage, QString textFileName = QString());
+bool saveGraphBin(QString fileName, const Graph_Description &description,
+		  QString &errorMessage, QString textFileName = QString());
+Graph * readGraphBin(QString fileName, QString &errorMessage);
+
+#endif // BINARYFORMAT_H
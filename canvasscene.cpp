@@ -2,7 +2,7 @@
  * File:    canvasscene.cpp
  * Author:  Rachel Bood
  * Date:    2014/11/07
- * Version: 1.18
+ * Version: 1.22
  *
  * Purpose: Initializes a QGraphicsScene to implement a drag and drop feature.
  *          still very much a WIP
@@ -82,12 +82,38 @@
  *      The rotation of root2 needs to take into account any previous rotation.
  *  (b) Added code to the keyReleaseEvent that checks if both sets of nodes
  *      in a 4-node join were connected by an edge and thus to remove one.
+ * Oct 18, 2026 (agent V1.19)
+ *  (a) Rewrote searchAndSeparate() as a BFS with hashed visited sets.
+ *      The old version used QList::contains(), indexOf() and removeOne()
+ *      inside nested loops, which made deleting an edge from a large
+ *      graph take seconds.  It is now linear in the size of the
+ *      component(s) searched.
+ *  (b) Use a QSet to collect the neighbours of a deleted node in
+ *      mousePressEvent(), rather than QList::contains().
+ * Oct 18, 2026 (agent V1.20)
+ *  (a) Handle graphs whose edges are in an EdgeBundle: the graph is
+ *      expanded into Edges before anything is deleted from it or it
+ *      is joined to another; clicking on a compact edge in edit mode
+ *      promotes just that edge so it can be labelled; and a bundle
+ *      can be used to drag its graph, as an Edge can.
+ * Oct 18, 2026 (agent V1.21)
+ *  (a) drawBackground() fills the exposed area with a brush made
+ *      from a pre-rendered grid cell (regenerated only when the
+ *      cell size on the screen changes), rather than drawing every
+ *      grid point separately, which was slow when zoomed out.
+ * Oct 18, 2026 (agent V1.22)
+ *  (a) setCanvasMode() no longer gives every node and edge a label
+ *      when edit mode is entered (which, for a big graph, made
+ *      thousands of HTML_Labels): only items which have a label
+ *      are told about the new mode, and in edit mode clicking on
+ *      an unlabelled node or edge makes its label then.
  */
 
 #include "canvasscene.h"
 #include "canvasview.h"
 #include "defuns.h"
 #include "edge.h"
+#include "edgebundle.h"
 #include "graph.h"
 #include "graphmimedata.h"
 #include "node.h"
@@ -100,6 +126,7 @@
 #include <qmath.h>
 #include <QApplication>
 #include <QPainter>
+#include <QStyleOptionGraphicsItem>
 #include <QtCore>
 #include <QtGui>
 
@@ -162,17 +189,56 @@ CanvasScene::dropEvent(QGraphicsSceneDragDropEvent * event)
 }
 
 
+/*
+ * Name:        drawBackground()
+ * Purpose:     Draw the grid points, if snap to grid is on.
+ * Arguments:   The painter, and the exposed part of the scene.
+ * Output:      The grid.
+ * Modifies:    gridTile, if the zoom level has changed.
+ * Returns:     Nothing.
+ * Assumptions: The view is not rotated or sheared.
+ * Bugs:        None.
+ * Notes:       The grid points are at multiples of mCellSize.  Rather
+ *              than drawing each one (hundreds of thousands of them
+ *              when zoomed out), one cell is drawn into gridTile at
+ *              the current zoom, and the exposed area is filled with
+ *              a brush which repeats it.  The tile has a point in its
+ *              middle, so the brush is shifted by half a cell, and
+ *              scaled by (about) 1/zoom so that it repeats every
+ *              mCellSize scene units.
+ */
+
 void
 CanvasScene::drawBackground(QPainter * painter, const QRectF &rect)
 {
     if (snapToGrid)
     {
-        qreal left = int(rect.left()) - (int(rect.left()) % mCellSize.width());
-        qreal top = int(rect.top()) - (int(rect.top()) % mCellSize.height());
+        qreal scale = QStyleOptionGraphicsItem::levelOfDetailFromTransform(
+            painter->worldTransform());
+        QSize tileSize(qMax(1, qRound(mCellSize.width() * scale)),
+                       qMax(1, qRound(mCellSize.height() * scale)));
+
+        if (gridTile.size() != tileSize)
+        {
+            qDeb() << "CS::drawBackground() making a" << tileSize << "tile";
+            gridTile = QPixmap(tileSize);
+            gridTile.fill(Qt::transparent);
+            QPainter tilePainter(&gridTile);
+            QPen pen(Qt::black);
+            pen.setWidthF(qMax(qreal(1), scale));
+            tilePainter.setPen(pen);
+            tilePainter.drawPoint(QPointF(tileSize.width() / 2.,
+                                          tileSize.height() / 2.));
+        }
 
-        for (qreal x = left; x < rect.right(); x += mCellSize.width())
-            for (qreal y = top; y < rect.bottom(); y += mCellSize.height())
-                painter->drawPoint(QPointF(x, y));
+        QTransform tileTransform;
+        tileTransform.translate(-mCellSize.width() / 2.,
+                                -mCellSize.height() / 2.);
+        tileTransform.scale(qreal(mCellSize.width()) / tileSize.width(),
+                            qreal(mCellSize.height()) / tileSize.height());
+        QBrush brush(gridTile);
+        brush.setTransform(tileTransform);
+        painter->fillRect(rect, brush);
     }
     else
         QGraphicsScene::drawBackground(painter, rect);
@@ -264,6 +330,26 @@ CanvasScene::mousePressEvent(QGraphicsSceneMouseEvent * event)
 	    break;
 
 	  case CanvasView::del:
+	    // Deleting anything from a graph looks at the nodes' edge
+	    // lists, so first replace any compact edges by real Edges.
+	    for (int i = 0; i < itemList.count(); i++)
+	    {
+		QGraphicsItem * item = itemList.at(i);
+		if (item->type() == EdgeBundle::Type)
+		{
+		    EdgeBundle * bundle = qgraphicsitem_cast<EdgeBundle *>(item);
+		    int e = bundle->edgeAt(bundle->mapFromScene(event->scenePos()));
+		    itemList[i] = (e >= 0) ? bundle->promote(e) : nullptr;
+		}
+		if (itemList.at(i) != nullptr
+		    && (itemList.at(i)->type() == Node::Type
+			|| itemList.at(i)->type() == Edge::Type))
+		{
+		    Graph::expandEdgesOf(itemList.at(i));
+		    break;
+		}
+	    }
+
 	    foreach (QGraphicsItem * item, itemList)
 	    {
 		if (item != nullptr)
@@ -288,17 +374,19 @@ CanvasScene::mousePressEvent(QGraphicsSceneMouseEvent * event)
 
 			// Delete all edges incident to node to be deleted
 			QList<Node *> adjacentNodes;
+			QSet<Node *> adjacentSet;
 			foreach (Edge * edge, node->edgeList)
 			{
 			    if (edge != nullptr || edge != 0)
 			    {
-				if (!adjacentNodes.contains(edge->destNode())
-					&& edge->destNode() != node)
-				    adjacentNodes.append(edge->destNode());
-
-				else if (!adjacentNodes.contains(edge->sourceNode())
-					 && edge->sourceNode() != node)
-				    adjacentNodes.append(edge->sourceNode());
+				Node * other = edge->destNode();
+				if (other == node)
+				    other = edge->sourceNode();
+				if (other != node && !adjacentSet.contains(other))
+				{
+				    adjacentSet.insert(other);
+				    adjacentNodes.append(other);
+				}
 
 				edge->destNode()->removeEdge(edge);
 				edge->sourceNode()->removeEdge(edge);
@@ -381,6 +469,35 @@ CanvasScene::mousePressEvent(QGraphicsSceneMouseEvent * event)
 			qDeb() << "\tLeft button over a label";
 			item->setFocus();
 		    }
+		    else if (item->type() == EdgeBundle::Type
+			     && !labelFound && !nodeFound)
+		    {
+			// Compact edges have no label to edit, so make
+			// a real Edge for this one and edit its label.
+			EdgeBundle * bundle
+			    = qgraphicsitem_cast<EdgeBundle *>(item);
+			int e = bundle->edgeAt(
+			    bundle->mapFromScene(event->scenePos()));
+			if (e >= 0)
+			{
+			    labelFound = true;
+			    qDeb() << "\tLeft button over a compact edge";
+			    Edge * edge = bundle->promote(e);
+			    edge->editLabel(true);
+			    edge->htmlLabel->setFocus();
+			}
+		    }
+		    else if (item->type() == Edge::Type
+			     && !labelFound && !nodeFound)
+		    {
+			// The label (if any) wasn't hit, so make it
+			// now if need be, and edit it.
+			labelFound = true;
+			qDeb() << "\tLeft button over an edge";
+			Edge * edge = qgraphicsitem_cast<Edge *>(item);
+			edge->editLabel(true);
+			edge->htmlLabel->setFocus();
+		    }
 		    else if (item->type() == Node::Type && !nodeFound)
 		    {
 			nodeFound = true;
@@ -398,6 +515,18 @@ CanvasScene::mousePressEvent(QGraphicsSceneMouseEvent * event)
 		    }
 		}
 	    }
+	    // An unlabelled node gets a label to type into, as an
+	    // edge does; it can still be dragged.
+	    if (nodeFound && !labelFound)
+	    {
+		Node * node = qgraphicsitem_cast<Node *>(mDragged);
+		if (node->htmlLabel == nullptr)
+		{
+		    labelFound = true;
+		    node->editLabel(true);
+		    node->htmlLabel->setFocus();
+		}
+	    }
 	    if (!labelFound)
 		clearFocus();
 
@@ -414,6 +543,7 @@ CanvasScene::mousePressEvent(QGraphicsSceneMouseEvent * event)
 		{
 		    if (item->type() == Node::Type
 			|| item->type() == Edge::Type
+			|| item->type() == EdgeBundle::Type
 			|| item->type() == HTML_Label::Type)
 		    {
 			itemFound = true;
@@ -628,6 +758,14 @@ CanvasScene::keyReleaseEvent(QKeyEvent * event)
 	root1 = nullptr;
 	root2 = nullptr;
 
+	// Joining moves edges between nodes and graphs, which needs
+	// real Edges.
+	if (connectNode1a != nullptr && connectNode2a != nullptr)
+	{
+	    Graph::expandEdgesOf(connectNode1a);
+	    Graph::expandEdgesOf(connectNode2a);
+	}
+
 	if (connectNode1a != nullptr && connectNode2a != nullptr
 	    && connectNode1b != nullptr && connectNode2b != nullptr)
 	{
@@ -1028,11 +1166,16 @@ CanvasScene::setCanvasMode(int mode)
     }
     undoPositions.clear();
 
+    // Only items which already have a label need to know; the others
+    // get one if they are clicked on in edit mode (see
+    // mousePressEvent()).
     foreach (QGraphicsItem * item, items())
     {
         if (item->type() == Node::Type)
         {
             Node * node = qgraphicsitem_cast<Node *>(item);
+            if (node->htmlLabel == nullptr)
+                continue;
             if (modeType == CanvasView::edit)
                 node->editLabel(true);
             else
@@ -1041,6 +1184,8 @@ CanvasScene::setCanvasMode(int mode)
         else if (item->type() == Edge::Type)
         {
             Edge * edge = qgraphicsitem_cast<Edge *>(item);
+            if (edge->htmlLabel == nullptr)
+                continue;
             if (modeType == CanvasView::edit)
                 edge->editLabel(true);
             else
@@ -1076,107 +1221,84 @@ CanvasScene::getMode() const
  * Modifies:	Potentially the graph(s) on the canvas.
  * Returns:	Nothing.
  * Assumptions:	Atleast 2 nodes are in the list.
+ *		The deleted item has already been removed from the
+ *		edgeLists of the remaining nodes.
  * Bugs:	?
- * Notes:	None.
+ * Notes:	Each node in the list which has not already been reached
+ *		is the start of a breadth-first search of its component.
+ *		If that component does not contain all of the listed
+ *		nodes, its nodes and edges are given to a new graph.
+ *		The component which is found last stays in the old graph.
+ *		Every node and edge is looked at (at most) once, and the
+ *		visited sets are hashed, so the cost is O(V + E) over the
+ *		components searched.
  */
 
 void
 CanvasScene::searchAndSeparate(QList<Node *> Nodes)
 {
-    QList<Node *> graphNodes; // Checks if nodes in passed list are reachable
+    QSet<Node *> visited;	// Nodes reached by any search so far
+    QSet<Edge *> seenEdges;	// Edges reached by any search so far
     QList<QGraphicsItem *> graphItems; // Stores items for new graph
-    QList<int> skipList; // Used to skip indexes of reachable nodes
-    QPointF itemPos;
-    Node * node1;
-    Node * node2;
-    int i = 0;
-    int j = 1;
+    QList<Node *> queue;
+    int seedsFound = 0;		// How many of Nodes[] have been reached
     bool graphAdded = false;
 
-    while (i < Nodes.indexOf(Nodes.last()))
+    QSet<Node *> seeds;
+    foreach (Node * node, Nodes)
+	seeds.insert(node);
+
+    foreach (Node * start, Nodes)
     {
-        node1 = Nodes.at(i);
-        graphNodes.append(node1);
-        graphItems.append(node1);
+	if (visited.contains(start))
+	    continue;
+
+	// Find everything reachable from start.
+	visited.insert(start);
+	queue.clear();
+	queue.append(start);
+	graphItems.clear();
+	for (int head = 0; head < queue.count(); head++)
+	{
+	    Node * node = queue.at(head);
+	    graphItems.append(node);
+	    if (seeds.contains(node))
+		seedsFound++;
 
-        while (!graphNodes.isEmpty())
-        {
-            for (Node * node : graphNodes)
-            {
-                // Check if this node can reach any nodes in the passed list
-                while (j <= Nodes.indexOf(Nodes.last()))
-                {
-                    node2 = Nodes.at(j);
-                    if (node == node2)
-                        skipList.append(j);
-                    j += 1;
-                }
-                j = i + 1; // Reset j
-                node->checked = 1;
-                // Add neighbor nodes to graphNodes and neighbor nodes/edges
-                // to graphItems in case we need to make a new graph
-                foreach (Edge * edge, node->edgeList)
-                {
-                    if (!graphNodes.contains(edge->destNode())
-                        && edge->destNode()->checked == 0)
-                    {
-                        graphNodes.append(edge->destNode());
-                        if (!graphItems.contains(edge->destNode()))
-                            graphItems.append(edge->destNode());
-                    }
-                    else if (!graphNodes.contains(edge->sourceNode())
-                             && edge->sourceNode()->checked == 0)
-                    {
-                        graphNodes.append(edge->sourceNode());
-                        if (!graphItems.contains(edge->sourceNode()))
-                            graphItems.append(edge->sourceNode());
-                    }
-                    if (!graphItems.contains(edge))
-                        graphItems.append(edge);
+	    foreach (Edge * edge, node->edgeList)
+	    {
+		if (seenEdges.contains(edge))
+		    continue;
+		seenEdges.insert(edge);
+		graphItems.append(edge);
+
+		Node * other = edge->destNode();
+		if (other == node)
+		    other = edge->sourceNode();
+		if (!visited.contains(other))
+		{
+		    visited.insert(other);
+		    queue.append(other);
+		}
+	    }
+	}
 
-                    edge->checked = 1;
-                }
-                graphNodes.removeOne(node);
-            }
-        }
-        // Only make a new graph if atleast one node from the passed list
-        // is not reachable
-        if (skipList.count() != (Nodes.count() - i - 1))
-        {
-            graphAdded = true;
-            Graph * graph = new Graph;
-            addItem(graph);
-
-            foreach (QGraphicsItem * item, graphItems)
-            {
-                itemPos = item->scenePos(); // MUST BE scenePos(), NOT pos()
-                item->setParentItem(graph);
-                item->setPos(itemPos);
-                item->setRotation(0); // Reset rotation to 0
-            }
-        }
-        // Reset all the checked items.
-        foreach (QGraphicsItem * item, graphItems)
-        {
-            if (item->type() == Node::Type)
-            {
-                Node * node = qgraphicsitem_cast<Node *>(item);
-                node->checked = 0;
-            }
-            else if (item->type() == Edge::Type)
-            {
-                Edge * edge = qgraphicsitem_cast<Edge *>(item);
-                edge->checked = 0;
-            }
-        }
-        graphItems.clear();
-
-        // Skip any nodes reachable by a previous node
-        i += 1;
-        while (skipList.contains(i))
-            i += 1;
-        skipList.clear();
-        j = i + 1;
+	// If this component holds all the remaining listed nodes it
+	// is the last one, and it can stay where it is.
+	if (seedsFound == seeds.count())
+	    break;
+
+	graphAdded = true;
+	Graph * graph = new Graph;
+	addItem(graph);
+
+	foreach (QGraphicsItem * item, graphItems)
+	{
+	    QPointF itemPos = item->scenePos(); // MUST BE scenePos(), NOT pos()
+	    item->setParentItem(graph);
+	    item->setPos(itemPos);
+	    item->setRotation(0); // Reset rotation to 0
+	}
     }
     if (graphAdded)
         emit graphSeparated();
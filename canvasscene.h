@@ -3,7 +3,7 @@
  * File:	canvasscene.h
  * Author:	Rachel Bood
  * Date:	?
- * Version:	1.5
+ * Version:	1.6
  *
  * Purpose:
  *
@@ -23,6 +23,8 @@
  * July 31, 2020 (IC V1.5)
  *  (a) Added somethingChanged() signal to tell mainWindow that something has
  *      changed on the canvas and thus a new save prompt is necessary.
+ * Oct 18, 2026 (agent V1.6)
+ *  (a) Add gridTile, the cached image of one grid cell.
  */
 
 #ifndef CANVASSCENE_H
@@ -33,6 +35,7 @@
 #include "graph.h"
 
 #include <QGraphicsScene>
+#include <QPixmap>
 
 class CanvasScene : public QGraphicsScene
 {
@@ -73,6 +76,7 @@ private:
     bool snapToGrid;
     bool moved = false;
     const QSize mCellSize;		// The size of the cells in the grid.
+    QPixmap gridTile;			// One cell of the grid, on screen.
     QGraphicsItem * mDragged;		// The item being dragged.
     Node * connectNode1a, * connectNode1b; // The first Nodes to be joined.
     Node * connectNode2a, * connectNode2b; // The second Nodes to be joined.
@@ -2,7 +2,7 @@
  * File:    canvasview.cpp
  * Author:  Rachel Bood
  * Date:    2014/11/07
- * Version: 1.22
+ * Version: 1.24
  *
  * Purpose: Initializes a QGraphicsView that is used to house the
  *	    QGraphicsScene.
@@ -75,6 +75,14 @@
  *      from preview.cpp, using either a key press or mouse wheel scroll.
  * August 12 (IC V1.22)
  *  (a) Created macros to be used for zoom level min and max for clarity.
+ * Oct 18, 2026 (agent V1.23)
+ *  (a) In freestyle mode, expand the compact edges (if any) of the
+ *      graphs of both nodes before looking for an existing edge
+ *      between them, since addEdgeToScene() may merge the graphs.
+ * Oct 18, 2026 (agent V1.24)
+ *  (a) createNode() and createEdge() look the new item's style up in
+ *      nodeStyles / edgeStyles, so freestyle items with the same
+ *      parameters share one style entry.
  */
 
 #include "canvasview.h"
@@ -183,6 +191,7 @@ CanvasView::createNode(QPointF pos)
     node->setRotation(0);
     node->setFillColour(nodeParams->fillColour);
     node->setLineColour(nodeParams->outlineColour);
+    node->setStyle(nodeStyles.intern(node->style()));
     node->setPos(pos.rx(), pos.ry());
     node->setParentItem(freestyleGraph);
     return node;
@@ -454,6 +463,9 @@ CanvasView::mousePressEvent(QMouseEvent * event) // Should this be in CS?
 		// If the user selected two nodes make an edge.
 		if (node1 != nullptr && node2 != nullptr && node1 != node2)
 		{
+		    Graph::expandEdgesOf(node1);
+		    Graph::expandEdgesOf(node2);
+
 		    // Prevent edges being made if one already exists between source and dest
 		    int exists = 0;
 		    for (int i = 0; i < node1->edgeList.count(); i++)
@@ -614,6 +626,7 @@ CanvasView::createEdge(Node * source, Node * destination)
     edge->setColour(edgeParams->color);
     edge->setEdgeLabelSize((edgeParams->LabelSize > 0)
 			     ? edgeParams->LabelSize : 1);
+    edge->setStyle(edgeStyles.intern(edge->style()));
     edge->setEdgeLabel(edgeParams->label);
     edge->setDestRadius(node2->getDiameter() / 2.);
     edge->setSourceRadius(node1->getDiameter() / 2.);
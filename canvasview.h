@@ -2,7 +2,7 @@
  * File:    canvasview.h
  * Author:  Rachel Bood
  * Date:    2014/11/07 (?)
- * Version: 1.6
+ * Version: 1.7
  *
  * Purpose: Define the CanvasView class.
  *
@@ -25,6 +25,9 @@
  *  (a) Added scaleView, wheelEvent, zoomIn, and zoomOut as well as updated
  *      keyPressEvent to allow for zooming on the canvas, similar to the zoom
  *      from preview.cpp, using either a key press or mouse wheel scroll.
+ * Oct 18, 2026 (agent V1.7)
+ *  (a) Added nodeStyles and edgeStyles, so that the nodes and edges
+ *	drawn in freestyle mode with the same parameters share styles.
  */
 
 
@@ -33,6 +36,7 @@
 
 #include "canvasscene.h"
 #include "graph.h"
+#include "styletable.h"
 
 #include <QGraphicsView>
 #include <QGraphicsSceneMouseEvent>
@@ -116,6 +120,8 @@ class CanvasView: public QGraphicsView
 	Node_Params * nodeParams;
 	Edge_Params * edgeParams;
 	Node * node1, * node2;
+	StyleTable<NodeStyle> nodeStyles;	// Of created nodes.
+	StyleTable<EdgeStyle> edgeStyles;	// Of created edges.
 };
 
 #endif // CANVASVIEW_H
@@ -0,0 +1,364 @@
+/*
+ * File:	compressedfile.cpp
+ * Author:	agent
+ * Date:	2026-10-18
+ * Version:	1.0
+ *
+ * Purpose:	Read graph-ic files which may have been compressed with
+ *		gzip, without first inflating the whole file.
+ *
+ *		A .grphc file repeats the same colours, radii and
+ *		rotations on line after line, so big ones compress
+ *		very well, which matters most for a library on a
+ *		network file system.  A CompressedFile is used in place
+ *		of a QFile by everything that reads .grphc files: if
+ *		the file starts with the gzip magic number it is
+ *		inflated (with zlib) a buffer at a time as the
+ *		QTextStream on top of it asks for more, otherwise the
+ *		bytes are passed through as they are.  So the parser
+ *		never sees the difference, and never has the whole
+ *		inflated file in memory.
+ *
+ *		Library files may be called foo.grphc.gz (or just
+ *		foo.grphc, since only the contents are looked at).
+ *
+ * Modification history:
+ * Oct 18, 2026 (agent V1.0)
+ *  (a) Initial version.
+ */
+
+#include "compressedfile.h"
+#include "defuns.h"
+
+#include <QFileInfo>
+
+#include <zlib.h>
+
+// The size of the reads from the compressed file.
+#define INPUT_BUFFER_SIZE	(64 * 1024)
+
+// zlib's windowBits for "gzip only, with the largest window".
+#define GZIP_WINDOW_BITS	(MAX_WBITS + 16)
+
+
+
+/*
+ * Name:	isGraphicFile()
+ * Purpose:	Say whether a file name is that of a graph-ic file.
+ * Arguments:	The file name.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	True for foo.grphc and foo.grphc.gz.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	None.
+ */
+
+bool
+isGraphicFile(QString fileName)
+{
+    return fileName.endsWith("." GRAPHiCS_FILE_EXTENSION)
+	|| fileName.endsWith("." GRAPHiCS_FILE_EXTENSION
+			     "." GZIP_FILE_EXTENSION);
+}
+
+
+
+/*
+ * Name:	CompressedFile()
+ * Purpose:	Constructor.
+ * Arguments:	The file name and the parent object.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	The file is not opened until open() is called.
+ */
+
+CompressedFile::CompressedFile(QString fileName, QObject * parent)
+    : QIODevice(parent), file(fileName)
+{
+    compressed = false;
+    finished = false;
+    error = false;
+    stream = nullptr;
+}
+
+
+
+CompressedFile::~CompressedFile()
+{
+    close();
+}
+
+
+
+/*
+ * Name:	open()
+ * Purpose:	Open the file and find out whether it is compressed.
+ * Arguments:	The open mode, which must be ReadOnly (possibly with
+ *		Text).
+ * Outputs:	Nothing.
+ * Modifies:	The device state.
+ * Returns:	True on success; otherwise errorString() says why.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	The device is opened Unbuffered, since QTextStream
+ *		does its own buffering; that also keeps pos() close to
+ *		what the parser has actually read.
+ */
+
+bool
+CompressedFile::open(OpenMode mode)
+{
+    if ((mode & ReadWrite) != ReadOnly)
+    {
+	setErrorString("compressed files can only be read");
+	return false;
+    }
+    if (!file.open(ReadOnly))
+    {
+	setErrorString(file.errorString());
+	return false;
+    }
+
+    char magic[2];
+    compressed = file.peek(magic, 2) == 2
+	&& (uchar)magic[0] == 0x1f && (uchar)magic[1] == 0x8b;
+    finished = false;
+    error = false;
+
+    if (compressed)
+    {
+	stream = new z_stream;
+	stream->zalloc = Z_NULL;
+	stream->zfree = Z_NULL;
+	stream->opaque = Z_NULL;
+	stream->next_in = Z_NULL;
+	stream->avail_in = 0;
+	if (inflateInit2(stream, GZIP_WINDOW_BITS) != Z_OK)
+	{
+	    setErrorString("unable to initialize zlib");
+	    delete stream;
+	    stream = nullptr;
+	    file.close();
+	    return false;
+	}
+	input.resize(INPUT_BUFFER_SIZE);
+    }
+
+    // The Text flag is honoured by the QTextStream, not here.
+    return QIODevice::open(ReadOnly | Unbuffered);
+}
+
+
+
+void
+CompressedFile::close()
+{
+    if (stream != nullptr)
+    {
+	inflateEnd(stream);
+	delete stream;
+	stream = nullptr;
+    }
+    input.clear();
+    file.close();
+    QIODevice::close();
+}
+
+
+
+bool
+CompressedFile::isSequential() const
+{
+    return true;
+}
+
+
+
+/*
+ * Name:	atEnd()
+ * Purpose:	Say whether there is no more to read.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	True at the end of the (inflated) data, or after an
+ *		error.
+ * Assumptions:	None.
+ * Bugs:	At the very end of a compressed file, this may say
+ *		false once more even though the next read gets
+ *		nothing (the last read may not have reached the gzip
+ *		trailer).  QTextStream copes with that.
+ * Notes:	The QIODevice version of this looks at bytesAvailable(),
+ *		which is always 0 for an Unbuffered sequential device.
+ */
+
+bool
+CompressedFile::atEnd() const
+{
+    if (!isOpen() || error)
+	return true;
+
+    return compressed ? finished : file.atEnd();
+}
+
+
+
+/*
+ * Name:	size(), pos()
+ * Purpose:	Return the size of, and position in, the file.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The size (position) of the file on disk, which for a
+ *		compressed file is not the size (position) of the
+ *		inflated data.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	These are only good for working out how much of the
+ *		file has been read, which is what parseGraphIc() uses
+ *		them for.
+ */
+
+qint64
+CompressedFile::size() const
+{
+    return file.size();
+}
+
+
+
+qint64
+CompressedFile::pos() const
+{
+    return file.pos();
+}
+
+
+
+bool
+CompressedFile::isCompressed() const
+{
+    return compressed;
+}
+
+
+
+/*
+ * Name:	failed()
+ * Purpose:	Say whether reading stopped because of bad data.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	True if the compressed data was corrupt or truncated,
+ *		or the file could not be read.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	QTextStream treats a failed read as the end of the
+ *		data, so readers must check this to tell a truncated
+ *		file from a short one.
+ */
+
+bool
+CompressedFile::failed() const
+{
+    return error;
+}
+
+
+
+/*
+ * Name:	readData()
+ * Purpose:	Read (and if need be inflate) some more of the file.
+ * Arguments:	Where to put the data, and how much room there is.
+ * Outputs:	Nothing.
+ * Modifies:	The stream state.
+ * Returns:	The number of bytes read (0 at the end), or -1 on
+ *		error.
+ * Assumptions:	The device is open.
+ * Bugs:	None.
+ * Notes:	A gzip file may consist of several gzip members one
+ *		after the other (e.g., from "cat a.gz b.gz"); these are
+ *		read as one, as gunzip does.
+ */
+
+qint64
+CompressedFile::readData(char * data, qint64 maxSize)
+{
+    if (!compressed)
+    {
+	qint64 n = file.read(data, maxSize);
+	if (n < 0)
+	{
+	    error = true;
+	    setErrorString(file.errorString());
+	}
+	return n;
+    }
+
+    if (error)
+	return -1;
+    if (finished)
+	return 0;
+
+    // avail_out is only a uInt.
+    uInt room = (uInt)qMin(maxSize, (qint64)INPUT_BUFFER_SIZE * 16);
+    stream->next_out = (Bytef *)data;
+    stream->avail_out = room;
+
+    while (stream->avail_out > 0)
+    {
+	if (stream->avail_in == 0)
+	{
+	    qint64 n = file.read(input.data(), input.size());
+	    if (n <= 0)
+	    {
+		// The data ended before the gzip trailer, or the
+		// file could not be read.
+		error = true;
+		setErrorString(n < 0 ? file.errorString()
+			       : QString("the compressed data is truncated"));
+		break;
+	    }
+	    stream->next_in = (Bytef *)input.data();
+	    stream->avail_in = (uInt)n;
+	}
+
+	int ret = inflate(stream, Z_NO_FLUSH);
+	if (ret == Z_STREAM_END)
+	{
+	    if (stream->avail_in == 0 && file.atEnd())
+	    {
+		finished = true;
+		break;
+	    }
+	    // Another member follows.
+	    inflateReset(stream);
+	}
+	else if (ret != Z_OK && ret != Z_BUF_ERROR)
+	{
+	    error = true;
+	    setErrorString(stream->msg != nullptr ? QString(stream->msg)
+			   : QString("the compressed data is corrupt"));
+	    break;
+	}
+    }
+
+    qint64 produced = room - stream->avail_out;
+    if (error && produced == 0)
+	return -1;
+    return produced;
+}
+
+
+
+qint64
+CompressedFile::writeData(const char * data, qint64 maxSize)
+{
+    Q_UNUSED(data);
+    Q_UNUSED(maxSize);
+
+    return -1;
+}
@@ -0,0 +1,61 @@
+/*
+ * File:	compressedfile.h
+ * Author:	agent
+ * Date:	2026-10-18
+ * Version:	1.0
+ *
+ * Purpose:	Declare CompressedFile, a read-only QIODevice which
+ *		inflates a gzip-compressed file as it is read.
+ *
+ * Modification history:
+ * Oct 18, 2026 (agent V1.0)
+ *  (a) Initial version.
+ */
+
+#ifndef COMPRESSEDFILE_H
+#define COMPRESSEDFILE_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QIODevice>
+#include <QString>
+
+#define GZIP_FILE_EXTENSION	"gz"
+
+// So that zlib.h is only needed by compressedfile.cpp.
+struct z_stream_s;
+
+bool isGraphicFile(QString fileName);
+
+class CompressedFile : public QIODevice
+{
+    Q_OBJECT
+
+  public:
+    explicit CompressedFile(QString fileName, QObject * parent = 0);
+    ~CompressedFile();
+
+    bool open(OpenMode mode);
+    void close();
+    bool isSequential() const;
+    bool atEnd() const;
+    qint64 size() const;
+    qint64 pos() const;
+
+    bool isCompressed() const;
+    bool failed() const;
+
+  protected:
+    qint64 readData(char * data, qint64 maxSize);
+    qint64 writeData(const char * data, qint64 maxSize);
+
+  private:
+    QFile		file;
+    bool		compressed;
+    bool		finished;	// Saw the end of the data.
+    bool		error;		// Corrupt or truncated data.
+    struct z_stream_s *	stream;
+    QByteArray		input;		// Compressed bytes from file.
+};
+
+#endif // COMPRESSEDFILE_H
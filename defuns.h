@@ -2,7 +2,7 @@
  * File:	defuns.h
  * Author:	Jim Diamond
  * Date:	2019-12-10
- * Version:	1.7
+ * Version:	1.12
  *
  * Purpose:	Hold definitions that are needed by multiple classes
  *		and yet don't seem to meaningfully fit anywhere else.
@@ -36,6 +36,21 @@
  * Aug 18, 2020 (JD V1.7)
  *  (a) Add '#include <QDebug>' when DEBUG is defined, otherwise in some
  *      cases the compiler whines bitterly and pukes on your shoes.
+ * Oct 18, 2026 (agent V1.8)
+ *  (a) Moved GRAPHiCS_FILE_EXTENSION here from mainwindow.cpp, since
+ *      the batch renderer needs it too.
+ * Oct 18, 2026 (agent V1.9)
+ *  (a) Add GRAPHiCS_BIN_EXTENSION, the extension of the binary
+ *      companion of a .grphc file.
+ * Oct 18, 2026 (agent V1.10)
+ *  (a) Add the LOD_* sizes, below which items on the screen are
+ *      drawn more simply.
+ * Oct 18, 2026 (agent V1.11)
+ *  (a) Add EXPORTING_PROPERTY and isExporting(), which the items use
+ *      to tell an export from a view.
+ * Oct 18, 2026 (agent V1.12)
+ *  (a) EXPORTING_PROPERTY is set through Graph::setExporting(), which
+ *      also turns the graphs' caches off.
  */
 
 #ifndef DEFUNS_H
@@ -57,6 +72,32 @@
     #define qDebu(...) 
 #endif
 
+#define GRAPHiCS_FILE_EXTENSION "grphc"
+#define GRAPHiCS_BIN_EXTENSION	"grphb"
+
+// When the view is zoomed out so far that (in device pixels) a label
+// is shorter than LOD_MIN_LABEL_PIXELS, it is not drawn; a node smaller
+// than LOD_MIN_NODE_PIXELS is drawn as a square of its outline colour;
+// and a line thinner than LOD_MIN_LINE_PIXELS is not antialiased.
+// (See QStyleOptionGraphicsItem::levelOfDetailFromTransform().)  This
+// only applies to views: exported images are always drawn in full.
+#define LOD_MIN_LABEL_PIXELS	4
+#define LOD_MIN_NODE_PIXELS	3
+#define LOD_MIN_LINE_PIXELS	1
+
+// Code which renders a scene to a file (or to anything else which is
+// not a view) sets this (boolean) property of the scene while doing so,
+// with Graph::setExporting() (which also turns the graphs' caches off).
+// The items can't use the widget argument of paint() to tell, since a
+// view paints items with a cache (e.g., graphs) with no widget too.
+#define EXPORTING_PROPERTY	"exporting"
+
+static inline bool
+isExporting(const QObject * scene)
+{
+    return scene != nullptr && scene->property(EXPORTING_PROPERTY).toBool();
+}
+
 #define BUTTON_STYLE "border-style: outset; border-width: 2px; " \
 	     "border-radius: 5px; border-color: beige; padding: 3px;"
 
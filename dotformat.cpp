@@ -0,0 +1,1073 @@
+/*
+ * File:	dotformat.cpp
+ * Author:	agent
+ * Date:	2026-10-18
+ * Version:	1.3
+ *
+ * Purpose:	Read and write the Graphviz DOT language.
+ *
+ *		The reader is a small tokenizer, which reads the file a
+ *		chunk at a time, under a recursive-descent parser for
+ *		the DOT grammar (strict/graph/digraph, node, edge and
+ *		graph attribute statements, subgraphs, edge chains and
+ *		subgraphs as edge operands).  Each node and edge is
+ *		turned into a Node_Description or Edge_Description as
+ *		soon as its statement is parsed.
+ *
+ *		Attributes are mapped onto the fields saveGraphIc()
+ *		writes:
+ *		    pos (points, y up; a trailing '!' is ignored)
+ *							-> position
+ *		    width, height (inches)		-> diameter
+ *		    penwidth				-> pen width
+ *		    color				-> outline (node),
+ *							   colour (edge)
+ *		    fillcolor, or color if style has "filled"
+ *							-> fill colour
+ *		    label ("\N" is the node name)	-> label
+ *		    fontsize				-> label size
+ *		    orientation				-> rotation
+ *		As in Graphviz, a node with no label is labelled with
+ *		its name.  All other attributes (and ports) are ignored,
+ *		and directed graphs are read as undirected.  If no node
+ *		has a pos the nodes are placed by completeDescription().
+ *
+ *		DOT has nothing corresponding to edge rotation or the
+ *		edge end radii, so saveDot() doesn't write them and
+ *		the reader works the radii out from the nodes.
+ *
+ * Modification history:
+ * Oct 18, 2026 (agent V1.0)
+ *  (a) Initial version.
+ * Oct 18, 2026 (agent V1.1)
+ *  (a) saveDot() gets the edges from describeEdges(), so compact
+ *	edges are written without expanding them first.
+ * Oct 18, 2026 (agent V1.2)
+ *  (a) Labels are unescaped as Graphviz escStrings, so "\\" is
+ *	read back as the '\' which quoted() doubled.  The tokenizer
+ *	keeps "\\" together, so that a string ending in a backslash
+ *	doesn't swallow its closing quote.
+ * Oct 18, 2026 (agent V1.3)
+ *  (a) Add a saveDot() which writes a Graph_Description, so that
+ *	"Export all" needs no items; the old one describes the nodes
+ *	and calls it.
+ */
+
+#include "dotformat.h"
+#include "defuns.h"
+#include "edge.h"
+#include "graph.h"
+#include "node.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QTextStream>
+
+// How many characters the tokenizer reads at a time.
+#define DOT_CHUNK	    4096
+
+// Points per inch, the unit of pos.
+#define DOT_POINTS_PER_INCH 72.
+
+// Digits after the decimal point of the node positions.
+#define DOT_POS_PREC	    2
+
+
+
+/*
+ * A DotTokenizer splits DOT text into tokens, holding no more than a
+ * chunk of the text (plus the token being read) at a time.
+ */
+
+class DotTokenizer
+{
+  public:
+    enum Kind { End, Id, Quoted, Punct, EdgeOp, Bad };
+
+    DotTokenizer(QTextStream &in) : in(in), pos(0), lineNumber(1),
+				    lineStart(true) {}
+    Kind next(QString &text);
+    int line() { return lineNumber; }
+
+  private:
+    QChar peek(int ahead = 0);
+    QChar get();
+    void skipSpace();
+    static bool isIdChar(QChar c)
+    {
+	return c.isLetterOrNumber() || c == '_' || c.unicode() >= 0x80;
+    }
+
+    QTextStream &in;
+    QString buffer;
+    int pos;
+    int lineNumber;
+    bool lineStart;
+};
+
+
+
+/*
+ * Name:	peek(), get()
+ * Purpose:	Look at (consume) the next character of the text.
+ * Arguments:	For peek(), how far ahead to look.
+ * Outputs:	Nothing.
+ * Modifies:	The buffer, and for get() the position and line number.
+ * Returns:	The character, or a null QChar at the end of the text.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	None.
+ */
+
+QChar
+DotTokenizer::peek(int ahead)
+{
+    if (pos + ahead >= buffer.length())
+    {
+	buffer = buffer.mid(pos) + in.read(DOT_CHUNK);
+	pos = 0;
+	if (ahead >= buffer.length())
+	    return QChar();
+    }
+    return buffer.at(pos + ahead);
+}
+
+
+
+QChar
+DotTokenizer::get()
+{
+    QChar c = peek();
+
+    if (!c.isNull())
+    {
+	pos++;
+	lineStart = c == '\n';
+	if (lineStart)
+	    lineNumber++;
+    }
+    return c;
+}
+
+
+
+/*
+ * Name:	skipSpace()
+ * Purpose:	Skip white space and comments.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	The tokenizer state.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	Lines starting with '#' are C preprocessor output and
+ *		are treated as comments, as Graphviz does.
+ */
+
+void
+DotTokenizer::skipSpace()
+{
+    for (;;)
+    {
+	QChar c = peek();
+	if (c.isSpace())
+	    get();
+	else if (c == '#' && lineStart)
+	{
+	    while (!peek().isNull() && peek() != '\n')
+		get();
+	}
+	else if (c == '/' && peek(1) == '/')
+	{
+	    while (!peek().isNull() && peek() != '\n')
+		get();
+	}
+	else if (c == '/' && peek(1) == '*')
+	{
+	    get();
+	    get();
+	    while (!peek().isNull() && !(peek() == '*' && peek(1) == '/'))
+		get();
+	    get();
+	    get();
+	}
+	else
+	    return;
+    }
+}
+
+
+
+/*
+ * Name:	next()
+ * Purpose:	Read the next token.
+ * Arguments:	A string to hold the text of the token.
+ * Outputs:	Nothing.
+ * Modifies:	text, and the tokenizer state.
+ * Returns:	The kind of the token.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	For quoted strings, text has the quotes removed, "\""
+ *		replaced by '"', escaped newlines removed and
+ *		concatenations ("a" + "b") done; other escapes (e.g.,
+ *		"\N" and "\\") are left for the caller (see
+ *		unescaped()), as Graphviz does, but "\\" is taken as
+ *		a pair, so that the '\' of "\\\"" is not an escape.
+ *		For HTML strings text is what is between the outer '<'
+ *		and '>'.
+ */
+
+DotTokenizer::Kind
+DotTokenizer::next(QString &text)
+{
+    skipSpace();
+    text.clear();
+
+    QChar c = peek();
+    if (c.isNull())
+	return End;
+
+    if (c == '"')
+    {
+	for (;;)
+	{
+	    get();
+	    while ((c = get()) != '"')
+	    {
+		if (c.isNull())
+		    return Bad;
+		if (c == '\\' && (peek() == '"' || peek() == '\n'))
+		{
+		    c = get();
+		    if (c == '\n')
+			continue;
+		}
+		else if (c == '\\' && peek() == '\\')
+		{
+		    text += c;
+		    c = get();
+		}
+		text += c;
+	    }
+	    skipSpace();
+	    if (peek() != '+')
+		return Quoted;
+	    get();
+	    skipSpace();
+	    if (peek() != '"')
+		return Bad;
+	}
+    }
+
+    if (c == '<')
+    {
+	int depth = 0;
+	get();
+	while ((c = get()) != '>' || depth > 0)
+	{
+	    if (c.isNull())
+		return Bad;
+	    if (c == '<')
+		depth++;
+	    else if (c == '>')
+		depth--;
+	    text += c;
+	}
+	return Quoted;
+    }
+
+    if (c == '-' && (peek(1) == '-' || peek(1) == '>'))
+    {
+	text += get();
+	text += get();
+	return EdgeOp;
+    }
+
+    if (c == '-' || c == '.' || c.isDigit())
+    {
+	// A numeral.
+	if (c == '-')
+	    text += get();
+	while (peek().isDigit())
+	    text += get();
+	if (peek() == '.')
+	{
+	    text += get();
+	    while (peek().isDigit())
+		text += get();
+	}
+	return text == "-" || text == "." || text == "-." ? Bad : Id;
+    }
+
+    if (isIdChar(c))
+    {
+	while (isIdChar(peek()))
+	    text += get();
+	return Id;
+    }
+
+    text += get();
+    return QString("{}[]=;,:").contains(c) ? Punct : Bad;
+}
+
+
+
+typedef QHash<QString, QString> Dot_Attributes;
+
+typedef struct dotScope
+{
+    Dot_Attributes  nodeDefaults;
+    Dot_Attributes  edgeDefaults;
+} Dot_Scope;
+
+typedef struct dotParser
+{
+    DotTokenizer *	tokens;
+    DotTokenizer::Kind	kind;		// The current token...
+    QString		text;		// ... and its text.
+    QString		graphName;
+    Graph_Description * description;
+    QHash<QString, int>	nodeIndex;
+    bool		positioned;
+    QString		errorMessage;
+} Dot_Parser;
+
+
+
+static void
+advance(Dot_Parser &p)
+{
+    p.kind = p.tokens->next(p.text);
+}
+
+
+
+static bool
+isPunct(Dot_Parser &p, QString punct)
+{
+    return p.kind == DotTokenizer::Punct && p.text == punct;
+}
+
+
+
+static bool
+isKeyword(Dot_Parser &p, QString keyword)
+{
+    return p.kind == DotTokenizer::Id && p.text.toLower() == keyword;
+}
+
+
+
+static bool
+isId(Dot_Parser &p)
+{
+    return p.kind == DotTokenizer::Id || p.kind == DotTokenizer::Quoted;
+}
+
+
+
+/*
+ * Name:	syntaxError()
+ * Purpose:	Record an error at the current token.
+ * Arguments:	The parser state and what was expected.
+ * Outputs:	Nothing.
+ * Modifies:	p.errorMessage.
+ * Returns:	false, so that callers can "return syntaxError(...)".
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	Only the first error is kept.
+ */
+
+static bool
+syntaxError(Dot_Parser &p, QString expected)
+{
+    if (p.errorMessage.isEmpty())
+	p.errorMessage = "Line " + QString::number(p.tokens->line())
+	    + " of file " + p.graphName + ": expected " + expected
+	    + (p.kind == DotTokenizer::End ? " but found the end of the file"
+	       : " but found '" + p.text + "'")
+	    + ".  Thus I can not read this file.";
+    return false;
+}
+
+
+
+/*
+ * Name:	unescaped()
+ * Purpose:	Interpret the escapes of a Graphviz escString (e.g.,
+ *		a label).
+ * Arguments:	The string (as given by the tokenizer) and the name of
+ *		the node it belongs to (or a null string).
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The text.
+ * Assumptions:	None.
+ * Bugs:	"\G", "\E", "\T", "\H" and the line break escapes
+ *		("\n", "\l" and "\r") are left as they are.
+ * Notes:	"\\" is a backslash and (for nodes) "\N" is the node
+ *		name.  The string is scanned once, so the "\N" of
+ *		"\\N" is not the node name.
+ */
+
+static QString
+unescaped(QString value, QString name)
+{
+    QString text;
+
+    text.reserve(value.length());
+    for (int i = 0; i < value.length(); i++)
+    {
+	QChar c = value.at(i);
+	if (c == '\\' && i + 1 < value.length())
+	{
+	    QChar next = value.at(i + 1);
+	    if (next == '\\')
+	    {
+		text += next;
+		i++;
+		continue;
+	    }
+	    if (next == 'N' && !name.isNull())
+	    {
+		text += name;
+		i++;
+		continue;
+	    }
+	}
+	text += c;
+    }
+
+    return text;
+}
+
+
+
+/*
+ * Name:	applyNodeAttributes(), applyEdgeAttributes()
+ * Purpose:	Store the attributes of a DOT node (edge) in a node
+ *		(edge) description.
+ * Arguments:	The description, the attributes, and for nodes the node
+ *		name and a flag to set if a position is given.
+ * Outputs:	Nothing.
+ * Modifies:	The description, and maybe positioned.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	Unknown attributes and bad values are ignored.
+ */
+
+static void
+applyNodeAttributes(Node_Description &node, const Dot_Attributes &attrs,
+		    QString name, bool &positioned)
+{
+    Dot_Attributes::const_iterator i;
+
+    for (i = attrs.constBegin(); i != attrs.constEnd(); ++i)
+    {
+	QString key = i.key();
+	QString value = i.value();
+	bool ok;
+	qreal v = value.toDouble(&ok);
+
+	if (key == "pos")
+	{
+	    QStringList xy = value.remove('!').split(',');
+	    bool okX, okY;
+	    if (xy.count() >= 2)
+	    {
+		qreal x = xy.at(0).toDouble(&okX);
+		qreal y = xy.at(1).toDouble(&okY);
+		if (okX && okY)
+		{
+		    node.x = x / DOT_POINTS_PER_INCH;
+		    node.y = -y / DOT_POINTS_PER_INCH;
+		    positioned = true;
+		}
+	    }
+	}
+	else if (key == "width" || key == "height")
+	{
+	    if (ok && v > 0)
+		node.diameter = v;
+	}
+	else if (key == "penwidth")
+	{
+	    if (ok && v >= 0)
+		node.penWidth = v;
+	}
+	else if (key == "orientation")
+	{
+	    if (ok)
+		node.rotation = v;
+	}
+	else if (key == "color" || key == "fillcolor")
+	{
+	    QColor c = colourFromString(value);
+	    if (!c.isValid())
+		continue;
+	    if (key == "fillcolor")
+		node.fillColour = c;
+	    else
+	    {
+		node.lineColour = c;
+		if (attrs.value("style").contains("filled")
+		    && !attrs.contains("fillcolor"))
+		    node.fillColour = c;
+	    }
+	}
+	else if (key == "label")
+	    node.label = unescaped(value, name);
+	else if (key == "fontsize")
+	{
+	    if (ok && v > 0)
+		node.labelSize = v;
+	}
+    }
+}
+
+
+
+static void
+applyEdgeAttributes(Edge_Description &edge, const Dot_Attributes &attrs)
+{
+    Dot_Attributes::const_iterator i;
+
+    for (i = attrs.constBegin(); i != attrs.constEnd(); ++i)
+    {
+	QString key = i.key();
+	QString value = i.value();
+	bool ok;
+	qreal v = value.toDouble(&ok);
+
+	if (key == "penwidth")
+	{
+	    if (ok && v >= 0)
+		edge.penWidth = v;
+	}
+	else if (key == "color")
+	{
+	    QColor c = colourFromString(value);
+	    if (c.isValid())
+		edge.colour = c;
+	}
+	else if (key == "label")
+	    edge.label = unescaped(value, QString());
+	else if (key == "fontsize")
+	{
+	    if (ok && v > 0)
+		edge.labelSize = v;
+	}
+    }
+}
+
+
+
+/*
+ * Name:	nodeFor()
+ * Purpose:	Find a node by name, making it if this is its first
+ *		appearance.
+ * Arguments:	The parser state, the node name and the current scope.
+ * Outputs:	Nothing.
+ * Modifies:	The description and the node index.
+ * Returns:	The index of the node.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	As in Graphviz, a node gets the node defaults in force
+ *		where it first appears.
+ */
+
+static int
+nodeFor(Dot_Parser &p, QString name, const Dot_Scope &scope)
+{
+    int index = p.nodeIndex.value(name, -1);
+
+    if (index < 0)
+    {
+	Node_Description node;
+	initNodeDescription(node);
+	node.label = name;
+	applyNodeAttributes(node, scope.nodeDefaults, name, p.positioned);
+	index = p.description->nodes.count();
+	p.nodeIndex.insert(name, index);
+	p.description->nodes.append(node);
+    }
+    return index;
+}
+
+
+
+/*
+ * Name:	parseAttributes()
+ * Purpose:	Parse zero or more attribute lists ("[a=b, c=d] [e=f]").
+ * Arguments:	The parser state and the attributes to add to.
+ * Outputs:	Nothing.
+ * Modifies:	The parser state and attrs.
+ * Returns:	False iff there was a syntax error.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	The attribute names are made lower case.
+ */
+
+static bool
+parseAttributes(Dot_Parser &p, Dot_Attributes &attrs)
+{
+    while (isPunct(p, "["))
+    {
+	advance(p);
+	while (!isPunct(p, "]"))
+	{
+	    if (!isId(p))
+		return syntaxError(p, "an attribute name");
+	    QString key = p.text.toLower();
+	    advance(p);
+	    QString value = "true";
+	    if (isPunct(p, "="))
+	    {
+		advance(p);
+		if (!isId(p))
+		    return syntaxError(p, "an attribute value");
+		value = p.text;
+		advance(p);
+	    }
+	    attrs.insert(key, value);
+	    if (isPunct(p, ",") || isPunct(p, ";"))
+		advance(p);
+	}
+	advance(p);
+    }
+    return true;
+}
+
+
+
+/*
+ * Name:	skipPort()
+ * Purpose:	Skip the port (if any) after a node name.
+ * Arguments:	The parser state.
+ * Outputs:	Nothing.
+ * Modifies:	The parser state.
+ * Returns:	False iff there was a syntax error.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	Graphic has no ports, so they are ignored.
+ */
+
+static bool
+skipPort(Dot_Parser &p)
+{
+    for (int i = 0; i < 2 && isPunct(p, ":"); i++)
+    {
+	advance(p);
+	if (!isId(p))
+	    return syntaxError(p, "a port name");
+	advance(p);
+    }
+    return true;
+}
+
+
+
+static bool parseStatements(Dot_Parser &p, Dot_Scope scope,
+			    QVector<int> &members);
+
+/*
+ * Name:	parseOperand()
+ * Purpose:	Parse a node id (with optional port) or a subgraph.
+ * Arguments:	The parser state, the current scope and a vector for
+ *		the nodes named.
+ * Outputs:	Nothing.
+ * Modifies:	The parser state, the description and nodes.
+ * Returns:	False iff there was a syntax error.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	nodes gets the one node for a node id, or all of the
+ *		nodes in a subgraph.
+ */
+
+static bool
+parseOperand(Dot_Parser &p, const Dot_Scope &scope, QVector<int> &nodes)
+{
+    if (isKeyword(p, "subgraph") || isPunct(p, "{"))
+    {
+	if (isKeyword(p, "subgraph"))
+	{
+	    advance(p);
+	    if (isId(p))
+		advance(p);
+	}
+	if (!isPunct(p, "{"))
+	    return syntaxError(p, "'{'");
+	advance(p);
+	if (!parseStatements(p, scope, nodes))
+	    return false;
+	advance(p);			// The '}'.
+	return true;
+    }
+
+    if (!isId(p))
+	return syntaxError(p, "a node name");
+    nodes.append(nodeFor(p, p.text, scope));
+    advance(p);
+    return skipPort(p);
+}
+
+
+
+/*
+ * Name:	parseStatements()
+ * Purpose:	Parse a statement list, up to (but not past) a '}'.
+ * Arguments:	The parser state, the enclosing scope (a copy, so that
+ *		defaults set here don't leak out) and a vector for the
+ *		nodes named in these statements.
+ * Outputs:	Nothing.
+ * Modifies:	The parser state, the description and members.
+ * Returns:	False iff there was a syntax error.
+ * Assumptions:	None.
+ * Bugs:	Graph attribute statements are parsed and ignored.
+ * Notes:	None.
+ */
+
+static bool
+parseStatements(Dot_Parser &p, Dot_Scope scope, QVector<int> &members)
+{
+    while (!isPunct(p, "}"))
+    {
+	if (p.kind == DotTokenizer::End)
+	    return syntaxError(p, "'}'");
+
+	if (isKeyword(p, "graph") || isKeyword(p, "node")
+	    || isKeyword(p, "edge"))
+	{
+	    QString which = p.text.toLower();
+	    Dot_Attributes attrs;
+	    advance(p);
+	    if (!parseAttributes(p, attrs))
+		return false;
+	    Dot_Attributes &defaults = which == "node" ? scope.nodeDefaults
+		: scope.edgeDefaults;
+	    if (which != "graph")
+		for (Dot_Attributes::const_iterator i = attrs.constBegin();
+		     i != attrs.constEnd(); ++i)
+		    defaults.insert(i.key(), i.value());
+	}
+	else
+	{
+	    QVector<int> left;
+	    bool isSubgraph = isKeyword(p, "subgraph") || isPunct(p, "{");
+	    QString name = p.text;
+	    if (isSubgraph)
+	    {
+		if (!parseOperand(p, scope, left))
+		    return false;
+	    }
+	    else
+	    {
+		// Don't make a node until we know this isn't "a = b".
+		if (!isId(p))
+		    return syntaxError(p, "a statement");
+		advance(p);
+		if (isPunct(p, "="))
+		{
+		    // A graph attribute; ignore it.
+		    advance(p);
+		    if (!isId(p))
+			return syntaxError(p, "an attribute value");
+		    advance(p);
+		    if (isPunct(p, ";"))
+			advance(p);
+		    continue;
+		}
+		left.append(nodeFor(p, name, scope));
+		if (!skipPort(p))
+		    return false;
+	    }
+
+	    if (p.kind == DotTokenizer::EdgeOp)
+	    {
+		QVector<QPair<int, int>> ends;
+		while (p.kind == DotTokenizer::EdgeOp)
+		{
+		    QVector<int> right;
+		    advance(p);
+		    if (!parseOperand(p, scope, right))
+			return false;
+		    foreach (int u, left)
+			foreach (int v, right)
+			    if (u != v)
+				ends.append(qMakePair(u, v));
+		    members += left;
+		    left = right;
+		}
+
+		Dot_Attributes attrs;
+		if (!parseAttributes(p, attrs))
+		    return false;
+		for (int i = 0; i < ends.count(); i++)
+		{
+		    Edge_Description edge;
+		    initEdgeDescription(edge);
+		    edge.source = ends.at(i).first;
+		    edge.dest = ends.at(i).second;
+		    applyEdgeAttributes(edge, scope.edgeDefaults);
+		    applyEdgeAttributes(edge, attrs);
+		    edge.hasLabel = !edge.label.isEmpty();
+		    p.description->edges.append(edge);
+		}
+	    }
+	    else if (!isSubgraph)
+	    {
+		Dot_Attributes attrs;
+		if (!parseAttributes(p, attrs))
+		    return false;
+		applyNodeAttributes(p.description->nodes[left.first()],
+				    attrs, name, p.positioned);
+	    }
+	    members += left;
+	}
+
+	if (isPunct(p, ";"))
+	    advance(p);
+    }
+    return true;
+}
+
+
+
+/*
+ * Name:	isDotFile()
+ * Purpose:	Decide whether a file should be read by readDot().
+ * Arguments:	The file name.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	True iff it has one of the DOT extensions.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	None.
+ */
+
+bool
+isDotFile(QString fileName)
+{
+    QString suffix = QFileInfo(fileName).suffix();
+
+    return suffix == DOT_FILE_EXTENSION || suffix == DOT_ALT_FILE_EXTENSION;
+}
+
+
+
+/*
+ * Name:	parseDot()
+ * Purpose:	Read a DOT graph into a Graph_Description.
+ * Arguments:	The device to read from, the name of the file (for
+ *		error messages), the description to fill in and a string
+ *		to hold an error message.
+ * Outputs:	Nothing.
+ * Modifies:	description, errorMessage.
+ * Returns:	True iff the graph was read.
+ * Assumptions:	None.
+ * Bugs:	Only the first graph in the file is read.
+ * Notes:	See the comments at the top of this file.
+ */
+
+bool
+parseDot(QIODevice * in, QString graphName,
+	 Graph_Description &description, QString &errorMessage)
+{
+    QTextStream stream(in);
+    DotTokenizer tokens(stream);
+    Dot_Parser p;
+
+    description.nodes.clear();
+    description.edges.clear();
+    p.tokens = &tokens;
+    p.graphName = graphName;
+    p.description = &description;
+    p.positioned = false;
+
+    advance(p);
+    if (isKeyword(p, "strict"))
+	advance(p);
+    if (!isKeyword(p, "graph") && !isKeyword(p, "digraph"))
+    {
+	syntaxError(p, "'graph' or 'digraph'");
+	errorMessage = p.errorMessage;
+	return false;
+    }
+    advance(p);
+    if (isId(p))
+	advance(p);
+    if (!isPunct(p, "{"))
+    {
+	syntaxError(p, "'{'");
+	errorMessage = p.errorMessage;
+	return false;
+    }
+    advance(p);
+
+    QVector<int> members;
+    if (!parseStatements(p, Dot_Scope(), members))
+    {
+	errorMessage = p.errorMessage;
+	return false;
+    }
+
+    for (int i = 0; i < description.nodes.count(); i++)
+	description.nodes[i].hasLabel = !description.nodes.at(i).label.isEmpty();
+
+    completeDescription(description, p.positioned);
+    return true;
+}
+
+
+
+/*
+ * Name:	readDot()
+ * Purpose:	Create a graph from a DOT file.
+ * Arguments:	The file name and a string to hold an error message.
+ * Outputs:	Nothing.
+ * Modifies:	errorMessage, if there is an error.
+ * Returns:	The new graph (not yet in any scene), or nullptr.
+ * Assumptions:	currentPhysicalDPI_{X,Y} are set.
+ * Bugs:	None.
+ * Notes:	As for readGraphIc(), the node preview coords are set
+ *		and the caller positions the graph.
+ */
+
+Graph *
+readDot(QString fileName, QString &errorMessage)
+{
+    QFile file(fileName);
+
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+	errorMessage = "File: " + fileName + ": " + file.errorString();
+	return nullptr;
+    }
+
+    Graph_Description description;
+    if (!parseDot(&file, fileName, description, errorMessage))
+	return nullptr;
+
+    GraphBuilder builder(description);
+    builder.build(builder.itemCount());
+    return builder.takeGraph();
+}
+
+
+
+/*
+ * Name:	quoted()
+ * Purpose:	Make a DOT quoted string.
+ * Arguments:	The text.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The text, quoted.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	Backslashes are doubled so that Graphviz doesn't treat
+ *		them as escapes.
+ */
+
+static QString
+quoted(QString text)
+{
+    return "\"" + text.replace("\\", "\\\\").replace("\"", "\\\"") + "\"";
+}
+
+
+
+/*
+ * Name:	saveDot()
+ * Purpose:	Write a graph (or graphs) as DOT.
+ * Arguments:	The device to write to and the nodes.
+ * Outputs:	The DOT graph.
+ * Modifies:	Nothing.
+ * Returns:	True iff it was all written.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	Describes the nodes and their edges (including compact
+ *		edges) and writes the description with the saveDot()
+ *		below.
+ */
+
+bool
+saveDot(QIODevice * out, QVector<Node *> nodes)
+{
+    Graph_Description description;
+
+    describeGraph(nodes, description);
+    return saveDot(out, description);
+}
+
+
+
+/*
+ * Name:	saveDot()
+ * Purpose:	Write a graph description as DOT.
+ * Arguments:	The device to write to and the description.
+ * Outputs:	The DOT graph.
+ * Modifies:	Nothing.
+ * Returns:	True iff it was all written.
+ * Assumptions:	The node positions are scene positions in inches, as
+ *		describeNode() gives them.
+ * Bugs:	Edge rotations and radii are not written.
+ * Notes:	The node positions are written as pinned ("!") pos
+ *		attributes, so "neato -n" draws the graph as it is
+ *		here.  The edges are written in the same order as
+ *		saveGraphIc() writes them.
+ *		This touches no QGraphicsItems, so it may be called on
+ *		any thread.
+ */
+
+bool
+saveDot(QIODevice * out, const Graph_Description &description)
+{
+    QTextStream stream(out);
+    const QVector<Node_Description> &nodes = description.nodes;
+    const QVector<Edge_Description> &edges = description.edges;
+    QPointF mid = centreInInches(nodes);
+
+    stream << "graph {\n";
+    stream << "    node [shape=circle, fixedsize=true, style=filled];\n";
+
+    for (int i = 0; i < nodes.count(); i++)
+    {
+	const Node_Description &node = nodes.at(i);
+	qreal x = (node.x - mid.x()) * DOT_POINTS_PER_INCH;
+	qreal y = -(node.y - mid.y()) * DOT_POINTS_PER_INCH;
+
+	stream << "    " << i << " [pos=\""
+	       << QString::number(x, 'f', DOT_POS_PREC) << ","
+	       << QString::number(y, 'f', DOT_POS_PREC) << "!\""
+	       << ", width=" << node.diameter
+	       << ", height=" << node.diameter
+	       << ", penwidth=" << node.penWidth
+	       << ", color=\"" << node.lineColour.name() << "\""
+	       << ", fillcolor=\"" << node.fillColour.name() << "\"";
+	if (node.rotation != 0)
+	    stream << ", orientation=" << node.rotation;
+	if (node.hasLabel)
+	    stream << ", label=" << quoted(node.label)
+		   << ", fontsize=" << node.labelSize;
+	else
+	    stream << ", label=\"\"";
+	stream << "];\n";
+    }
+
+    foreach (const Edge_Description &e, edges)
+    {
+	stream << "    " << qMin(e.source, e.dest)
+	       << " -- " << qMax(e.source, e.dest)
+	       << " [penwidth=" << e.penWidth
+	       << ", color=\"" << e.colour.name() << "\"";
+	if (e.hasLabel)
+	    stream << ", label=" << quoted(e.label)
+		   << ", fontsize=" << e.labelSize;
+	stream << "];\n";
+    }
+
+    stream << "}\n";
+    stream.flush();
+    return stream.status() == QTextStream::Ok;
+}
@@ -0,0 +1,39 @@
+/*
+ * File:	dotformat.h
+ * Author:	agent
+ * Date:	2026-10-18
+ * Version:	1.1
+ *
+ * Purpose:	Declare the functions which read and write Graphviz DOT.
+ *
+ * Modification history:
+ * Oct 18, 2026 (agent V1.0)
+ *  (a) Initial version.
+ * Oct 18, 2026 (agent V1.1)
+ *  (a) Declare the saveDot() which writes a Graph_Description.
+ */
+
+#ifndef DOTFORMAT_H
+#define DOTFORMAT_H
+
+#include "graphloader.h"
+
+#include <QIODevice>
+#include <QString>
+#include <QVector>
+
+// saveDot() writes .gv files; .dot files are also read.
+#define DOT_FILE_EXTENSION	"gv"
+#define DOT_ALT_FILE_EXTENSION	"dot"
+
+class Graph;
+class Node;
+
+bool isDotFile(QString fileName);
+bool parseDot(QIODevice * in, QString graphName,
+	      Graph_Description &description, QString &errorMessage);
+Graph * readDot(QString fileName, QString &errorMessage);
+bool saveDot(QIODevice * out, QVector<Node *> nodes);
+bool saveDot(QIODevice * out, const Graph_Description &description);
+
+#endif // DOTFORMAT_H
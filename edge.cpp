@@ -2,7 +2,7 @@
  * File:    edge.cpp
  * Author:  Rachel Bood
  * Date:    2014/11/07
- * Version: 1.13
+ * Version: 1.25
  *
  * Purpose: creates an edge for the users graph
  *
@@ -73,14 +73,72 @@
  * August 21, 2020 (IC V1.13)
  *  (a) Added the ability to number edge labels similar to nodes so setLabel
  *      has been replaced with copies of the label functions from node.cpp.
+ * Oct 18, 2026 (agent V1.14)
+ *  (a) Added queueAdjust() and adjustQueuedEdges().  Node::itemChange()
+ *	now queues its edges instead of calling adjust() directly, so
+ *	dragging a node with many edges only recomputes each edge's
+ *	geometry once per pass through the event loop.
+ *  (b) Replaced the commented-out WIP destructor with one which just
+ *	removes the edge from the queue, so that a deleted edge is
+ *	never adjusted.
+ * Oct 18, 2026 (agent V1.15)
+ *  (a) queueAdjust() adjusts the edge at once when it is not called
+ *	on the GUI thread, so that graphs can be built and rendered on
+ *	the batch renderer's worker threads.
+ * Oct 18, 2026 (agent V1.16)
+ *  (a) As for nodes, the edge's HTML_Label is only created (by
+ *	createHtmlLabel()) when a non-empty label is set or the label
+ *	is to be edited, and editLabel(false) deletes a label which
+ *	is (still) empty.  labelSize is now initialized, and is what
+ *	a new label's font size is set from.
+ * Oct 18, 2026 (agent V1.17)
+ *  (a) The pen width, colour and label size now live in an EdgeStyle
+ *	shared with the other edges of the graph; see Node V1.17.
+ * Oct 18, 2026 (agent V1.18)
+ *  (a) An edge in a graph no longer draws its own line: the graph
+ *	draws all of its edges, a pen at a time (see Graph::paint()).
+ *	Added drawnLine(), pen() and getPenStyle() for that, and
+ *	redraw() (called where update() used to be, and from adjust()
+ *	and the new itemChange()) to tell the graph what to redraw.
+ * Oct 18, 2026 (agent V1.19)
+ *  (a) paint() doesn't antialias an edge thinner than a pixel on
+ *	the screen (as Graph::paint() does).
+ * Oct 18, 2026 (agent V1.20)
+ *  (a) paint() no longer has side effects: adjust() (and
+ *	createHtmlLabel()) centre the label on the edge, rather than
+ *	paint() moving it on every repaint, and paint() no longer
+ *	sets edgeLine (adjust() already does).
+ * Oct 18, 2026 (agent V1.21)
+ *  (a) createSelectionPolygon() works out the perpendicular offset
+ *	from the line itself rather than from its angle (no trig),
+ *	and also makes the path returned by shape() and the rect
+ *	returned by boundingRect(), which used to be made on every
+ *	call.
+ * Oct 18, 2026 (agent V1.22)
+ *  (a) ~Edge() only touches dirtyEdges on the GUI thread (as
+ *	queueAdjust() does), since Export All and the autosaver
+ *	build and destroy edges on pool threads.
+ * Oct 18, 2026 (agent V1.23)
+ *  (a) paint() tells an export from a view by isExporting(), not
+ *	by the widget (see Graph::paint()).
+ * Oct 18, 2026 (agent V1.24)
+ *  (a) Remove Pi and the #include of math.h, which nothing uses
+ *	any more (see V1.21).
+ * Oct 18, 2026 (agent V1.25)
+ *  (a) The setters and itemChange() tell the autosaver (see
+ *	AutoSaver::edgeChanged()) when the edge changes, and
+ *	itemChange(), setDestNode(), setSourceNode() and the destructor
+ *	tell it when the edge joins or leaves a scene or gets new
+ *	nodes.
  */
 
+#include "autosave.h"
 #include "edge.h"
+#include "graph.h"
 #include "node.h"
 #include "canvasview.h"
 
 #include <QTextDocument>
-#include <math.h>
 #include <QtCore>
 #include <QKeyEvent>
 #include <QGraphicsScene>
@@ -89,10 +147,15 @@
 #include <QStyleOption>
 #include <QMessageBox>
 #include <QDebug>
+#include <QTimer>
+#include <QThread>
+#include <QCoreApplication>
 
-static const double Pi = 3.14159265358979323846264338327950288419717;
 static const double offset = 5;		// TO DO: what is this?
 
+QSet<Edge *> Edge::dirtyEdges;
+bool Edge::adjustPending = false;
+
 
 
 /*
@@ -120,15 +183,47 @@ Edge::Edge(Node * sourceNode, Node * destNode)
     source->addEdge(this);
     dest->addEdge(this);
     penStyle = 0;	// What type of pen style to use when drawing outline.
-    penSize = 1;
+    edgeStyle = EdgeStyle::defaultStyle();  // Pen size, colour, ...
     rotation = 0;
     label = "";
     causedConnect = 0;
     destRadius = destNode->getDiameter() / 2.;
     sourceRadius = destNode->getDiameter() / 2.;
     setHandlesChildEvents(true);
-    htmlLabel = new HTML_Label(this);
+    htmlLabel = nullptr;	// See createHtmlLabel().
     checked = 0;
+}
+
+
+
+/*
+ * Name:	createHtmlLabel()
+ * Purpose:	Create the HTML_Label of this edge, if it doesn't
+ *		already have one.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	htmlLabel.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	Most edges are never labelled, and an HTML_Label (with
+ *		its QTextDocument) is much bigger than the rest of the
+ *		edge, so it is made only when it is needed.
+ */
+
+void
+Edge::createHtmlLabel()
+{
+    if (htmlLabel != nullptr)
+	return;
+
+    qDeb() << "E::createHtmlLabel() called";
+
+    htmlLabel = new HTML_Label(this);
+    QFont font = htmlLabel->font();
+    font.setPointSize(edgeStyle->labelSize);
+    htmlLabel->setFont(font);
+    htmlLabel->setCentre((sourcePoint + destPoint) / 2.);
 
     connect(htmlLabel, SIGNAL(editDone(QString)),
             this, SLOT(setEdgeLabel(QString)));
@@ -182,11 +277,12 @@ Edge::destNode() const
  * Argument:    Boolean
  * Output:      Nothing.
  * Modifies:    ItemisFocusable flag, ItemIsFocusable flag,
- *		setHandlesChildEvents
+ *		setHandlesChildEvents, htmlLabel (which may be created
+ *		or deleted).
  * Returns:     Nothign.
  * Assumptions: None.
  * Bugs:        None.
- * Notes:       None.
+ * Notes:       See Node::editLabel().
  */
 
 void
@@ -195,6 +291,23 @@ Edge::editLabel(bool edit)
     qDeb() << "E::editLabel(" << edit << ") called";
 
     setHandlesChildEvents(!edit);
+
+    if (edit)
+	createHtmlLabel();
+    else if (htmlLabel == nullptr)
+	return;
+    else
+    {
+	if (htmlLabel->hasFocus())
+	    htmlLabel->clearFocus();
+	if (label.isEmpty())
+	{
+	    delete htmlLabel;
+	    htmlLabel = nullptr;
+	    return;
+	}
+    }
+
     htmlLabel->setFlag(QGraphicsItem::ItemIsFocusable, edit);
     htmlLabel->setFlag(ItemIsSelectable, edit);
 }
@@ -225,26 +338,30 @@ Edge::getRootParent()
 
 
 /*
- * Name:
- * Purpose:
- * Arguments:
- * Output:
- * Modifies:
- * Returns:
- * Assumptions:
- * Bugs:
- * Notes:       *** edge destructor...work in progress****
+ * Name:        ~Edge()
+ * Purpose:     Destructor for the Edge class.
+ * Arguments:   None.
+ * Output:      Nothing.
+ * Modifies:    dirtyEdges
+ * Returns:     Nothing.
+ * Assumptions: None.
+ * Bugs:        None.
+ * Notes:       The nodes' edgeLists are still looked after by the
+ *		callers (e.g., CanvasScene::mousePressEvent()); all this
+ *		does is make sure a pending adjustQueuedEdges() does not
+ *		touch a deleted edge, and tell the autosaver that the
+ *		edge has gone.
+ *		An edge made off the GUI thread is never queued (see
+ *		queueAdjust()), so there is nothing to do for it, and
+ *		dirtyEdges (a QSet) must not be touched there.
  */
-//Edge::~Edge()
-//{
-//    emit edgeDeleted();
-//    this->sourceNode()->removeEdge(this);
-//    this->destNode()->removeEdge(this);
-//    htmlLabel->setParentItem(nullptr);
-//    delete htmlLabel;
-//    htmlLabel = nullptr;
-//    setParentItem(nullptr);
-//}
+
+Edge::~Edge()
+{
+    AutoSaver::itemsChanged(scene());
+    if (QThread::currentThread() == QCoreApplication::instance()->thread())
+	dirtyEdges.remove(this);
+}
 
 
 
@@ -321,16 +438,26 @@ Edge::setEdgeLabel(QString aLabel, QString subscript)
  * Returns:     Nothing.
  * Assumptions: none
  * Bugs:        none
- * Notes:       This is (apparently) called from the labelcontroller.cpp
- *		callback, which doesn't distinguish between integer and
- *		string.  So do a test to choose the correct font.
+ * Notes:       This is called from EditTabModel::setData() (formerly
+ *		from the labelcontroller.cpp callback), which doesn't
+ *		distinguish between integer and string.  So do a test
+ *		to choose the correct font.
  *		TODO: eh??
+ *		Clearing the label of an edge which has no HTML_Label
+ *		does not create one.
  */
 
 void
 Edge::setEdgeLabel(QString aLabel)
 {
     label = aLabel;
+    AutoSaver::edgeChanged(this);
+    if (htmlLabel == nullptr)
+    {
+	if (aLabel.isEmpty())
+	    return;
+	createHtmlLabel();
+    }
     htmlLabel->texLabelText = aLabel;
     labelToHtml();
 }
@@ -428,6 +555,7 @@ Edge::adjust()
     QLineF line(mapFromItem(source, 0, 0), mapFromItem(dest, 0, 0));
     qreal length = line.length();
 
+    redraw();			// Where the edge was...
     prepareGeometryChange();
 
     if (length > destRadius * 2)
@@ -448,6 +576,84 @@ Edge::adjust()
     }
     edgeLine = line;
     createSelectionPolygon();
+    if (htmlLabel != nullptr)
+	htmlLabel->setCentre((sourcePoint + destPoint) / 2.);
+    redraw();			// ... and where it is now.
+}
+
+
+
+/*
+ * Name:        queueAdjust()
+ * Purpose:     Remember that the given edge needs to be adjust()ed, and
+ *		arrange for adjustQueuedEdges() to be called once control
+ *		returns to the event loop.
+ * Arguments:   The edge whose geometry is now out of date.
+ * Output:      Nothing.
+ * Modifies:    dirtyEdges, adjustPending
+ * Returns:     Nothing.
+ * Assumptions: None.
+ * Bugs:        None.
+ * Notes:       Called from Node::itemChange(), i.e., for every mouse
+ *		move while a node is being dragged.  Qt compresses mouse
+ *		moves, so a node with thousands of edges now gets each
+ *		edge adjusted once per repaint rather than once per
+ *		itemChange() (which could be many times per repaint).
+ *		Off the GUI thread the edge is adjusted immediately.
+ */
+
+void
+Edge::queueAdjust(Edge * edge)
+{
+    // The queue belongs to the GUI thread.  Elsewhere (e.g., the batch
+    // renderer's pool threads) there is no event loop to flush it.
+    if (QThread::currentThread() != QCoreApplication::instance()->thread())
+    {
+	edge->adjust();
+	return;
+    }
+
+    dirtyEdges.insert(edge);
+    if (!adjustPending)
+    {
+	adjustPending = true;
+	QTimer::singleShot(0, &Edge::adjustQueuedEdges);
+    }
+}
+
+
+
+/*
+ * Name:        adjustQueuedEdges()
+ * Purpose:     adjust() all the edges recorded by queueAdjust().
+ * Arguments:   None.
+ * Output:      Nothing.
+ * Modifies:    The queued edges, dirtyEdges, adjustPending.
+ * Returns:     Nothing.
+ * Assumptions: None.
+ * Bugs:        None.
+ * Notes:       Normally called from the timer set up in queueAdjust(),
+ *		but code which needs correct edge geometry right now
+ *		(e.g., before rendering the scene to a file) may call it
+ *		directly; the later timer call then does nothing.
+ *		Edges are only ever queued on the GUI thread, so this
+ *		does nothing when called from any other thread.
+ */
+
+void
+Edge::adjustQueuedEdges()
+{
+    if (QThread::currentThread() != QCoreApplication::instance()->thread())
+	return;
+
+    adjustPending = false;
+    if (dirtyEdges.isEmpty())
+	return;
+
+    QSet<Edge *> edges;
+    edges.swap(dirtyEdges);
+    foreach (Edge * edge, edges)
+	edge->adjust();
 }
 
 
@@ -473,6 +679,7 @@ Edge::setDestNode(Node * node)
 
     dest = node;
     setDestRadius(node->getDiameter() / 2.);
+    AutoSaver::itemsChanged(scene());
 }
 
 
@@ -498,6 +705,7 @@ Edge::setSourceNode(Node * node)
 
     source = node;
     setSourceRadius(node->getDiameter() / 2.);
+    AutoSaver::itemsChanged(scene());
 }
 
 
@@ -519,6 +727,7 @@ Edge::setDestRadius(qreal aRadius)
 {
     destRadius = aRadius;
     adjust();
+    AutoSaver::edgeChanged(this);
 }
 
 
@@ -560,6 +769,7 @@ Edge::setSourceRadius(qreal aRadius)
 {
     sourceRadius = aRadius;
     adjust();
+    AutoSaver::edgeChanged(this);
 }
 
 
@@ -589,7 +799,7 @@ Edge::getSourceRadius()
  * Purpose:     Sets the width (penSize) of the edge.
  * Arguments:   The new width.
  * Output:      Nothing.
- * Modifies:    The edge's penSize.
+ * Modifies:    edgeStyle (which is first copied if it is shared).
  * Returns:     Nothing.
  * Assumptions: ?
  * Bugs:        ?
@@ -601,8 +811,10 @@ Edge::getSourceRadius()
 void
 Edge::setPenWidth(qreal aPenWidth)
 {
-    penSize = aPenWidth;
-    update();
+    edgeStyle.detach();
+    edgeStyle->penWidth = aPenWidth;
+    redraw();
+    AutoSaver::edgeChanged(this);
 }
 
 
@@ -624,7 +836,7 @@ Edge::setPenWidth(qreal aPenWidth)
 qreal
 Edge::getPenWidth()
 {
-    return penSize;
+    return edgeStyle->penWidth;
 }
 
 
@@ -650,6 +862,7 @@ Edge::setRotation(qreal aRotation)
 
     rotation = aRotation;
     QGraphicsItem::setRotation(aRotation);
+    AutoSaver::edgeChanged(this);
 }
 
 
@@ -679,7 +892,7 @@ Edge::getRotation()
  * Purpose:     Stores the colour of the edge in a QColor variable.
  * Arguments:   A QColor, the desired colour of this edge.
  * Output:      Nothing.
- * Modifies:    The node's edgeColour.
+ * Modifies:    edgeStyle (which is first copied if it is shared).
  * Returns:     Nothing.
  * Assumptions: None.
  * Bugs:        None?
@@ -689,8 +902,10 @@ Edge::getRotation()
 void
 Edge::setColour(QColor colour)
 {
-    edgeColour = colour;
-    update();
+    edgeStyle.detach();
+    edgeStyle->colour = colour;
+    redraw();
+    AutoSaver::edgeChanged(this);
 }
 
 
@@ -710,7 +925,7 @@ Edge::setColour(QColor colour)
 QColor
 Edge::getColour()
 {
-    return edgeColour;
+    return edgeStyle->colour;
 }
 
 
@@ -720,9 +935,10 @@ Edge::getColour()
  * Purpose:     Sets the font size of the edge label.
  * Arguments:   A qreal specifying the size, in points.
  * Output:      Nothing.
- * Modifies:    Both the attribute labelSize and the htmlLabel's font size.
+ * Modifies:    edgeStyle (which is first copied if it is shared) and
+ *		the htmlLabel's font size (if there is an htmlLabel).
  * Returns:     Nothing.
- * Assumptions: The font has been defined.
+ * Assumptions: None.
  * Bugs:        None.
  * Notes:       None.
  */
@@ -730,10 +946,15 @@ Edge::getColour()
 void
 Edge::setEdgeLabelSize(qreal edgeLabelSize)
 {
+    edgeStyle.detach();
+    edgeStyle->labelSize = edgeLabelSize;
+    AutoSaver::edgeChanged(this);
+    if (htmlLabel == nullptr)
+	return;
+
     QFont font = htmlLabel->font();
     font.setPointSize(edgeLabelSize);
     htmlLabel->setFont(font);
-    labelSize = edgeLabelSize;
 }
 
 
@@ -753,7 +974,179 @@ Edge::setEdgeLabelSize(qreal edgeLabelSize)
 qreal
 Edge::getLabelSize()
 {
-    return labelSize;
+    return edgeStyle->labelSize;
+}
+
+
+
+/*
+ * Name:	style()
+ * Purpose:	Return this edge's style entry.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The (possibly shared) EdgeStyle.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	See Node::style().
+ */
+
+const EdgeStyle *
+Edge::style() const
+{
+    return edgeStyle.constData();
+}
+
+
+
+/*
+ * Name:	setStyle()
+ * Purpose:	Make this edge use the given style entry.
+ * Arguments:	The new entry.
+ * Outputs:	Nothing.
+ * Modifies:	edgeStyle, and the label font if the label size changed.
+ * Returns:	Nothing.
+ * Assumptions:	aStyle is not null.
+ * Bugs:	None.
+ * Notes:	See Node::setStyle().
+ */
+
+void
+Edge::setStyle(EdgeStylePtr aStyle)
+{
+    if (htmlLabel != nullptr && aStyle->labelSize != edgeStyle->labelSize)
+    {
+	QFont font = htmlLabel->font();
+	font.setPointSize(aStyle->labelSize);
+	htmlLabel->setFont(font);
+    }
+    edgeStyle = aStyle;
+    redraw();
+    AutoSaver::edgeChanged(this);
+}
+
+
+
+/*
+ * Name:	drawnLine()
+ * Purpose:	Return the part of the edge which is drawn.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The line between the node outlines, in this edge's
+ *		coordinates (a null line if the nodes overlap).
+ * Assumptions:	adjust() has been called since the nodes last moved.
+ * Bugs:	None.
+ * Notes:	None.
+ */
+
+QLineF
+Edge::drawnLine() const
+{
+    return QLineF(sourcePoint, destPoint);
+}
+
+
+
+/*
+ * Name:	pen()
+ * Purpose:	Return the pen the edge is drawn with.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The pen.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	The line is dashed while the edge is being looked at in
+ *		the edit tab (see eventFilter()).
+ */
+
+QPen
+Edge::pen() const
+{
+    QPen pen;
+    pen.setColor(edgeStyle->colour);
+    pen.setWidthF(edgeStyle->penWidth);
+    pen.setCapStyle(Qt::RoundCap);
+    pen.setJoinStyle(Qt::RoundJoin);
+
+    if (penStyle == 1)
+        pen.setStyle(Qt::DashLine);
+    else
+        pen.setStyle(Qt::SolidLine);
+
+    return pen;
+}
+
+
+
+int
+Edge::getPenStyle() const
+{
+    return penStyle;
+}
+
+
+
+/*
+ * Name:	redraw()
+ * Purpose:	Arrange for the edge to be drawn again.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	An edge in a graph is drawn by the graph, whose drawing
+ *		is cached, so it is the graph's cache which must be
+ *		updated, and only where the edge is.  A graph which is
+ *		not in a scene has nothing cached, and is drawn in full
+ *		when it is added to one, so it is left alone (which
+ *		saves it collecting an update per edge while it is
+ *		built).
+ */
+
+void
+Edge::redraw()
+{
+    QGraphicsItem * parent = parentItem();
+
+    if (parent == nullptr || parent->type() != Graph::Type)
+	update();
+    else if (parent->scene() != nullptr)
+	parent->update(mapRectToParent(boundingRect()));
+}
+
+
+
+/*
+ * Name:	itemChange()
+ * Purpose:	Tell the graph(s) when the edge joins or leaves them, or
+ *		is shown or hidden, and the autosaver when it joins or
+ *		leaves a scene.
+ * Arguments:	The change and its value.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The value from QGraphicsObject::itemChange().
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	When the parent is about to change, parentItem() is
+ *		still the old graph, which must erase the edge;
+ *		afterwards it is the new one, which must draw it.
+ *		Likewise scene() is the old (new) scene before (after)
+ *		the scene changes.
+ */
+
+QVariant
+Edge::itemChange(GraphicsItemChange change, const QVariant &value)
+{
+    if (change == ItemParentChange || change == ItemParentHasChanged
+	|| change == ItemVisibleHasChanged)
+	redraw();
+    else if (change == ItemSceneChange || change == ItemSceneHasChanged)
+	AutoSaver::itemsChanged(scene());
+
+    return QGraphicsObject::itemChange(change, value);
 }
 
 
@@ -792,7 +1185,7 @@ Edge::boundingRect() const
     if (!source || !dest)
         return QRectF();
 
-    return selectionPolygon.boundingRect();
+    return selectionRect;
 }
 
 
@@ -814,6 +1207,7 @@ Edge::boundingRect() const
  *		sees why every mouse move should call this.
  *		It also is called sometimes when moving nodes around
  *		the canvas in "Edit" mode.
+ *		So the path is made by createSelectionPolygon(), not here.
  */
 
 QPainterPath
@@ -821,9 +1215,7 @@ Edge::shape() const
 {
     // qDeb() << "E::shape() called!";  // Way too much noise from this one!
 
-    QPainterPath ret;
-    ret.addPolygon(selectionPolygon);
-    return ret;
+    return selectionShape;
 }
 
 
@@ -833,12 +1225,16 @@ Edge::shape() const
  * Purpose:     Paints an edge between two nodes.
  * Arguments:   QPainter * pointer, QStyleOptionGraphicsITem *, QWidget *
  * Output:      Renders an edge to canvasScene.
- * Modifies:    QGraphicsScene
+ * Modifies:    Nothing.
  * Returns:     Nothing.
  * Assumptions: None.
  * Bugs:        None.
  * Notes:       QWidget * and QStyleOptionGraphicsItem * are not used in my
  *              implementation of this function.
+ *		The line of an edge in a graph is drawn by the graph
+ *		(see Graph::paint()), along with all the other edges
+ *		drawn with the same pen; the edge itself is still
+ *		an item, so it can be found and clicked on as before.
  */
 
 void
@@ -852,36 +1248,26 @@ Edge::paint(QPainter * painter, const QStyleOptionGraphicsItem * option,
     if (!source || !dest)
         return;
 
-    QColor color = edgeColour;
-
     QLineF line(sourcePoint, destPoint);
     if (qFuzzyCompare(line.length(), qreal(0.)))
         return;
 
-    // Set the style and draw the line.
-    QPen pen;
-    pen.setColor(color);
-    pen.setWidthF(penSize);
-    pen.setCapStyle(Qt::RoundCap);
-    pen.setJoinStyle(Qt::RoundJoin);
-
-    if (penStyle == 1)
-        pen.setStyle(Qt::DashLine);
-    else
-        pen.setStyle(Qt::SolidLine);
-
-    painter->setPen(pen);
-    painter->drawLine(line);
-    edgeLine = line;
+    if (parentItem() == nullptr || parentItem()->type() != Graph::Type)
+    {
+	bool antialiased = painter->testRenderHint(QPainter::Antialiasing);
+	if (!isExporting(scene())
+	    && edgeStyle->penWidth
+	    * QStyleOptionGraphicsItem::levelOfDetailFromTransform(
+		painter->worldTransform()) < LOD_MIN_LINE_PIXELS)
+	    painter->setRenderHint(QPainter::Antialiasing, false);
+	painter->setPen(pen());
+	painter->drawLine(line);
+	painter->setRenderHint(QPainter::Antialiasing, antialiased);
+    }
 
     // Debug statement to view the edge's bounding shape.
     if (debug)
         painter->drawPolygon(selectionPolygon);
-
-    htmlLabel->setPos((line.p2().rx() + line.p1().rx()) / 2.
-                      - htmlLabel->boundingRect().width() / 2.,
-                      (line.p2().ry() + line.p1().ry()) / 2.
-                      - htmlLabel->boundingRect().height() / 2.);
 }
 
 
@@ -911,7 +1297,7 @@ Edge::eventFilter(QObject *obj, QEvent *event)
     {
         penStyle = 0;
     }
-    update();
+    redraw();
     return QObject::eventFilter(obj, event);
 }
 
@@ -923,13 +1309,21 @@ Edge::eventFilter(QObject *obj, QEvent *event)
  *              runs parallel and the width runs perpendicular to the edge.
  * Arguments:   QLineF
  * Output:      Nothing.
- * Modifies:    selectionPolygon
+ * Modifies:    selectionPolygon, selectionShape, selectionRect
  * Returns:     Nothing.
  * Assumptions: None.
  * Bugs:        None.
  * Notes:       Called from E::adjust().
  *		Thus it is called so often than I commented out its
  *		debug output.
+ *		The offset is perpendicular to edgeLine; since
+ *		QLineF::angle() is measured counter-clockwise with y
+ *		pointing down, sin(angle) = -dy/length and
+ *		cos(angle) = dx/length.  A zero-length line has angle
+ *		0, so it gets a vertical offset, as before.
+ *		shape() and boundingRect() are called on every mouse
+ *		move over the scene, so their values are made here,
+ *		once per adjust().
  */
 
 void
@@ -938,10 +1332,15 @@ Edge::createSelectionPolygon()
     // qDeb() << "E::createSelectionPolygon() called!";
 
     QPolygonF nPolygon;
-    qreal radAngle = edgeLine.angle() * Pi / 180;
+    qreal length = edgeLine.length();
+    qreal dx = 0;
+    qreal dy = offset;
 
-    qreal dx = offset * qSin(radAngle);
-    qreal dy = offset * qCos(radAngle);
+    if (length > 0)
+    {
+	dx = -offset * edgeLine.dy() / length;
+	dy = offset * edgeLine.dx() / length;
+    }
 
     QPointF offset1 = QPointF(dx, dy);
     QPointF offset2 = QPointF(-dx, -dy);
@@ -951,4 +1350,7 @@ Edge::createSelectionPolygon()
              << edgeLine.p2() + offset1;
 
     selectionPolygon = nPolygon;
+    selectionShape = QPainterPath();
+    selectionShape.addPolygon(selectionPolygon);
+    selectionRect = selectionPolygon.boundingRect();
 }
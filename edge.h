@@ -2,7 +2,7 @@
  * File:    edge.h
  * Author:  Rachel Bood
  * Date:    2014/11/07 (?)
- * Version: 1.8
+ * Version: 1.13
  *
  * Purpose: creates an edge for the users graph
  * Modification history:
@@ -40,6 +40,25 @@
  *  (a) Added the ability to number edge labels similar to nodes so setLabel
  *      has been replaced with copies of the label functions from node.cpp.
  *  (b) setLabelSize renamed to setEdgeLabelSize for clarity.
+ * Oct 18, 2026 (agent V1.9)
+ *  (a) Added queueAdjust(), adjustQueuedEdges() and the static
+ *      dirtyEdges set so that the geometry updates caused by node
+ *      moves are done once per event loop pass, not once per move.
+ *  (b) Added a destructor which removes the edge from dirtyEdges.
+ * Oct 18, 2026 (agent V1.10)
+ *  (a) Add createHtmlLabel(); htmlLabel is now nullptr until the edge
+ *	is given a label or its label is edited.
+ * Oct 18, 2026 (agent V1.11)
+ *  (a) The pen width, colour and label size are now kept in a (shared)
+ *	EdgeStyle; add style() and setStyle().
+ * Oct 18, 2026 (agent V1.12)
+ *  (a) Add drawnLine(), pen() and getPenStyle(), which the parent
+ *	graph uses to draw the edge (see Graph::paint()), and
+ *	itemChange() and redraw(), which tell the graph when it
+ *	must draw the edge again.
+ * Oct 18, 2026 (agent V1.13)
+ *  (a) Add selectionShape and selectionRect, the cached shape() and
+ *	boundingRect() of the edge.
  */
 
 #ifndef EDGE_H
@@ -47,11 +66,15 @@
 
 #include "defuns.h"
 #include "html-label.h"
+#include "styletable.h"
 #include <QGraphicsItem>
 #include <QGraphicsObject>
 #include <QList>
+#include <QPainterPath>
+#include <QSet>
 #include <QGraphicsSimpleTextItem>
 #include <QGraphicsSceneMouseEvent>
+#include <QPen>
 #include <QTextDocument>
 
 class Node;
@@ -64,6 +87,7 @@ class Edge: public QGraphicsObject
 
 public:
     Edge(Node * sourceNode, Node * destNode);
+    ~Edge();
 
     void setDestRadius(qreal aRadius);
     qreal getDestRadius();
@@ -92,6 +116,8 @@ public:
     QString getLabel();
 
     void adjust();
+    static void queueAdjust(Edge * edge);
+    static void adjustQueuedEdges();
     void setDestNode(Node * node);
     void setSourceNode(Node * node);
 
@@ -104,9 +130,14 @@ public:
     void editLabel(bool edit);
     QGraphicsItem * getRootParent();
 
-     //~Edge(); deconstructor a WIP
+    const EdgeStyle * style() const;
+    void setStyle(EdgeStylePtr aStyle);
 
-    HTML_Label * htmlLabel;
+    QLineF drawnLine() const;
+    QPen pen() const;
+    int getPenStyle() const;
+
+    HTML_Label * htmlLabel;	// nullptr if the edge has no label.
     int causedConnect;
     int checked;
 
@@ -117,19 +148,26 @@ protected:
     void paint(QPainter * painter, const QStyleOptionGraphicsItem * option,
                QWidget * widget);
     bool eventFilter(QObject *obj, QEvent *event);
+    QVariant itemChange(GraphicsItemChange change, const QVariant &value);
 
 private:
     void	createSelectionPolygon();
+    void	redraw();
     Node	* source, * dest;   // Original names based on directed graphs
     QPointF	sourcePoint, destPoint;
     QPolygonF	selectionPolygon;
+    QPainterPath selectionShape;    // selectionPolygon, for shape().
+    QRectF	selectionRect;	    // Its bounding rect.
     qreal	destRadius, sourceRadius, rotation;
     QLineF	edgeLine;
     QString	label;
     int 	penStyle;
-    qreal	labelSize, penSize;
-    QColor	edgeColour;
+    EdgeStylePtr edgeStyle;	    // Pen width, colour, ...; shared.
     void	labelToHtml();
+    void	createHtmlLabel();
+
+    static QSet<Edge *> dirtyEdges;	// Edges waiting for adjust().
+    static bool	adjustPending;		// adjustQueuedEdges() is scheduled.
 };
 
 #endif // EDGE_H
@@ -0,0 +1,513 @@
+/*
+ * File:	edgebundle.cpp
+ * Author:	agent
+ * Date:	2026-10-18
+ * Version:	1.6
+ *
+ * Purpose:	A compact representation of the edges of a graph.
+ *		Dense generated graphs (K_n, K_m,n) have far more edges
+ *		than nodes, and a full Edge is a QObject (with an
+ *		HTML_Label, and its QTextDocument, once it is given a
+ *		label).  An EdgeBundle instead
+ *		keeps the edges of one graph as a flat array of pairs
+ *		of node indices, all with the same pen, and draws and
+ *		hit-tests them as a single item.
+ *
+ *		The file writers see the compact edges through
+ *		sourceAt() and destAt() (see describeEdges() in
+ *		graphloader.cpp), so saving leaves the bundle alone.
+ *		Some of the program (joining, deleting, the edge lists
+ *		of the nodes) only knows about Edges, so before any of
+ *		those things is done to a graph its bundle is expanded
+ *		into Edges (see Graph::expandEdges()).  A single edge
+ *		can also be promoted to an Edge when it is to be given
+ *		a label.
+ *
+ * Modification history:
+ * Oct 18, 2026 (agent V1.0)
+ *  (a) Initial version.
+ * Oct 18, 2026 (agent V1.1)
+ *  (a) The pen width, colour and label size are kept in an EdgeStyle,
+ *	and the Edges made by promote() and expand() share it.
+ * Oct 18, 2026 (agent V1.2)
+ *  (a) Add sourceAt() and destAt() so the layout code can see the
+ *	endpoints of the compact edges.
+ * Oct 18, 2026 (agent V1.3)
+ *  (a) Add setStyle(), for readGraphBin().
+ * Oct 18, 2026 (agent V1.4)
+ *  (a) paint() doesn't antialias lines thinner than a pixel on the
+ *	screen (see Graph::paint()).
+ * Oct 18, 2026 (agent V1.5)
+ *  (a) paint() tells an export from a view by isExporting(), not
+ *	by the widget, which is null in a view too when the graph
+ *	is cached.
+ * Oct 18, 2026 (agent V1.6)
+ *  (a) Tell the autosaver (see AutoSaver::itemsChanged()) when the
+ *	compact edges or their pen change.
+ */
+
+#include "edgebundle.h"
+#include "autosave.h"
+#include "defuns.h"
+#include "edge.h"
+#include "node.h"
+
+#include <QGraphicsScene>
+#include <QPainter>
+#include <QPen>
+#include <QPolygonF>
+#include <QStyleOptionGraphicsItem>
+
+
+
+/*
+ * Name:	EdgeBundle()
+ * Purpose:	Constructor.
+ * Arguments:	The parent item (the graph the edges belong to).
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	The defaults are those of a newly created Edge.
+ */
+
+EdgeBundle::EdgeBundle(QGraphicsItem * parent)
+    : QGraphicsObject(parent)
+{
+    edgeStyle = EdgeStylePtr(new EdgeStyle());
+    edgeStyle->colour = Qt::black;
+    boundsValid = false;
+    setZValue(0);
+}
+
+
+
+/*
+ * Name:	addEdge()
+ * Purpose:	Add an edge between two nodes.
+ * Arguments:	The two endpoints.
+ * Outputs:	Nothing.
+ * Modifies:	The edge (and maybe the node) arrays.
+ * Returns:	Nothing.
+ * Assumptions:	The nodes are in the same graph as this bundle.
+ * Bugs:	None.
+ * Notes:	Unlike the Edge constructor, this does not touch the
+ *		nodes' edgeLists.
+ */
+
+void
+EdgeBundle::addEdge(Node * source, Node * dest)
+{
+    Compact_Edge e;
+
+    e.source = nodeIndex.value(source, -1);
+    if (e.source < 0)
+    {
+	e.source = nodes.count();
+	nodeIndex.insert(source, e.source);
+	nodes.append(source);
+    }
+    e.dest = nodeIndex.value(dest, -1);
+    if (e.dest < 0)
+    {
+	e.dest = nodes.count();
+	nodeIndex.insert(dest, e.dest);
+	nodes.append(dest);
+    }
+
+    prepareGeometryChange();
+    boundsValid = false;
+    edges.append(e);
+    AutoSaver::itemsChanged(scene());
+}
+
+
+
+int
+EdgeBundle::count() const
+{
+    return edges.count();
+}
+
+
+
+/*
+ * Name:	sourceAt(), destAt()
+ * Purpose:	Return the endpoints of one of the compact edges.
+ * Arguments:	The index of the edge.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The node.
+ * Assumptions:	0 <= index < count().
+ * Bugs:	None.
+ * Notes:	None.
+ */
+
+Node *
+EdgeBundle::sourceAt(int index) const
+{
+    return nodes.at(edges.at(index).source);
+}
+
+
+
+Node *
+EdgeBundle::destAt(int index) const
+{
+    return nodes.at(edges.at(index).dest);
+}
+
+
+
+/*
+ * Name:	nodeCentres()
+ * Purpose:	Find the centre of each node in this item's coordinates.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The centres, in the same order as nodes.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	Each node is mapped once, rather than once per edge.
+ */
+
+QVector<QPointF>
+EdgeBundle::nodeCentres() const
+{
+    QVector<QPointF> centres(nodes.count());
+
+    for (int i = 0; i < nodes.count(); i++)
+	centres[i] = mapFromItem(nodes.at(i), 0, 0);
+
+    return centres;
+}
+
+
+
+/*
+ * Name:	nodesMoved()
+ * Purpose:	Note that some of the nodes may have moved (relative to
+ *		this item), so the bounding rect must be recomputed.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	boundsValid.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	Called from Graph::childMoved() (i.e., when a node is
+ *		dragged) and after the graph has been restyled or
+ *		rotated.  The recomputation is deferred to the next
+ *		call of boundingRect().
+ */
+
+void
+EdgeBundle::nodesMoved()
+{
+    prepareGeometryChange();
+    boundsValid = false;
+}
+
+
+
+QRectF
+EdgeBundle::boundingRect() const
+{
+    if (!boundsValid)
+    {
+	if (edges.isEmpty())
+	    bounds = QRectF();
+	else
+	{
+	    qreal margin = edgeStyle->penWidth / 2. + 1;
+	    bounds = QPolygonF(nodeCentres()).boundingRect()
+		.adjusted(-margin, -margin, margin, margin);
+	}
+	boundsValid = true;
+    }
+    return bounds;
+}
+
+
+
+/*
+ * Name:	edgeAt()
+ * Purpose:	Find the edge under a given point.
+ * Arguments:	The point, in this item's coordinates.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The index of the closest edge within a couple of pixels
+ *		of the line, or -1 if there is none.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	This is linear in the number of edges, but it is only
+ *		used for mouse clicks.
+ */
+
+int
+EdgeBundle::edgeAt(QPointF point) const
+{
+    QVector<QPointF> centres = nodeCentres();
+    qreal tolerance = edgeStyle->penWidth / 2. + 2;
+    qreal best = tolerance * tolerance;
+    int found = -1;
+
+    for (int i = 0; i < edges.count(); i++)
+    {
+	QPointF a = centres.at(edges.at(i).source);
+	QPointF ab = centres.at(edges.at(i).dest) - a;
+	qreal len2 = QPointF::dotProduct(ab, ab);
+	qreal t = 0;
+	if (len2 > 0)
+	    t = qBound(qreal(0), QPointF::dotProduct(point - a, ab) / len2,
+		       qreal(1));
+	QPointF d = point - (a + t * ab);
+	qreal dist2 = QPointF::dotProduct(d, d);
+	if (dist2 <= best)
+	{
+	    best = dist2;
+	    found = i;
+	}
+    }
+    return found;
+}
+
+
+
+bool
+EdgeBundle::contains(const QPointF &point) const
+{
+    return edgeAt(point) >= 0;
+}
+
+
+
+/*
+ * Name:	makeEdge()
+ * Purpose:	Create a full Edge with the same endpoints and style as
+ *		the given compact edge.
+ * Arguments:	The compact edge.
+ * Outputs:	Nothing.
+ * Modifies:	The edgeLists of the two nodes.
+ * Returns:	The new Edge.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	The new Edge is given this item's rotation, which
+ *		Graph::setRotation() keeps in step with that of the
+ *		graph's Edges.  It shares this item's style entry.
+ */
+
+Edge *
+EdgeBundle::makeEdge(const Compact_Edge &e)
+{
+    Edge * edge = new Edge(nodes.at(e.source), nodes.at(e.dest));
+
+    edge->setStyle(edgeStyle);
+    edge->setParentItem(parentItem());
+    edge->setRotation(rotation());
+    edge->adjust();
+    return edge;
+}
+
+
+
+/*
+ * Name:	promote()
+ * Purpose:	Replace one compact edge by a full Edge.
+ * Arguments:	The index of the edge (as returned by edgeAt()).
+ * Outputs:	Nothing.
+ * Modifies:	The edge array.
+ * Returns:	The new Edge.
+ * Assumptions:	0 <= index < count().
+ * Bugs:	None.
+ * Notes:	Used when a single edge is to be labelled.
+ */
+
+Edge *
+EdgeBundle::promote(int index)
+{
+    qDeb() << "EB::promote(" << index << ") called";
+
+    prepareGeometryChange();
+    boundsValid = false;
+
+    Edge * edge = makeEdge(edges.at(index));
+    edges.remove(index);
+    AutoSaver::itemsChanged(scene());
+    return edge;
+}
+
+
+
+/*
+ * Name:	expand()
+ * Purpose:	Replace all of the compact edges by full Edges.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	The edge array (which is emptied).
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	The Edges are created in the order the edges were
+ *		added, so that saved files are the same as when the
+ *		graph was generated with Edges in the first place.
+ *		The (now empty) bundle is normally deleted next; see
+ *		Graph::expandEdges().
+ */
+
+void
+EdgeBundle::expand()
+{
+    qDeb() << "EB::expand() called; " << edges.count() << " edges";
+
+    prepareGeometryChange();
+    boundsValid = false;
+
+    foreach (const Compact_Edge &e, edges)
+	makeEdge(e);
+    edges.clear();
+    AutoSaver::itemsChanged(scene());
+}
+
+
+
+void
+EdgeBundle::setPenWidth(qreal aPenWidth)
+{
+    prepareGeometryChange();
+    boundsValid = false;
+    edgeStyle.detach();
+    edgeStyle->penWidth = aPenWidth;
+    AutoSaver::itemsChanged(scene());
+}
+
+
+
+qreal
+EdgeBundle::getPenWidth()
+{
+    return edgeStyle->penWidth;
+}
+
+
+
+void
+EdgeBundle::setColour(QColor colour)
+{
+    edgeStyle.detach();
+    edgeStyle->colour = colour;
+    update();
+    AutoSaver::itemsChanged(scene());
+}
+
+
+
+QColor
+EdgeBundle::getColour()
+{
+    return edgeStyle->colour;
+}
+
+
+
+/*
+ * Name:	setEdgeLabelSize()
+ * Purpose:	Set the label size given to edges when they are
+ *		promoted or expanded.
+ * Arguments:	The font size.
+ * Outputs:	Nothing.
+ * Modifies:	edgeStyle.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	The compact edges themselves have no labels.
+ */
+
+void
+EdgeBundle::setEdgeLabelSize(qreal edgeLabelSize)
+{
+    edgeStyle.detach();
+    edgeStyle->labelSize = edgeLabelSize;
+    AutoSaver::itemsChanged(scene());
+}
+
+
+
+qreal
+EdgeBundle::getLabelSize()
+{
+    return edgeStyle->labelSize;
+}
+
+
+
+/*
+ * Name:	setStyle()
+ * Purpose:	Give the compact edges (and the Edges made from them)
+ *		the given style entry.
+ * Arguments:	The entry.
+ * Outputs:	Nothing.
+ * Modifies:	edgeStyle.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	The entry is shared, not copied.
+ */
+
+void
+EdgeBundle::setStyle(EdgeStylePtr aStyle)
+{
+    prepareGeometryChange();
+    boundsValid = false;
+    edgeStyle = aStyle;
+    AutoSaver::itemsChanged(scene());
+}
+
+
+
+/*
+ * Name:	paint()
+ * Purpose:	Draw all of the edges.
+ * Arguments:	QPainter *, QStyleOptionGraphicsItem *, QWidget *
+ * Outputs:	The edges, to the painter.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	The lines go from centre to centre; the (filled) nodes
+ *		are drawn on top of them.
+ *		In a view, lines thinner than LOD_MIN_LINE_PIXELS are
+ *		not antialiased.
+ */
+
+void
+EdgeBundle::paint(QPainter * painter, const QStyleOptionGraphicsItem * option,
+		  QWidget * widget)
+{
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+
+    if (edges.isEmpty())
+	return;
+
+    QVector<QPointF> centres = nodeCentres();
+    QVector<QLineF> lines;
+    lines.reserve(edges.count());
+    foreach (const Compact_Edge &e, edges)
+	lines.append(QLineF(centres.at(e.source), centres.at(e.dest)));
+
+    QPen pen;
+    pen.setColor(edgeStyle->colour);
+    pen.setWidthF(edgeStyle->penWidth);
+    pen.setCapStyle(Qt::RoundCap);
+    pen.setJoinStyle(Qt::RoundJoin);
+    painter->setPen(pen);
+    bool antialiased = painter->testRenderHint(QPainter::Antialiasing);
+    if (!isExporting(scene())
+	&& edgeStyle->penWidth
+	* QStyleOptionGraphicsItem::levelOfDetailFromTransform(
+	    painter->worldTransform()) < LOD_MIN_LINE_PIXELS)
+	painter->setRenderHint(QPainter::Antialiasing, false);
+    painter->drawLines(lines);
+    painter->setRenderHint(QPainter::Antialiasing, antialiased);
+}
@@ -0,0 +1,86 @@
+/*
+ * File:	edgebundle.h
+ * Author:	agent
+ * Date:	2026-10-18
+ * Version:	1.3
+ *
+ * Purpose:	Declare the EdgeBundle class, a compact representation of
+ *		the (unlabelled, uniformly styled) edges of a graph.
+ *
+ * Modification history:
+ * Oct 18, 2026 (agent V1.0)
+ *  (a) Initial version.
+ * Oct 18, 2026 (agent V1.1)
+ *  (a) Keep the pen width, colour and label size in an EdgeStyle.
+ * Oct 18, 2026 (agent V1.2)
+ *  (a) Add sourceAt() and destAt().
+ * Oct 18, 2026 (agent V1.3)
+ *  (a) Add setStyle().
+ */
+
+#ifndef EDGEBUNDLE_H
+#define EDGEBUNDLE_H
+
+#include "styletable.h"
+
+#include <QColor>
+#include <QGraphicsObject>
+#include <QHash>
+#include <QVector>
+
+class Edge;
+class Node;
+
+class EdgeBundle : public QGraphicsObject
+{
+    Q_OBJECT
+
+  public:
+    EdgeBundle(QGraphicsItem * parent = 0);
+
+    enum { Type = UserType + 5 };
+    int type() const { return Type; }
+
+    void addEdge(Node * source, Node * dest);
+    int count() const;
+    Node * sourceAt(int index) const;
+    Node * destAt(int index) const;
+    int edgeAt(QPointF point) const;
+    Edge * promote(int index);
+    void expand();
+    void nodesMoved();
+
+    void setPenWidth(qreal aPenWidth);
+    qreal getPenWidth();
+    void setColour(QColor colour);
+    QColor getColour();
+    void setEdgeLabelSize(qreal edgeLabelSize);
+    qreal getLabelSize();
+    void setStyle(EdgeStylePtr aStyle);
+
+    QRectF boundingRect() const;
+    bool contains(const QPointF &point) const;
+
+  protected:
+    void paint(QPainter * painter, const QStyleOptionGraphicsItem * option,
+	       QWidget * widget);
+
+  private:
+    typedef struct compactEdge
+    {
+	int source;		// Indices into nodes.
+	int dest;
+    } Compact_Edge;
+
+    Edge * makeEdge(const Compact_Edge &e);
+    QVector<QPointF> nodeCentres() const;
+
+    QVector<Node *>	    nodes;	// Each endpoint once.
+    QHash<Node *, int>	    nodeIndex;	// Node -> index in nodes.
+    QVector<Compact_Edge>   edges;
+    EdgeStylePtr	    edgeStyle;	// Given to each Edge made.
+    mutable QRectF	    bounds;
+    mutable bool	    boundsValid;
+};
+
+#endif // EDGEBUNDLE_H
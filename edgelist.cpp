@@ -0,0 +1,351 @@
+/*
+ * File:	edgelist.cpp
+ * Author:	agent
+ * Date:	2026-10-18
+ * Version:	1.2
+ *
+ * Purpose:	Import graphs from edge list files.
+ *
+ *		Two kinds of edge list are understood:
+ *		  the format written by saveEdgelist(): the number of
+ *		    nodes n on a line by itself, then one "u,v" line per
+ *		    edge, where 0 <= u, v < n;
+ *		  SNAP-style files (as used by the Stanford Large Network
+ *		    Dataset Collection and many other tools): one edge per
+ *		    line, with the two node IDs separated by white space,
+ *		    and '#' comment lines.  The IDs may be any unsigned
+ *		    32-bit numbers; the nodes are numbered in the order
+ *		    their IDs first appear.  Anything after the two IDs
+ *		    (e.g., a weight, which may be signed, fractional or
+ *		    in exponent form) is ignored.
+ *		Which one a file is is decided by its first non-comment
+ *		line.  Commas and white space are accepted as separators
+ *		in both, and '%' also starts a comment.
+ *
+ *		These files can have millions of edges, so the file is
+ *		mapped into memory and scanned byte by byte, without
+ *		making a QString (or anything else) per line.  The edges
+ *		are collected as pairs of node numbers, self-loops and
+ *		duplicates (including "v,u" after "u,v") are dropped, and
+ *		only then is the graph described (see graphloader.h),
+ *		so that a GraphBuilder can make the items: the nodes
+ *		share one style and the edges go in the graph's
+ *		EdgeBundle once there are enough of them.  The nodes
+ *		are placed by a short run of the force-directed layout
+ *		(see forcelayout.cpp), which gets shorter as the graph
+ *		gets bigger.  The GUI has the GraphLoader do all of
+ *		this, so the window doesn't freeze while a big file is
+ *		read and laid out.
+ *
+ * Modification history:
+ * Oct 18, 2026 (agent V1.0)
+ *  (a) Initial version.
+ * Oct 18, 2026 (agent V1.1)
+ *  (a) readEdgeList() skips the rest of a line once it has two node
+ *	IDs, so that weights such as -1, 0.5 or 2e-3 are accepted (the
+ *	third column used to be allowed only if it was a whole number).
+ *  (b) #include <climits> for INT_MAX.
+ * Oct 18, 2026 (agent V1.2)
+ *  (a) Split parseEdgeList() out of readEdgeList(): it reads and lays
+ *	out the file into a Graph_Description without making any
+ *	items, so the GraphLoader can run it on a pool thread rather
+ *	than laying the graph out on the GUI thread.  readEdgeList()
+ *	builds the description with a GraphBuilder.
+ */
+
+#include "edgelist.h"
+#include "defuns.h"
+#include "forcelayout.h"
+
+#include <algorithm>
+#include <climits>
+
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QVector>
+
+// Graphs with at most this many nodes get a full layout; bigger graphs
+// get proportionally fewer iterations, but at least IMPORT_MIN_ITERATIONS.
+#define IMPORT_FULL_LAYOUT_NODES    2000
+#define IMPORT_MIN_ITERATIONS	    10
+
+
+
+/*
+ * Name:	isEdgeListFile()
+ * Purpose:	Decide whether a file should be read by readEdgeList().
+ * Arguments:	The file name.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	True iff it has one of the edge list extensions.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	None.
+ */
+
+bool
+isEdgeListFile(QString fileName)
+{
+    QString suffix = QFileInfo(fileName).suffix();
+
+    return suffix == EDGES_FILE_EXTENSION || suffix == SNAP_FILE_EXTENSION;
+}
+
+
+
+/*
+ * Name:	parseEdgeList()
+ * Purpose:	Describe the graph in an edge list file.
+ * Arguments:	The file name, the description to fill in, a string to
+ *		hold an error message, and (optionally) a flag which
+ *		says to give up and a counter for the percentage done.
+ * Outputs:	Nothing.
+ * Modifies:	description, errorMessage (if there is an error),
+ *		*percentDone.
+ * Returns:	True on success, false if the file can't be read, is
+ *		not valid, or the parse was cancelled.
+ * Assumptions:	None.
+ * Bugs:	The layout can't be cancelled once it has started.
+ * Notes:	See the comments at the top of this file.  No items are
+ *		made, so this may be run on any thread; the
+ *		GraphLoader runs it (layout and all) on a pool thread.
+ *		The node positions are in inches, and the nodes and
+ *		edges get the values initNodeDescription() and
+ *		initEdgeDescription() give those of the other
+ *		imported formats.
+ */
+
+bool
+parseEdgeList(QString fileName, Graph_Description &description,
+	      QString &errorMessage, QAtomicInt * cancelled,
+	      QAtomicInt * percentDone)
+{
+    QFile file(fileName);
+
+    if (!file.open(QIODevice::ReadOnly))
+    {
+	errorMessage = "File: " + fileName + ": " + file.errorString();
+	return false;
+    }
+
+    qint64 size = file.size();
+    QByteArray contents;
+    const uchar * data = size > 0 ? file.map(0, size) : nullptr;
+    if (data == nullptr)
+    {
+	contents = file.readAll();
+	data = reinterpret_cast<const uchar *>(contents.constData());
+	size = contents.size();
+    }
+
+    const char * p = reinterpret_cast<const char *>(data);
+    const char * end = p + size;
+    qint64 lineNumber = 0;
+    qint64 numOfNodes = -1;		// >= 0 ==> the file gave n.
+    bool firstLine = true;
+    QHash<quint32, int> ids;		// SNAP ID -> node number.
+    QVector<quint64> keys;		// (min << 32) | max of each edge.
+
+    keys.reserve(size / 8);
+    while (p < end)
+    {
+	quint64 values[2];
+	int count = 0;
+	bool bad = false;
+
+	lineNumber++;
+	if ((lineNumber & 0xFFFF) == 0)
+	{
+	    if (cancelled != nullptr && cancelled->loadAcquire())
+		return false;
+	    // Reading the file is the first half of the work.
+	    if (percentDone != nullptr)
+		percentDone->storeRelease(
+		    int(50 * (p - reinterpret_cast<const char *>(data))
+			/ size));
+	}
+	while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+	    p++;
+	if (p < end && (*p == '#' || *p == '%'))
+	{
+	    while (p < end && *p != '\n')
+		p++;
+	    p++;
+	    continue;
+	}
+
+	while (p < end && *p != '\n')
+	{
+	    char c = *p;
+	    if (c >= '0' && c <= '9')
+	    {
+		quint64 v = 0;
+		while (p < end && *p >= '0' && *p <= '9')
+		{
+		    v = v * 10 + (*p++ - '0');
+		    if (v > 0xFFFFFFFFu)
+			bad = true;
+		}
+		values[count++] = v;
+		if (count == 2)
+		{
+		    // The rest (e.g., a weight) is not wanted, whatever
+		    // it looks like.
+		    while (p < end && *p != '\n')
+			p++;
+		}
+	    }
+	    else if (c == ',' || c == ' ' || c == '\t' || c == '\r')
+		p++;
+	    else
+	    {
+		bad = true;
+		p++;
+	    }
+	}
+	p++;				// Skip the newline.
+
+	if (count == 0 && !bad)
+	    continue;			// A blank line.
+
+	if (firstLine && count == 1 && !bad)
+	{
+	    numOfNodes = values[0];
+	    if (numOfNodes > INT_MAX)
+		bad = true;
+	    firstLine = false;
+	    if (!bad)
+		continue;
+	}
+	firstLine = false;
+	if (bad || count < 2)
+	{
+	    errorMessage = "Line " + QString::number(lineNumber)
+		+ " of file " + fileName
+		+ " is not a valid edge.  Thus I can not read this file.";
+	    return false;
+	}
+
+	quint32 u, v;
+	if (numOfNodes >= 0)
+	{
+	    if (values[0] >= quint64(numOfNodes)
+		|| values[1] >= quint64(numOfNodes))
+	    {
+		errorMessage = "Line " + QString::number(lineNumber)
+		    + " of file " + fileName
+		    + " refers to a non-existent node.  "
+		    "Thus I can not read this file.";
+		return false;
+	    }
+	    u = values[0];
+	    v = values[1];
+	}
+	else
+	{
+	    u = ids.value(values[0], ids.count());
+	    if (u == quint32(ids.count()))
+		ids.insert(values[0], u);
+	    v = ids.value(values[1], ids.count());
+	    if (v == quint32(ids.count()))
+		ids.insert(values[1], v);
+	}
+
+	if (u != v)
+	    keys.append(u < v ? (quint64(u) << 32) | v
+			: (quint64(v) << 32) | u);
+    }
+
+    int nodeCount = numOfNodes >= 0 ? int(numOfNodes) : ids.count();
+    if (nodeCount == 0)
+    {
+	errorMessage = "The file " + fileName + " has no nodes.  "
+	    "Thus I can not read this file.";
+	return false;
+    }
+
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    QVector<Layout_Edge> edges(keys.count());
+    for (int i = 0; i < keys.count(); i++)
+    {
+	edges[i].source = int(keys.at(i) >> 32);
+	edges[i].dest = int(keys.at(i) & 0xFFFFFFFFu);
+    }
+    keys.clear();
+    keys.squeeze();
+
+    if (cancelled != nullptr && cancelled->loadAcquire())
+	return false;
+    if (percentDone != nullptr)
+	percentDone->storeRelease(50);
+
+    // All of the nodes start at the origin, so the layout spreads
+    // them out on a grid before it starts.
+    int iterations = qBound(IMPORT_MIN_ITERATIONS,
+			    int(qint64(FL_ITERATIONS)
+				* IMPORT_FULL_LAYOUT_NODES / nodeCount),
+			    FL_ITERATIONS);
+    ForceLayout layout(QVector<QPointF>(nodeCount), edges, 1.);
+    layout.run(iterations);
+    QVector<QPointF> positions = layout.positions();
+
+    description.nodes.resize(nodeCount);
+    for (int i = 0; i < nodeCount; i++)
+    {
+	Node_Description &node = description.nodes[i];
+	initNodeDescription(node);
+	node.x = positions.at(i).x();
+	node.y = positions.at(i).y();
+    }
+    description.edges.resize(edges.count());
+    for (int i = 0; i < edges.count(); i++)
+    {
+	Edge_Description &edge = description.edges[i];
+	initEdgeDescription(edge);
+	edge.source = edges.at(i).source;
+	edge.dest = edges.at(i).dest;
+    }
+    completeDescription(description, true);
+    if (percentDone != nullptr)
+	percentDone->storeRelease(100);
+
+    qDeb() << "parseEdgeList(" << fileName << "): " << nodeCount
+	   << " nodes, " << edges.count() << " edges, "
+	   << iterations << " layout iterations";
+    return true;
+}
+
+
+
+/*
+ * Name:	readEdgeList()
+ * Purpose:	Create a graph from an edge list file.
+ * Arguments:	The file name and a string to hold an error message.
+ * Outputs:	Nothing.
+ * Modifies:	errorMessage, if there is an error.
+ * Returns:	The new graph (not yet in any scene), or nullptr if the
+ *		file can't be read or is not valid.
+ * Assumptions:	currentPhysicalDPI_{X,Y} are set.
+ * Bugs:	?
+ * Notes:	Parses (and lays out) the file with parseEdgeList() and
+ *		builds the graph all at once, on the calling thread.
+ *		The GUI uses a GraphLoader instead.  As for
+ *		readGraphIc(), the node preview coords are set and the
+ *		caller positions the graph.
+ */
+
+Graph *
+readEdgeList(QString fileName, QString &errorMessage)
+{
+    Graph_Description description;
+
+    if (!parseEdgeList(fileName, description, errorMessage))
+	return nullptr;
+
+    GraphBuilder builder(description);
+    builder.build(builder.itemCount());
+    return builder.takeGraph();
+}
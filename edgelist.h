@@ -0,0 +1,36 @@
+/*
+ * File:	edgelist.h
+ * Author:	agent
+ * Date:	2026-10-18
+ * Version:	1.1
+ *
+ * Purpose:	Declare the functions which import edge list files.
+ *
+ * Modification history:
+ * Oct 18, 2026 (agent V1.0)
+ *  (a) Initial version.
+ * Oct 18, 2026 (agent V1.1)
+ *  (a) Declare parseEdgeList().
+ */
+
+#ifndef EDGELIST_H
+#define EDGELIST_H
+
+#include "graphloader.h"
+
+#include <QAtomicInt>
+#include <QString>
+
+// The extensions of the files we treat as edge lists.
+#define EDGES_FILE_EXTENSION	"edges"
+#define SNAP_FILE_EXTENSION	"txt"
+
+class Graph;
+
+bool isEdgeListFile(QString fileName);
+bool parseEdgeList(QString fileName, Graph_Description &description,
+		   QString &errorMessage, QAtomicInt * cancelled = nullptr,
+		   QAtomicInt * percentDone = nullptr);
+Graph * readEdgeList(QString fileName, QString &errorMessage);
+
+#endif // EDGELIST_H
@@ -0,0 +1,179 @@
+/*
+ * File:	edittabdelegate.cpp
+ * Author:	agent
+ * Date:	2026-10-18
+ * Version:	1.0
+ *
+ * Purpose:	The item delegate used by the "Edit Graph" tab.  An
+ *		editor is only created for the cell the user is
+ *		editing, and (as with the old controllers) changes are
+ *		applied to the canvas as they are typed rather than
+ *		when the editor is closed.  Colours are chosen with a
+ *		QColorDialog when a colour cell is double-clicked.
+ *
+ * Modification history:
+ * Oct 18, 2026 (agent V1.0)
+ *  (a) Initial version.
+ */
+
+#include "edittabdelegate.h"
+#include "edittabmodel.h"
+
+#include <QColorDialog>
+#include <QDoubleSpinBox>
+#include <QEvent>
+#include <QLineEdit>
+#include <QMetaProperty>
+#include <QSpinBox>
+
+
+
+EditTabDelegate::EditTabDelegate(QObject * parent)
+    : QStyledItemDelegate(parent)
+{
+}
+
+
+
+/*
+ * Name:	createEditor()
+ * Purpose:	Create the editor for one cell of the edit tab.
+ * Arguments:	As for QStyledItemDelegate::createEditor().
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The editor, or nullptr for the colour columns.
+ * Assumptions:	index.model() is an EditTabModel.
+ * Bugs:	None.
+ * Notes:	The item being edited is installed as an event filter on
+ *		the editor so that it is highlighted on the canvas while
+ *		the editor has the focus, as was done with the widgets
+ *		of the old edit tab.
+ */
+
+QWidget *
+EditTabDelegate::createEditor(QWidget * parent,
+			      const QStyleOptionViewItem &option,
+			      const QModelIndex &index) const
+{
+    if (index.column() == EditTabModel::LineCol
+	|| index.column() == EditTabModel::FillCol)
+	return nullptr;
+
+    QWidget * editor = QStyledItemDelegate::createEditor(parent, option,
+							 index);
+    if (editor == nullptr)
+	return nullptr;
+
+    if (QDoubleSpinBox * box = qobject_cast<QDoubleSpinBox *>(editor))
+    {
+	box->setRange(0, 99.99);
+	if (index.column() == EditTabModel::DiamCol)
+	    box->setSingleStep(0.05);
+	connect(box, SIGNAL(valueChanged(double)),
+		this, SLOT(commitEditor()));
+    }
+    else if (QSpinBox * box = qobject_cast<QSpinBox *>(editor))
+    {
+	box->setRange(1, 99);
+	connect(box, SIGNAL(valueChanged(int)),
+		this, SLOT(commitEditor()));
+    }
+    else if (QLineEdit * edit = qobject_cast<QLineEdit *>(editor))
+    {
+	connect(edit, SIGNAL(textEdited(QString)),
+		this, SLOT(commitEditor()));
+    }
+
+    const EditTabModel * model
+	= qobject_cast<const EditTabModel *>(index.model());
+    QGraphicsObject * item = model->itemAt(index.row());
+    if (item != nullptr)
+	editor->installEventFilter(item);
+
+    return editor;
+}
+
+
+
+/*
+ * Name:	setEditorData()
+ * Purpose:	Load the editor from the model.
+ * Arguments:	The editor and the index of the cell.
+ * Outputs:	Nothing.
+ * Modifies:	The editor.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	Since commitEditor() writes every change straight back
+ *		to the model, the view calls this for each keystroke.
+ *		Leave the editor alone if it already has the value, so
+ *		that (e.g.) the cursor in a line edit does not jump to
+ *		the end of the text.
+ */
+
+void
+EditTabDelegate::setEditorData(QWidget * editor,
+			       const QModelIndex &index) const
+{
+    QByteArray name = editor->metaObject()->userProperty().name();
+
+    if (editor->property(name) == index.data(Qt::EditRole))
+	return;
+
+    QStyledItemDelegate::setEditorData(editor, index);
+}
+
+
+
+/*
+ * Name:	editorEvent()
+ * Purpose:	Let the user pick a new colour by double-clicking on one
+ *		of the colour cells.
+ * Arguments:	As for QStyledItemDelegate::editorEvent().
+ * Outputs:	Nothing.
+ * Modifies:	The model (and thus the canvas item).
+ * Returns:	True if the event was handled here.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	None.
+ */
+
+bool
+EditTabDelegate::editorEvent(QEvent * event, QAbstractItemModel * model,
+			     const QStyleOptionViewItem &option,
+			     const QModelIndex &index)
+{
+    if ((index.column() == EditTabModel::LineCol
+	 || index.column() == EditTabModel::FillCol)
+	&& event->type() == QEvent::MouseButtonDblClick
+	&& (index.flags() & Qt::ItemIsEditable))
+    {
+	QColor colour = QColorDialog::getColor(
+	    index.data(Qt::EditRole).value<QColor>());
+	if (colour.isValid())
+	    model->setData(index, colour);
+	return true;
+    }
+
+    return QStyledItemDelegate::editorEvent(event, model, option, index);
+}
+
+
+
+/*
+ * Name:	commitEditor()
+ * Purpose:	Write the value in the sending editor to the model.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	The model (and thus the canvas item).
+ * Returns:	Nothing.
+ * Assumptions:	The sender is an editor created by createEditor().
+ * Bugs:	None.
+ * Notes:	None.
+ */
+
+void
+EditTabDelegate::commitEditor()
+{
+    emit commitData(qobject_cast<QWidget *>(sender()));
+}
@@ -0,0 +1,40 @@
+/*
+ * File:	edittabdelegate.h
+ * Author:	agent
+ * Date:	2026-10-18
+ * Version:	1.0
+ *
+ * Purpose:	Declare the item delegate used by the "Edit Graph" tab.
+ *
+ * Modification history:
+ * Oct 18, 2026 (agent V1.0)
+ *  (a) Initial version.
+ */
+
+#ifndef EDITTABDELEGATE_H
+#define EDITTABDELEGATE_H
+
+#include <QStyledItemDelegate>
+
+class EditTabDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+  public:
+    explicit EditTabDelegate(QObject * parent = 0);
+
+    QWidget * createEditor(QWidget * parent,
+			   const QStyleOptionViewItem &option,
+			   const QModelIndex &index) const;
+    void setEditorData(QWidget * editor, const QModelIndex &index) const;
+
+  protected:
+    bool editorEvent(QEvent * event, QAbstractItemModel * model,
+		     const QStyleOptionViewItem &option,
+		     const QModelIndex &index);
+
+  private slots:
+    void commitEditor();
+};
+
+#endif // EDITTABDELEGATE_H
@@ -0,0 +1,536 @@
+/*
+ * File:	edittabmodel.cpp
+ * Author:	agent
+ * Date:	2026-10-18
+ * Version:	1.1
+ *
+ * Purpose:	The model behind the "Edit Graph" tab.  This replaces the
+ *		grid of widgets (and the five controller objects per
+ *		node) which MainWindow::updateEditTab() used to build
+ *		for every item on the canvas.  The model only holds a
+ *		guarded pointer for each graph, node and edge; the
+ *		values shown are read from the items when the view
+ *		asks for them, and the view only creates an editor for
+ *		the cell being edited (see edittabdelegate.cpp).
+ *
+ * Modification history:
+ * Oct 18, 2026 (agent V1.0)
+ *  (a) Initial version.
+ * Oct 18, 2026 (agent V1.1)
+ *  (a) Add a row for each EdgeBundle.  Its width, label size and
+ *	colour apply to all of the compact edges in the bundle.
+ */
+
+#include "edittabmodel.h"
+#include "defuns.h"
+#include "edge.h"
+#include "edgebundle.h"
+#include "graph.h"
+#include "node.h"
+
+#include <QColor>
+#include <QFont>
+#include <QTimer>
+
+
+
+/*
+ * Name:	EditTabModel()
+ * Purpose:	Constructor.
+ * Arguments:	The scene whose items are to be listed, and the QObject
+ *		parent.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	aScene outlives the model.
+ * Bugs:	None.
+ * Notes:	The model is empty until rebuild() is called.
+ */
+
+EditTabModel::EditTabModel(QGraphicsScene * aScene, QObject * parent)
+    : QAbstractTableModel(parent)
+{
+    scene = aScene;
+    highlighted = nullptr;
+    rebuildPending = false;
+}
+
+
+
+int
+EditTabModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : rows.count();
+}
+
+
+
+int
+EditTabModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+
+
+/*
+ * Name:	rebuild()
+ * Purpose:	Recreate the list of rows from the items on the canvas.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	The rows of the model.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	As with the old edit tab, there is one "Graph" row for
+ *		each root graph, followed by rows for all of the
+ *		nodes and edges in it and in its subgraphs.  The
+ *		compact edges of a graph (if any) get one row, for
+ *		their EdgeBundle.
+ *		This is linear in the number of items on the canvas and
+ *		creates no widgets, so it is cheap to call after each
+ *		change to the canvas.
+ */
+
+void
+EditTabModel::rebuild()
+{
+    qDeb() << "ETM::rebuild() called";
+
+    rebuildPending = false;
+    beginResetModel();
+    rows.clear();
+    rowIndex.clear();
+
+    foreach (QGraphicsItem * item, scene->items())
+    {
+	if (item->type() != Graph::Type || item->parentItem() != nullptr
+	    || item->childItems().isEmpty())
+	    continue;
+
+	Row row;
+	row.type = Graph::Type;
+	row.item = item->toGraphicsObject();
+	rowIndex.insert(item, rows.count());
+	rows.append(row);
+
+	QList<QGraphicsItem *> list = item->childItems();
+	for (int i = 0; i < list.count(); i++)
+	{
+	    QGraphicsItem * child = list.at(i);
+	    if (child->type() == Graph::Type)
+		list.append(child->childItems());
+	    else if (child->type() == Node::Type
+		     || child->type() == Edge::Type
+		     || child->type() == EdgeBundle::Type)
+	    {
+		row.type = child->type();
+		row.item = child->toGraphicsObject();
+		rowIndex.insert(child, rows.count());
+		rows.append(row);
+	    }
+	}
+    }
+    endResetModel();
+}
+
+
+
+/*
+ * Name:	queueRebuild()
+ * Purpose:	Arrange for rebuild() to be called once control returns
+ *		to the event loop.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	rebuildPending.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	A single user action can emit several of the signals
+ *		connected to this slot; they all result in one rebuild.
+ */
+
+void
+EditTabModel::queueRebuild()
+{
+    if (rebuildPending)
+	return;
+
+    rebuildPending = true;
+    QTimer::singleShot(0, this, SLOT(rebuild()));
+}
+
+
+
+/*
+ * Name:	itemAt()
+ * Purpose:	Find the canvas item shown in a given row.
+ * Arguments:	The row.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The item, or nullptr if the row is invalid or its item
+ *		has been deleted since the last rebuild().
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	None.
+ */
+
+QGraphicsObject *
+EditTabModel::itemAt(int row) const
+{
+    if (row < 0 || row >= rows.count())
+	return nullptr;
+
+    return rows.at(row).item.data();
+}
+
+
+
+/*
+ * Name:	rowOf()
+ * Purpose:	Find the row showing a given canvas item.
+ * Arguments:	The item.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The row, or -1 if the item is not in the model.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	None.
+ */
+
+int
+EditTabModel::rowOf(QGraphicsItem * item) const
+{
+    int row = rowIndex.value(item, -1);
+
+    if (row < 0 || rows.at(row).item.data() != item)
+	return -1;
+
+    return row;
+}
+
+
+
+/*
+ * Name:	setHighlighted()
+ * Purpose:	Show the row of the given item in bold (or no row, if
+ *		item is nullptr).
+ * Arguments:	The item whose label is being edited on the canvas.
+ * Outputs:	Nothing.
+ * Modifies:	highlighted.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	This replaces HTML_Label::editTabLabel, which pointed
+ *		to a QLabel in the old edit tab.
+ */
+
+void
+EditTabModel::setHighlighted(QGraphicsItem * item)
+{
+    QGraphicsItem * old = highlighted;
+
+    highlighted = item;
+    itemChanged(old);
+    itemChanged(item);
+}
+
+
+
+/*
+ * Name:	itemChanged()
+ * Purpose:	Tell the view(s) that the properties of an item were
+ *		changed from somewhere other than this model.
+ * Arguments:	The item (which may be nullptr).
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	None.
+ */
+
+void
+EditTabModel::itemChanged(QGraphicsItem * item)
+{
+    int row = rowOf(item);
+
+    if (row >= 0)
+	emit dataChanged(index(row, 0), index(row, ColumnCount - 1));
+}
+
+
+
+/*
+ * Name:	data()
+ * Purpose:	Return the value of one property of one item.
+ * Arguments:	The index and the role.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The value, or an invalid QVariant if the item does not
+ *		have that property (or no longer exists).
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	The colour columns return a QColor for the decoration
+ *		and edit roles and nothing for the display role, so that
+ *		the view draws a swatch rather than a colour name.
+ *		The label size is returned as an int so that the editor
+ *		is a QSpinBox, as it was before.
+ */
+
+QVariant
+EditTabModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= rows.count())
+	return QVariant();
+
+    const Row &row = rows.at(index.row());
+    QGraphicsObject * item = row.item.data();
+    int col = index.column();
+
+    if (item == nullptr)
+	return QVariant();
+
+    if (role == Qt::FontRole)
+    {
+	if (item != highlighted)
+	    return QVariant();
+	QFont font;
+	font.setBold(true);
+	return font;
+    }
+
+    if (role == Qt::DecorationRole)
+    {
+	if (col != LineCol && col != FillCol)
+	    return QVariant();
+	role = Qt::EditRole;
+    }
+    else if (role == Qt::DisplayRole)
+    {
+	if (col == LineCol || col == FillCol)
+	    return QVariant();
+    }
+    else if (role != Qt::EditRole)
+	return QVariant();
+
+    if (row.type == Graph::Type)
+    {
+	if (col == ItemCol)
+	    return tr("Graph");
+    }
+    else if (row.type == Node::Type)
+    {
+	Node * node = qgraphicsitem_cast<Node *>(item);
+	switch (col)
+	{
+	  case ItemCol:
+	    return tr("Node");
+	  case WidthCol:
+	    return node->getPenWidth();
+	  case DiamCol:
+	    return node->getDiameter();
+	  case LabelCol:
+	    return node->getLabel();
+	  case SizeCol:
+	    return qRound(node->getLabelSize());
+	  case LineCol:
+	    return node->getLineColour();
+	  case FillCol:
+	    return node->getFillColour();
+	}
+    }
+    else if (row.type == Edge::Type)
+    {
+	Edge * edge = qgraphicsitem_cast<Edge *>(item);
+	switch (col)
+	{
+	  case ItemCol:
+	    return tr("Edge");
+	  case WidthCol:
+	    return edge->getPenWidth();
+	  case LabelCol:
+	    return edge->getLabel();
+	  case SizeCol:
+	    return qRound(edge->getLabelSize());
+	  case LineCol:
+	    return edge->getColour();
+	}
+    }
+    else if (row.type == EdgeBundle::Type)
+    {
+	EdgeBundle * bundle = qgraphicsitem_cast<EdgeBundle *>(item);
+	switch (col)
+	{
+	  case ItemCol:
+	    return tr("Edges (%1)").arg(bundle->count());
+	  case WidthCol:
+	    return bundle->getPenWidth();
+	  case SizeCol:
+	    return qRound(bundle->getLabelSize());
+	  case LineCol:
+	    return bundle->getColour();
+	}
+    }
+    return QVariant();
+}
+
+
+
+/*
+ * Name:	setData()
+ * Purpose:	Change one property of one item.
+ * Arguments:	The index, the new value and the role.
+ * Outputs:	Nothing.
+ * Modifies:	The item on the canvas.
+ * Returns:	True iff the property was changed.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	These are the same calls the old per-item controllers
+ *		made when their widgets changed.
+ */
+
+bool
+EditTabModel::setData(const QModelIndex &index, const QVariant &value,
+		      int role)
+{
+    if (role != Qt::EditRole || !(flags(index) & Qt::ItemIsEditable))
+	return false;
+
+    const Row &row = rows.at(index.row());
+
+    if (row.type == Node::Type)
+    {
+	Node * node = qgraphicsitem_cast<Node *>(row.item.data());
+	switch (index.column())
+	{
+	  case WidthCol:
+	    node->setPenWidth(value.toDouble());
+	    break;
+	  case DiamCol:
+	    node->setDiameter(value.toDouble());
+	    break;
+	  case LabelCol:
+	    node->setNodeLabel(value.toString());
+	    break;
+	  case SizeCol:
+	    node->setNodeLabelSize(value.toInt());
+	    break;
+	  case LineCol:
+	    node->setLineColour(value.value<QColor>());
+	    break;
+	  case FillCol:
+	    node->setFillColour(value.value<QColor>());
+	    break;
+	}
+    }
+    else if (row.type == EdgeBundle::Type)
+    {
+	EdgeBundle * bundle
+	    = qgraphicsitem_cast<EdgeBundle *>(row.item.data());
+	switch (index.column())
+	{
+	  case WidthCol:
+	    bundle->setPenWidth(value.toDouble());
+	    break;
+	  case SizeCol:
+	    bundle->setEdgeLabelSize(value.toInt());
+	    break;
+	  case LineCol:
+	    bundle->setColour(value.value<QColor>());
+	    break;
+	}
+    }
+    else
+    {
+	Edge * edge = qgraphicsitem_cast<Edge *>(row.item.data());
+	switch (index.column())
+	{
+	  case WidthCol:
+	    edge->setPenWidth(value.toDouble());
+	    break;
+	  case LabelCol:
+	    edge->setEdgeLabel(value.toString());
+	    break;
+	  case SizeCol:
+	    edge->setEdgeLabelSize(value.toInt());
+	    break;
+	  case LineCol:
+	    edge->setColour(value.value<QColor>());
+	    break;
+	}
+    }
+
+    emit dataChanged(index, index);
+    return true;
+}
+
+
+
+/*
+ * Name:	flags()
+ * Purpose:	Say which cells may be edited.
+ * Arguments:	The index.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The item flags.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	Graph rows and cells for properties an item does not
+ *		have (an edge's diameter or fill colour, a bundle's
+ *		label) are read-only, as are rows whose item has been
+ *		deleted.
+ */
+
+Qt::ItemFlags
+EditTabModel::flags(const QModelIndex &index) const
+{
+    if (!index.isValid() || index.row() >= rows.count())
+	return Qt::NoItemFlags;
+
+    const Row &row = rows.at(index.row());
+    Qt::ItemFlags f = Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+
+    if (row.item.isNull() || row.type == Graph::Type
+	|| index.column() == ItemCol)
+	return f;
+
+    if (row.type == Edge::Type
+	&& (index.column() == DiamCol || index.column() == FillCol))
+	return f;
+
+    if (row.type == EdgeBundle::Type && index.column() != WidthCol
+	&& index.column() != SizeCol && index.column() != LineCol)
+	return f;
+
+    return f | Qt::ItemIsEditable;
+}
+
+
+
+QVariant
+EditTabModel::headerData(int section, Qt::Orientation orientation,
+			 int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+	return QVariant();
+
+    switch (section)
+    {
+      case ItemCol:
+	return tr("Item");
+      case WidthCol:
+	return tr("Width");
+      case DiamCol:
+	return tr("Diam");
+      case LabelCol:
+	return tr("Label");
+      case SizeCol:
+	return tr("Size");
+      case LineCol:
+	return tr("Line");
+      case FillCol:
+	return tr("Fill");
+    }
+    return QVariant();
+}
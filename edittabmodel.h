@@ -0,0 +1,69 @@
+/*
+ * File:	edittabmodel.h
+ * Author:	agent
+ * Date:	2026-10-18
+ * Version:	1.0
+ *
+ * Purpose:	Declare the model behind the "Edit Graph" tab.  Each row
+ *		of the model is a graph, node or edge on the canvas, and
+ *		each column is one of the properties which can be
+ *		edited from that tab.
+ *
+ * Modification history:
+ * Oct 18, 2026 (agent V1.0)
+ *  (a) Initial version.
+ */
+
+#ifndef EDITTABMODEL_H
+#define EDITTABMODEL_H
+
+#include <QAbstractTableModel>
+#include <QGraphicsObject>
+#include <QGraphicsScene>
+#include <QHash>
+#include <QPointer>
+#include <QVector>
+
+class EditTabModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+  public:
+    enum { ItemCol, WidthCol, DiamCol, LabelCol, SizeCol, LineCol, FillCol,
+	   ColumnCount };
+
+    explicit EditTabModel(QGraphicsScene * aScene, QObject * parent = 0);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+    bool setData(const QModelIndex &index, const QVariant &value,
+		 int role = Qt::EditRole);
+    Qt::ItemFlags flags(const QModelIndex &index) const;
+    QVariant headerData(int section, Qt::Orientation orientation,
+			int role = Qt::DisplayRole) const;
+
+    QGraphicsObject * itemAt(int row) const;
+    int rowOf(QGraphicsItem * item) const;
+    void setHighlighted(QGraphicsItem * item);
+    void itemChanged(QGraphicsItem * item);
+
+  public slots:
+    void rebuild();
+    void queueRebuild();
+
+  private:
+    struct Row
+    {
+	int type;
+	QPointer<QGraphicsObject> item;
+    };
+
+    QGraphicsScene * scene;
+    QVector<Row> rows;
+    QHash<QGraphicsItem *, int> rowIndex;
+    QGraphicsItem * highlighted;
+    bool rebuildPending;
+};
+
+#endif // EDITTABMODEL_H
@@ -0,0 +1,503 @@
+/*
+ * File:	forcelayout.cpp
+ * Author:	agent
+ * Date:	2026-10-18
+ * Version:	1.0
+ *
+ * Purpose:	A force-directed (Fruchterman-Reingold) layout engine.
+ *
+ *		The engine works on a plain array of coordinates and an
+ *		array of (index, index) edges, never on QGraphicsItems,
+ *		so it can be run on a worker thread while the GUI
+ *		carries on; the caller writes the final positions back
+ *		to the nodes in one batch.
+ *
+ *		Each iteration the bodies are put into a Barnes-Hut
+ *		quadtree (built serially, it is cheap), and the
+ *		repulsive force on each body is found by walking the
+ *		tree, treating a cell which is far enough away as a
+ *		single body at its centre of mass.  That makes the
+ *		repulsion O(n log n) rather than O(n^2), and since the
+ *		tree is read-only while it is walked, the bodies are
+ *		split into chunks which are done in parallel.  The
+ *		(much cheaper) attraction along the edges is done
+ *		serially, then every body is moved along its net force,
+ *		by at most the current "temperature", which cools
+ *		linearly over the iterations.
+ *
+ * Modification history:
+ * Oct 18, 2026 (agent V1.0)
+ *  (a) Initial version.
+ */
+
+#include "forcelayout.h"
+
+#include <QThread>
+#include <QVarLengthArray>
+#include <QtConcurrent>
+#include <qmath.h>
+
+// A cell is treated as one body if (its width / distance) < THETA.
+#define THETA		1.0
+
+// Coincident bodies stay together in a leaf below this depth.
+#define MAX_DEPTH	24
+
+// The pull towards the centroid (which keeps disconnected pieces
+// from drifting apart), as a fraction of the distance.
+#define GRAVITY		0.01
+
+// Don't bother splitting up less work than this between threads.
+#define MIN_CHUNK	256
+
+typedef struct layoutChunk
+{
+    const ForceLayout * layout;
+    int		first, last;	// Bodies [first, last).
+    QPointF *	out;		// The layout's displacements.
+} Layout_Chunk;
+
+
+
+/*
+ * Name:	ForceLayout()
+ * Purpose:	Constructor.
+ * Arguments:	The starting positions of the bodies, the edges between
+ *		them, and the ideal edge length.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	The indices in the edges are valid.
+ * Bugs:	None known.
+ * Notes:	If the bodies all start (nearly) on top of each other,
+ *		they are spread out on a grid first, since the forces
+ *		between coincident bodies have no direction.
+ */
+
+ForceLayout::ForceLayout(const QVector<QPointF> &positions,
+			 const QVector<Layout_Edge> &edges, qreal edgeLength)
+{
+    pos = positions;
+    this->edges = edges;
+    k = edgeLength > 0 ? edgeLength : 1;
+
+    int n = pos.size();
+    if (n < 2)
+	return;
+
+    QPointF centre;
+    qreal minX = pos[0].x(), maxX = minX;
+    qreal minY = pos[0].y(), maxY = minY;
+    foreach (QPointF p, pos)
+    {
+	centre += p;
+	minX = qMin(minX, p.x());
+	maxX = qMax(maxX, p.x());
+	minY = qMin(minY, p.y());
+	maxY = qMax(maxY, p.y());
+    }
+    centre /= n;
+
+    if (maxX - minX < k && maxY - minY < k)
+    {
+	int cols = qCeil(qSqrt(n));
+	QPointF origin = centre - QPointF(cols - 1, (n - 1) / cols) * k / 2;
+	for (int i = 0; i < n; i++)
+	    pos[i] = origin + QPointF(i % cols, i / cols) * k;
+    }
+}
+
+
+
+/*
+ * Name:	positions()
+ * Purpose:	Return the current coordinates of the bodies.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The coordinates, in the order they were given.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	None.
+ */
+
+QVector<QPointF>
+ForceLayout::positions() const
+{
+    return pos;
+}
+
+
+
+/*
+ * Name:	run()
+ * Purpose:	Run the layout.
+ * Arguments:	The number of iterations.
+ * Outputs:	Nothing.
+ * Modifies:	pos, disp, cells
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Blocks until done; the caller decides which thread to
+ *		run it on.  The repulsion is done on the global thread
+ *		pool, which is fine even if this is itself running on a
+ *		pool thread, since blockingMap() lets the waiting thread
+ *		do some of the work.
+ *		The starting temperature is about a tenth of the width
+ *		of the final drawing (roughly k * sqrt(n)).
+ */
+
+void
+ForceLayout::run(int iterations)
+{
+    int n = pos.size();
+    if (n < 2 || iterations < 1)
+	return;
+
+    int nChunks = qMax(1, qMin(n / MIN_CHUNK,
+			       QThread::idealThreadCount() * 4));
+    int chunkSize = (n + nChunks - 1) / nChunks;
+
+    qreal t0 = qMax(k, k * qSqrt(n) / 10);
+    for (int iter = 0; iter < iterations; iter++)
+    {
+	disp = QVector<QPointF>(n);
+	buildTree();
+
+	QVector<Layout_Chunk> chunks;
+	for (int first = 0; first < n; first += chunkSize)
+	{
+	    Layout_Chunk chunk;
+	    chunk.layout = this;
+	    chunk.first = first;
+	    chunk.last = qMin(first + chunkSize, n);
+	    chunk.out = disp.data();
+	    chunks.append(chunk);
+	}
+	if (chunks.size() == 1)
+	    repelChunk(chunks[0]);
+	else
+	    QtConcurrent::blockingMap(chunks, repelChunk);
+
+	attract();
+	move(qMax(t0 * (iterations - iter) / iterations, k / 100));
+    }
+    cells.clear();
+    disp.clear();
+}
+
+
+
+/*
+ * Name:	buildTree()
+ * Purpose:	Build the Barnes-Hut quadtree of the current positions.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	cells
+ * Returns:	Nothing.
+ * Assumptions:	pos is not empty.
+ * Bugs:	None known.
+ * Notes:	The root is the smallest square (plus a little) which
+ *		holds all of the bodies.
+ */
+
+void
+ForceLayout::buildTree()
+{
+    qreal minX = pos[0].x(), maxX = minX;
+    qreal minY = pos[0].y(), maxY = minY;
+    foreach (QPointF p, pos)
+    {
+	minX = qMin(minX, p.x());
+	maxX = qMax(maxX, p.x());
+	minY = qMin(minY, p.y());
+	maxY = qMax(maxY, p.y());
+    }
+
+    Quad_Cell root;
+    root.centre = QPointF((minX + maxX) / 2, (minY + maxY) / 2);
+    root.half = qMax(maxX - minX, maxY - minY) / 2 * 1.01 + k / 100;
+    root.mass = 0;
+    root.child[0] = root.child[1] = root.child[2] = root.child[3] = -1;
+    root.body = -1;
+
+    cells.clear();
+    cells.reserve(pos.size() * 2);
+    cells.append(root);
+    for (int i = 0; i < pos.size(); i++)
+	insert(i);
+    finishTree();
+}
+
+
+
+/*
+ * Name:	child()
+ * Purpose:	Find (making it if need be) one of a cell's children.
+ * Arguments:	The cell's index and the quadrant.
+ * Outputs:	Nothing.
+ * Modifies:	cells
+ * Returns:	The child's index.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	Quadrant bit 0 is set for the right half, bit 1 for the
+ *		bottom half.  Appending may move the cells, so callers
+ *		must not hold references into cells across a call.
+ */
+
+int
+ForceLayout::child(int cell, int quadrant)
+{
+    if (cells[cell].child[quadrant] >= 0)
+	return cells[cell].child[quadrant];
+
+    Quad_Cell c;
+    c.half = cells[cell].half / 2;
+    c.centre = cells[cell].centre
+	+ QPointF(quadrant & 1 ? c.half : -c.half,
+		  quadrant & 2 ? c.half : -c.half);
+    c.mass = 0;
+    c.child[0] = c.child[1] = c.child[2] = c.child[3] = -1;
+    c.body = -1;
+    cells.append(c);
+    cells[cell].child[quadrant] = cells.size() - 1;
+    return cells.size() - 1;
+}
+
+
+
+/*
+ * Name:	insert()
+ * Purpose:	Add a body to the quadtree.
+ * Arguments:	The body's index.
+ * Outputs:	Nothing.
+ * Modifies:	cells
+ * Returns:	Nothing.
+ * Assumptions:	The body is inside the root cell.
+ * Bugs:	None known.
+ * Notes:	Each cell on the way down gets the body's mass and
+ *		position added to it (finishTree() turns the sums into
+ *		centres of mass).  An occupied leaf is split and its
+ *		body pushed down, unless it is already MAX_DEPTH deep,
+ *		in which case the bodies are (as good as) coincident and
+ *		the leaf just counts them.
+ */
+
+void
+ForceLayout::insert(int body)
+{
+    const QPointF p = pos[body];
+    int c = 0;
+
+    for (int depth = 0; ; depth++)
+    {
+	cells[c].mass += 1;
+	cells[c].com += p;
+
+	Quad_Cell &cell = cells[c];
+	bool leaf = cell.child[0] < 0 && cell.child[1] < 0
+	    && cell.child[2] < 0 && cell.child[3] < 0;
+	if (leaf)
+	{
+	    if (cell.mass == 1)
+	    {
+		cell.body = body;
+		return;
+	    }
+	    if (depth >= MAX_DEPTH)
+		return;
+
+	    int old = cell.body;
+	    QPointF centre = cell.centre;
+	    cell.body = -1;
+	    int oc = child(c, (pos[old].x() >= centre.x() ? 1 : 0)
+			   | (pos[old].y() >= centre.y() ? 2 : 0));
+	    cells[oc].mass = 1;
+	    cells[oc].com = pos[old];
+	    cells[oc].body = old;
+	}
+
+	QPointF centre = cells[c].centre;
+	c = child(c, (p.x() >= centre.x() ? 1 : 0)
+		  | (p.y() >= centre.y() ? 2 : 0));
+    }
+}
+
+
+
+/*
+ * Name:	finishTree()
+ * Purpose:	Turn the position sums of the cells into centres of mass.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	cells
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	None.
+ */
+
+void
+ForceLayout::finishTree()
+{
+    for (int i = 0; i < cells.size(); i++)
+    {
+	if (cells[i].mass > 0)
+	    cells[i].com /= cells[i].mass;
+    }
+}
+
+
+
+/*
+ * Name:	repelChunk()
+ * Purpose:	Find the repulsive forces on one chunk of the bodies.
+ * Arguments:	The chunk.
+ * Outputs:	Nothing.
+ * Modifies:	The chunk's part of the layout's displacements.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	Called on a pool thread via QtConcurrent.  The chunks
+ *		write to disjoint parts of disp (through a pointer taken
+ *		on the calling thread, so that no thread can trigger a
+ *		detach) and only read everything else.
+ */
+
+void
+ForceLayout::repelChunk(Layout_Chunk &chunk)
+{
+    chunk.layout->repel(chunk.first, chunk.last, chunk.out);
+}
+
+
+
+/*
+ * Name:	repel()
+ * Purpose:	Add the repulsive forces on some bodies to their
+ *		displacements.
+ * Arguments:	The range [first, last) of bodies, and the array of
+ *		displacements.
+ * Outputs:	Nothing.
+ * Modifies:	out[first .. last - 1]
+ * Returns:	Nothing.
+ * Assumptions:	The quadtree is up to date.
+ * Bugs:	None known.
+ * Notes:	The Fruchterman-Reingold repulsion between two bodies a
+ *		distance d apart is k^2 / d.  Bodies which sit right on
+ *		top of each other (in the same MAX_DEPTH leaf) are given
+ *		a small push in a direction which depends on the body,
+ *		so that they separate.
+ */
+
+void
+ForceLayout::repel(int first, int last, QPointF * out) const
+{
+    const QPointF * p = pos.constData();
+    const Quad_Cell * tree = cells.constData();
+    const qreal k2 = k * k;
+    const qreal tooClose = k2 / 1e6;
+    QVarLengthArray<int, 4 * MAX_DEPTH + 4> stack;
+
+    for (int i = first; i < last; i++)
+    {
+	QPointF force;
+
+	stack.clear();
+	stack.append(0);
+	while (!stack.isEmpty())
+	{
+	    const Quad_Cell &cell = tree[stack.last()];
+	    stack.removeLast();
+
+	    bool leaf = cell.child[0] < 0 && cell.child[1] < 0
+		&& cell.child[2] < 0 && cell.child[3] < 0;
+	    if (leaf && cell.body == i && cell.mass == 1)
+		continue;
+
+	    QPointF d = p[i] - cell.com;
+	    qreal dist2 = d.x() * d.x() + d.y() * d.y();
+	    if (!leaf && 4 * cell.half * cell.half >= THETA * THETA * dist2)
+	    {
+		for (int q = 0; q < 4; q++)
+		{
+		    if (cell.child[q] >= 0 && tree[cell.child[q]].mass > 0)
+			stack.append(cell.child[q]);
+		}
+		continue;
+	    }
+
+	    if (dist2 < tooClose)
+	    {
+		qreal angle = i * 2.39996323;	// The golden angle.
+		force += QPointF(qCos(angle), qSin(angle)) * k / 10;
+	    }
+	    else
+		force += d * (k2 * cell.mass / dist2);
+	}
+	out[i] += force;
+    }
+}
+
+
+
+/*
+ * Name:	attract()
+ * Purpose:	Add the attractive forces along the edges (and towards
+ *		the centroid) to the displacements.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	disp
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	The attraction along an edge of length d is d^2 / k.
+ */
+
+void
+ForceLayout::attract()
+{
+    QPointF centroid;
+    foreach (QPointF p, pos)
+	centroid += p;
+    centroid /= pos.size();
+
+    for (int i = 0; i < pos.size(); i++)
+	disp[i] -= (pos[i] - centroid) * GRAVITY;
+
+    foreach (Layout_Edge e, edges)
+    {
+	if (e.source == e.dest)
+	    continue;
+	QPointF d = pos[e.source] - pos[e.dest];
+	QPointF f = d * (qSqrt(d.x() * d.x() + d.y() * d.y()) / k);
+	disp[e.source] -= f;
+	disp[e.dest] += f;
+    }
+}
+
+
+
+/*
+ * Name:	move()
+ * Purpose:	Move each body along its displacement.
+ * Arguments:	The maximum distance any body may move.
+ * Outputs:	Nothing.
+ * Modifies:	pos
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	None.
+ */
+
+void
+ForceLayout::move(qreal temperature)
+{
+    for (int i = 0; i < pos.size(); i++)
+    {
+	QPointF d = disp[i];
+	qreal len = qSqrt(d.x() * d.x() + d.y() * d.y());
+	if (len > 0)
+	    pos[i] += d * (qMin(len, temperature) / len);
+    }
+}
@@ -0,0 +1,68 @@
+/*
+ * File:	forcelayout.h
+ * Author:	agent
+ * Date:	2026-10-18
+ * Version:	1.0
+ *
+ * Purpose:	Declare the ForceLayout class, a force-directed layout
+ *		engine which works on an array of coordinates.
+ *
+ * Modification history:
+ * Oct 18, 2026 (agent V1.0)
+ *  (a) Initial version.
+ */
+
+#ifndef FORCELAYOUT_H
+#define FORCELAYOUT_H
+
+#include <QPointF>
+#include <QVector>
+
+#define FL_ITERATIONS	200	// Default number of iterations.
+
+struct layoutChunk;
+
+typedef struct layoutEdge
+{
+    int source;			// Indices into the position array.
+    int dest;
+} Layout_Edge;
+
+typedef struct quadCell
+{
+    QPointF centre;		// Centre of this (square) cell.
+    qreal half;			// Half the width of the cell.
+    qreal mass;			// Number of bodies in the cell.
+    QPointF com;		// Their centre of mass.
+    int child[4];		// Indices into cells, or -1.
+    int body;			// The body in a leaf, or -1.
+} Quad_Cell;
+
+class ForceLayout
+{
+  public:
+    ForceLayout(const QVector<QPointF> &positions,
+		const QVector<Layout_Edge> &edges, qreal edgeLength);
+
+    void run(int iterations = FL_ITERATIONS);
+    QVector<QPointF> positions() const;
+
+  private:
+    void buildTree();
+    void insert(int body);
+    int child(int cell, int quadrant);
+    void finishTree();
+    void repel(int first, int last, QPointF * out) const;
+    void attract();
+    void move(qreal temperature);
+
+    static void repelChunk(struct layoutChunk &chunk);
+
+    QVector<QPointF>	pos;	// The current coordinates.
+    QVector<QPointF>	disp;	// This iteration's displacements.
+    QVector<Layout_Edge> edges;
+    QVector<Quad_Cell>	cells;	// The Barnes-Hut quadtree; cells[0] is root.
+    qreal		k;	// The ideal edge length.
+};
+
+#endif // FORCELAYOUT_H
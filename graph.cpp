@@ -2,7 +2,7 @@
  * File:    graph.cpp
  * Author:  Rachel Bood
  * Date:    2014/11/07 (?)
- * Version: 1.3
+ * Version: 1.10
  *
  * Purpose:
  *
@@ -18,19 +18,51 @@
  *  (a) Once again changed setRotation back to the July 20 change. The issue
  *      was that the GraphicsItem rotation call at the end of the function
  *      wasn't using the additive rotation value but instead the passed value.
+ * Oct 18, 2026 (agent V1.4)
+ *  (a) Added childMoved(), called from Node::itemChange() in place of
+ *      the old detach/reattach of the node to its graph.
+ * Oct 18, 2026 (agent V1.5)
+ *  (a) A graph may now keep (some of) its edges in an EdgeBundle.
+ *      Added getEdgeBundle(), expandEdges() and expandEdgesOf(), and
+ *      made childMoved() and setRotation() look after the bundle.
+ * Oct 18, 2026 (agent V1.6)
+ *  (a) paint() draws the lines of the graph's (own) edges, grouped
+ *      by pen, with one drawLines() per pen, instead of each Edge
+ *      drawing its own.  The graph's drawing is cached, so most
+ *      repaints of a dense graph no longer touch its edges at all.
+ * Oct 18, 2026 (agent V1.7)
+ *  (a) paint() doesn't antialias edges which are thinner than a
+ *      pixel on the screen.
+ * Oct 18, 2026 (agent V1.8)
+ *  (a) paint() tells an export from a view by isExporting() (see
+ *      defuns.h), not by the widget, which is null when a view paints
+ *      the graph's cache too.
+ * Oct 18, 2026 (agent V1.9)
+ *  (a) Added setExporting(), which also turns the graphs' caches off
+ *      while a scene is exported, so that exports draw the edges as
+ *      lines rather than as a copy of the cache pixmap.
+ * Oct 18, 2026 (agent V1.10)
+ *  (a) Added itemChange(), which tells the autosaver when the graph
+ *      (and so every node in it) moves.
  */
 
 #include "graph.h"
+#include "autosave.h"
 #include "canvasview.h"
+#include "defuns.h"
 #include "node.h"
 #include "edge.h"
+#include "edgebundle.h"
 #include "graphmimedata.h"
 
 #include <QMimeData>
 #include <QDrag>
 #include <QDebug>
 #include <QByteArray>
+#include <QGraphicsScene>
 #include <QGraphicsSceneMouseEvent>
+#include <QHash>
+#include <QStyleOptionGraphicsItem>
 #include <QtAlgorithms>
 #include <QApplication>
 #include <QtCore>
@@ -39,6 +71,13 @@
 
 #define MOVED   0
 
+// The edges of a graph which are drawn with the same pen.
+typedef struct penGroup
+{
+    QPen            pen;
+    QVector<QLineF> lines;
+} Pen_Group;
+
 static const bool verbose = false; // used for debugging
 
 /*
@@ -57,9 +96,14 @@ Graph::Graph()
     setFlag(ItemIsMovable);
     setFlag(ItemIsSelectable);
     setFlag(ItemIsFocusable);
+    // So that itemChange() hears about moves.
+    setFlag(ItemSendsGeometryChanges);
     setCacheMode(DeviceCoordinateCache);
+    // So that paint() can skip the edges outside an updated area.
+    setFlag(ItemUsesExtendedStyleOption);
     moved = 0;
     rotation = 0;
+    edgeBundle = nullptr;
     setAcceptHoverEvents(true);
     setZValue(0);
 }
@@ -100,22 +144,85 @@ void Graph::mouseReleaseEvent(QGraphicsSceneMouseEvent *event)
 
 /*
  * Name:        paint()
- * Purpose:     no purpose but required to implement for custom QGraphicsItems
+ * Purpose:     Draw the lines of the edges which are children of this
+ *              graph.
  * Arguments:   QPainter*, QStyleOptionGraphicsItem *, QWidget *
- * Output:      none
+ * Output:      The edges, to the painter.
  * Modifies:    none
  * Returns:     none
- * Assumptions: none
+ * Assumptions: The edges have been adjust()ed since their nodes moved.
  * Bugs:        none
- * Notes:       A Graph object is more of a container to house the nodes and edges
- *              therefore nothing is required to be drawn in a graph object
+ * Notes:       A Graph object is mostly a container to house the nodes
+ *              and edges, but drawing each Edge as its own item costs
+ *              a state change and a drawLine() per edge, so the graph
+ *              draws them instead: the edges are grouped by pen (in
+ *              the order they are found, so that the drawing doesn't
+ *              change from one paint to the next) and each group is
+ *              drawn with one drawLines().  The Edges are still items
+ *              (see Edge::paint()), so they are hit-tested as before,
+ *              and tell the graph where to redraw when they change
+ *              (see Edge::redraw()).  Only the edges which cross the
+ *              exposed rect are drawn.
+ *              Edges in subgraphs are drawn by the subgraphs, and
+ *              compact edges by the EdgeBundle.
+ *              In a view (but not in an exported image), lines
+ *              thinner than LOD_MIN_LINE_PIXELS are not antialiased.
  */
 void Graph::paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
                   QWidget *widget)
 {
-    Q_UNUSED(option);
     Q_UNUSED(widget);
-    Q_UNUSED(painter);
+
+    QVector<Pen_Group> groups;
+    QHash<QPair<const EdgeStyle *, int>, int> groupIndex;
+    QRectF exposed = option->exposedRect;
+
+    foreach (QGraphicsItem * child, childItems())
+    {
+        if (child->type() != Edge::Type || !child->isVisible())
+            continue;
+
+        Edge * edge = qgraphicsitem_cast<Edge *>(child);
+        QLineF line = edge->drawnLine();
+        if (qFuzzyCompare(line.length(), qreal(0.)))
+            continue;
+        line = QLineF(edge->mapToParent(line.p1()),
+                      edge->mapToParent(line.p2()));
+        qreal w = edge->style()->penWidth;
+        if (!QRectF(line.p1(), line.p2()).normalized()
+            .adjusted(-w, -w, w, w).intersects(exposed))
+            continue;
+
+        QPair<const EdgeStyle *, int> key(edge->style(),
+                                          edge->getPenStyle());
+        int i = groupIndex.value(key, -1);
+        if (i < 0)
+        {
+            i = groups.count();
+            groupIndex.insert(key, i);
+            Pen_Group group;
+            group.pen = edge->pen();
+            groups.append(group);
+        }
+        groups[i].lines.append(line);
+    }
+
+    bool exporting = isExporting(scene());
+    qreal lod = exporting ? 0
+        : QStyleOptionGraphicsItem::levelOfDetailFromTransform(
+            painter->worldTransform());
+    bool antialiased = painter->testRenderHint(QPainter::Antialiasing);
+    foreach (const Pen_Group &group, groups)
+    {
+        painter->setRenderHint(QPainter::Antialiasing,
+                               antialiased
+                               && (exporting
+                                   || group.pen.widthF() * lod
+                                   >= LOD_MIN_LINE_PIXELS));
+        painter->setPen(group.pen);
+        painter->drawLines(group.lines);
+    }
+    painter->setRenderHint(QPainter::Antialiasing, antialiased);
 }
 
 /*
@@ -179,6 +286,15 @@ void Graph::setRotation(qreal aRotation, bool keepRotation)
                     else
                         edge->setRotation(-aRotation);
                 }
+                else if (child->type() == EdgeBundle::Type)
+                {
+                    // Only matters for the Edges made from it later.
+                    if (keepRotation)
+                        child->setRotation(child->rotation() + -aRotation);
+                    else
+                        child->setRotation(-aRotation);
+                    qgraphicsitem_cast<EdgeBundle *>(child)->nodesMoved();
+                }
                 list.removeOne(child);
             }
         }
@@ -229,3 +345,175 @@ QGraphicsItem *Graph::getRootParent()
     return parent;
 }
 
+
+
+/*
+ * Name:        childMoved()
+ * Purpose:     Tell the scene that the bounding rect of this graph may
+ *              have changed because one of its children moved.
+ * Arguments:   none
+ * Output:      none
+ * Modifies:    the scene's index for this graph
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       boundingRect() is childrenBoundingRect(), which Qt
+ *              recomputes on demand, but the scene's index is not
+ *              told about it unless prepareGeometryChange() is called.
+ *              Node::itemChange() used to get the same effect by
+ *              removing and re-adding the node to the graph on every
+ *              mouse move, which is far more expensive.
+ */
+void Graph::childMoved()
+{
+    prepareGeometryChange();
+    if (edgeBundle != nullptr)
+        edgeBundle->nodesMoved();
+}
+
+
+
+/*
+ * Name:        itemChange()
+ * Purpose:     Tell the autosaver when the graph moves in the scene.
+ * Arguments:   The change and its value.
+ * Output:      none
+ * Modifies:    none
+ * Returns:     The value from QGraphicsObject::itemChange().
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       The nodes' own positions don't change, so they don't
+ *              hear about it (see AutoSaver::graphMoved()).
+ */
+QVariant Graph::itemChange(GraphicsItemChange change, const QVariant &value)
+{
+    switch (change)
+    {
+      case ItemPositionHasChanged:
+      case ItemRotationHasChanged:
+      case ItemTransformHasChanged:
+      case ItemParentHasChanged:
+        AutoSaver::graphMoved(this);
+        break;
+
+      default:
+        break;
+    }
+
+    return QGraphicsObject::itemChange(change, value);
+}
+
+
+
+/*
+ * Name:        getEdgeBundle()
+ * Purpose:     Return the EdgeBundle holding this graph's compact edges.
+ * Arguments:   If create is true, make a bundle if there is none.
+ * Output:      none
+ * Modifies:    edgeBundle (if create)
+ * Returns:     The bundle, or nullptr if there is none (and !create).
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       The bundle is a child item of this graph.
+ */
+EdgeBundle * Graph::getEdgeBundle(bool create)
+{
+    if (edgeBundle == nullptr && create)
+        edgeBundle = new EdgeBundle(this);
+    return edgeBundle;
+}
+
+
+
+/*
+ * Name:        expandEdges()
+ * Purpose:     Replace the compact edges of this graph and all of its
+ *              subgraphs by full Edges.
+ * Arguments:   none
+ * Output:      none
+ * Modifies:    the graph(s), and the edgeLists of their nodes
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       This must be done before anything which looks at the
+ *              nodes' edgeLists or moves items between graphs (saving,
+ *              joining, deleting, ...).  It does nothing for a graph
+ *              which has no bundle.
+ */
+void Graph::expandEdges()
+{
+    QList<Graph *> list;
+    list.append(this);
+
+    for (int i = 0; i < list.count(); i++)
+    {
+        Graph * graph = list.at(i);
+        foreach (QGraphicsItem * child, graph->childItems())
+            if (child->type() == Graph::Type)
+                list.append(qgraphicsitem_cast<Graph *>(child));
+
+        if (graph->edgeBundle != nullptr)
+        {
+            graph->edgeBundle->expand();
+            delete graph->edgeBundle;
+            graph->edgeBundle = nullptr;
+        }
+    }
+}
+
+
+
+/*
+ * Name:        expandEdgesOf()
+ * Purpose:     Call expandEdges() on the root graph of an item.
+ * Arguments:   The item (a node, edge, bundle, ...), or nullptr.
+ * Output:      none
+ * Modifies:    see expandEdges()
+ * Returns:     none
+ * Assumptions: none
+ * Bugs:        none
+ * Notes:       none
+ */
+void Graph::expandEdgesOf(QGraphicsItem * item)
+{
+    if (item == nullptr)
+        return;
+
+    while (item->parentItem() != nullptr)
+        item = item->parentItem();
+
+    if (item->type() == Graph::Type)
+        qgraphicsitem_cast<Graph *>(item)->expandEdges();
+}
+
+
+
+/*
+ * Name:        setExporting()
+ * Purpose:     Mark a scene as being drawn into a file (or anything
+ *              else which is not a view), or as no longer being so.
+ * Arguments:   The scene, and true at the start of the export, false
+ *              (or whatever it was before) at the end.
+ * Output:      none
+ * Modifies:    the scene's EXPORTING_PROPERTY, and the cache mode of
+ *              each graph in the scene
+ * Returns:     none
+ * Assumptions: The graphs are already in the scene.
+ * Bugs:        none
+ * Notes:       A graph normally keeps a device coordinate cache of its
+ *              drawing (see Graph()).  Rendering a cached item to an
+ *              SVG generator or a QPicture copies the cache pixmap,
+ *              so an SVG file got an <image> of the edges, and a tiled
+ *              export (which replays a QPicture at a higher scale) got
+ *              blocky edges.  So the graphs are not cached while the
+ *              scene is exported.
+ */
+void Graph::setExporting(QGraphicsScene * scene, bool exporting)
+{
+    scene->setProperty(EXPORTING_PROPERTY, exporting);
+    foreach (QGraphicsItem * item, scene->items())
+    {
+        if (item->type() == Graph::Type)
+            item->setCacheMode(exporting ? NoCache : DeviceCoordinateCache);
+    }
+}
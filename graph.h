@@ -2,7 +2,7 @@
  * File:	graph.h
  * Author:	Rachel Bood
  * Date:	2014 or 2015?
- * Version:	1.1
+ * Version:	1.6
  *
  * Purpose:	Define the graph class.
  *
@@ -14,6 +14,18 @@
  * June 17, 2020 (IC V1.1)
  *  (a) Changed class type from QGraphicsItem to QGraphicsObject for access to
  *      destroyed() signal in connect statements for graphs.
+ * Oct 18, 2026 (agent V1.2)
+ *  (a) Added childMoved() so a node can tell its graph that the
+ *      graph's bounding rect changed without being re-parented.
+ * Oct 18, 2026 (agent V1.3)
+ *  (a) Added getEdgeBundle(), expandEdges() and expandEdgesOf() for
+ *	graphs whose edges are kept in an EdgeBundle.
+ * Oct 18, 2026 (agent V1.4)
+ *  (a) paint() now draws the lines of the graph's edges.
+ * Oct 18, 2026 (agent V1.5)
+ *  (a) Added setExporting().
+ * Oct 18, 2026 (agent V1.6)
+ *  (a) Added itemChange().
  */
 
 #ifndef GRAPH_H
@@ -23,8 +35,10 @@
 #include "cornergrabber.h"
 
 class CanvasView;
+class QGraphicsScene;
 class Node;
 class Edge;
+class EdgeBundle;
 
 class Graph : public QGraphicsObject
 {
@@ -52,8 +66,14 @@ public:
     void setRotation(qreal aRotation, bool keepRotation);
     qreal getRotation();
     QGraphicsItem * getRootParent();
+    void childMoved();
+    EdgeBundle * getEdgeBundle(bool create = false);
+    void expandEdges();
+    static void expandEdgesOf(QGraphicsItem * item);
+    static void setExporting(QGraphicsScene * scene, bool exporting);
 
 protected:
+    QVariant itemChange(GraphicsItemChange change, const QVariant &value);
     void mouseReleaseEvent(QGraphicsSceneMouseEvent * event);
     void paint(QPainter * painter,
 	       const QStyleOptionGraphicsItem * option,
@@ -62,6 +82,7 @@ protected:
 private:
      int moved;		// 1 means the graph was dropped onto the canvas.
      qreal rotation;
+     EdgeBundle * edgeBundle;	// Compact edges, if any.
 };
 
 #endif // GRAPH_H
@@ -0,0 +1,79 @@
+#-------------------------------------------------
+#
+# The sources of Graphic, less main.cpp.  Included by Graphic.pro
+# and by the tests (tests/bench/bench.pro), so that a new file only
+# has to be added here.
+#
+#-------------------------------------------------
+
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+# For reading gzipped .grphc files (compressedfile.cpp).
+LIBS += -lz
+
+SOURCES += \
+    $$PWD/autosave.cpp \
+    $$PWD/basicgraphs.cpp \
+    $$PWD/batchrender.cpp \
+    $$PWD/binaryformat.cpp \
+    $$PWD/canvasscene.cpp \
+    $$PWD/canvasview.cpp \
+    $$PWD/compressedfile.cpp \
+    $$PWD/cornergrabber.cpp \
+    $$PWD/dotformat.cpp \
+    $$PWD/edge.cpp \
+    $$PWD/edgebundle.cpp \
+    $$PWD/edgelist.cpp \
+    $$PWD/edittabdelegate.cpp \
+    $$PWD/edittabmodel.cpp \
+    $$PWD/forcelayout.cpp \
+    $$PWD/graph.cpp \
+    $$PWD/graphloader.cpp \
+    $$PWD/graphml.cpp \
+    $$PWD/graphmimedata.cpp \
+    $$PWD/html-label.cpp \
+    $$PWD/libraryindex.cpp \
+    $$PWD/mainwindow.cpp \
+    $$PWD/node.cpp \
+    $$PWD/preview.cpp \
+    $$PWD/settingsdialog.cpp \
+    $$PWD/styletable.cpp \
+    $$PWD/thumbnailcache.cpp \
+    $$PWD/tiledexport.cpp
+
+HEADERS += \
+    $$PWD/autosave.h \
+    $$PWD/basicgraphs.h \
+    $$PWD/batchrender.h \
+    $$PWD/binaryformat.h \
+    $$PWD/canvasscene.h \
+    $$PWD/canvasview.h \
+    $$PWD/compressedfile.h \
+    $$PWD/cornergrabber.h \
+    $$PWD/dotformat.h \
+    $$PWD/defuns.h \
+    $$PWD/edge.h \
+    $$PWD/edgebundle.h \
+    $$PWD/edgelist.h \
+    $$PWD/edittabdelegate.h \
+    $$PWD/edittabmodel.h \
+    $$PWD/forcelayout.h \
+    $$PWD/graph.h \
+    $$PWD/graphloader.h \
+    $$PWD/graphml.h \
+    $$PWD/graphmimedata.h \
+    $$PWD/html-label.h \
+    $$PWD/libraryindex.h \
+    $$PWD/mainwindow.h \
+    $$PWD/node.h \
+    $$PWD/preview.h \
+    $$PWD/settingsdialog.h \
+    $$PWD/styletable.h \
+    $$PWD/thumbnailcache.h \
+    $$PWD/tiledexport.h
+
+FORMS += $$PWD/mainwindow.ui \
+    $$PWD/settingsdialog.ui
+
+RESOURCES += $$PWD/application.qrc
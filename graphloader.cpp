@@ -0,0 +1,1206 @@
+/*
+ * File:	graphloader.cpp
+ * Author:	agent
+ * Date:	2026-10-18
+ * Version:	1.8
+ *
+ * Purpose:	Read .grphc files without freezing the GUI.
+ *
+ *		Loading a graph used to be done entirely by readGraphIc()
+ *		on the GUI thread: each line was parsed and the Node or
+ *		Edge it describes was made straight away, so a big file
+ *		froze the window until it was all done.  Now the work is
+ *		in two parts:
+ *		  parseGraphIc() reads and checks the text and fills in a
+ *		    Graph_Description, which holds only numbers, colours
+ *		    and strings; it touches no QGraphicsItems, so it can
+ *		    run on any thread;
+ *		  a GraphBuilder turns a Graph_Description into a Graph,
+ *		    as many items at a time as it is asked to make.
+ *		readGraphIc() just does one and then the other.  A
+ *		GraphLoader runs parseGraphIc() on a pool thread, and then
+ *		runs the GraphBuilder on the GUI thread LOAD_CHUNK_ITEMS
+ *		items at a time, going back to the event loop between
+ *		chunks.  It reports its progress (parsing is counted as
+ *		the first half) and can be cancelled at any time.
+ *		Edge lists are loaded the same way, with parseEdgeList()
+ *		(see edgelist.cpp) in place of parseGraphIc().
+ *
+ * Modification history:
+ * Oct 18, 2026 (agent V1.0)
+ *  (a) Initial version.
+ * Oct 18, 2026 (agent V1.1)
+ *  (a) Add initNodeDescription(), initEdgeDescription(),
+ *	completeDescription(), colourFromString() and
+ *	centreInInches() for the GraphML and DOT code.
+ * Oct 18, 2026 (agent V1.2)
+ *  (a) Add describeNode() and describeEdge(), used to take
+ *	snapshots of the canvas.
+ * Oct 18, 2026 (agent V1.3)
+ *  (a) GraphLoader::parse() reads through a CompressedFile, so
+ *	gzipped .grphc files can be loaded, and parseGraphIc()
+ *	reports a truncated or corrupt compressed file.
+ * Oct 18, 2026 (agent V1.4)
+ *  (a) Add describeEdges(), which the file writers use to find the
+ *	edges (including compact edges) of a set of nodes.
+ * Oct 18, 2026 (agent V1.5)
+ *  (a) build() no longer loses one of its items when it goes from
+ *	making nodes to making edges.
+ * Oct 18, 2026 (agent V1.6)
+ *  (a) Add isPlainEdge(), bundleKey() and chooseBundle() (from
+ *	readGraphBin()).  A GraphBuilder now puts the plain edges of
+ *	a big graph in its EdgeBundle, as readGraphBin() does, so a
+ *	.grphc file and its .grphb companion give the same graph.
+ * Oct 18, 2026 (agent V1.7)
+ *  (a) Add describeGraph(); centreInInches() takes descriptions,
+ *	since the writers now all work from a Graph_Description.
+ * Oct 18, 2026 (agent V1.8)
+ *  (a) A GraphLoader also loads edge lists, which it parses (and lays
+ *	out) with parseEdgeList() on the pool thread.
+ */
+
+#include "graphloader.h"
+#include "compressedfile.h"
+#include "defuns.h"
+#include "edge.h"
+#include "edgebundle.h"
+#include "edgelist.h"
+#include "forcelayout.h"
+#include "graph.h"
+#include "node.h"
+
+#include <QFile>
+#include <QHash>
+#include <QRegExp>
+#include <QSet>
+#include <QtConcurrent>
+
+// How many nodes and edges are made each time through the event loop.
+#define LOAD_CHUNK_ITEMS	2000
+
+// How often (in lines) the parser looks at the cancel flag.
+#define PARSE_CHECK_LINES	1024
+
+// The diameter (in inches) of imported nodes which don't say.
+#define IMPORT_NODE_DIAMETER	0.2
+
+
+
+/*
+ * Name:	parseGraphIc()
+ * Purpose:	Read a graph-ic (.grphc) description into a
+ *		Graph_Description.
+ * Arguments:	The stream to read from, the name of the file (for
+ *		error messages), the description to fill in, a string
+ *		to hold an error message, and (optionally) a flag which
+ *		is set to ask the parser to stop and a counter to hold
+ *		how far (in percent) through the file the parser is.
+ * Outputs:	Nothing.
+ * Modifies:	description, errorMessage, *percentDone.
+ * Returns:	True iff the whole file was read and is valid.
+ * Assumptions:	None.
+ * Bugs:	?
+ * Notes:	This is the parsing half of the old readGraphIc(), with
+ *		the same checks and error messages.  It makes no items,
+ *		and so is safe to call on any thread.
+ *		If the parse is cancelled, false is returned and
+ *		errorMessage is left empty.
+ *		The progress is worked out from the position of the
+ *		stream's device (if any), which is ahead of the text
+ *		actually parsed by at most the stream's buffer.
+ *		If the stream is reading a CompressedFile, the sizes
+ *		are those of the compressed file.
+ */
+
+bool
+parseGraphIc(QTextStream &in, QString graphName,
+	     Graph_Description &description, QString &errorMessage,
+	     QAtomicInt * cancelled, QAtomicInt * percentDone)
+{
+    int numOfNodes = -1;		// < 0 ==> haven't read numOfNodes yet
+    int lines = 0;
+    qint64 size = in.device() != nullptr ? in.device()->size() : 0;
+
+    description.nodes.clear();
+    description.edges.clear();
+
+    while (!in.atEnd())
+    {
+	if (++lines % PARSE_CHECK_LINES == 0)
+	{
+	    if (cancelled != nullptr && cancelled->loadAcquire())
+		return false;
+	    if (percentDone != nullptr && size > 0)
+		percentDone->storeRelease(in.device()->pos() * 100 / size);
+	}
+
+	QString line = in.readLine();
+	QString simpLine = line.simplified();
+	if (simpLine.isEmpty())
+	{
+	    // Allow visually blank lines
+	}
+	else if (simpLine.at(0).toLatin1() == '#')
+	{
+	    // Allow comments where first non-white is '#'.
+	    // TODO: Should we save these comments somewhere?
+	}
+	else if (numOfNodes < 0)
+	{
+	    bool ok;
+	    numOfNodes = line.toInt(&ok);
+	    // TODO: do we want to allow 0-node graphs?
+	    // Theoretically yes, but practically, no.
+	    if (! ok || numOfNodes < 0)
+	    {
+		errorMessage = "The file " + graphName
+		    + " has an invalid number of nodes.  "
+		    "Thus I can not read this file.";
+		return false;
+	    }
+	    description.nodes.reserve(numOfNodes);
+	}
+	else if (description.nodes.count() < numOfNodes)
+	{
+	    QStringList fields = line.split(",");
+
+	    // Nodes may or may not have label info.  Accept both.
+	    // Nominally, we want 11 or 13 (and this assumes we don't
+	    // want to record the label size if there is no label,
+	    // which is possibly not what we will eventually realize
+	    // we want).  But to avoid complex quoting of commas in
+	    // labels, we just glue all the fields past #12 into the
+	    // label.
+	    if (fields.count() < 11 || fields.count() == 12)
+	    {
+		errorMessage = "Node "
+		    + QString::number(description.nodes.count())
+		    + " of file " + graphName
+		    + " has an invalid number of fields.  "
+		    "Thus I can not read this file.";
+		return false;
+	    }
+
+	    Node_Description node;
+	    node.x = fields.at(0).toDouble();
+	    node.y = fields.at(1).toDouble();
+	    node.diameter = fields.at(2).toDouble();
+	    node.penWidth = fields.at(3).toDouble();
+	    node.rotation = fields.at(4).toDouble();
+	    node.fillColour.setRedF(fields.at(5).toDouble());
+	    node.fillColour.setGreenF(fields.at(6).toDouble());
+	    node.fillColour.setBlueF(fields.at(7).toDouble());
+	    node.lineColour.setRedF(fields.at(8).toDouble());
+	    node.lineColour.setGreenF(fields.at(9).toDouble());
+	    node.lineColour.setBlueF(fields.at(10).toDouble());
+	    node.hasLabel = fields.count() >= 13;
+	    node.labelSize = 0;
+	    if (node.hasLabel)
+	    {
+		// If the label has one or more commas, we must glue
+		// the fields back together.
+		node.labelSize = fields.at(11).toFloat();
+		node.label = fields.at(12);
+		for (int i = 13; i < fields.count(); i++)
+		    node.label += "," + fields.at(i);
+	    }
+	    description.nodes.append(node);
+	}
+	else	// Default case: looking at an edge
+	{
+	    QStringList fields = line.split(",");
+
+	    // Edges may or may not have label info.  Accept both.
+	    if (fields.count() < 9 || fields.count() == 10)
+	    {
+		errorMessage = "Edge "
+		    + QString::number(description.edges.count())
+		    + " of file " + graphName
+		    + " has an invalid number of fields.  "
+		    "Thus I can not read this file.";
+		return false;
+	    }
+
+	    Edge_Description edge;
+	    edge.source = fields.at(0).toInt();
+	    edge.dest = fields.at(1).toInt();
+	    if (edge.source < 0 || edge.source >= numOfNodes
+		|| edge.dest < 0 || edge.dest >= numOfNodes)
+	    {
+		errorMessage = "Edge "
+		    + QString::number(description.edges.count())
+		    + " of file " + graphName
+		    + " refers to a non-existent node.  "
+		    "Thus I can not read this file.";
+		return false;
+	    }
+	    edge.destRadius = fields.at(2).toDouble();
+	    edge.sourceRadius = fields.at(3).toDouble();
+	    edge.rotation = fields.at(4).toDouble();
+	    edge.penWidth = fields.at(5).toDouble();
+	    edge.colour.setRedF(fields.at(6).toDouble());
+	    edge.colour.setGreenF(fields.at(7).toDouble());
+	    edge.colour.setBlueF(fields.at(8).toDouble());
+	    edge.hasLabel = fields.count() >= 11;
+	    edge.labelSize = 0;
+	    if (edge.hasLabel)
+	    {
+		edge.labelSize = fields.at(9).toFloat();
+		// If the label has one or more commas, we must glue
+		// the fields back together.
+		edge.label = fields.at(10);
+		for (int i = 11; i < fields.count(); i++)
+		    edge.label += "," + fields.at(i);
+	    }
+	    description.edges.append(edge);
+	}
+    }
+
+    // A truncated compressed file would otherwise look like a
+    // complete (but shorter) one.
+    CompressedFile * file = qobject_cast<CompressedFile *>(in.device());
+    if (file != nullptr && file->failed())
+    {
+	errorMessage = "The file " + graphName + " could not be read: "
+	    + file->errorString() + ".";
+	return false;
+    }
+
+    if (percentDone != nullptr)
+	percentDone->storeRelease(100);
+    return true;
+}
+
+
+
+/*
+ * Name:	initNodeDescription(), initEdgeDescription()
+ * Purpose:	Give a node (edge) description the values used for the
+ *		fields an imported file doesn't give.
+ * Arguments:	The description.
+ * Outputs:	Nothing.
+ * Modifies:	The description.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	The edge radii are set to -1, meaning "work them out
+ *		from the nodes" (see completeDescription()).
+ */
+
+void
+initNodeDescription(Node_Description &node)
+{
+    node.x = node.y = 0;
+    node.diameter = IMPORT_NODE_DIAMETER;
+    node.penWidth = 1;
+    node.rotation = 0;
+    node.fillColour = Qt::white;
+    node.lineColour = Qt::black;
+    node.hasLabel = false;
+    node.labelSize = 12;
+    node.label.clear();
+}
+
+
+
+void
+initEdgeDescription(Edge_Description &edge)
+{
+    edge.source = edge.dest = 0;
+    edge.destRadius = edge.sourceRadius = -1;
+    edge.rotation = 0;
+    edge.penWidth = 1;
+    edge.colour = Qt::black;
+    edge.hasLabel = false;
+    edge.labelSize = 12;
+    edge.label.clear();
+}
+
+
+
+/*
+ * Name:	completeDescription()
+ * Purpose:	Fill in what an imported file left out.
+ * Arguments:	The description, and whether the file gave positions
+ *		for (some of) the nodes.
+ * Outputs:	Nothing.
+ * Modifies:	The description.
+ * Returns:	Nothing.
+ * Assumptions:	The edge endpoints are valid node indices.
+ * Bugs:	None.
+ * Notes:	Edges with no radii get what the Edge constructor
+ *		would give them (half the diameter of the destination
+ *		node, for both ends).
+ *		If no node has a position, all of the nodes are placed
+ *		by a ForceLayout, with the edge length that
+ *		MainWindow::layout_Graphs() would use.
+ */
+
+void
+completeDescription(Graph_Description &description, bool positioned)
+{
+    for (int i = 0; i < description.edges.count(); i++)
+    {
+	Edge_Description &e = description.edges[i];
+	qreal r = description.nodes.at(e.dest).diameter / 2.;
+	if (e.destRadius < 0)
+	    e.destRadius = r;
+	if (e.sourceRadius < 0)
+	    e.sourceRadius = r;
+    }
+
+    if (positioned || description.nodes.isEmpty())
+	return;
+
+    qreal diameters = 0;
+    foreach (const Node_Description &n, description.nodes)
+	diameters += n.diameter;
+
+    QVector<Layout_Edge> edges(description.edges.count());
+    for (int i = 0; i < edges.count(); i++)
+    {
+	edges[i].source = description.edges.at(i).source;
+	edges[i].dest = description.edges.at(i).dest;
+    }
+
+    ForceLayout layout(QVector<QPointF>(description.nodes.count()), edges,
+		       qMax(4 * diameters / description.nodes.count(), 0.5));
+    layout.run();
+    QVector<QPointF> positions = layout.positions();
+    for (int i = 0; i < positions.count(); i++)
+    {
+	description.nodes[i].x = positions.at(i).x();
+	description.nodes[i].y = positions.at(i).y();
+    }
+}
+
+
+
+/*
+ * Name:	colourFromString()
+ * Purpose:	Turn a colour as written by some other program into a
+ *		QColor.
+ * Arguments:	The text.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The colour (invalid if the text isn't understood).
+ * Assumptions:	None.
+ * Bugs:	Graphviz (X11) colour names which aren't also SVG colour
+ *		names are not understood.
+ * Notes:	Understood are "#rrggbb" and "#rrggbbaa", the SVG colour
+ *		names, and three numbers in [0, 1] separated by commas
+ *		or spaces, which are taken as Graphviz takes them (as
+ *		HSV), unless they are separated by commas and followed
+ *		by nothing else, in which case they are taken as RGB,
+ *		as in a .grphc file.  Only the first colour of a
+ *		Graphviz colour list ("red:blue") is used, and a
+ *		Graphviz colour scheme ("/x11/red") is ignored.
+ */
+
+QColor
+colourFromString(QString text)
+{
+    QString t = text.trimmed();
+
+    t = t.section(':', 0, 0);
+    if (t.startsWith('/'))
+	t = t.section('/', -1);
+
+    if (t.startsWith('#') && t.length() == 9)
+    {
+	bool ok;
+	uint rgba = t.mid(1).toUInt(&ok, 16);
+	if (!ok)
+	    return QColor();
+	return QColor((rgba >> 24) & 0xff, (rgba >> 16) & 0xff,
+		      (rgba >> 8) & 0xff, rgba & 0xff);
+    }
+
+    QStringList fields = t.split(QRegExp("[, ]+"), QString::SkipEmptyParts);
+    if (fields.count() == 3)
+    {
+	qreal v[3];
+	for (int i = 0; i < 3; i++)
+	{
+	    bool ok;
+	    v[i] = fields.at(i).toDouble(&ok);
+	    if (!ok || v[i] < 0 || v[i] > 1)
+		return QColor();
+	}
+	if (!t.contains(' '))
+	    return QColor::fromRgbF(v[0], v[1], v[2]);
+	return QColor::fromHsvF(v[0], v[1], v[2]);
+    }
+
+    return QColor(t);
+}
+
+
+
+/*
+ * Name:	centreInInches()
+ * Purpose:	Find the centre of the bounding box of the nodes.
+ * Arguments:	The node descriptions (see describeNode()).
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The centre, in inches (scene coords / DPI).
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	The writers subtract this from each position, so that,
+ *		as in a .grphc file, the graph is centred on (0, 0).
+ */
+
+QPointF
+centreInInches(const QVector<Node_Description> &nodes)
+{
+    if (nodes.isEmpty())
+	return QPointF();
+
+    QRectF bounds(QPointF(nodes.at(0).x, nodes.at(0).y), QSizeF(0, 0));
+    foreach (const Node_Description &d, nodes)
+    {
+	bounds.setLeft(qMin(bounds.left(), d.x));
+	bounds.setRight(qMax(bounds.right(), d.x));
+	bounds.setTop(qMin(bounds.top(), d.y));
+	bounds.setBottom(qMax(bounds.bottom(), d.y));
+    }
+
+    return bounds.center();
+}
+
+
+
+/*
+ * Name:	describeNode(), describeEdge()
+ * Purpose:	Fill in the description of an existing node (edge).
+ * Arguments:	The item and the description; for edges, the indices
+ *		of the source and destination nodes in the description.
+ * Outputs:	Nothing.
+ * Modifies:	The description.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	The node position is its scene position, in inches
+ *		(i.e., not centred, unlike in a .grphc file).  Building
+ *		the descriptions with a GraphBuilder gives back items
+ *		which look the same.
+ */
+
+void
+describeNode(Node * node, Node_Description &d)
+{
+    d.x = node->scenePos().x() / currentPhysicalDPI_X;
+    d.y = node->scenePos().y() / currentPhysicalDPI_Y;
+    d.diameter = node->getDiameter();
+    d.penWidth = node->getPenWidth();
+    d.rotation = node->getRotation();
+    d.fillColour = node->getFillColour();
+    d.lineColour = node->getLineColour();
+    d.label = node->getLabel();
+    d.hasLabel = d.label.length() > 0;
+    d.labelSize = node->getLabelSize();
+}
+
+
+
+void
+describeEdge(Edge * edge, int source, int dest, Edge_Description &d)
+{
+    d.source = source;
+    d.dest = dest;
+    d.destRadius = edge->getDestRadius();
+    d.sourceRadius = edge->getSourceRadius();
+    d.rotation = edge->getRotation();
+    d.penWidth = edge->getPenWidth();
+    d.colour = edge->getColour();
+    d.label = edge->getLabel();
+    d.hasLabel = d.label.length() > 0;
+    d.labelSize = edge->getLabelSize();
+}
+
+
+
+/*
+ * Name:	describeEdges()
+ * Purpose:	Describe each edge between the given nodes once,
+ *		including compact edges (see edgebundle.cpp).
+ * Arguments:	The nodes and the list to fill in.
+ * Outputs:	Nothing.
+ * Modifies:	edges.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	source and dest are indices into nodes, and keep the
+ *		direction of the edge.  The Edges come first, in the
+ *		order of the endpoint with the lower index (the order
+ *		saveGraphIc() has always written them in), then the
+ *		compact edges of the graphs the nodes are in.
+ *		Edges from a node to itself, and edges to nodes which
+ *		are not in the list, are left out, as the writers have
+ *		always done.
+ *		Nothing in the scene is changed; in particular a
+ *		graph's compact edges are not expanded into Edges.
+ */
+
+void
+describeEdges(const QVector<Node *> &nodes, QVector<Edge_Description> &edges)
+{
+    QHash<Node *, int> index;
+    QList<EdgeBundle *> bundles;
+    QSet<EdgeBundle *> seen;
+
+    edges.clear();
+    for (int i = 0; i < nodes.count(); i++)
+    {
+	index.insert(nodes.at(i), i);
+	for (QGraphicsItem * item = nodes.at(i)->parentItem();
+	     item != nullptr; item = item->parentItem())
+	{
+	    if (item->type() != Graph::Type)
+		continue;
+	    EdgeBundle * bundle
+		= qgraphicsitem_cast<Graph *>(item)->getEdgeBundle();
+	    if (bundle != nullptr && !seen.contains(bundle))
+	    {
+		seen.insert(bundle);
+		bundles.append(bundle);
+	    }
+	}
+    }
+
+    // Each Edge is in the edgeList of both of its nodes.
+    for (int i = 0; i < nodes.count(); i++)
+    {
+	foreach (Edge * edge, nodes.at(i)->edgeList)
+	{
+	    int source = index.value(edge->sourceNode(), -1);
+	    int dest = index.value(edge->destNode(), -1);
+	    if (source < 0 || dest < 0 || source == dest
+		|| qMin(source, dest) != i)
+		continue;
+	    Edge_Description d;
+	    describeEdge(edge, source, dest, d);
+	    edges.append(d);
+	}
+    }
+
+    foreach (EdgeBundle * bundle, bundles)
+    {
+	for (int k = 0; k < bundle->count(); k++)
+	{
+	    Edge_Description d;
+	    d.source = index.value(bundle->sourceAt(k), -1);
+	    d.dest = index.value(bundle->destAt(k), -1);
+	    if (d.source < 0 || d.dest < 0 || d.source == d.dest)
+		continue;
+	    // As the Edge constructor (see EdgeBundle::makeEdge()) does.
+	    d.destRadius = d.sourceRadius
+		= bundle->destAt(k)->getDiameter() / 2.;
+	    d.rotation = 0;
+	    d.penWidth = bundle->getPenWidth();
+	    d.colour = bundle->getColour();
+	    d.hasLabel = false;
+	    d.labelSize = bundle->getLabelSize();
+	    edges.append(d);
+	}
+    }
+}
+
+
+
+/*
+ * Name:	isPlainEdge()
+ * Purpose:	Tell whether an edge read from a file could go in an
+ *		EdgeBundle.
+ * Arguments:	The edge's label flag, rotation and radii, and the
+ *		diameter of its destination node (inches).
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	True iff the edge is just what the Edge constructor
+ *		(and so EdgeBundle::makeEdge()) would make.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	A node's diameter is kept in pixels, so converting it to
+ *		inches and back may change the last bit or so of the
+ *		radii.
+ */
+
+bool
+isPlainEdge(bool hasLabel, qreal rotation, qreal destRadius,
+	    qreal sourceRadius, qreal destDiameter)
+{
+    qreal r = destDiameter / 2.;
+    qreal slop = 1e-9 * qMax(qreal(1), qAbs(r));
+
+    return !hasLabel && rotation == 0
+	&& qAbs(destRadius - r) <= slop && qAbs(sourceRadius - r) <= slop;
+}
+
+
+
+Bundle_Key
+bundleKey(qreal penWidth, QColor colour)
+{
+    return qMakePair(penWidth, quint64(colour.rgba64()));
+}
+
+
+
+/*
+ * Name:	chooseBundle()
+ * Purpose:	Pick the edges of a graph being read which go in its
+ *		EdgeBundle.
+ * Arguments:	The number of plain edges (see isPlainEdge()) with each
+ *		pen width and colour, and the key to set.
+ * Outputs:	Nothing.
+ * Modifies:	key.
+ * Returns:	True iff there are enough of them (BUNDLE_MIN_EDGES)
+ *		with one pen width and colour.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	The most common key wins; ties go to the smallest key,
+ *		so that every reader picks the same one.
+ */
+
+bool
+chooseBundle(const QHash<Bundle_Key, int> &plainCounts, Bundle_Key &key)
+{
+    int best = 0;
+
+    for (QHash<Bundle_Key, int>::const_iterator it = plainCounts.begin();
+	 it != plainCounts.end(); ++it)
+    {
+	if (it.value() > best || (it.value() == best && it.key() < key))
+	{
+	    best = it.value();
+	    key = it.key();
+	}
+    }
+    return best >= BUNDLE_MIN_EDGES;
+}
+
+
+
+/*
+ * Name:	describeGraph()
+ * Purpose:	Describe the given nodes and the edges between them.
+ * Arguments:	The nodes and the description to fill in.
+ * Outputs:	Nothing.
+ * Modifies:	description.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	Node i of the description is nodes[i].  The writers
+ *		which take nodes describe them with this and then
+ *		write the description.
+ */
+
+void
+describeGraph(const QVector<Node *> &nodes, Graph_Description &description)
+{
+    description.nodes.resize(nodes.count());
+    for (int i = 0; i < nodes.count(); i++)
+	describeNode(nodes.at(i), description.nodes[i]);
+    describeEdges(nodes, description.edges);
+}
+
+
+
+/*
+ * Name:	GraphBuilder()
+ * Purpose:	Constructor.
+ * Arguments:	The description of the graph to build.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	The description was filled in by parseGraphIc().
+ * Bugs:	None.
+ * Notes:	The (empty) Graph is made here, and the edges which
+ *		will go in its EdgeBundle (if any) are picked, as
+ *		readGraphBin() picks them.
+ */
+
+GraphBuilder::GraphBuilder(const Graph_Description &description)
+{
+    this->description = description;
+    graph = new Graph();
+    nodes.reserve(description.nodes.count());
+    edgesBuilt = 0;
+    bundle = nullptr;
+
+    int edgeCount = description.edges.count();
+    QVector<bool> plain(edgeCount);
+    QHash<Bundle_Key, int> plainCounts;
+    for (int i = 0; i < edgeCount; i++)
+    {
+	const Edge_Description &d = description.edges.at(i);
+	plain[i] = isPlainEdge(d.hasLabel, d.rotation, d.destRadius,
+			       d.sourceRadius,
+			       description.nodes.at(d.dest).diameter);
+	if (plain.at(i))
+	    plainCounts[bundleKey(d.penWidth, d.colour)]++;
+    }
+
+    Bundle_Key key;
+    bundled.fill(false, edgeCount);
+    if (chooseBundle(plainCounts, key))
+    {
+	for (int i = 0; i < edgeCount; i++)
+	{
+	    const Edge_Description &d = description.edges.at(i);
+	    bundled[i] = plain.at(i) && bundleKey(d.penWidth, d.colour) == key;
+	}
+    }
+}
+
+
+
+/*
+ * Name:	~GraphBuilder()
+ * Purpose:	Destructor.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	A graph which was not taken (e.g., because the load was
+ *		cancelled part way through) is deleted, with whatever
+ *		items it has so far.
+ */
+
+GraphBuilder::~GraphBuilder()
+{
+    delete graph;
+}
+
+
+
+int
+GraphBuilder::itemsBuilt() const
+{
+    return nodes.count() + edgesBuilt;
+}
+
+
+
+int
+GraphBuilder::itemCount() const
+{
+    return description.nodes.count() + description.edges.count();
+}
+
+
+
+/*
+ * Name:	build()
+ * Purpose:	Make (up to) the given number of nodes and edges.
+ * Arguments:	The maximum number of items to make.
+ * Outputs:	Nothing.
+ * Modifies:	graph, nodes, edgesBuilt.
+ * Returns:	True iff the graph is now complete.
+ * Assumptions:	currentPhysicalDPI_{X,Y} are set.
+ * Bugs:	?
+ * Notes:	All of the nodes are made before any edge.  Each item is
+ *		made just as the old readGraphIc() did, and then made
+ *		to share a style entry with any earlier item which ended
+ *		up looking the same.  Edges picked for the EdgeBundle
+ *		(see GraphBuilder()) are added to it instead of being
+ *		made into Edges.
+ *		When the last item has been made, the preview coords
+ *		are set (see finish()).
+ */
+
+bool
+GraphBuilder::build(int maxItems)
+{
+    for (; maxItems > 0 && nodes.count() < description.nodes.count();
+	 maxItems--)
+    {
+	const Node_Description &d = description.nodes.at(nodes.count());
+	Node * node = new Node();
+	node->setPos(d.x * currentPhysicalDPI_X, d.y * currentPhysicalDPI_Y);
+	node->setDiameter(d.diameter);
+	node->setPenWidth(d.penWidth);
+	node->setRotation(d.rotation);
+	node->setID(nodes.count());
+	node->setFillColour(d.fillColour);
+	node->setLineColour(d.lineColour);
+	if (d.hasLabel)
+	{
+	    node->setNodeLabelSize(d.labelSize);
+	    node->setNodeLabel(d.label);
+	}
+	node->setStyle(nodeStyles.intern(node->style()));
+	nodes.append(node);
+	node->setParentItem(graph);
+    }
+
+    for (; maxItems > 0 && edgesBuilt < description.edges.count();
+	 maxItems--)
+    {
+	int i = edgesBuilt++;
+	const Edge_Description &d = description.edges.at(i);
+	if (bundled.at(i))
+	{
+	    if (bundle == nullptr)
+	    {
+		bundle = graph->getEdgeBundle(true);
+		bundle->setPenWidth(d.penWidth);
+		bundle->setColour(d.colour);
+		bundle->setEdgeLabelSize(d.labelSize);
+	    }
+	    bundle->addEdge(nodes.at(d.source), nodes.at(d.dest));
+	    continue;
+	}
+
+	Edge * edge = new Edge(nodes.at(d.source), nodes.at(d.dest));
+	edge->setDestRadius(d.destRadius);
+	edge->setSourceRadius(d.sourceRadius);
+	edge->setRotation(d.rotation);
+	edge->setPenWidth(d.penWidth);
+	edge->setColour(d.colour);
+	if (d.hasLabel)
+	{
+	    edge->setEdgeLabelSize(d.labelSize);
+	    edge->setEdgeLabel(d.label);
+	}
+	edge->setStyle(edgeStyles.intern(edge->style()));
+	edge->setParentItem(graph);
+    }
+
+    if (itemsBuilt() < itemCount())
+	return false;
+
+    finish();
+    return true;
+}
+
+
+
+/*
+ * Name:	finish()
+ * Purpose:	Set the preview coords of the nodes.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	The nodes.
+ * Returns:	Nothing.
+ * Assumptions:	All of the nodes have been made.
+ * Bugs:	?
+ * Notes:	Moved from readGraphIc().  The node preview coords are
+ *		needed by PreView::Style_Graph().
+ */
+
+void
+GraphBuilder::finish()
+{
+    // The following 4 variables hold the extremal positions actually drawn,
+    // so they take into account both the node center location and the
+    // node diameter.  (These are the two values stored in the .grphc file.)
+    qreal minX = 1E10, maxX = -1E10, minY = 1E10, maxY = -1E10;
+    // These 4 variables hold the radii of the vertices which give the
+    // extremal positions stored above.
+    qreal minXr = 0, maxXr = 0, minYr = 0, maxYr = 0;
+
+    foreach (const Node_Description &d, description.nodes)
+    {
+	qreal r = d.diameter / 2.;
+	if (d.x - r < minX)
+	{
+	    minX = d.x - r;
+	    minXr = r;
+	}
+	if (d.x + r > maxX)
+	{
+	    maxX = d.x + r;
+	    maxXr = r;
+	}
+	if (d.y - r < minY)
+	{
+	    minY = d.y - r;
+	    minYr = r;
+	}
+	if (d.y + r > maxY)
+	{
+	    maxY = d.y + r;
+	    maxYr = r;
+	}
+    }
+
+    // Scale all the node CENTER positions to a 1"x1" square
+    // so that it can be appropriately styled.
+    // TODO(?): center it on (0,0).  (Graphs output by this
+    // program should already be centered.)
+    qreal width = (maxX - maxXr) - (minX + minXr);
+    qreal height = (maxY - maxYr) - (minY + minYr);
+    qDebu("    X: [%.4f, %.4f], Xr min %.4f, max %.4f",
+	  minX, maxX, minXr, maxXr);
+    qDebu("    Y: [%.4f, %.4f], Yr min %.4f, max %.4f",
+	  minY, maxY, minYr, maxYr);
+    qDebu("    width %.4f, height %.4f", width, height);
+    for (int i = 0; i < nodes.count(); i++)
+    {
+	Node * n = nodes.at(i);
+	n->setPreviewCoords(n->x() / width / currentPhysicalDPI_X,
+			    n->y() / height / currentPhysicalDPI_Y);
+    }
+}
+
+
+
+/*
+ * Name:	takeGraph()
+ * Purpose:	Hand over the graph.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	graph.
+ * Returns:	The graph (not in any scene); the caller now owns it.
+ * Assumptions:	build() has returned true.
+ * Bugs:	None.
+ * Notes:	None.
+ */
+
+Graph *
+GraphBuilder::takeGraph()
+{
+    Graph * g = graph;
+
+    graph = nullptr;
+    return g;
+}
+
+
+
+/*
+ * Name:	GraphLoader()
+ * Purpose:	Constructor.
+ * Arguments:	The parent object.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	None.
+ */
+
+GraphLoader::GraphLoader(QObject * parent) : QObject(parent)
+{
+    builder = nullptr;
+    progressTimer.setInterval(100);
+    connect(&watcher, SIGNAL(finished()), this, SLOT(parseDone()));
+    connect(&progressTimer, SIGNAL(timeout()),
+	    this, SLOT(reportParseProgress()));
+}
+
+
+
+/*
+ * Name:	~GraphLoader()
+ * Purpose:	Destructor.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	A parse in progress is told to stop, but not waited
+ *		for; it has its own reference to the job.
+ */
+
+GraphLoader::~GraphLoader()
+{
+    cancel();
+}
+
+
+
+/*
+ * Name:	load()
+ * Purpose:	Start loading a .grphc or edge list file.
+ * Arguments:	The file name.
+ * Outputs:	Nothing.
+ * Modifies:	job.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	Any load already in progress is cancelled.  Eventually
+ *		either loaded() or failed() is emitted (unless this load
+ *		is cancelled in turn), with progress() emitted along
+ *		the way.
+ */
+
+void
+GraphLoader::load(QString fileName)
+{
+    cancel();
+
+    job = QSharedPointer<Parse_Job>(new Parse_Job);
+    job->fileName = fileName;
+    job->ok = false;
+    job->cancelled.storeRelease(0);
+    job->percentDone.storeRelease(0);
+
+    emit progress(0);
+    watcher.setFuture(QtConcurrent::run(parse, job));
+    progressTimer.start();
+}
+
+
+
+bool
+GraphLoader::isBusy() const
+{
+    return !job.isNull() || builder != nullptr;
+}
+
+
+
+/*
+ * Name:	cancel()
+ * Purpose:	Stop the current load, if any.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	job, builder.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	Neither loaded() nor failed() is emitted for a cancelled
+ *		load.  Any items already built are deleted.
+ */
+
+void
+GraphLoader::cancel()
+{
+    progressTimer.stop();
+    if (!job.isNull())
+    {
+	job->cancelled.storeRelease(1);
+	job.clear();
+    }
+    delete builder;
+    builder = nullptr;
+}
+
+
+
+/*
+ * Name:	parse()
+ * Purpose:	Parse the file of a job.
+ * Arguments:	The job.
+ * Outputs:	Nothing.
+ * Modifies:	The job.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	Runs on a pool thread via QtConcurrent.  An edge list
+ *		is laid out here too (see parseEdgeList()).
+ */
+
+void
+GraphLoader::parse(QSharedPointer<Parse_Job> job)
+{
+    if (isEdgeListFile(job->fileName))
+    {
+	job->ok = parseEdgeList(job->fileName, job->description,
+				job->errorMessage,
+				&job->cancelled, &job->percentDone);
+	return;
+    }
+
+    CompressedFile file(job->fileName);
+
+    if (!file.open(QIODevice::ReadOnly))
+    {
+	job->errorMessage = "File: " + job->fileName + ": "
+	    + file.errorString();
+	return;
+    }
+
+    QTextStream in(&file);
+    job->ok = parseGraphIc(in, job->fileName, job->description,
+			   job->errorMessage,
+			   &job->cancelled, &job->percentDone);
+}
+
+
+
+void
+GraphLoader::reportParseProgress()
+{
+    if (!job.isNull())
+	emit progress(job->percentDone.loadAcquire() / 2);
+}
+
+
+
+/*
+ * Name:	parseDone()
+ * Purpose:	Start building the items once the file has been parsed.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	job, builder.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	Called (on the GUI thread) when the watched parse ends.
+ *		A cancelled job is no longer watched, so this is only
+ *		called for the current one.
+ */
+
+void
+GraphLoader::parseDone()
+{
+    progressTimer.stop();
+    if (job.isNull())
+	return;
+
+    QSharedPointer<Parse_Job> done = job;
+    job.clear();
+    if (!done->ok)
+    {
+	emit failed(done->errorMessage);
+	return;
+    }
+
+    builder = new GraphBuilder(done->description);
+    emit progress(50);
+    QTimer::singleShot(0, this, SLOT(buildChunk()));
+}
+
+
+
+/*
+ * Name:	buildChunk()
+ * Purpose:	Build the next LOAD_CHUNK_ITEMS items.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	builder.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	Called from the event loop until the graph is done, so
+ *		the GUI stays responsive (and a Cancel button works)
+ *		while a big graph is being built.
+ */
+
+void
+GraphLoader::buildChunk()
+{
+    if (builder == nullptr)
+	return;
+
+    bool done = builder->build(LOAD_CHUNK_ITEMS);
+    if (builder->itemCount() > 0)
+	emit progress(50 + 50 * qint64(builder->itemsBuilt())
+		      / builder->itemCount());
+    if (!done)
+    {
+	QTimer::singleShot(0, this, SLOT(buildChunk()));
+	return;
+    }
+
+    Graph * graph = builder->takeGraph();
+    delete builder;
+    builder = nullptr;
+    emit loaded(graph);
+}
@@ -0,0 +1,205 @@
+/*
+ * File:	graphloader.h
+ * Author:	agent
+ * Date:	2026-10-18
+ * Version:	1.6
+ *
+ * Purpose:	Declare the plain (item-free) description of a graph read
+ *		from a .grphc file, the functions which parse a file into
+ *		one and build a Graph from one, and the GraphLoader class
+ *		which does both without blocking the GUI.
+ *
+ * Modification history:
+ * Oct 18, 2026 (agent V1.0)
+ *  (a) Initial version.
+ * Oct 18, 2026 (agent V1.1)
+ *  (a) Declare the helpers used by the GraphML and DOT readers and
+ *	writers: initNodeDescription(), initEdgeDescription(),
+ *	completeDescription(), colourFromString() and
+ *	centreInInches().
+ * Oct 18, 2026 (agent V1.2)
+ *  (a) Declare describeNode() and describeEdge().
+ * Oct 18, 2026 (agent V1.3)
+ *  (a) Declare describeEdges().
+ * Oct 18, 2026 (agent V1.4)
+ *  (a) Move BUNDLE_MIN_EDGES here from binaryformat.cpp, and declare
+ *	isPlainEdge(), bundleKey() and chooseBundle(), so that a
+ *	GraphBuilder bundles edges just as readGraphBin() does.
+ * Oct 18, 2026 (agent V1.5)
+ *  (a) Declare describeGraph(); centreInInches() takes descriptions.
+ * Oct 18, 2026 (agent V1.6)
+ *  (a) A GraphLoader also loads edge lists.
+ */
+
+#ifndef GRAPHLOADER_H
+#define GRAPHLOADER_H
+
+#include "styletable.h"
+
+#include <QAtomicInt>
+#include <QColor>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QObject>
+#include <QPair>
+#include <QPointF>
+#include <QSharedPointer>
+#include <QString>
+#include <QTextStream>
+#include <QTimer>
+#include <QVector>
+
+class Edge;
+class EdgeBundle;
+class Graph;
+class Node;
+
+typedef struct nodeDescription
+{
+    qreal	x, y;		// Inches, as in the file.
+    qreal	diameter;	// Inches.
+    qreal	penWidth;
+    qreal	rotation;
+    QColor	fillColour, lineColour;
+    bool	hasLabel;	// If not, labelSize and label are unused.
+    qreal	labelSize;
+    QString	label;
+} Node_Description;
+
+typedef struct edgeDescription
+{
+    int		source, dest;	// Indices into the nodes.
+    qreal	destRadius, sourceRadius;
+    qreal	rotation;
+    qreal	penWidth;
+    QColor	colour;
+    bool	hasLabel;
+    qreal	labelSize;
+    QString	label;
+} Edge_Description;
+
+typedef struct graphDescription
+{
+    QVector<Node_Description> nodes;
+    QVector<Edge_Description> edges;
+} Graph_Description;
+
+bool parseGraphIc(QTextStream &in, QString graphName,
+		  Graph_Description &description, QString &errorMessage,
+		  QAtomicInt * cancelled = nullptr,
+		  QAtomicInt * percentDone = nullptr);
+
+// For formats which may leave out some of the fields.
+void initNodeDescription(Node_Description &node);
+void initEdgeDescription(Edge_Description &edge);
+void completeDescription(Graph_Description &description, bool positioned);
+QColor colourFromString(QString text);
+QPointF centreInInches(const QVector<Node_Description> &nodes);
+
+// A graph read from a file with at least this many edges which are
+// unlabelled, unrotated and touch the node outlines (i.e., look just
+// like the edges of a generated graph), and which have the same pen
+// width and colour, gets those edges put in an EdgeBundle.
+#define BUNDLE_MIN_EDGES	1000
+
+// The pen width and (QRgba64) colour of an edge.
+typedef QPair<qreal, quint64> Bundle_Key;
+
+bool isPlainEdge(bool hasLabel, qreal rotation, qreal destRadius,
+		 qreal sourceRadius, qreal destDiameter);
+Bundle_Key bundleKey(qreal penWidth, QColor colour);
+bool chooseBundle(const QHash<Bundle_Key, int> &plainCounts,
+		  Bundle_Key &key);
+
+// The reverse of a GraphBuilder: describe items which exist.
+void describeNode(Node * node, Node_Description &d);
+void describeEdge(Edge * edge, int source, int dest, Edge_Description &d);
+void describeEdges(const QVector<Node *> &nodes,
+		   QVector<Edge_Description> &edges);
+void describeGraph(const QVector<Node *> &nodes,
+		   Graph_Description &description);
+
+
+
+/*
+ * A GraphBuilder makes the items described by a Graph_Description,
+ * as many at a time as it is asked to.
+ */
+
+class GraphBuilder
+{
+  public:
+    GraphBuilder(const Graph_Description &description);
+    ~GraphBuilder();
+
+    bool build(int maxItems);
+    int itemsBuilt() const;
+    int itemCount() const;
+    Graph * takeGraph();
+
+  private:
+    void finish();
+
+    Graph_Description	    description;
+    Graph *		    graph;	// Owned until takeGraph().
+    QVector<Node *>	    nodes;
+    int			    edgesBuilt;
+    QVector<bool>	    bundled;	// Per edge: goes in the bundle.
+    EdgeBundle *	    bundle;	// Made with its first edge.
+    StyleTable<NodeStyle>   nodeStyles;
+    StyleTable<EdgeStyle>   edgeStyles;
+};
+
+
+
+/*
+ * A GraphLoader reads a .grphc (or edge list) file in the background:
+ * the file is parsed (and an edge list laid out) on a pool thread, then
+ * the items are built on the GUI thread a chunk at a time between events.
+ */
+
+class GraphLoader : public QObject
+{
+    Q_OBJECT
+
+  public:
+    explicit GraphLoader(QObject * parent = 0);
+    ~GraphLoader();
+
+    void load(QString fileName);
+    bool isBusy() const;
+
+  public slots:
+    void cancel();
+
+  signals:
+    void progress(int percent);
+    void loaded(Graph * graph);
+    void failed(QString errorMessage);
+
+  private slots:
+    void parseDone();
+    void reportParseProgress();
+    void buildChunk();
+
+  private:
+    // Shared with the parsing thread, which may outlive a cancelled load.
+    typedef struct parseJob
+    {
+	QString		    fileName;
+	Graph_Description   description;
+	QString		    errorMessage;
+	bool		    ok;
+	QAtomicInt	    cancelled;
+	QAtomicInt	    percentDone;
+    } Parse_Job;
+
+    static void parse(QSharedPointer<Parse_Job> job);
+
+    QSharedPointer<Parse_Job>	job;
+    QFutureWatcher<void>	watcher;
+    QTimer			progressTimer;
+    GraphBuilder *		builder;
+};
+
+#endif // GRAPHLOADER_H
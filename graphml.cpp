@@ -0,0 +1,566 @@
+/*
+ * File:	graphml.cpp
+ * Author:	agent
+ * Date:	2026-10-18
+ * Version:	1.2
+ *
+ * Purpose:	Read and write GraphML, so that graphs can be exchanged
+ *		with other programs without ad-hoc conversion scripts.
+ *
+ *		Both directions stream: the reader is a QXmlStreamReader
+ *		which turns each <node> and <edge> element into a
+ *		Node_Description or Edge_Description as it goes (no DOM
+ *		is built), and the writer is a QXmlStreamWriter which
+ *		writes each node and edge straight from the items.
+ *
+ *		The GraphML data keys written are those holding the
+ *		fields that saveGraphIc() writes, with the same units
+ *		(positions and diameters in inches, colours as
+ *		#rrggbb):
+ *		    nodes: x, y, diameter, penwidth, rotation, fill,
+ *			   outline, label, labelsize
+ *		    edges: destradius, sourceradius, rotation, penwidth,
+ *			   colour, label, labelsize
+ *		When reading, keys are matched by their attr.name (not
+ *		their id), case-insensitively, and some common
+ *		alternatives are also understood (e.g., "fillcolor",
+ *		"color", "size", "fontsize"); see applyNodeData() and
+ *		applyEdgeData().  Key defaults are honoured.  Anything
+ *		else (yEd graphics, ports, nested graphs, hyperedges)
+ *		is skipped.  If no node has a position the nodes are
+ *		placed by completeDescription().
+ *
+ * Modification history:
+ * Oct 18, 2026 (agent V1.0)
+ *  (a) Initial version.
+ * Oct 18, 2026 (agent V1.1)
+ *  (a) saveGraphML() gets the edges from describeEdges(), so
+ *	compact edges are written without expanding them first.
+ * Oct 18, 2026 (agent V1.2)
+ *  (a) Add a saveGraphML() which writes a Graph_Description, so
+ *	that "Export all" needs no items; the old one describes the
+ *	nodes and calls it.
+ */
+
+#include "graphml.h"
+#include "defuns.h"
+#include "edge.h"
+#include "graph.h"
+#include "node.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QHash>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
+
+#define GRAPHML_NAMESPACE   "http://graphml.graphdrawing.org/xmlns"
+
+// Digits after the decimal point of the node positions.
+#define GRAPHML_POS_PREC    4
+
+typedef struct graphmlKey
+{
+    QString	domain;		// "node", "edge", "all", ...
+    QString	name;		// attr.name, in lower case.
+    bool	hasDefault;
+    QString	defaultValue;
+} GraphML_Key;
+
+// The keys written by saveGraphML().
+static const struct
+{
+    const char * id;
+    const char * domain;
+    const char * name;
+    const char * type;
+} writtenKeys[] =
+{
+    { "x",	"node",	"x",		"double" },
+    { "y",	"node",	"y",		"double" },
+    { "d",	"node",	"diameter",	"double" },
+    { "pw",	"node",	"penwidth",	"double" },
+    { "rot",	"node",	"rotation",	"double" },
+    { "fill",	"node",	"fill",		"string" },
+    { "line",	"node",	"outline",	"string" },
+    { "label",	"node",	"label",	"string" },
+    { "ls",	"node",	"labelsize",	"double" },
+    { "edr",	"edge",	"destradius",	"double" },
+    { "esr",	"edge",	"sourceradius",	"double" },
+    { "erot",	"edge",	"rotation",	"double" },
+    { "epw",	"edge",	"penwidth",	"double" },
+    { "ecol",	"edge",	"colour",	"string" },
+    { "elabel",	"edge",	"label",	"string" },
+    { "els",	"edge",	"labelsize",	"double" },
+};
+
+
+
+/*
+ * Name:	applyNodeData()
+ * Purpose:	Store the value of one GraphML data item in a node.
+ * Arguments:	The node, the (lower case) name of the key, the value,
+ *		and a flag to set if this is a position.
+ * Outputs:	Nothing.
+ * Modifies:	The node, and maybe positioned.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	Unknown keys and bad values are ignored.
+ */
+
+static void
+applyNodeData(Node_Description &node, QString name, QString value,
+	      bool &positioned)
+{
+    bool ok;
+    qreal v = value.toDouble(&ok);
+
+    if (name == "x" || name == "y")
+    {
+	if (!ok)
+	    return;
+	if (name == "x")
+	    node.x = v;
+	else
+	    node.y = v;
+	positioned = true;
+    }
+    else if (name == "diameter" || name == "size" || name == "width")
+    {
+	if (ok && v > 0)
+	    node.diameter = v;
+    }
+    else if (name == "penwidth")
+    {
+	if (ok && v >= 0)
+	    node.penWidth = v;
+    }
+    else if (name == "rotation")
+    {
+	if (ok)
+	    node.rotation = v;
+    }
+    else if (name == "fill" || name == "fillcolor" || name == "fillcolour"
+	     || name == "color" || name == "colour")
+    {
+	QColor c = colourFromString(value);
+	if (c.isValid())
+	    node.fillColour = c;
+    }
+    else if (name == "outline" || name == "linecolor"
+	     || name == "linecolour" || name == "outlinecolor"
+	     || name == "outlinecolour")
+    {
+	QColor c = colourFromString(value);
+	if (c.isValid())
+	    node.lineColour = c;
+    }
+    else if (name == "label" || name == "name")
+	node.label = value;
+    else if (name == "labelsize" || name == "fontsize")
+    {
+	if (ok && v > 0)
+	    node.labelSize = v;
+    }
+}
+
+
+
+/*
+ * Name:	applyEdgeData()
+ * Purpose:	Store the value of one GraphML data item in an edge.
+ * Arguments:	The edge, the (lower case) name of the key and the value.
+ * Outputs:	Nothing.
+ * Modifies:	The edge.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	Unknown keys and bad values are ignored.
+ */
+
+static void
+applyEdgeData(Edge_Description &edge, QString name, QString value)
+{
+    bool ok;
+    qreal v = value.toDouble(&ok);
+
+    if (name == "destradius")
+    {
+	if (ok && v >= 0)
+	    edge.destRadius = v;
+    }
+    else if (name == "sourceradius")
+    {
+	if (ok && v >= 0)
+	    edge.sourceRadius = v;
+    }
+    else if (name == "rotation")
+    {
+	if (ok)
+	    edge.rotation = v;
+    }
+    else if (name == "penwidth")
+    {
+	if (ok && v >= 0)
+	    edge.penWidth = v;
+    }
+    else if (name == "colour" || name == "color")
+    {
+	QColor c = colourFromString(value);
+	if (c.isValid())
+	    edge.colour = c;
+    }
+    else if (name == "label" || name == "name")
+	edge.label = value;
+    else if (name == "labelsize" || name == "fontsize")
+    {
+	if (ok && v > 0)
+	    edge.labelSize = v;
+    }
+}
+
+
+
+/*
+ * Name:	parseGraphML()
+ * Purpose:	Read a GraphML document into a Graph_Description.
+ * Arguments:	The device to read from, the name of the file (for
+ *		error messages), the description to fill in and a string
+ *		to hold an error message.
+ * Outputs:	Nothing.
+ * Modifies:	description, errorMessage.
+ * Returns:	True iff the document was read.
+ * Assumptions:	None.
+ * Bugs:	Self-loops are dropped, since Graphic can't draw them.
+ * Notes:	All of the <graph>s in the document (other than those
+ *		nested in nodes or edges) are read into the one graph.
+ *		Edges may refer to nodes which come later in the file;
+ *		only the edges which do are remembered by node id until
+ *		the end.
+ */
+
+bool
+parseGraphML(QIODevice * in, QString graphName,
+	     Graph_Description &description, QString &errorMessage)
+{
+    QXmlStreamReader xml(in);
+    QHash<QString, GraphML_Key> keys;
+    QHash<QString, int> nodeIndex;
+    QVector<int> pending;		// Edges with unresolved ends...
+    QVector<QString> pendingEnds;	// ... and the ids of those ends.
+    bool positioned = false;
+
+    description.nodes.clear();
+    description.edges.clear();
+
+    while (!xml.atEnd())
+    {
+	xml.readNext();
+	if (!xml.isStartElement())
+	    continue;
+
+	QXmlStreamAttributes attrs = xml.attributes();
+	if (xml.name() == "key")
+	{
+	    GraphML_Key key;
+	    key.domain = attrs.value("for").toString();
+	    key.name = attrs.value("attr.name").toString().toLower();
+	    key.hasDefault = false;
+	    while (xml.readNextStartElement())
+	    {
+		if (xml.name() == "default")
+		{
+		    key.hasDefault = true;
+		    key.defaultValue = xml.readElementText(
+			QXmlStreamReader::SkipChildElements);
+		}
+		else
+		    xml.skipCurrentElement();
+	    }
+	    keys.insert(attrs.value("id").toString(), key);
+	}
+	else if (xml.name() == "node")
+	{
+	    QString id = attrs.value("id").toString();
+	    if (id.isEmpty() || nodeIndex.contains(id))
+	    {
+		errorMessage = "The file " + graphName
+		    + " has a node with a missing or repeated id (line "
+		    + QString::number(xml.lineNumber())
+		    + ").  Thus I can not read this file.";
+		return false;
+	    }
+
+	    Node_Description node;
+	    initNodeDescription(node);
+	    foreach (const GraphML_Key &key, keys)
+		if (key.hasDefault
+		    && (key.domain == "node" || key.domain == "all"))
+		    applyNodeData(node, key.name, key.defaultValue,
+				  positioned);
+	    while (xml.readNextStartElement())
+	    {
+		if (xml.name() == "data")
+		{
+		    QString k = xml.attributes().value("key").toString();
+		    QString value = xml.readElementText(
+			QXmlStreamReader::SkipChildElements);
+		    if (keys.contains(k))
+			applyNodeData(node, keys.value(k).name, value,
+				      positioned);
+		}
+		else
+		    xml.skipCurrentElement();
+	    }
+	    node.hasLabel = !node.label.isEmpty();
+	    nodeIndex.insert(id, description.nodes.count());
+	    description.nodes.append(node);
+	}
+	else if (xml.name() == "edge")
+	{
+	    QString source = attrs.value("source").toString();
+	    QString target = attrs.value("target").toString();
+
+	    Edge_Description edge;
+	    initEdgeDescription(edge);
+	    foreach (const GraphML_Key &key, keys)
+		if (key.hasDefault
+		    && (key.domain == "edge" || key.domain == "all"))
+		    applyEdgeData(edge, key.name, key.defaultValue);
+	    while (xml.readNextStartElement())
+	    {
+		if (xml.name() == "data")
+		{
+		    QString k = xml.attributes().value("key").toString();
+		    QString value = xml.readElementText(
+			QXmlStreamReader::SkipChildElements);
+		    if (keys.contains(k))
+			applyEdgeData(edge, keys.value(k).name, value);
+		}
+		else
+		    xml.skipCurrentElement();
+	    }
+	    edge.hasLabel = !edge.label.isEmpty();
+
+	    if (source == target)
+	    {
+		qDeb() << "parseGraphML(): dropping loop at " << source;
+		continue;
+	    }
+	    edge.source = nodeIndex.value(source, -1);
+	    edge.dest = nodeIndex.value(target, -1);
+	    if (edge.source < 0 || edge.dest < 0)
+	    {
+		pending.append(description.edges.count());
+		pendingEnds.append(source);
+		pendingEnds.append(target);
+	    }
+	    description.edges.append(edge);
+	}
+    }
+
+    if (xml.hasError())
+    {
+	errorMessage = "The file " + graphName
+	    + " is not valid GraphML (line "
+	    + QString::number(xml.lineNumber()) + ": "
+	    + xml.errorString() + ").  Thus I can not read this file.";
+	return false;
+    }
+
+    for (int i = 0; i < pending.count(); i++)
+    {
+	Edge_Description &edge = description.edges[pending.at(i)];
+	edge.source = nodeIndex.value(pendingEnds.at(2 * i), -1);
+	edge.dest = nodeIndex.value(pendingEnds.at(2 * i + 1), -1);
+	if (edge.source < 0 || edge.dest < 0)
+	{
+	    errorMessage = "Edge " + QString::number(pending.at(i))
+		+ " of file " + graphName
+		+ " refers to a non-existent node.  "
+		"Thus I can not read this file.";
+	    return false;
+	}
+    }
+
+    completeDescription(description, positioned);
+    return true;
+}
+
+
+
+/*
+ * Name:	readGraphML()
+ * Purpose:	Create a graph from a GraphML file.
+ * Arguments:	The file name and a string to hold an error message.
+ * Outputs:	Nothing.
+ * Modifies:	errorMessage, if there is an error.
+ * Returns:	The new graph (not yet in any scene), or nullptr.
+ * Assumptions:	currentPhysicalDPI_{X,Y} are set.
+ * Bugs:	None.
+ * Notes:	As for readGraphIc(), the node preview coords are set
+ *		and the caller positions the graph.
+ */
+
+Graph *
+readGraphML(QString fileName, QString &errorMessage)
+{
+    QFile file(fileName);
+
+    if (!file.open(QIODevice::ReadOnly))
+    {
+	errorMessage = "File: " + fileName + ": " + file.errorString();
+	return nullptr;
+    }
+
+    Graph_Description description;
+    if (!parseGraphML(&file, fileName, description, errorMessage))
+	return nullptr;
+
+    GraphBuilder builder(description);
+    builder.build(builder.itemCount());
+    return builder.takeGraph();
+}
+
+
+
+/*
+ * Name:	saveGraphML()
+ * Purpose:	Write a graph (or graphs) as GraphML.
+ * Arguments:	The device to write to and the nodes.
+ * Outputs:	The GraphML document.
+ * Modifies:	Nothing.
+ * Returns:	True iff it was all written.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	Describes the nodes and their edges (including compact
+ *		edges) and writes the description with the
+ *		saveGraphML() below.
+ */
+
+bool
+saveGraphML(QIODevice * out, QVector<Node *> nodes)
+{
+    Graph_Description description;
+
+    describeGraph(nodes, description);
+    return saveGraphML(out, description);
+}
+
+
+
+/*
+ * Name:	saveGraphML()
+ * Purpose:	Write a graph description as GraphML.
+ * Arguments:	The device to write to and the description.
+ * Outputs:	The GraphML document.
+ * Modifies:	Nothing.
+ * Returns:	True iff it was all written.
+ * Assumptions:	The node positions are scene positions in inches, as
+ *		describeNode() gives them.
+ * Bugs:	None.
+ * Notes:	The edges are written in the same order as
+ *		saveGraphIc() writes them, and the graph is centred on
+ *		(0, 0) in the same way.  Node n (its index in the
+ *		description) is given the id "n<n>".
+ *		This touches no QGraphicsItems, so it may be called on
+ *		any thread.
+ */
+
+bool
+saveGraphML(QIODevice * out, const Graph_Description &description)
+{
+    QXmlStreamWriter xml(out);
+    const QVector<Node_Description> &nodes = description.nodes;
+    const QVector<Edge_Description> &edges = description.edges;
+    QPointF mid = centreInInches(nodes);
+
+    xml.setAutoFormatting(true);
+    xml.writeStartDocument();
+    xml.writeComment(" graph-ic graph definition created "
+		     + QDateTime::currentDateTime()
+		     .toString("yyyy-MM-dd hh:mm:ss") + " ");
+    xml.writeStartElement("graphml");
+    xml.writeDefaultNamespace(GRAPHML_NAMESPACE);
+    for (uint i = 0; i < sizeof(writtenKeys) / sizeof(writtenKeys[0]); i++)
+    {
+	xml.writeEmptyElement("key");
+	xml.writeAttribute("id", writtenKeys[i].id);
+	xml.writeAttribute("for", writtenKeys[i].domain);
+	xml.writeAttribute("attr.name", writtenKeys[i].name);
+	xml.writeAttribute("attr.type", writtenKeys[i].type);
+    }
+
+    xml.writeStartElement("graph");
+    xml.writeAttribute("id", "G");
+    xml.writeAttribute("edgedefault", "undirected");
+
+    for (int i = 0; i < nodes.count(); i++)
+    {
+	const Node_Description &node = nodes.at(i);
+	xml.writeStartElement("node");
+	xml.writeAttribute("id", "n" + QString::number(i));
+	xml.writeStartElement("data");
+	xml.writeAttribute("key", "x");
+	xml.writeCharacters(QString::number(node.x - mid.x(),
+					    'f', GRAPHML_POS_PREC));
+	xml.writeEndElement();
+	xml.writeStartElement("data");
+	xml.writeAttribute("key", "y");
+	xml.writeCharacters(QString::number(node.y - mid.y(),
+					    'f', GRAPHML_POS_PREC));
+	xml.writeEndElement();
+
+	QVector<QPair<QString, QString>> data;
+	data << qMakePair(QString("d"), QString::number(node.diameter))
+	     << qMakePair(QString("pw"), QString::number(node.penWidth))
+	     << qMakePair(QString("rot"), QString::number(node.rotation))
+	     << qMakePair(QString("fill"), node.fillColour.name())
+	     << qMakePair(QString("line"), node.lineColour.name());
+	if (node.hasLabel)
+	    data << qMakePair(QString("label"), node.label)
+		 << qMakePair(QString("ls"), QString::number(node.labelSize));
+	for (int j = 0; j < data.count(); j++)
+	{
+	    xml.writeStartElement("data");
+	    xml.writeAttribute("key", data.at(j).first);
+	    xml.writeCharacters(data.at(j).second);
+	    xml.writeEndElement();
+	}
+	xml.writeEndElement();		// node
+    }
+
+    foreach (const Edge_Description &e, edges)
+    {
+	xml.writeStartElement("edge");
+	xml.writeAttribute("source",
+			   "n" + QString::number(qMin(e.source, e.dest)));
+	xml.writeAttribute("target",
+			   "n" + QString::number(qMax(e.source, e.dest)));
+
+	QVector<QPair<QString, QString>> data;
+	data << qMakePair(QString("edr"), QString::number(e.destRadius))
+	     << qMakePair(QString("esr"), QString::number(e.sourceRadius))
+	     << qMakePair(QString("erot"), QString::number(e.rotation))
+	     << qMakePair(QString("epw"), QString::number(e.penWidth))
+	     << qMakePair(QString("ecol"), e.colour.name());
+	if (e.hasLabel)
+	    data << qMakePair(QString("elabel"), e.label)
+		 << qMakePair(QString("els"), QString::number(e.labelSize));
+	for (int j = 0; j < data.count(); j++)
+	{
+	    xml.writeStartElement("data");
+	    xml.writeAttribute("key", data.at(j).first);
+	    xml.writeCharacters(data.at(j).second);
+	    xml.writeEndElement();
+	}
+	xml.writeEndElement();		// edge
+    }
+
+    xml.writeEndElement();		// graph
+    xml.writeEndElement();		// graphml
+    xml.writeEndDocument();
+
+    return !xml.hasError();
+}
@@ -0,0 +1,36 @@
+/*
+ * File:	graphml.h
+ * Author:	agent
+ * Date:	2026-10-18
+ * Version:	1.1
+ *
+ * Purpose:	Declare the functions which read and write GraphML.
+ *
+ * Modification history:
+ * Oct 18, 2026 (agent V1.0)
+ *  (a) Initial version.
+ * Oct 18, 2026 (agent V1.1)
+ *  (a) Declare the saveGraphML() which writes a Graph_Description.
+ */
+
+#ifndef GRAPHML_H
+#define GRAPHML_H
+
+#include "graphloader.h"
+
+#include <QIODevice>
+#include <QString>
+#include <QVector>
+
+#define GRAPHML_FILE_EXTENSION	"graphml"
+
+class Graph;
+class Node;
+
+bool parseGraphML(QIODevice * in, QString graphName,
+		  Graph_Description &description, QString &errorMessage);
+Graph * readGraphML(QString fileName, QString &errorMessage);
+bool saveGraphML(QIODevice * out, QVector<Node *> nodes);
+bool saveGraphML(QIODevice * out, const Graph_Description &description);
+
+#endif // GRAPHML_H
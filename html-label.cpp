@@ -2,7 +2,7 @@
  * File:	html-label.cpp	    Formerly label.cpp
  * Author:	Rachel Bood
  * Date:	2014-??-??
- * Version:	1.8
+ * Version:	1.12
  * 
  * Purpose:	Implement the functions relating to node and edge labels.
  *		(Some places in the code use "weight" for "edge label".)
@@ -51,13 +51,35 @@
  *	     latter is supported by HTML4, the former maybe not.
  *  (b) Remove the function "setTextInteraction()" which has not been
  *	called in many a year, if ever.
+ * Oct 18, 2026 (agent V1.9)
+ *  (a) eventFilter() no longer emboldens the edit tab entry itself
+ *	(editTabLabel is gone); MainWindow watches the scene's focus
+ *	item for that now.
+ * Oct 18, 2026 (agent V1.10)
+ *  (a) paint() doesn't draw a label which is too small (on the
+ *	screen) to read.
+ * Oct 18, 2026 (agent V1.11)
+ *  (a) A label now remembers the point it is centred on (see
+ *	setCentre()) and moves itself whenever its size changes,
+ *	rather than being moved by its parent's paint().
+ *	setHtmlLabel() no longer positions the label itself.
+ * Oct 18, 2026 (agent V1.12)
+ *  (a) paint() tells an export from a view by isExporting() (see
+ *	defuns.h), not by the widget, which is null in a view too
+ *	when the label's graph is cached.
  */
 
 #include "defuns.h"
 #include "html-label.h"
 
 #include <QTextCursor>
+#include <QTextDocument>
+#include <QAbstractTextDocumentLayout>
 #include <QEvent>
+#include <QFontMetricsF>
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include <QGraphicsScene>
 #include <QGraphicsSceneMouseEvent>
 #include <QDebug>
 #include <QInputMethodEvent>
@@ -82,13 +104,14 @@ HTML_Label::HTML_Label(QGraphicsItem * parent)
     this->setFont(font);
     setTextInteractionFlags(Qt::TextEditorInteraction);
 
+    // Stay centred as the text (or font) changes, including while
+    // the label is being edited on the canvas.
+    connect(document()->documentLayout(), SIGNAL(documentSizeChanged(QSizeF)),
+	    this, SLOT(recentre()));
     if (parentItem() != nullptr)
-        setPos(parentItem()->boundingRect().center().x()
-	       - boundingRect().width() / 2.,
-               parentItem()->boundingRect().center().y()
-	       - boundingRect().height() / 2.);
+	centre = parentItem()->boundingRect().center();
+    recentre();
 
-    editTabLabel = nullptr;
     installEventFilter(this);
 }
 
@@ -96,7 +119,6 @@ HTML_Label::HTML_Label(QGraphicsItem * parent)
 /*
  * Name:        eventFilter()
  * Purpose:     Intercepts events related to canvas labels so we can
- *              identify the location of the item on the edit tab and
  *              transfer text data between the nodes/edges and the labels.
  * Arguments:
  * Output:	Nothing.
@@ -112,22 +134,12 @@ HTML_Label::eventFilter(QObject * obj, QEvent * event)
 {
     if (event->type() == QEvent::FocusIn)
     {
-        // Embolden the header for this item's entry on the edit tab
-        QFont font = editTabLabel->font();
-        font.setBold(true);
-        editTabLabel->setFont(font);
-
-        // Now update the editable text on the canvas temporarily
+        // Update the editable text on the canvas temporarily
         QString text = "<font face=\"cmtt10\">" + texLabelText + "</font>";
         setHtml(text);
     }
     else if (event->type() == QEvent::FocusOut)
     {
-	// Undo the bold text
-        QFont font = editTabLabel->font();
-        font.setBold(false);
-        editTabLabel->setFont(font);
-
         // Let the parent know to update and reformat the label text.
         emit editDone(toPlainText());
     }
@@ -161,7 +173,7 @@ HTML_Label::eventFilter(QObject * obj, QEvent * event)
  * Returns:	Nothing.
  * Assumptions:	None.
  * Bugs:	None.
- * Notes:	None.
+ * Notes:	The label recentres itself if its size changes.
  */
 
 void
@@ -170,21 +182,89 @@ HTML_Label::setHtmlLabel(QString string)
     qDeb() << "HL:setHtmlLabel(" << string << ") called";
 
     this->setHtml(strToHtml(string));
+}
 
-    if (parentItem() != nullptr)
-        setPos(parentItem()->boundingRect().center().x()
-	       - boundingRect().width() / 2.,
-               parentItem()->boundingRect().center().y()
-	       - boundingRect().height() / 2.);
+
+
+/*
+ * Name:	setCentre()
+ * Purpose:	Say where the middle of the label should be.
+ * Arguments:	The point, in the parent's coordinates.
+ * Outputs:	Nothing.
+ * Modifies:	centre, and the label's position.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	The parent calls this when its geometry changes (e.g.,
+ *		Edge::adjust(), Node::setDiameter()); recentre() takes
+ *		care of changes to the label itself.
+ */
+
+void
+HTML_Label::setCentre(QPointF aCentre)
+{
+    centre = aCentre;
+    recentre();
 }
 
 
 
+/*
+ * Name:	recentre()
+ * Purpose:	Move the label so that its middle is at centre.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	The label's position.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	Connected to the document layout's documentSizeChanged()
+ *		signal, after QGraphicsTextItem's own connection, so
+ *		boundingRect() is already up to date when this is called.
+ *		setPos() does nothing if the position hasn't changed.
+ */
+
+void
+HTML_Label::recentre()
+{
+    QRectF rect = boundingRect();
+    setPos(centre.x() - rect.width() / 2., centre.y() - rect.height() / 2.);
+}
+
+
+
+/*
+ * Name:	paint()
+ * Purpose:	Draw the label, if it is big enough to read.
+ * Arguments:	QPainter *, QStyleOptionGraphicsItem *, QWidget *
+ * Outputs:	The label, to the painter.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	When a view is zoomed far out, rasterizing the text of
+ *		thousands of labels only to get a few grey pixels each
+ *		is what makes panning slow, so a label whose lines are
+ *		less than LOD_MIN_LABEL_PIXELS high on the screen is
+ *		skipped.  A label being edited is always drawn, and so
+ *		is everything drawn while exporting (see
+ *		isExporting()).  The widget can't be used to tell,
+ *		since a view paints cached items with no widget.
+ */
+
 void
 HTML_Label::paint(QPainter * painter,
 		  const QStyleOptionGraphicsItem * option,
 		  QWidget * widget)
 {
+    if (!hasFocus() && !isExporting(scene()))
+    {
+	qreal lod = QStyleOptionGraphicsItem::levelOfDetailFromTransform(
+	    painter->worldTransform());
+	if (QFontMetricsF(font()).height() * lod < LOD_MIN_LABEL_PIXELS)
+	    return;
+    }
+
     QGraphicsTextItem::paint(painter, option, widget);
 }
 
@@ -2,7 +2,7 @@
  * File:	html-label.h	    formerly label.h
  * Author:	Rachel Bood
  * Date:	2014-??-??
- * Version:	1.2
+ * Version:	1.4
  * 
  * Purpose:	Declare the functions relating to the HTML version of
  *		node and edge labels (i.e., the version of the strings
@@ -23,13 +23,19 @@
  * July 29, 2020 (IC V1.2)
  *  (a) Added eventFilter() to receive canvas events so we can identify
  *      the node being edited/looked at in the edit tab list.
+ * Oct 18, 2026 (agent V1.3)
+ *  (a) Remove editTabLabel; the edit tab now follows the scene's
+ *	focus item instead (see MainWindow::canvasFocusChanged()).
+ * Oct 18, 2026 (agent V1.4)
+ *  (a) Add setCentre() and recentre(), so that a label keeps itself
+ *	centred on its node or edge.
  */
 
 #ifndef HTML_LABEL_H
 #define HTML_LABEL_H
 
 #include <QGraphicsTextItem>
-#include <QLabel>
+#include <QPointF>
 
 class HTML_Label : public QGraphicsTextItem
 {
@@ -43,8 +49,8 @@ public:
     int type() const { return Type; }
 
     void setHtmlLabel(QString string);
+    void setCentre(QPointF aCentre);
     static QString strToHtml(QString str);
-    QLabel * editTabLabel;
     QString texLabelText;
 
 signals:
@@ -54,6 +60,12 @@ protected:
     void paint(QPainter * painter, const QStyleOptionGraphicsItem * option,
 	       QWidget * widget);
     bool eventFilter(QObject *obj, QEvent *event);
+
+private slots:
+    void recentre();
+
+private:
+    QPointF centre;	// In the parent's coordinates.
 };
 
 #endif // LABEL_H
@@ -0,0 +1,517 @@
+/*
+ * File:	libraryindex.cpp
+ * Author:	agent
+ * Date:	2026-10-18
+ * Version:	1.2
+ *
+ * Purpose:	Keep a list of the graph-ic files in the graph library
+ *		without walking the library at every startup.
+ *
+ *		load_Graphic_Library() used to walk the whole library
+ *		directory with a QDirIterator, stat()ing every file, on
+ *		the GUI thread, which is slow when the library is big or
+ *		on a network file system.  A LibraryIndex instead reads
+ *		the list (the relative path and mtime of each file) from
+ *		an index file in the user's cache directory, and then
+ *		checks it against the library on a worker thread.  After
+ *		that a QFileSystemWatcher watches every directory of the
+ *		library, and only the directories it reports as changed
+ *		are scanned again.  Whenever the list changes the index
+ *		file is rewritten and changed() is emitted.
+ *
+ *		The index file is a QDataStream with
+ *		    quint32 INDEX_MAGIC, quint32 INDEX_VERSION,
+ *		    QString (absolute) library directory,
+ *		    quint32 number of entries,
+ *		    and for each entry: QString path, qint64 mtime.
+ *
+ * Modification history:
+ * Oct 18, 2026 (agent V1.0)
+ *  (a) Initial version.
+ * Oct 18, 2026 (agent V1.1)
+ *  (a) Gzipped graph-ic files (foo.grphc.gz) are library graphs
+ *	too.
+ * Oct 18, 2026 (agent V1.2)
+ *  (a) Add contains(), so MainWindow can tell which saved files
+ *	get a binary companion.
+ */
+
+#include "libraryindex.h"
+#include "compressedfile.h"
+#include "defuns.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QtConcurrent>
+
+#define INDEX_MAGIC	0x47524958	// "GRIX"
+#define INDEX_VERSION	1
+#define INDEX_FILE	"index"
+
+// How long to wait for a burst of changes to settle before rescanning.
+#define RESCAN_DELAY_MS	500
+
+
+
+/*
+ * Name:	LibraryIndex()
+ * Purpose:	Constructor.
+ * Arguments:	The library directory and the parent object.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	The saved index (if any) is read here, so names() is
+ *		usable straight away; a full scan is then started in
+ *		the background.
+ */
+
+LibraryIndex::LibraryIndex(QString directory, QObject * parent)
+    : QObject(parent)
+{
+    this->directory = QDir(directory).absolutePath();
+
+    rescanTimer.setSingleShot(true);
+    rescanTimer.setInterval(RESCAN_DELAY_MS);
+    connect(&rescanTimer, SIGNAL(timeout()), this, SLOT(startScan()));
+    connect(&scanWatcher, SIGNAL(finished()), this, SLOT(scanDone()));
+    connect(&dirWatcher, SIGNAL(directoryChanged(QString)),
+	    this, SLOT(directoryChanged(QString)));
+
+    if (!readIndex())
+	qDeb() << "LI::LI(): no usable index for " << this->directory;
+    refresh();
+}
+
+
+
+/*
+ * Name:	names()
+ * Purpose:	Return the names of the library graphs.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The base name of each file, in index order.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	The order is that in which the files were first found,
+ *		so adding a file to the library doesn't move the others
+ *		around in the graph type menu.
+ */
+
+QStringList
+LibraryIndex::names() const
+{
+    QStringList list;
+
+    foreach (const Library_Entry &e, entryList)
+	list.append(QFileInfo(e.path).baseName());
+
+    return list;
+}
+
+
+
+QVector<Library_Entry>
+LibraryIndex::entries() const
+{
+    return entryList;
+}
+
+
+
+/*
+ * Name:	cacheDirectory()
+ * Purpose:	Return the directory holding the index of this library.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The directory name (which may not exist yet).
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	Each library gets its own directory, named from a hash
+ *		of the library's path, under the same organization and
+ *		application names as the QSettings.
+ */
+
+QString
+LibraryIndex::cacheDirectory() const
+{
+    QByteArray hash = QCryptographicHash::hash(directory.toUtf8(),
+					       QCryptographicHash::Md5);
+
+    return QStandardPaths::writableLocation(
+	QStandardPaths::GenericCacheLocation)
+	+ "/Acadia/Graphic/library-" + QString(hash.toHex());
+}
+
+
+
+/*
+ * Name:	refresh()
+ * Purpose:	Check the whole library against the index.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	dirtySubdirs.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	The scan is done in the background; changed() is
+ *		emitted afterwards if anything was different.
+ */
+
+void
+LibraryIndex::refresh()
+{
+    dirtySubdirs.insert("");
+    startScan();
+}
+
+
+
+/*
+ * Name:	contains()
+ * Purpose:	Tell whether a file is in (a directory of) the library.
+ * Arguments:	The name of the file.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	True iff the file is under the library directory.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	The file need not exist, nor be in the index yet.
+ */
+
+bool
+LibraryIndex::contains(QString fileName) const
+{
+    QString dir = QFileInfo(fileName).absolutePath();
+
+    return dir == directory || dir.startsWith(directory + "/");
+}
+
+
+
+/*
+ * Name:	fileSaved()
+ * Purpose:	Note that a file may have been added to or changed in
+ *		the library.
+ * Arguments:	The name of the file.
+ * Outputs:	Nothing.
+ * Modifies:	dirtySubdirs.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	Files outside the library are ignored.  Otherwise the
+ *		file's directory is rescanned, as if the watcher had
+ *		reported it.
+ */
+
+void
+LibraryIndex::fileSaved(QString fileName)
+{
+    if (!contains(fileName))
+	return;
+
+    directoryChanged(QFileInfo(fileName).absolutePath());
+}
+
+
+
+/*
+ * Name:	directoryChanged()
+ * Purpose:	Note that a library directory has changed.
+ * Arguments:	The (absolute) directory name.
+ * Outputs:	Nothing.
+ * Modifies:	dirtySubdirs.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	Changing the contents of an existing file does not
+ *		always change its directory, so that is only noticed
+ *		at the next refresh() (or fileSaved()).
+ * Notes:	The directory is rescanned once things have been quiet
+ *		for RESCAN_DELAY_MS, so copying many files into the
+ *		library causes only a few scans.
+ */
+
+void
+LibraryIndex::directoryChanged(QString path)
+{
+    QString subdir = QDir(directory).relativeFilePath(path);
+
+    if (subdir == ".")
+	subdir = "";
+    qDeb() << "LI::directoryChanged(" << path << "): subdir " << subdir;
+    dirtySubdirs.insert(subdir);
+    rescanTimer.start();
+}
+
+
+
+/*
+ * Name:	startScan()
+ * Purpose:	Scan the directories which may have changed.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	dirtySubdirs.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	Only one scan runs at a time; anything which changes
+ *		while one is running is scanned when it is done.
+ */
+
+void
+LibraryIndex::startScan()
+{
+    if (scanWatcher.isRunning() || dirtySubdirs.isEmpty())
+	return;
+
+    QStringList subdirs;
+    if (dirtySubdirs.contains(""))
+	subdirs.append("");
+    else
+	subdirs = dirtySubdirs.values();
+    dirtySubdirs.clear();
+
+    scanWatcher.setFuture(QtConcurrent::run(scan, directory, subdirs));
+}
+
+
+
+/*
+ * Name:	scan()
+ * Purpose:	Find the graph-ic files in part of the library.
+ * Arguments:	The library directory and the subdirectories of it to
+ *		scan ("" meaning the whole library).
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	What was found.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	Runs on a pool thread via QtConcurrent.  This is the
+ *		same walk as the old load_Graphic_Library() did.
+ */
+
+Library_Scan
+LibraryIndex::scan(QString directory, QStringList subdirs)
+{
+    Library_Scan result;
+    QDir libDir(directory);
+
+    result.subdirs = subdirs;
+    foreach (QString subdir, subdirs)
+    {
+	QString top = subdir.isEmpty() ? directory : directory + "/" + subdir;
+	if (!QFileInfo(top).isDir())
+	    continue;
+	result.dirs.append(top);
+
+	QDirIterator dirIt(top,
+			   QDir::Files | QDir::AllDirs | QDir::NoDotAndDotDot,
+			   QDirIterator::Subdirectories);
+	while (dirIt.hasNext())
+	{
+	    dirIt.next();
+	    QFileInfo fileInfo = dirIt.fileInfo();
+	    if (fileInfo.isDir())
+		result.dirs.append(fileInfo.filePath());
+	    else if (isGraphicFile(fileInfo.fileName()))
+	    {
+		Library_Entry e;
+		e.path = libDir.relativeFilePath(fileInfo.filePath());
+		e.mtime = fileInfo.lastModified().toMSecsSinceEpoch();
+		result.entries.append(e);
+	    }
+	}
+    }
+
+    return result;
+}
+
+
+
+/*
+ * Name:	scanDone()
+ * Purpose:	Merge the results of a scan into the index.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	entryList, the index file, dirWatcher.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	Entries outside the scanned directories are kept as
+ *		they are; those inside are updated or dropped, and newly
+ *		found files are added at the end.
+ *		Emits changed() if the list is different.
+ */
+
+void
+LibraryIndex::scanDone()
+{
+    Library_Scan result = scanWatcher.result();
+    QHash<QString, qint64> found;
+    QStringList foundOrder;
+
+    foreach (const Library_Entry &e, result.entries)
+    {
+	if (!found.contains(e.path))
+	    foundOrder.append(e.path);
+	found.insert(e.path, e.mtime);
+    }
+
+    QVector<Library_Entry> newList;
+    newList.reserve(entryList.count() + found.count());
+    foreach (Library_Entry e, entryList)
+    {
+	bool scanned = false;
+	foreach (QString subdir, result.subdirs)
+	{
+	    if (subdir.isEmpty() || e.path.startsWith(subdir + "/"))
+	    {
+		scanned = true;
+		break;
+	    }
+	}
+	if (scanned)
+	{
+	    if (!found.contains(e.path))
+		continue;
+	    e.mtime = found.take(e.path);
+	}
+	newList.append(e);
+    }
+    foreach (QString path, foundOrder)
+    {
+	if (found.contains(path))
+	{
+	    Library_Entry e;
+	    e.path = path;
+	    e.mtime = found.value(path);
+	    newList.append(e);
+	}
+    }
+
+    // Watch any directories we haven't seen before.
+    QStringList watched = dirWatcher.directories();
+    QStringList newDirs;
+    foreach (QString dir, result.dirs)
+	if (!watched.contains(dir))
+	    newDirs.append(dir);
+    if (!newDirs.isEmpty())
+	dirWatcher.addPaths(newDirs);
+
+    bool same = newList.count() == entryList.count();
+    for (int i = 0; same && i < newList.count(); i++)
+	same = newList.at(i).path == entryList.at(i).path
+	    && newList.at(i).mtime == entryList.at(i).mtime;
+
+    if (!same)
+    {
+	qDeb() << "LI::scanDone(): " << newList.count() << " graphs (was "
+	       << entryList.count() << ")";
+	entryList = newList;
+	writeIndex();
+	emit changed();
+    }
+
+    if (!dirtySubdirs.isEmpty())
+	rescanTimer.start();
+}
+
+
+
+/*
+ * Name:	readIndex()
+ * Purpose:	Read the saved index of this library.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	entryList.
+ * Returns:	True iff a valid index for this library was read.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	Anything wrong with the file (including it being for a
+ *		different directory) just means we start with an empty
+ *		list and wait for the scan.
+ */
+
+bool
+LibraryIndex::readIndex()
+{
+    QFile file(cacheDirectory() + "/" INDEX_FILE);
+
+    if (!file.open(QIODevice::ReadOnly))
+	return false;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_0);
+
+    quint32 magic, version, count;
+    QString dir;
+    in >> magic >> version >> dir >> count;
+    if (in.status() != QDataStream::Ok || magic != INDEX_MAGIC
+	|| version != INDEX_VERSION || dir != directory)
+	return false;
+
+    QVector<Library_Entry> list;
+    for (quint32 i = 0; i < count; i++)
+    {
+	Library_Entry e;
+	in >> e.path >> e.mtime;
+	if (in.status() != QDataStream::Ok)
+	    return false;
+	list.append(e);
+    }
+
+    entryList = list;
+    return true;
+}
+
+
+
+/*
+ * Name:	writeIndex()
+ * Purpose:	Save the index of this library.
+ * Arguments:	None.
+ * Outputs:	The index file.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	A QSaveFile is used so that a crash can't leave a
+ *		half-written index.  Failure is not fatal: the next
+ *		startup just has to wait for a scan.
+ */
+
+void
+LibraryIndex::writeIndex()
+{
+    QDir().mkpath(cacheDirectory());
+    QSaveFile file(cacheDirectory() + "/" INDEX_FILE);
+
+    if (!file.open(QIODevice::WriteOnly))
+    {
+	qDeb() << "LI::writeIndex(): can't write " << file.fileName()
+	       << ": " << file.errorString();
+	return;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_0);
+    out << quint32(INDEX_MAGIC) << quint32(INDEX_VERSION) << directory
+	<< quint32(entryList.count());
+    foreach (const Library_Entry &e, entryList)
+	out << e.path << e.mtime;
+
+    if (!file.commit())
+	qDeb() << "LI::writeIndex(): can't write " << file.fileName()
+	       << ": " << file.errorString();
+}
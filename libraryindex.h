@@ -0,0 +1,80 @@
+/*
+ * File:	libraryindex.h
+ * Author:	agent
+ * Date:	2026-10-18
+ * Version:	1.1
+ *
+ * Purpose:	Declare the LibraryIndex class, which keeps an on-disk
+ *		list of the graph-ic files in the graph library.
+ *
+ * Modification history:
+ * Oct 18, 2026 (agent V1.0)
+ *  (a) Initial version.
+ * Oct 18, 2026 (agent V1.1)
+ *  (a) Add contains().
+ */
+
+#ifndef LIBRARYINDEX_H
+#define LIBRARYINDEX_H
+
+#include <QFileSystemWatcher>
+#include <QFutureWatcher>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+#include <QVector>
+
+typedef struct libraryEntry
+{
+    QString	path;		// Relative to the library directory.
+    qint64	mtime;		// ms since the epoch.
+} Library_Entry;
+
+// The result of scanning part of the library on a worker thread.
+typedef struct libraryScan
+{
+    QStringList		    subdirs;	// What was scanned ("" is all).
+    QVector<Library_Entry>  entries;	// The graph-ic files found.
+    QStringList		    dirs;	// Every directory visited.
+} Library_Scan;
+
+class LibraryIndex : public QObject
+{
+    Q_OBJECT
+
+  public:
+    explicit LibraryIndex(QString directory, QObject * parent = 0);
+
+    QStringList names() const;
+    QVector<Library_Entry> entries() const;
+    QString cacheDirectory() const;
+    bool contains(QString fileName) const;
+
+  public slots:
+    void refresh();
+    void fileSaved(QString fileName);
+
+  signals:
+    void changed();
+
+  private slots:
+    void directoryChanged(QString path);
+    void startScan();
+    void scanDone();
+
+  private:
+    bool readIndex();
+    void writeIndex();
+    static Library_Scan scan(QString directory, QStringList subdirs);
+
+    QString			    directory;
+    QVector<Library_Entry>	    entryList;
+    QFileSystemWatcher		    dirWatcher;
+    QFutureWatcher<Library_Scan>    scanWatcher;
+    QTimer			    rescanTimer;
+    QSet<QString>		    dirtySubdirs;
+};
+
+#endif // LIBRARYINDEX_H
@@ -2,7 +2,7 @@
  * File:    main.cpp
  * Author:  Rachel Bood 100088769
  * Date:    2014/11/07
- * Version: 1.4
+ * Version: 1.5
  *
  * Purpose: executes the mainwindow.ui file
  *
@@ -17,8 +17,12 @@
  *      when resizing the window.
  * August 18, 2020 (IC V1.4)
  *  (a) Added cmtt10 and cmsy10 fonts to be embeded.
+ * Oct 18, 2026 (agent V1.5)
+ *  (a) If --batch (or -b) is given, use the offscreen platform and
+ *	run the batch renderer instead of creating the MainWindow.
  */
 
+#include "batchrender.h"
 #include "mainwindow.h"
 #include <QApplication>
 #include <QFileSystemModel>
@@ -28,6 +32,12 @@
 int
 main(int argc, char * argv[])
 {
+    bool batch = isBatchInvocation(argc, argv);
+
+    // No windows in batch mode, so don't need (or want) a display.
+    if (batch && qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+	qputenv("QT_QPA_PLATFORM", "offscreen");
+
     QApplication a(argc, argv);
 
     QFontDatabase::addApplicationFont(":/fonts/cmmi10.ttf");
@@ -36,6 +46,9 @@ main(int argc, char * argv[])
     QFontDatabase::addApplicationFont(":/fonts/cmtt10.ttf");
     QFontDatabase::addApplicationFont(":/fonts/arimo.ttf");
 
+    if (batch)
+	return batchRender(a.arguments());
+
     MainWindow w;
     w.show();
     w.set_Interface_Sizes();
@@ -2,7 +2,7 @@
  * File:	mainwindow.cpp
  * Author:	Rachel Bood
  * Date:	January 25, 2015.
- * Version:	1.50
+ * Version:	1.75
  *
  * Purpose:	Implement the main window and functions called from there.
  *
@@ -291,27 +291,182 @@
  *      can specify the start number with EdgeNumLabelStart.
  *  (b) Widgets related to numbering slightly renamed to indicate whether they
  *      are related to an edge or a node for clarity.
+ * Oct 18, 2026 (agent V1.51)
+ *  (a) save_Graph() flushes any edges queued by Edge::queueAdjust()
+ *      before writing anything, so that the output does not depend
+ *      on whether the event loop has run since the last node move.
+ * Oct 18, 2026 (agent V1.52)
+ *  (a) Split the parsing of .grphc files out of select_Custom_Graph()
+ *      into readGraphIc(), which reports errors through a string
+ *      instead of a QMessageBox, frees the partially built graph on
+ *      error, and checks that edge endpoints are valid node numbers.
+ *      This (and the save*() functions) is now used by the batch
+ *      renderer in batchrender.cpp.
+ *  (b) GRAPHiCS_FILE_EXTENSION moved to defuns.h.
+ * Oct 18, 2026 (agent V1.53)
+ *  (a) save_Graph() now asks for the resolution of image output and
+ *      hands the work to exportTiledImage(), which renders the canvas
+ *      in tiles on worker threads instead of into one QPixmap.
+ *      TIF output is streamed to the file a band at a time, so its
+ *      memory use no longer depends on the size of the image.
+ * Oct 18, 2026 (agent V1.54)
+ *  (a) The "Edit Graph" tab is now a QTableView onto an EditTabModel
+ *	instead of a grid with a row of widgets and five controllers
+ *	for each node and edge.  updateEditTab(int) is gone and
+ *	updateEditTab() just asks the model to rebuild itself; it is
+ *	now also called when the canvas emits somethingChanged(),
+ *	since the model no longer tracks deletions itself.
+ *  (b) Added canvasFocusChanged(), which replaces the emboldening
+ *	of the edit tab entry done through HTML_Label::editTabLabel.
+ * Oct 18, 2026 (agent V1.55)
+ *  (a) Added expandCompactEdges(), called before anything is written
+ *	from the nodes' edge lists (save_Graph(), dumpTikZ() and
+ *	dumpGraphIc()), since those lists do not include the edges in
+ *	a graph's EdgeBundle.
+ * Oct 18, 2026 (agent V1.56)
+ *  (a) findDefaults() counts the nodes and edges using each (shared)
+ *	style entry, and then tallies the properties of each distinct
+ *	entry once, rather than reading every property of every item.
+ *  (b) readGraphIc() makes nodes (edges) with the same properties
+ *	share one style entry.
+ * Oct 18, 2026 (agent V1.57)
+ *  (a) Added layout_Graphs() (Edit -> Lay Out Graphs, Ctrl-L), which
+ *	runs a ForceLayout on each graph on the canvas in the
+ *	background, and layoutDone(), which moves the nodes when the
+ *	layouts are finished.
+ * Oct 18, 2026 (agent V1.58)
+ *  (a) save_Graph() also writes a binary (.grphb) companion of each
+ *	.grphc file, and select_Custom_Graph() reads the companion
+ *	instead of the text file when it is up to date.  .grphb files
+ *	can also be opened directly.
+ * Oct 18, 2026 (agent V1.59)
+ *  (a) readGraphIc() is now parseGraphIc() followed by a GraphBuilder.
+ *  (b) select_Custom_Graph() hands big .grphc files to a GraphLoader,
+ *	which parses them on a worker thread and builds the items a
+ *	chunk at a time, so the window stays responsive.  A progress
+ *	dialog (with a Cancel button) is shown while it works; the
+ *	graph is put into the preview by customGraphLoaded().
+ * Oct 18, 2026 (agent V1.60)
+ *  (a) load_Graphic_Library() gets the names of the library graphs
+ *	from a LibraryIndex instead of walking the library directory
+ *	at startup, and libraryChanged() updates the graph type menu
+ *	when the index finds the library has changed.
+ *  (b) save_Graph() tells the LibraryIndex about the saved file
+ *	(which rebuilds the menu if need be), rather than adding the
+ *	file to the graph type menu itself.
+ * Oct 18, 2026 (agent V1.61)
+ *  (a) The library graphs in the graph type menu are shown with
+ *	thumbnails, which a ThumbnailCache finds or makes in the
+ *	background the first time the menu is popped up.  Added
+ *	eventFilter(), requestThumbnails() and thumbnailReady().
+ * Oct 18, 2026 (agent V1.62)
+ *  (a) load_Graphic_File() also offers edge lists (.edges, and
+ *	SNAP-style .txt files), which select_Custom_Graph() imports
+ *	with readEdgeList().
+ * Oct 18, 2026 (agent V1.63)
+ *  (a) save_Graph() can write GraphML (saveGraphML()) and Graphviz
+ *	DOT (saveDot()), and load_Graphic_File() offers both, which
+ *	select_Custom_Graph() reads with readGraphML() and readDot().
+ * Oct 18, 2026 (agent V1.64)
+ *  (a) Added export_All() (File -> Export All...), which writes the
+ *	canvas in several formats at once from one snapshot of it,
+ *	one format per pool thread, and exportDone().
+ * Oct 18, 2026 (agent V1.65)
+ *  (a) saveTikZ() defines each distinct colour once (tikzColour())
+ *	and puts each distinct set of non-default node, edge and
+ *	label options into a named style (tikzStyle()), instead of
+ *	a \definecolor per item and the options on every item.
+ * Oct 18, 2026 (agent V1.66)
+ *  (a) Add autoSaver, which saves the canvas in the background
+ *	every so often, and recoverAutosave(), which offers the
+ *	canvas of a session which crashed.  closeEvent() removes
+ *	the autosave file.
+ *  (b) snapshotScene() uses describeNode() and describeEdge().
+ * Oct 18, 2026 (agent V1.67)
+ *  (a) select_Custom_Graph() reads .grphc files through a
+ *	CompressedFile, so they may be gzipped; load_Graphic_File()
+ *	offers .grphc.gz files, and generate_Graph() finds library
+ *	graphs which are only there compressed.
+ * Oct 18, 2026 (agent V1.68)
+ *  (a) Removed expandCompactEdges().  Saving no longer turns the
+ *	compact edges of every graph on the canvas into Edges: the
+ *	writers get the edges from describeEdges(), which includes
+ *	compact edges and leaves the scene alone.  findDefaults()
+ *	takes that list of edges too.
+ *  (b) snapshotScene() also uses describeEdges().
+ * Oct 18, 2026 (agent V1.69)
+ *  (a) Split saveGraphIc(): the new one writes a Graph_Description,
+ *	so the autosaver no longer has to build the graph (on a pool
+ *	thread) to save it.  The old one describes the nodes and
+ *	edges and calls it.  Also fixed the typo which compared y
+ *	with minx when finding the middle of the graph.
+ * Oct 18, 2026 (agent V1.70)
+ *  (a) Hide the load progress dialog when a load finishes, fails
+ *	or is replaced by another one (reset() doesn't hide it, since
+ *	autoClose is off).
+ * Oct 18, 2026 (agent V1.71)
+ *  (a) Mark the scene as exporting (see isExporting()) while an SVG
+ *	file is written, and for the whole life of an "Export all"
+ *	scene.
+ * Oct 18, 2026 (agent V1.72)
+ *  (a) Use Graph::setExporting() for that, so that the graphs are
+ *	not drawn from their caches (which put an <image> of the
+ *	edges in SVG files).
+ * Oct 18, 2026 (agent V1.73)
+ *  (a) Only write a .grphb companion for (plain) .grphc files in the
+ *	library, and only read one which binaryCompanionIsCurrent()
+ *	says was made from the .grphc file as it is now, rather than
+ *	trusting the files' modification times.
+ * Oct 18, 2026 (agent V1.74)
+ *  (a) "Export all" writes the text formats straight from the
+ *	snapshot (with new Graph_Description versions of
+ *	saveEdgelist() and saveTikZ()), and only builds one scene,
+ *	shared by all of the images, when an image format is chosen.
+ * Oct 18, 2026 (agent V1.75)
+ *  (a) select_Custom_Graph() has the GraphLoader read (and lay out)
+ *	edge lists, so the layout no longer runs on the GUI thread.
+ *	The progress dialog is set up by the new loadInBackground().
  */
 
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
+#include "autosave.h"
+#include "binaryformat.h"
+#include "compressedfile.h"
+#include "dotformat.h"
 #include "edge.h"
+#include "edgebundle.h"
+#include "edgelist.h"
+#include "node.h"
 #include "basicgraphs.h"
-#include "colourlinecontroller.h"
-#include "sizecontroller.h"
-#include "labelcontroller.h"
-#include "labelsizecontroller.h"
-#include "colourfillcontroller.h"
+#include "edittabdelegate.h"
+#include "edittabmodel.h"
+#include "graphloader.h"
+#include "graphml.h"
+#include "libraryindex.h"
+#include "thumbnailcache.h"
+#include "tiledexport.h"
 
 #include <unordered_map>
 
+#include <QAbstractItemView>
+#include <QCheckBox>
+#include <QDialog>
+#include <QDialogButtonBox>
+#include <QFormLayout>
+#include <QSpinBox>
+#include <QVBoxLayout>
 #include <QDesktopWidget>
 #include <QColorDialog>
 #include <QGraphicsItem>
+#include <QHash>
 #include <QMessageBox>
 #include <QFileDialog>
+#include <QHeaderView>
+#include <QInputDialog>
 #include <QShortcut>
 #include <qmath.h>
+#include <QtConcurrent>
 #include <QtSvg/QSvgGenerator>
 #include <QErrorMessage>
 #include <QDate>
@@ -319,12 +474,27 @@
 #include <QCloseEvent>
 
 
-#define GRAPHiCS_FILE_EXTENSION "grphc"
 #define GRAPHiCS_SAVE_FILE	"Graph-ic (*." GRAPHiCS_FILE_EXTENSION ")"
+#define GRAPHiCS_OPEN_FILE	"Graph-ic (*." GRAPHiCS_FILE_EXTENSION \
+				" *." GRAPHiCS_FILE_EXTENSION \
+				"." GZIP_FILE_EXTENSION \
+				" *." GRAPHiCS_BIN_EXTENSION ")"
 #define GRAPHiCS_SAVE_SUBDIR	"graph-ic"
 #define TIKZ_SAVE_FILE		"TikZ (*.tikz)"
 #define EDGES_SAVE_FILE		"Edge list (*.edges)"
+#define EDGES_OPEN_FILE		"Edge list (*." EDGES_FILE_EXTENSION \
+				" *." SNAP_FILE_EXTENSION ")"
 #define SVG_SAVE_FILE		"SVG (*.svg)"
+#define GRAPHML_SAVE_FILE	"GraphML (*." GRAPHML_FILE_EXTENSION ")"
+#define GRAPHML_OPEN_FILE	GRAPHML_SAVE_FILE
+#define DOT_SAVE_FILE		"Graphviz (*." DOT_FILE_EXTENSION ")"
+#define DOT_OPEN_FILE		"Graphviz (*." DOT_FILE_EXTENSION \
+				" *." DOT_ALT_FILE_EXTENSION ")"
+
+// .grphc files at least this big are read by a GraphLoader.
+#define LOAD_IN_BACKGROUND_BYTES    (512 * 1024)
+// About how much smaller gzip makes a .grphc file.
+#define GZIP_RATIO		    8
 
 // The unit of these is points:
 #define TITLE_SIZE	    20
@@ -383,6 +553,22 @@ QMainWindow(parent),
     connect(ui->actionSave, SIGNAL(triggered()), this, SLOT(save_Graph()));
     connect(ui->actionOpen_File, SIGNAL(triggered()),
 	    this, SLOT(load_Graphic_File()));
+    connect(ui->actionLayout_Graphs, SIGNAL(triggered()),
+	    this, SLOT(layout_Graphs()));
+
+    layoutWatcher = new QFutureWatcher<void>(this);
+    connect(layoutWatcher, SIGNAL(finished()), this, SLOT(layoutDone()));
+
+    connect(ui->actionExport_All, SIGNAL(triggered()),
+	    this, SLOT(export_All()));
+    exportWatcher = new QFutureWatcher<void>(this);
+    connect(exportWatcher, SIGNAL(finished()), this, SLOT(exportDone()));
+
+    graphLoader = new GraphLoader(this);
+    connect(graphLoader, SIGNAL(loaded(Graph *)),
+	    this, SLOT(customGraphLoaded(Graph *)));
+    connect(graphLoader, SIGNAL(failed(QString)),
+	    this, SLOT(customGraphFailed(QString)));
 
     // Ctrl-Q quits.
     new QShortcut(QKeySequence(Qt::CTRL + Qt::Key_Q), this, SLOT(close()));
@@ -581,11 +767,28 @@ QMainWindow(parent),
     ui->canvas->snapToGrid(ui->snapToGrid_checkBox->isChecked());
 
     set_Font_Sizes();
-    // Initialize font sizes for ui labels/widgets (Linux fix).
-    gridLayout = new QGridLayout();
 
-    //ui->editGraph->setLayout(gridLayout);
-    ui->scrollAreaWidgetContents->setLayout(gridLayout);
+    // The edit tab is a view onto a model of the canvas items.  Fixed
+    // row heights let the view work out its geometry without looking
+    // at every row, and editors are only created for the cell being
+    // edited, so large graphs cost little here.
+    editTabModel = new EditTabModel(ui->canvas->scene(), this);
+    ui->editTableView->setModel(editTabModel);
+    ui->editTableView->setItemDelegate(
+	new EditTabDelegate(ui->editTableView));
+    ui->editTableView->verticalHeader()->setSectionResizeMode(
+	QHeaderView::Fixed);
+    ui->editTableView->horizontalHeader()->setSectionResizeMode(
+	EditTabModel::LabelCol, QHeaderView::Stretch);
+
+    connect(ui->canvas->scene(), SIGNAL(somethingChanged()),
+	    this, SLOT(updateEditTab()));
+    connect(ui->canvas->scene(),
+	    SIGNAL(focusItemChanged(QGraphicsItem*,QGraphicsItem*,
+				    Qt::FocusReason)),
+	    this,
+	    SLOT(canvasFocusChanged(QGraphicsItem*,QGraphicsItem*,
+				    Qt::FocusReason)));
 
     // Initialize Create Graph pane to default values
     on_graphType_ComboBox_currentIndexChanged(-1);
@@ -619,6 +822,12 @@ QMainWindow(parent),
     connect(settingsDialog, SIGNAL(saveDone()),
             this, SLOT(updateDpiAndPreview()));
 
+    // Save the canvas every so often, and offer the canvas of a
+    // session which crashed once the window is up.
+    autoSaver = new AutoSaver(ui->canvas->scene(), this);
+    if (autoSaver->hasRecovery())
+	QTimer::singleShot(0, this, SLOT(recoverAutosave()));
+
 
 #ifdef DEBUG
     // Info to help with dealing with HiDPI issues
@@ -648,6 +857,11 @@ QMainWindow(parent),
 
 MainWindow::~MainWindow()
 {
+    // The layout threads are using layoutJobs.
+    layoutWatcher->waitForFinished();
+    // Likewise the export threads and exportJobs (via exportTasks).
+    exportWatcher->waitForFinished();
+    graphLoader->cancel();
     delete ui;
 }
 
@@ -691,37 +905,44 @@ MainWindow::generate_Combobox_Titles()
  * Returns:	True on success.
  * Assumptions:	Args are valid.
  * Bugs:	?!
- * Notes:	Currently always returns T, but maybe in the future ...
+ * Notes:	Describes the nodes and their edges (including compact
+ *		edges) and writes the description with the
+ *		saveEdgelist() below.
  */
 
 bool
 saveEdgelist(QTextStream &outfile, QVector<Node *> nodes)
 {
-    QString edges = "";
+    Graph_Description description;
 
-    for (int i = 0; i < nodes.count(); i++)
-    {
-	for (int j = 0; j < nodes.at(i)->edgeList.count(); j++)
-	{
-	    Edge * edge = nodes.at(i)->edgeList.at(j);
+    describeGraph(nodes, description);
+    return saveEdgelist(outfile, description);
+}
 
-	    if (edge->sourceNode()->getID() == i
-		&& edge->destNode()->getID() > i)
-	    {
-		edges += QString::number(edge->sourceNode()->getID()) + ","
-		    + QString::number(edge->destNode()->getID()) + "\n";
-	    }
-	    else if (edge->destNode()->getID() == i
-		     && edge->sourceNode()->getID() > i)
-	    {
-		edges += QString::number(edge->destNode()->getID()) + ","
-		    + QString::number(edge->sourceNode()->getID())
-		    + "\n";
-	    }
-	}
-    }
-    outfile << nodes.count() << "\n";
-    outfile << edges;
+
+
+/*
+ * Name:	saveEdgelist()
+ * Purpose:	Save a graph description as an edgelist.
+ * Arguments:	A file pointer to write to and the description.
+ * Outputs:	An edge list of the graph to the file.
+ * Modifies:	Nothing.
+ * Returns:	True on success.
+ * Assumptions:	Args are valid.
+ * Bugs:	?!
+ * Notes:	Currently always returns T, but maybe in the future ...
+ *		Each edge is written with its lower-numbered node first.
+ *		This touches no QGraphicsItems, so it may be called on
+ *		any thread.
+ */
+
+bool
+saveEdgelist(QTextStream &outfile, const Graph_Description &description)
+{
+    outfile << description.nodes.count() << "\n";
+    foreach (const Edge_Description &e, description.edges)
+	outfile << qMin(e.source, e.dest) << "," << qMax(e.source, e.dest)
+		<< "\n";
 
     return true;
 }
@@ -852,17 +1073,22 @@ typedef struct
  * Name:	findDefaults()
  * Purpose:	Find the most common line colours, fill colours, pen widths,
  *		and so on, of the set of nodes and edges in the graph.
- * Arguments:	The list of nodes and int *'s to hold the R, G and B values.
+ * Arguments:	The descriptions of the nodes and their edges (see
+ *		describeGraph()), and int *'s to hold the R, G and B
+ *		values.
  * Outputs:	Nothing.
  * Modifies:	Nothing.
  * Returns:	The two sets of R, G and B.
  * Assumptions:	None.
  * Bugs:	?
  * Notes:	Returns (0,0,0) in the case there are no edges or vertices.
+ *		Nodes and edges are both plain descriptions, so that
+ *		this can run on any thread; each one is counted.
  */
 
 void
-findDefaults(QVector<Node *> nodes,
+findDefaults(const QVector<Node_Description> &nodes,
+	     const QVector<Edge_Description> &edges,
 	     nodeInfo * nodeDefaults_p, edgeInfo * edgeDefaults_p)
 {
     // Set the default defaults (sic).
@@ -885,24 +1111,23 @@ findDefaults(QVector<Node *> nodes,
     std::unordered_map<qreal, int> eLabelSize;
 
     // Populate all the node hashes.
-    for (int i = 0; i < nodes.count(); i++)
+    foreach (const Node_Description &d, nodes)
     {
-	Node * node = nodes.at(i);
-	R = node->getFillColour().red();
-	G = node->getFillColour().green();
-	B = node->getFillColour().blue();
+	R = d.fillColour.red();
+	G = d.fillColour.green();
+	B = d.fillColour.blue();
 	colour = R << 16 | G << 8 | B;
 	vFillColour[colour]++;
 
-	R = node->getLineColour().red();
-	G = node->getLineColour().green();
-	B = node->getLineColour().blue();
+	R = d.lineColour.red();
+	G = d.lineColour.green();
+	B = d.lineColour.blue();
 	colour = R << 16 | G << 8 | B;
 	vLineColour[colour]++;
 
-	vNodeDiam[node->getDiameter()]++;
-	vPenSize[node->getPenWidth()]++;
-	vLabelSize[node->getLabelSize()]++;
+	vNodeDiam[d.diameter]++;
+	vPenSize[d.penWidth]++;
+	vLabelSize[d.labelSize]++;
     }
 
     max_count = 0;
@@ -974,35 +1199,23 @@ findDefaults(QVector<Node *> nodes,
     nodeDefaults_p->labelSize = fresult;
     qDebu("nodeLabelSize: %.4f count = %d", fresult, max_count);
 
-    for (int i = 0; i < nodes.count(); i++)
+    // Likewise for the edges, but label sizes are only counted for
+    // edges which have a label.
+    foreach (const Edge_Description &e, edges)
     {
-	for (int j = 0; j < nodes.at(i)->edgeList.count(); j++)
+	R = e.colour.red();
+	G = e.colour.green();
+	B = e.colour.blue();
+	colour = R << 16 | G << 8 | B;
+	eLineColour[colour]++;
+	// Don't count 0's, they are likely bogus.
+	if (e.penWidth > 0)
+	    ePenSize[e.penWidth]++;
+	if (e.hasLabel && e.labelSize >= 1)
 	{
-	    // TODO: see TODO in Edge section of saveTikZ().
-	    Edge * edge = nodes.at(i)->edgeList.at(j);
-	    int sourceID = edge->sourceNode()->getID();
-	    int destID = edge->destNode()->getID();
-	    if ((sourceID == i && destID > i)
-		|| (destID == i && sourceID > i))
-	    {
-		R = edge->getColour().red();
-		G = edge->getColour().green();
-		B = edge->getColour().blue();
-		colour = R << 16 | G << 8 | B;
-		eLineColour[colour]++;
-		// Don't count 0's, they are likely bogus.
-		if (edge->getPenWidth() > 0)
-		    ePenSize[edge->getPenWidth()]++;
-		// Only count the label sizes for edges which have a label.
-		if (edge->getLabel().length() > 0)
-		{
-		    qDebu("i=%d, j=%d, label=/%s/, size=%.1f",
-			  i, j, edge->getLabel().toLatin1().data(),
-			  edge->getLabelSize());
-		    if (edge->getLabelSize() >= 1)
-			eLabelSize[edge->getLabelSize()]++;
-		}
-	    }
+	    qDebu("%d-%d: label=/%s/, size=%.1f", e.source, e.dest,
+		  e.label.toLatin1().data(), e.labelSize);
+	    eLabelSize[e.labelSize]++;
 	}
     }
 
@@ -1052,6 +1265,85 @@ findDefaults(QVector<Node *> nodes,
 
 
 
+/*
+ * Name:	tikzColour()
+ * Purpose:	Find the name to use for a colour in TikZ output,
+ *		defining the colour the first time it is seen.
+ * Arguments:	The colour, the names given so far, a string to add
+ *		any \definecolor to, and (optionally) the name to
+ *		define the colour with.
+ * Outputs:	Nothing.
+ * Modifies:	names and definitions.
+ * Returns:	The name of the colour.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	Colours known to TikZ (see lookupColour()) are used by
+ *		name; every other distinct colour gets one \definecolor,
+ *		called clr<n> unless a name is given, however many nodes
+ *		and edges use it.
+ */
+
+static QString
+tikzColour(QColor colour, QHash<QRgb, QString> &names, QString &definitions,
+	   QString newName = QString())
+{
+    QRgb rgb = colour.rgb();
+
+    if (names.contains(rgb))
+	return names.value(rgb);
+
+    QString name = lookupColour(colour);
+    if (name.isNull())
+    {
+	name = newName.isEmpty() ? "clr" + QString::number(names.count())
+	    : newName;
+	definitions += "\\definecolor{" + name + "} {RGB} {"
+	    + QString::number(colour.red()) + ","
+	    + QString::number(colour.green()) + ","
+	    + QString::number(colour.blue()) + "}\n";
+    }
+    names.insert(rgb, name);
+    return name;
+}
+
+
+
+/*
+ * Name:	tikzStyle()
+ * Purpose:	Find the name of the TikZ style for a set of options,
+ *		defining the style the first time it is seen.
+ * Arguments:	The base style ("n", "e" or "l"), the options which
+ *		differ from it (each preceded by ", "), the names given
+ *		so far and a string to add any style definition to.
+ * Outputs:	Nothing.
+ * Modifies:	names and definitions.
+ * Returns:	The name of the style.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	If there are no options the base style is used as is.
+ *		Otherwise the style is called <base><n> and is the base
+ *		style plus the options.
+ */
+
+static QString
+tikzStyle(QString base, QString options, QHash<QString, QString> &names,
+	  QString &definitions)
+{
+    if (options.isEmpty())
+	return base;
+
+    QString key = base + options;
+    if (names.contains(key))
+	return names.value(key);
+
+    QString name = base + QString::number(names.count() + 1);
+    definitions += "    " + name + "/.style={" + base + options + "},\n";
+    names.insert(key, name);
+    return name;
+}
+
+
+
 /*
  * Name:	saveTikZ()
  * Purpose:	Save the current graph as a (LaTeX) TikZ file.
@@ -1060,30 +1352,67 @@ findDefaults(QVector<Node *> nodes,
  * Modifies:	Nothing.
  * Returns:	True on success.
  * Assumptions:	Args are valid.
- * Bugs:	This is grotesquely long.
+ * Bugs:	None known.
  * Notes:	Currently always returns T, but maybe in the future ...
  * 		Idea: to minimize the amount of TikZ code, the most
  *		common vertex and edge attributes are found and stored
- *		in the styles v/.style, e/.style and l/.style.  Then
- *		when drawing a particular vertex or edge, anything not
- *		matching the default is output, over-riding the style.
+ *		in the styles n/.style, e/.style and l/.style.  The
+ *		nodes and edges which differ from these are then looked
+ *		at, and each distinct colour is defined once (see
+ *		tikzColour()) and each distinct combination of
+ *		differences becomes one more style (see tikzStyle()),
+ *		so the size of the preamble depends on the number of
+ *		different looks, not on the number of items.  Each
+ *		\node and \path then just names its style.
+ *		The nodes and their edges (including compact edges)
+ *		are described and written by the saveTikZ() below.
  */
 
 bool
 saveTikZ(QTextStream &outfile, QVector<Node *> nodes)
+{
+    Graph_Description description;
+
+    describeGraph(nodes, description);
+    return saveTikZ(outfile, description);
+}
+
+
+
+/*
+ * Name:	saveTikZ()
+ * Purpose:	Save a graph description as a (LaTeX) TikZ file.
+ * Arguments:	A file pointer to write to and the description.
+ * Outputs:	A TikZ picture (in LaTeX syntax) which draws the graph.
+ * Modifies:	Nothing.
+ * Returns:	True on success.
+ * Assumptions:	The node positions are scene positions in inches, as
+ *		describeNode() gives them.
+ * Bugs:	None known.
+ * Notes:	See the saveTikZ() above.  This touches no
+ *		QGraphicsItems, so it may be called on any thread.
+ */
+
+bool
+saveTikZ(QTextStream &outfile, const Graph_Description &description)
 {
     qDebu("saveTikZ() called!");
-    // TODO: only define a given colour once.
-    // (Hash the known colours, and use the name if already defined?)
+
+    const QVector<Node_Description> &nodes = description.nodes;
+    const QVector<Edge_Description> &edgeList = description.edges;
 
     nodeInfo nodeDefaults;
     edgeInfo edgeDefaults;
+    QHash<QRgb, QString> colourNames;
+    QString colourDefs;
+    QHash<QString, QString> styleNames;	    // base + options -> name
+    QString styleDefs;
 
     // Output the boilerplate TikZ picture code
     outfile << "\\begin{tikzpicture}[x=1in, y=1in, xscale=1, yscale=1,\n";
 
     // Now find and output the default node and edge details
-    findDefaults(nodes, &nodeDefaults, &edgeDefaults);
+    findDefaults(nodes, edgeList, &nodeDefaults, &edgeDefaults);
 
     // Define the default styles.
     // If the line or fill colour is a TikZ "known" colour,
@@ -1093,29 +1422,19 @@ saveTikZ(QTextStream &outfile, QVector<Node *> nodes)
     //	     printed, due to the RGB/rgb <-> cmyk conversion nightmare.
     // Note: TikZ for plain TeX does not support the cmyk colourspace
     //	     nor (without JD's addition) the RGB colourspace.
-    bool defineDefNodeFillColour = false;
     QColor defNodeFillColour
 	= QColor(nodeDefaults.fillR, nodeDefaults.fillG, nodeDefaults.fillB);
-    QString defNodeFillColourName = lookupColour(defNodeFillColour);
-    if (defNodeFillColourName == nullptr)
-    {
-	defineDefNodeFillColour = true;
-	outfile << "    n/.style={fill=defNodeFillColour, ";
-    }
-    else
-	outfile << "    n/.style={fill=" << defNodeFillColourName << ", ";
-
-    bool defineDefNodeLineColour = false;
     QColor defNodeLineColour
 	= QColor(nodeDefaults.lineR, nodeDefaults.lineG, nodeDefaults.lineB);
-    QString defNodeLineColourName = lookupColour(defNodeLineColour);
-    if (defNodeLineColourName == nullptr)
-    {
-	defineDefNodeLineColour = true;
-	outfile << "draw=defNodeLineColour, shape=circle,\n";
-    }
-    else
-	outfile << "draw=" << defNodeLineColourName << ", shape=circle,\n";
+    QColor defEdgeLineColour
+	= QColor(edgeDefaults.lineR, edgeDefaults.lineG, edgeDefaults.lineB);
+
+    outfile << "    n/.style={fill="
+	    << tikzColour(defNodeFillColour, colourNames, colourDefs,
+			  "defNodeFillColour") << ", ";
+    outfile << "draw="
+	    << tikzColour(defNodeLineColour, colourNames, colourDefs,
+			  "defNodeLineColour") << ", shape=circle,\n";
 
     outfile << "\tminimum size=" << nodeDefaults.nodeDiameter << "in, "
 	    << "inner sep=0, "
@@ -1132,17 +1451,9 @@ saveTikZ(QTextStream &outfile, QVector<Node *> nodes)
     // label text colour to something else, use 'text=<colour>';
     // if we want to draw a box around the label text, use 'draw=<colour>'
     // (and "circle" to get a circle instead of a box).
-    bool defineDefEdgeLineColour = false;
-    QColor defEdgeLineColour
-	= QColor(edgeDefaults.lineR, edgeDefaults.lineG, edgeDefaults.lineB);
-    QString defEdgeLineColourName = lookupColour(defEdgeLineColour);
-    if (defEdgeLineColourName == nullptr)
-    {
-	defineDefEdgeLineColour = true;
-	outfile << "    e/.style={draw=defEdgeLineColour";
-    }
-    else
-	outfile << "    e/.style={draw=" << defEdgeLineColourName;
+    outfile << "    e/.style={draw="
+	    << tikzColour(defEdgeLineColour, colourNames, colourDefs,
+			  "defEdgeLineColour");
 
     outfile << ", line width="
 	    << QString::number(edgeDefaults.penSize / currentPhysicalDPI_X,
@@ -1150,48 +1461,87 @@ saveTikZ(QTextStream &outfile, QVector<Node *> nodes)
     outfile << "    l/.style={font=\\fontsize{" << edgeDefaults.labelSize
 	    << "}{1}\\selectfont}]\n";
 
-    // We have now finished the generic style.
-    // Output default colours, if needed.
-    if (defineDefNodeFillColour)
+    // Find the style of each node.
+    // Note that TikZ is OK with a spurious ',' at the end of the options;
+    // this fact is used to simplify the styles.
+    QVector<QString> nodeStyles(nodes.count());
+    for (int i = 0; i < nodes.count(); i++)
     {
-	outfile << "\\definecolor{defNodeFillColour} {RGB} {"
-		<< QString::number(defNodeFillColour.red())
-		<< "," << QString::number(defNodeFillColour.green())
-		<< "," << QString::number(defNodeFillColour.blue())
-		<< "}\n";
+	const Node_Description &node = nodes.at(i);
+	QString options;
+
+	if (node.fillColour != defNodeFillColour)
+	    options += ", fill=" + tikzColour(node.fillColour,
+					      colourNames, colourDefs);
+	if (node.lineColour != defNodeLineColour)
+	    options += ", draw=" + tikzColour(node.lineColour,
+					      colourNames, colourDefs);
+	if (node.diameter != nodeDefaults.nodeDiameter)
+	    options += ", minimum size=" + QString::number(node.diameter)
+		+ "in";
+	if (node.penWidth != nodeDefaults.penSize)
+	    options += ", node width="
+		+ QString::number(node.penWidth / currentPhysicalDPI_X,
+				  'f', VT_PREC_TIKZ) + "in";
+	// The label font size matters if and only if there is a label.
+	if (node.hasLabel && node.labelSize != nodeDefaults.labelSize)
+	    options += ", font=\\fontsize{"
+		+ QString::number(node.labelSize) + "}{1}\\selectfont";
+
+	nodeStyles[i] = tikzStyle("n", options, styleNames, styleDefs);
     }
-    if (defineDefNodeLineColour)
+
+    // Likewise for the edges.
+    typedef struct
     {
-	outfile << "\\definecolor{defNodeLineColour} {RGB} {"
-		<< QString::number(defNodeLineColour.red())
-		<< "," << QString::number(defNodeLineColour.green())
-		<< "," << QString::number(defNodeLineColour.blue())
-		<< "}\n";
-    }
-    if (defineDefEdgeLineColour)
+	int	sourceID, destID;
+	QString	label;
+	QString	edgeStyle, labelStyle;
+    } tikzEdge;
+    QVector<tikzEdge> edges;
+    foreach (const Edge_Description &d, edgeList)
     {
-	outfile << "\\definecolor{defEdgeLineColour} {RGB} {"
-		<< QString::number(defEdgeLineColour.red())
-		<< "," << QString::number(defEdgeLineColour.green())
-		<< "," << QString::number(defEdgeLineColour.blue())
-		<< "}\n";
+	qDebu("\tsrcID %d dstID %d", d.source, d.dest);
+	QString options;
+	if (d.colour != defEdgeLineColour)
+	    options += ", draw=" + tikzColour(d.colour,
+					      colourNames, colourDefs);
+	if (d.penWidth != edgeDefaults.penSize)
+	    options += ", line width="
+		+ QString::number(d.penWidth / currentPhysicalDPI_X,
+				  'f', ET_PREC_TIKZ) + "in";
+
+	QString labelOptions;
+	if (d.hasLabel && d.labelSize != edgeDefaults.labelSize)
+	    labelOptions = ", font=\\fontsize{"
+		+ QString::number(d.labelSize) + "}{1}\\selectfont";
+
+	tikzEdge e;
+	e.sourceID = d.source;
+	e.destID = d.dest;
+	e.label = d.label;
+	e.edgeStyle = tikzStyle("e", options, styleNames, styleDefs);
+	e.labelStyle = tikzStyle("l", labelOptions, styleNames, styleDefs);
+	edges.append(e);
     }
 
-    QString edgeStyles = "";
+    // We have now finished the generic style.
+    // Output the colours and the styles for the non-default items.
+    outfile << colourDefs;
+    if (!styleDefs.isEmpty())
+	outfile << "\\tikzset{\n" << styleDefs << "}\n";
 
     // Nodes: find center of graph, output graph centered on (0, 0)
     qreal minx = 0, maxx = 0, miny = 0, maxy = 0;
     if (nodes.count() > 0)
     {
-	Node * node = nodes.at(0);
-	minx = maxx = node->scenePos().rx();
-	miny = maxy = node->scenePos().ry();
+	minx = maxx = nodes.at(0).x;
+	miny = maxy = nodes.at(0).y;
     }
     for (int i = 1; i < nodes.count(); i++)
     {
-	Node * node = nodes.at(i);
-	qreal x = node->scenePos().rx();
-	qreal y = node->scenePos().ry();
+	qreal x = nodes.at(i).x;
+	qreal y = nodes.at(i).y;
 	if (x > maxx)
 	    maxx = x;
 	else if (x < minx)
@@ -1205,97 +1555,24 @@ saveTikZ(QTextStream &outfile, QVector<Node *> nodes)
     qreal midy = (maxy + miny) / 2.;
 
     // Sample output for a node:
-    //  \definecolor{n<n>lineClr} {RGB} {R,G,B}   (if not default)
-    //  \definecolor{n<n>fillClr} {RGB} {R,G,B}   (if not default)
-    //	\node (v<n>) at (x,y) [n ,diffs from defaults] {$<node label>$};
+    //	\node (v<n>) at (x,y) [<style>] {$<node label>$};
     // Note that to change the text colour we could add (e.g.) "text=red"
     // to the \node options (or to the 'n' style above).
-    // Note that TikZ is OK with a spurious ',' at the end of the options;
-    // this fact is used to simplify the code below.
     for (int i = 0; i < nodes.count(); i++)
     {
-	QString fillColour = "";
-	QString lineColour = "";
-	Node * node = nodes.at(i);
-	bool doNewLine = false;
-
-	if (node->getFillColour() != defNodeFillColour)
-	{
-	    fillColour = lookupColour(node->getFillColour());
-	    if (fillColour == nullptr)
-	    {
-		// Output the colour defn:
-		fillColour = "n" + QString::number(i) + "fillClr";
-		outfile << "\\definecolor{" << fillColour << "} {RGB} {"
-			<< QString::number(node->getFillColour().red())
-			<< "," << QString::number(node->getFillColour().green())
-			<< "," << QString::number(node->getFillColour().blue())
-			<< "}\n";
-	    }
-	    // Wrap the fillColour with the TikZ syntax for later consumption:
-	    fillColour = ", fill=" + fillColour;
-	    doNewLine = true;
-	}
-	if (node->getLineColour() != defNodeLineColour)
-	{
-	    lineColour = lookupColour(node->getLineColour());
-	    if (lineColour == nullptr)
-	    {
-		lineColour = "n" + QString::number(i) + "lineClr";
-		outfile << "\\definecolor{" << lineColour << "}{RGB}{"
-			<< QString::number(node->getLineColour().red())
-			<< "," << QString::number(node->getLineColour().green())
-			<< "," << QString::number(node->getLineColour().blue())
-			<< "}\n";
-	    }
-	    lineColour = ", draw=" + lineColour;
-	    doNewLine = true;
-	}
+	const Node_Description &node = nodes.at(i);
 
 	// Use (x,y) coordinate system for node positions.
+	// (The positions are already in inches.)
 	outfile << "\\node (v" << QString::number(i) << ") at ("
-		<< QString::number((node->scenePos().rx() - midx)
-				   / currentPhysicalDPI_X,
-				   'f', VP_PREC_TIKZ)
+		<< QString::number(node.x - midx, 'f', VP_PREC_TIKZ)
 		<< ","
-		<< QString::number((node->scenePos().ry() - midy)
-				   / -currentPhysicalDPI_Y,
-				   'f', VP_PREC_TIKZ)
-		<< ") [n";
-	outfile << fillColour << lineColour;
-	if (node->getDiameter() != nodeDefaults.nodeDiameter)
-	{
-	    outfile << ", minimum size=" << QString::number(node->getDiameter())
-		    << "in";
-	    doNewLine = true;
-	}
-
-	if (node->getPenWidth() != nodeDefaults.penSize)
-	{
-	    outfile << ", node width="
-		    << QString::number(node->getPenWidth()
-				       / currentPhysicalDPI_X,
-				       'f', VT_PREC_TIKZ)
-		    << "in";
-	    doNewLine = true;
-	}
+		<< QString::number(midy - node.y, 'f', VP_PREC_TIKZ)
+		<< ") [" << nodeStyles.at(i);
 
-	// Output the node label and its font size if and only if
-	// there is a node label.
-	if (node->getLabel().length() > 0)
+	if (node.hasLabel)
 	{
-	    if (node->getLabelSize() != nodeDefaults.labelSize)
-	    {
-		if (doNewLine)
-		    outfile << ",\n\t";
-		else
-		    outfile << ", ";
-		outfile << "font=\\fontsize{"
-			<< QString::number(node->getLabelSize()) // Font size
-			<< "}{1}\\selectfont";
-	    }
-
-	    QString thisLabel = node->getLabel();
+	    QString thisLabel = node.label;
 	    // TODO: this check just checks for a '^', but
 	    // if a subscript itself has a superscript
 	    // and there is no (top-level) superscript, we would
@@ -1310,95 +1587,15 @@ saveTikZ(QTextStream &outfile, QVector<Node *> nodes)
     }
 
     // Sample output for an edge:
-    //  \definecolor{e<n>_<m>lineClr} {RGB} {R,G,B}   (if not default)
-    //  \path (v<n>) edge[e, diff from defaults] node[l, diff from defaults]
+    //  \path (v<n>) edge[<style>] node[<label style>]
     //		{$<edge label>} (v_<m>);
-    for (int i = 0; i < nodes.count(); i++)
+    foreach (const tikzEdge &e, edges)
     {
-	bool wroteExtra = false;
-	qDebu("\tNode %d has %d edges", i, nodes.at(i)->edgeList.count());
-	for (int j = 0; j < nodes.at(i)->edgeList.count(); j++)
-	{
-	    // TODO: is it possible that with various and sundry
-	    // operations on graphs neither the sourceID nor the
-	    // destID of an edge in nodes.at(i)'s list is equal to
-	    // i, and thus some edge won't be printed?  If so,
-	    // should we just test "sourceID < destID in the if
-	    // test immediately below?
-	    Edge * edge = nodes.at(i)->edgeList.at(j);
-	    int sourceID = edge->sourceNode()->getID();
-	    int destID = edge->destNode()->getID();
-	    if ((sourceID == i && destID > i)
-		|| (destID == i && sourceID > i))
-	    {
-		qDebu("\ti %d j %d srcID %d dstID %d", i, j, sourceID, destID);
-		qDebu("\tlabel = /%s/", edge->getLabel().toLatin1().data());
-		QString lineColour = "";
-		if (edge->getColour() != defEdgeLineColour)
-		{
-		    qDebu("E %d,%d: colour non-default", sourceID, destID);
-		    lineColour = lookupColour(edge->getColour());
-		    if (lineColour == nullptr)
-		    {
-			lineColour = "e" + QString::number(sourceID) + "_"
-			    + QString::number(destID) + "lineClr";
-			outfile << "\\definecolor{" << lineColour << "}{RGB}{"
-				<< QString::number(edge->getColour().red())
-				<< ","
-				<< QString::number(edge->getColour().green())
-				<< ","
-				<< QString::number(edge->getColour().blue())
-				<< "}\n";
-		    }
-		    lineColour = ", draw=" + lineColour;
-		    wroteExtra = true;
-		    qDebu("\tSETTING lineColour = /%s/",
-			  lineColour.toLatin1().data());
-		}
-
-		outfile << "\\path (v"
-			<< QString::number(sourceID)
-			<< ") edge[e" << lineColour;
-		if (edge->getPenWidth() != edgeDefaults.penSize)
-		{
-		    outfile << ", line width="
-			    << QString::number(edge->getPenWidth()
-					       / currentPhysicalDPI_X,
-					       'f', ET_PREC_TIKZ)
-			    << "in";
-		    wroteExtra = true;
-		}
-
-		// Output a \n iff we have both a non-default line
-		// width and a non-default label size.
-		if (edge->getLabel().length() > 0
-		    && edge->getLabelSize() != edgeDefaults.labelSize
-		    && wroteExtra)
-		    outfile << "]\n\tnode[l";
-		else
-		    outfile << "] node[l";
-
-		// Output edge label size (and the "select font" info)
-		// if and only if the edge has a label.
-		if (edge->getLabel().length() > 0)
-		{
-		    if (edge->getLabelSize() != edgeDefaults.labelSize)
-		    {
-			outfile << ", font=\\fontsize{"
-				<< QString::number(edge->getLabelSize())
-				<< "}{1}\\selectfont";
-		    }
-		    outfile << "] {$" << edge->getLabel() << "$}";
-		}
-		else
-		    outfile << "] {$$}";
-
-		// Finally, output the other end of the edge:
-		outfile << " (v"
-			<< QString::number(destID)
-			<< ");\n";
-	    }
-	}
+	outfile << "\\path (v" << QString::number(e.sourceID)
+		<< ") edge[" << e.edgeStyle
+		<< "] node[" << e.labelStyle << "] {$"
+		<< e.label << "$} (v"
+		<< QString::number(e.destID) << ");\n";
     }
 
     outfile << "\\end{tikzpicture}\n";
@@ -1417,16 +1614,49 @@ saveTikZ(QTextStream &outfile, QVector<Node *> nodes)
  * Returns:	True on success.
  * Assumptions:	Args are valid.
  * Bugs:	
+ * Notes:	Describes the nodes and their edges (including compact
+ *		edges) and writes the descriptions with the
+ *		saveGraphIc() below.
+ */
+
+bool
+saveGraphIc(QTextStream &outfile, QVector<Node *> nodes, bool outputExtra)
+{
+    Graph_Description description;
+
+    describeGraph(nodes, description);
+
+    return saveGraphIc(outfile, description, outputExtra);
+}
+
+
+
+/*
+ * Name:	saveGraphIc()
+ * Purpose:	Output a graph description in "graph-ic" format.
+ * Arguments:	A file pointer to write to and the description.
+ * Outputs:	The graph-ic description of the graph.
+ * Modifies:	Nothing.
+ * Returns:	True on success.
+ * Assumptions:	The node positions are scene positions in inches, as
+ *		describeNode() gives them.
+ * Bugs:	
  * Notes:	Currently always returns T, but maybe in the future ...
  *		Normally vertex and edge label info is not output if
  *		the label is empty, but if outputExtra = T these
  *		are output (this is a debugging aid), as well as some
  *		extra info.
+ *		This touches no QGraphicsItems, so it may be called on
+ *		any thread (the autosaver calls it on a pool thread).
  */
 
 bool
-saveGraphIc(QTextStream &outfile, QVector<Node *> nodes, bool outputExtra)
+saveGraphIc(QTextStream &outfile, const Graph_Description &description,
+	    bool outputExtra)
 {
+    const QVector<Node_Description> &nodes = description.nodes;
+    const QVector<Edge_Description> &edges = description.edges;
+
     qDeb() << "MW::saveGraphIc() called!";
     // Use some painful Qt constructs to output the node and edge
     // information with a more readable format.
@@ -1456,55 +1686,51 @@ saveGraphIc(QTextStream &outfile, QVector<Node *> nodes, bool outputExtra)
     qreal minx = 0, maxx = 0, miny = 0, maxy = 0;
     if (nodes.count() > 0)
     {
-	Node * node = nodes.at(0);
-	minx = maxx = node->scenePos().rx();
-	miny = maxy = node->scenePos().ry();
+	minx = maxx = nodes.at(0).x;
+	miny = maxy = nodes.at(0).y;
     }
     for (int i = 1; i < nodes.count(); i++)
     {
-	Node * node = nodes.at(i);
-	qreal x = node->scenePos().rx();
-	qreal y = node->scenePos().ry();
+	qreal x = nodes.at(i).x;
+	qreal y = nodes.at(i).y;
 	if (x > maxx)
 	    maxx = x;
 	else if (x < minx)
 	    minx = x;
 	if (y > maxy)
 	    maxy = y;
-	else if (y < minx)
+	else if (y < miny)
 	    miny = y;
     }
 
-    qreal midxInch = (maxx + minx) / (currentPhysicalDPI_X * 2.);
-    qreal midyInch = (maxy + miny) / (currentPhysicalDPI_Y * 2.);
+    qreal midxInch = (maxx + minx) / 2.;
+    qreal midyInch = (maxy + miny) / 2.;
     for (int i = 0; i < nodes.count(); i++)
     {
 	// TODO: s/,/\\/ before writing out label.  Undo this when reading.
-	Node * node = nodes.at(i);
+	const Node_Description &node = nodes.at(i);
 	outfile << "# Node " + QString::number(i) + ":\n";
-	outfile << QString::number(node->scenePos().rx() / currentPhysicalDPI_X
-				   - midxInch,
-				   'f', VP_PREC_GRPHC) << ","
-		<< QString::number(node->scenePos().ry() / currentPhysicalDPI_Y
-				   - midyInch,
-				   'f', VP_PREC_GRPHC) << ", "
-		<< QString::number(node->getDiameter()) << ", "
-		<< QString::number(node->getPenWidth()) << ", "
-		<< QString::number(node->getRotation()) << ", "
-		<< QString::number(node->getFillColour().redF()) << ","
-		<< QString::number(node->getFillColour().greenF()) << ","
-		<< QString::number(node->getFillColour().blueF()) << ", "
-		<< QString::number(node->getLineColour().redF()) << ","
-		<< QString::number(node->getLineColour().greenF()) << ","
-		<< QString::number(node->getLineColour().blueF());
+	outfile << QString::number(node.x - midxInch, 'f', VP_PREC_GRPHC)
+		<< ","
+		<< QString::number(node.y - midyInch, 'f', VP_PREC_GRPHC)
+		<< ", "
+		<< QString::number(node.diameter) << ", "
+		<< QString::number(node.penWidth) << ", "
+		<< QString::number(node.rotation) << ", "
+		<< QString::number(node.fillColour.redF()) << ","
+		<< QString::number(node.fillColour.greenF()) << ","
+		<< QString::number(node.fillColour.blueF()) << ", "
+		<< QString::number(node.lineColour.redF()) << ","
+		<< QString::number(node.lineColour.greenF()) << ","
+		<< QString::number(node.lineColour.blueF());
 	// Output the node label and its font size if and only if
 	// there is a node label.
-	if (node->getLabel().length() > 0 || outputExtra)
+	if (node.hasLabel || outputExtra)
 	{
 	    outfile << ", "
-		    << QString::number(node->getLabelSize())
+		    << QString::number(node.labelSize)
 		    << ","
-		    << node->getLabel();
+		    << node.label;
 	}
 	outfile << "\n";
     }
@@ -1512,63 +1738,43 @@ saveGraphIc(QTextStream &outfile, QVector<Node *> nodes, bool outputExtra)
     outfile << "\n# Edge descriptions; the format is:\n"
 	    << "# u, v, dest_radius, source_radius, rotation, pen_width,\n"
 	    << "#       line r,g,b[, label font size, label]\n";
-	    
-    for (int i = 0; i < nodes.count(); i++)
+
+    // The lower-numbered node of each edge is written first.
+    for (int k = 0; k < edges.count(); k++)
     {
-	for (int j = 0; j < nodes.at(i)->edgeList.count(); j++)
+	const Edge_Description &e = edges.at(k);
+	if (outputExtra)
 	{
-	    Edge * edge = nodes.at(i)->edgeList.at(j);
-	    if (outputExtra)
-	    {
-		outfile << "# Looking at i, j = "
-			<< QString::number(i) << ", " << QString::number(j)
-			<< "  ->  src, dst = "
-			<< QString::number(edge->sourceNode()->getID())
-			<< ", "
-			<< QString::number(edge->destNode()->getID())
-			<< "\n";
-	    }
+	    outfile << "# Looking at edge " << QString::number(k)
+		    << "  ->  src, dst = "
+		    << QString::number(e.source) << ", "
+		    << QString::number(e.dest) << "\n";
+	}
 
-	    int printThisOne = 0;
-	    int sourceID = edge->sourceNode()->getID();
-	    int destID = edge->destNode()->getID();
-	    if (sourceID == i && destID > i)
-	    {
-		printThisOne++;
-		outfile << QString("%1").arg(sourceID, 2, 10, QChar(' '))
-			<<  ","
-			<< QString("%1").arg(destID, 2, 10, QChar(' '));
-	    }
-	    else if (destID == i && sourceID > i)
-	    {
-		printThisOne++;
-		outfile << QString("%1").arg(destID, 2, 10, QChar(' '))
-			<<  ","
-			<< QString("%1").arg(sourceID, 2, 10, QChar(' '));
-	    }
-	    if (printThisOne)
-	    {
-		outfile << ", " << QString::number(edge->getDestRadius())
-			<< ", " << QString::number(edge->getSourceRadius())
-			<< ", " << QString::number(edge->getRotation())
-			<< ", " << QString::number(edge->getPenWidth())
-			<< ", "
-			<< QString::number(edge->getColour().redF())
-			<< ","
-			<< QString::number(edge->getColour().greenF())
-			<< ","
-			<< QString::number(edge->getColour().blueF());
-		if (edge->getLabel().length() > 0 || outputExtra)
-		{
-		    // TODO: check for ',' in the label and deal with it.
-		    outfile << ", "
-			    << edge->getLabelSize()
-			    << ","
-			    << edge->getLabel();
-		}
-		outfile << "\n";
-	    }
+	outfile << QString("%1").arg(qMin(e.source, e.dest), 2, 10,
+				     QChar(' '))
+		<< ","
+		<< QString("%1").arg(qMax(e.source, e.dest), 2, 10,
+				     QChar(' '))
+		<< ", " << QString::number(e.destRadius)
+		<< ", " << QString::number(e.sourceRadius)
+		<< ", " << QString::number(e.rotation)
+		<< ", " << QString::number(e.penWidth)
+		<< ", "
+		<< QString::number(e.colour.redF())
+		<< ","
+		<< QString::number(e.colour.greenF())
+		<< ","
+		<< QString::number(e.colour.blueF());
+	if (e.hasLabel || outputExtra)
+	{
+	    // TODO: check for ',' in the label and deal with it.
+	    outfile << ", "
+		    << e.labelSize
+		    << ","
+		    << e.label;
 	}
+	outfile << "\n";
     }
 
     return true;
@@ -1600,7 +1806,9 @@ MainWindow::save_Graph()
 
     fileTypes += GRAPHiCS_SAVE_FILE ";;"
 	TIKZ_SAVE_FILE ";;"
-	EDGES_SAVE_FILE	";;";
+	EDGES_SAVE_FILE	";;"
+	GRAPHML_SAVE_FILE ";;"
+	DOT_SAVE_FILE ";;";
 
     foreach (QByteArray format, QImageWriter::supportedImageFormats())
     {
@@ -1679,55 +1887,64 @@ MainWindow::save_Graph()
     if (saveStatus)
 	ui->canvas->snapToGrid(false);
 
+    // Make sure all the edge geometries are up-to-date.
+    Edge::adjustQueuedEdges();
+
     if (selectedFilter != GRAPHiCS_SAVE_FILE
 	&& selectedFilter != TIKZ_SAVE_FILE
 	&& selectedFilter != EDGES_SAVE_FILE
+	&& selectedFilter != GRAPHML_SAVE_FILE
+	&& selectedFilter != DOT_SAVE_FILE
 	&& selectedFilter != SVG_SAVE_FILE)
     {
 	ui->canvas->scene()->clearSelection();
 	ui->canvas->scene()->invalidate(ui->canvas->scene()->itemsBoundingRect(),
 					ui->canvas->scene()->BackgroundLayer);
 
-	QPixmap * image = new QPixmap(ui->canvas->scene()
-				      ->itemsBoundingRect().size().toSize());
+	// One canvas pixel is 1/currentPhysicalDPI_X of an inch, so
+	// the default resolution gives a 1:1 copy of the canvas.
+	bool ok;
+	int dpi = QInputDialog::getInt(this, "Save graph",
+				       "Image resolution (dots per inch):",
+				       qRound(currentPhysicalDPI_X),
+				       10, 10000, 1, &ok);
+	if (!ok)
+	{
+	    ui->canvas->snapToGrid(saveStatus);
+	    return false;
+	}
+
+	QColor background = Qt::transparent;
 	if (selectedFilter == "JPG (*.jpg)")
 	{
 	    if (settings.contains("jpgBgColour"))
-	    {
-		QColor color = settings.value("jpgBgColour").toString();
-		image->fill(color);
-	    }
+		background = settings.value("jpgBgColour").toString();
 	    else
-		image->fill(Qt::white);
+		background = Qt::white;
 	}
 	else
 	{
 	    if (settings.contains("otherImageBgColour"))
-	    {
-		QColor color = settings.value("otherImageBgColour").toString();
-		image->fill(color);
-	    }
-	    else
-		image->fill(Qt::transparent);
+		background = settings.value("otherImageBgColour").toString();
 	}
-	QPainter painter(image);
-	painter.setRenderHints(QPainter::Antialiasing
-			       | QPainter::TextAntialiasing
-			       | QPainter::HighQualityAntialiasing
-			       | QPainter::NonCosmeticDefaultPen, true);
 	ui->canvas->scene()->setBackgroundBrush(Qt::transparent);
-	ui->canvas->
-	    scene()->render(&painter,
-			    QRectF(0, 0,
-				   ui->canvas->scene()
-				   ->itemsBoundingRect().width(),
-				   ui->canvas->scene()
-				   ->itemsBoundingRect().height()),
-			    ui->canvas->scene()->itemsBoundingRect(),
-			    Qt::IgnoreAspectRatio);
-	image->save(fileName); // Requires file extension or it won't save :-/
+
+	QString errorMessage;
+	QApplication::setOverrideCursor(Qt::WaitCursor);
+	bool success = exportTiledImage(ui->canvas->scene(),
+					ui->canvas->scene()->itemsBoundingRect(),
+					dpi / currentPhysicalDPI_X, dpi,
+					background, fileName,
+					QFileInfo(fileName).suffix(),
+					errorMessage);
+	QApplication::restoreOverrideCursor();
 	ui->canvas->snapToGrid(saveStatus);
 	ui->canvas->update();
+	if (!success)
+	{
+	    QMessageBox::information(0, "Error", errorMessage);
+	    return false;
+	}
 	promptSave = false;
 	return true;
     }
@@ -1763,11 +1980,20 @@ MainWindow::save_Graph()
     {
 	bool success = saveGraphIc(outStream, nodes, false);
 	outputFile.close();
+	// Library graphs, which are opened again and again, get a
+	// companion.  It is only a faster copy, so if it can't be
+	// written make sure no stale one is left to be read instead.
+	QString companion = binaryCompanion(fileName);
+	QString errorMessage;
+	if (success && !companion.isNull() && libraryIndex->contains(fileName)
+	    && !saveGraphBin(companion, nodes, errorMessage, fileName))
+	{
+	    qDeb() << "save_Graph(): " << errorMessage;
+	    QFile::remove(companion);
+	}
 	ui->canvas->snapToGrid(saveStatus);
 	ui->canvas->update();
-	QFileInfo fi(fileName);
-	ui->graphType_ComboBox->insertItem(ui->graphType_ComboBox->count(),
-					   fi.baseName());
+	libraryIndex->fileSaved(fileName);
 	promptSave = false;
 	return true && success;
     }
@@ -1782,6 +2008,26 @@ MainWindow::save_Graph()
 	return true && success;
     }
 
+    if (selectedFilter == GRAPHML_SAVE_FILE)
+    {
+	bool success = saveGraphML(&outputFile, nodes);
+	outputFile.close();
+	ui->canvas->snapToGrid(saveStatus);
+	ui->canvas->update();
+	promptSave = false;
+	return true && success;
+    }
+
+    if (selectedFilter == DOT_SAVE_FILE)
+    {
+	bool success = saveDot(&outputFile, nodes);
+	outputFile.close();
+	ui->canvas->snapToGrid(saveStatus);
+	ui->canvas->update();
+	promptSave = false;
+	return true && success;
+    }
+
     if (selectedFilter == TIKZ_SAVE_FILE)
     {
 	bool success = saveTikZ(outStream, nodes);
@@ -1800,6 +2046,7 @@ MainWindow::save_Graph()
 	svgGen.setSize(ui->canvas->scene()
 		       ->itemsBoundingRect().size().toSize());
 	QPainter painter(&svgGen);
+	Graph::setExporting(ui->canvas->scene(), true);
 	ui->canvas->scene()->render(&painter,
 				    QRectF(0, 0, ui->canvas->scene()
 					   ->itemsBoundingRect().width(),
@@ -1807,6 +2054,7 @@ MainWindow::save_Graph()
 					   ->itemsBoundingRect().height()),
 				    ui->canvas->scene()->itemsBoundingRect(),
 				    Qt::IgnoreAspectRatio);
+	Graph::setExporting(ui->canvas->scene(), false);
 	ui->canvas->snapToGrid(saveStatus);
 	ui->canvas->update();
 	promptSave = false;
@@ -1840,7 +2088,10 @@ MainWindow::load_Graphic_File()
     QString fileName = QFileDialog::getOpenFileName(this,
 						    "Load Graph-ics File",
 						    fileDirectory,
-						    GRAPHiCS_SAVE_FILE);
+						    GRAPHiCS_OPEN_FILE ";;"
+						    EDGES_OPEN_FILE ";;"
+						    GRAPHML_OPEN_FILE ";;"
+						    DOT_OPEN_FILE);
     if (! fileName.isNull())
 	select_Custom_Graph(fileName);
 
@@ -1859,276 +2110,410 @@ MainWindow::load_Graphic_File()
  * Returns:	Nothing.
  * Assumptions:	fileDirectory has been initialized.
  *		This assumes that if a file has a GRAPHiCS_FILE_EXTENSION
- *		extension then it is a graph-ic file.
+ *		extension (possibly followed by GZIP_FILE_EXTENSION)
+ *		then it is a graph-ic file.
  * Bugs:
- * Notes:
+ * Notes:	The names come from the LibraryIndex (created the first
+ *		time through), which reads its saved index rather than
+ *		walking the library.  It checks the library in the
+ *		background and libraryChanged() is called if the list
+ *		is not up to date.
+ *		Each graph is shown with its thumbnail, if we have one
+ *		yet (see requestThumbnails()).
  */
 
 void
 MainWindow::load_Graphic_Library()
 {
-    QDirIterator dirIt(fileDirectory, QDirIterator::Subdirectories);
-    while (dirIt.hasNext())
+    if (libraryIndex == nullptr)
     {
-	dirIt.next();
-#ifdef DEBUG2
-	if (QFileInfo(dirIt.filePath()).isFile())
-	    qDeb() << "MW::load_Graphic_Library(): suffix of"
-		   << QFileInfo(dirIt.filePath()).fileName()
-		   << "is"
-		   << QFileInfo(dirIt.filePath()).suffix();
-#endif
+	libraryIndex = new LibraryIndex(fileDirectory, this);
+	connect(libraryIndex, SIGNAL(changed()),
+		this, SLOT(libraryChanged()));
+	thumbnailCache = new ThumbnailCache(fileDirectory,
+					    libraryIndex->cacheDirectory(),
+					    this);
+	connect(thumbnailCache, SIGNAL(thumbnailReady(QString)),
+		this, SLOT(thumbnailReady(QString)));
+	ui->graphType_ComboBox->setIconSize(QSize(THUMBNAIL_SIZE,
+						  THUMBNAIL_SIZE));
+	ui->graphType_ComboBox->view()->installEventFilter(this);
+    }
 
-	if (QFileInfo(dirIt.filePath()).suffix() == GRAPHiCS_FILE_EXTENSION
-	    && QFileInfo(dirIt.filePath()).isFile())
-	{
-	    QFileInfo fileInfo(dirIt.filePath());
-	    ui->graphType_ComboBox->addItem(fileInfo.baseName());
-	}
+    foreach (const Library_Entry &e, libraryIndex->entries())
+    {
+	QImage image = thumbnailCache->thumbnail(e.path);
+	if (image.isNull())
+	    ui->graphType_ComboBox->addItem(QFileInfo(e.path).baseName());
+	else
+	    ui->graphType_ComboBox->addItem(QPixmap::fromImage(image),
+					    QFileInfo(e.path).baseName());
     }
+
+    if (thumbnailsWanted)
+	requestThumbnails();
 }
 
 
 
 /*
- * Name:	    select_Custom_Graph()
- * Purpose:	    Read in a graph-ic file.
- * Argument:	    The name of the file to read from.
- * Outputs:	    Nothing.
- * Modifies:	    Clears the preview scene and then adds the created
- *		    graph to the preview.
- * Returns:	    Nothing.
- * Assumptions:	    The input file is valid.
- * Bugs:	    May crash and burn on invalid input.
- * Notes:	    JD added "comment lines" capability Oct 2019.
- *		    Arguably this function should be in preview.cpp.
+ * Name:	libraryChanged()
+ * Purpose:	Bring the library graphs in the graphType menu up to
+ *		date.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	ui->graphType_ComboBox
+ * Returns:	Nothing.
+ * Assumptions:	The library graphs are the items after the separator.
+ * Bugs:	?
+ * Notes:	Called when the LibraryIndex finds that files have been
+ *		added to or removed from the library.  The menu's
+ *		signals are blocked so that the graph in the preview is
+ *		not regenerated; if a library graph was selected it is
+ *		selected again (if it is still there).
  */
 
 void
-MainWindow::select_Custom_Graph(QString graphName)
+MainWindow::libraryChanged()
 {
-    if (graphName.isNull())
-    {
-	qDebug() << "MW::select_Custom_Graph(): graphName is NULL!! ??";
-	return;
-    }
+    QComboBox * box = ui->graphType_ComboBox;
+    QString current = box->currentText();
+    bool wasLibrary = box->currentIndex() > BasicGraphs::Count;
 
-    qDeb() << "MW::select_Custom_Graph(): graphName is\n\t" << graphName;
+    qDeb() << "MW::libraryChanged() called";
 
-    QFile file(graphName);
+    box->blockSignals(true);
+    while (box->count() > BasicGraphs::Count + 1)
+	box->removeItem(BasicGraphs::Count + 1);
+    load_Graphic_Library();
 
-    if (!file.open(QIODevice::ReadOnly))
+    if (wasLibrary)
     {
-	QMessageBox::information(0,
-				 "Error",
-				 "File: " + graphName
-				 + ": " + file.errorString());
-	// Reset the combo box to the "Select Graph Type" item (#0).
-	ui->graphType_ComboBox->setCurrentIndex(BasicGraphs::Nothing);
-	return;
-    }
-
-    QTextStream in(&file);
-    int i = 0;
-    QVector<Node *> nodes;
-    int numOfNodes = -1;		// < 0 ==> haven't read numOfNodes yet
-    Graph * graph = new Graph();
-    // The following 4 variables hold the extremal positions actually drawn,
-    // so they take into account both the node center location and the
-    // node diameter.  (These are the two values stored in the .grphc file.)
-    qreal minX = 1E10, maxX = -1E10, minY = 1E10, maxY = -1E10;
-    // These 4 variables hold the radii of the vertices which give the
-    // extremal positions stored above.
-    qreal minXr = 0, maxXr = 0, minYr = 0, maxYr = 0;
-
-    while (!in.atEnd())
-    {
-	QString line = in.readLine();
-	QString simpLine = line.simplified();
-	if (simpLine.isEmpty())
-	{
-	    // Allow visually blank lines
-	}
-	else if (simpLine.at(0).toLatin1() == '#')
-	{
-	    // Allow comments where first non-white is '#'.
-	    // TODO: Should we save these comments somewhere?
-	}
-	else if (numOfNodes < 0)
+	int index = BasicGraphs::Nothing;
+	for (int i = BasicGraphs::Count + 1; i < box->count(); i++)
 	{
-	    bool ok;
-	    numOfNodes = line.toInt(&ok);
-	    // TODO: do we want to allow 0-node graphs?
-	    // Theoretically yes, but practically, no.
-	    if (! ok || numOfNodes < 0)
+	    if (box->itemText(i) == current)
 	    {
-		QMessageBox::information(0, "Error",
-					 "The file " + graphName
-					 + " has an invalid number of "
-					 "nodes.  Thus I can not read "
-					 "this file.");
-		file.close();
-		return;
+		index = i;
+		break;
 	    }
 	}
-	else if (i < numOfNodes)
-	{
-	    QStringList fields = line.split(",");
-
-	    // Nodes may or may not have label info.  Accept both.
-	    // Nominally, we want 11 or 13 (and this assumes we don't
-	    // want to record the label size if there is no label,
-	    // which is possibly not what we will eventually realize
-	    // we want).  But to avoid complex quoting of commas in
-	    // labels, we just glue all the fields past #12 into the
-	    // label.
-	    if (fields.count() < 11 || fields.count() == 12)
-	    {
-		QMessageBox::information(0, "Error",
-					 "Node " + QString::number(i)
-					 + " of file "
-					 + graphName
-					 + " has an invalid number of "
-					 "fields.  Thus I can not read "
-					 "this file.");
-		// TODO: do I need to free any storage?
-		file.close();
-		return;
-	    }
+	box->setCurrentIndex(index);
+    }
+    box->blockSignals(false);
+}
 
-	    Node * node = new Node();
-	    qreal x = fields.at(0).toDouble();
-	    qreal y = fields.at(1).toDouble();
-	    qreal d = fields.at(2).toDouble();
-	    qreal r = d / 2.;
-	    qreal t = fields.at(3).toDouble();
-	    node->setPos(x * currentPhysicalDPI_X, y * currentPhysicalDPI_Y);
-	    node->setDiameter(d);
-	    node->setPenWidth(t);
-	    node->setRotation(fields.at(4).toDouble());
-	    node->setID(i++);
-	    // Record information about the extremal nodes for use below.
-	    if (x - r < minX)
-	    {
-		minX = x - r;
-		minXr = r;
-	    }
-	    if (x + r > maxX)
-	    {
-		maxX = x + r;
-		maxXr = r;
-	    }
-	    if (y - r < minY)
-	    {
-		minY = y - r;
-		minYr = r;
-	    }
-	    if (y + r > maxY)
-	    {
-		maxY = y + r;
-		maxYr = r;
-	    }
-	    qDebu("  node id %d at (%.4f, %.4f)\n\tX [%.4f, %.4f], "
-		  "Y [%.4f, %.4f]", i-1, x, y, minX, maxX, minY, maxY);
-
-	    QColor fillColor;
-	    fillColor.setRedF(fields.at(5).toDouble());
-	    fillColor.setGreenF(fields.at(6).toDouble());
-	    fillColor.setBlueF(fields.at(7).toDouble());
-	    node->setFillColour(fillColor);
-
-	    QColor lineColor;
-	    lineColor.setRedF(fields.at(8).toDouble());
-	    lineColor.setGreenF(fields.at(9).toDouble());
-	    lineColor.setBlueF(fields.at(10).toDouble());
-	    node->setLineColour(lineColor);
-	    if (fields.count() >= 13)
-	    {
-		// If the label has one or more commas, we must glue
-		// the fields back together.
-		node->setNodeLabelSize(fields.at(11).toFloat());
-		QString l = fields.at(12);
-		for (int i = 13; i < fields.count(); i++)
-		    l += "," + fields.at(i);
-		node->setNodeLabel(l);
-	    }
-	    nodes.append(node);
-	    node->setParentItem(graph);
-	}
-	else	// Default case: looking at an edge
-	{
-	    QStringList fields = line.split(",");
 
-	    // Edges may or may not have label info.  Accept both.
-	    if (fields.count() < 9 || fields.count() == 10)
-	    {
-		QMessageBox::information(0, "Error",
-					 "Edge "
-					 + QString::number(i - numOfNodes)
-					 + "of file "
-					 + graphName
-					 + " has an invalid number of "
-					 "fields.  Thus I can not read "
-					 "this file.");
-		// TODO: do I need to free any storage?
-		file.close();
-		return;
-	    }
-	    Edge * edge = new Edge(nodes.at(fields.at(0).toInt()),
-				   nodes.at(fields.at(1).toInt()));
-	    edge->setDestRadius(fields.at(2).toDouble());
-	    edge->setSourceRadius(fields.at(3).toDouble());
-	    edge->setRotation(fields.at(4).toDouble());
-	    edge->setPenWidth(fields.at(5).toDouble());
-	    QColor lineColor;
-	    lineColor.setRedF(fields.at(6).toDouble());
-	    lineColor.setGreenF(fields.at(7).toDouble());
-	    lineColor.setBlueF(fields.at(8).toDouble());
-	    // printf("setting edge (%d, %d) colour to %.3f, %.3f, %.3f\n",
-	    //    fields.at(0).toInt(), fields.at(1).toInt(),
-	    //    fields.at(6).toDouble(), fields.at(7).toDouble(),
-	    //    fields.at(8).toDouble());
-	    edge->setColour(lineColor);
-	    if (fields.count() >= 11)
-	    {
-		edge->setEdgeLabelSize(fields.at(9).toFloat());
-		// If the label has one or more commas, we must glue
-		// the fields back together.
-		QString l = fields.at(10);
-		for (int i = 11; i < fields.count(); i++)
-		    l += "," + fields.at(i);
-		edge->setEdgeLabel(l);
-	    }
-	    edge->setParentItem(graph);
-	}
+
+/*
+ * Name:	eventFilter()
+ * Purpose:	Notice when the graph type menu is first popped up.
+ * Arguments:	The object and the event.
+ * Outputs:	Nothing.
+ * Modifies:	thumbnailsWanted.
+ * Returns:	False (the event is never eaten).
+ * Assumptions:	This is only installed on the graph type menu's view.
+ * Bugs:	None.
+ * Notes:	The thumbnails are only asked for when someone actually
+ *		looks at the menu, so that starting the program doesn't
+ *		read every graph in the library.
+ */
+
+bool
+MainWindow::eventFilter(QObject * obj, QEvent * event)
+{
+    if (event->type() == QEvent::Show
+	&& obj == ui->graphType_ComboBox->view() && !thumbnailsWanted)
+    {
+	thumbnailsWanted = true;
+	requestThumbnails();
     }
-    file.close();
-
-    // Scale all the node CENTER positions to a 1"x1" square
-    // so that it can be appropriately styled.
-    // TODO(?): center it on (0,0).  (Graphs output by this
-    // program should already be centered.)
-    qreal width = (maxX - maxXr) - (minX + minXr);
-    qreal height = (maxY - maxYr) - (minY + minYr);
-    qDebu("    X: [%.4f, %.4f], Xr min %.4f, max %.4f",
-	  minX, maxX, minXr, maxXr);
-    qDebu("    Y: [%.4f, %.4f], Yr min %.4f, max %.4f",
-	  minY, maxY, minYr, maxYr);
-    qDebu("    width %.4f, height %.4f", width, height);
-    qDeb() << "    minX = " << minX << ", maxX = "
-	   << maxX << "\n\tminY = " << minY << ", maxY = " << maxY
-	   << "; width = " << width << " and height = " << height;
-    for (int i = 0; i < nodes.count(); i++)
+    return QMainWindow::eventFilter(obj, event);
+}
+
+
+
+/*
+ * Name:	requestThumbnails()
+ * Purpose:	Ask for the thumbnails of all of the library graphs.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	libraryIndex and thumbnailCache have been created.
+ * Bugs:	None.
+ * Notes:	They are found or made in the background, in menu
+ *		order; thumbnailReady() is called for each one.  Graphs
+ *		whose thumbnails are up to date are skipped.
+ */
+
+void
+MainWindow::requestThumbnails()
+{
+    foreach (const Library_Entry &e, libraryIndex->entries())
+	thumbnailCache->request(e);
+}
+
+
+
+/*
+ * Name:	thumbnailReady()
+ * Purpose:	Show a new thumbnail in the graph type menu.
+ * Arguments:	The path of the graph, relative to the library.
+ * Outputs:	Nothing.
+ * Modifies:	ui->graphType_ComboBox
+ * Returns:	Nothing.
+ * Assumptions:	The library graphs follow the separator, in the order
+ *		of the LibraryIndex.
+ * Bugs:	None.
+ * Notes:	None.
+ */
+
+void
+MainWindow::thumbnailReady(QString path)
+{
+    QVector<Library_Entry> entries = libraryIndex->entries();
+
+    for (int i = 0; i < entries.count(); i++)
+    {
+	if (entries.at(i).path == path)
+	{
+	    int index = BasicGraphs::Count + 1 + i;
+	    if (index < ui->graphType_ComboBox->count())
+		ui->graphType_ComboBox->setItemIcon(
+		    index, QPixmap::fromImage(thumbnailCache->thumbnail(path)));
+	    return;
+	}
+    }
+}
+
+
+
+/*
+ * Name:	readGraphIc()
+ * Purpose:	Create a graph from a graph-ic (.grphc) description.
+ * Arguments:	The stream to read from, the name of the file (for
+ *		error messages) and a string to hold an error message.
+ * Outputs:	Nothing.
+ * Modifies:	errorMessage, if there is an error.
+ * Returns:	The new graph (not yet in any scene), or nullptr if the
+ *		input is not valid.
+ * Assumptions:	currentPhysicalDPI_{X,Y} are set.
+ * Bugs:	?
+ * Notes:	Split out of MainWindow::select_Custom_Graph() so that
+ *		the batch renderer can read graphs without a MainWindow.
+ *		The node preview coords are set, as they are needed by
+ *		PreView::Style_Graph(); the caller positions the graph.
+ *		The work is done by parseGraphIc() and a GraphBuilder
+ *		(see graphloader.cpp), all at once.
+ */
+
+Graph *
+readGraphIc(QTextStream &in, QString graphName, QString &errorMessage)
+{
+    Graph_Description description;
+
+    if (!parseGraphIc(in, graphName, description, errorMessage))
+	return nullptr;
+
+    GraphBuilder builder(description);
+    builder.build(builder.itemCount());
+    return builder.takeGraph();
+}
+
+
+
+/*
+ * Name:	    select_Custom_Graph()
+ * Purpose:	    Read in a graph-ic file.
+ * Argument:	    The name of the file to read from.
+ * Outputs:	    Nothing.
+ * Modifies:	    Clears the preview scene and then adds the created
+ *		    graph to the preview.
+ * Returns:	    Nothing.
+ * Assumptions:	    None.
+ * Bugs:	    ?
+ * Notes:	    JD added "comment lines" capability Oct 2019.
+ *		    Arguably this function should be in preview.cpp.
+ *		    The parsing is done by readGraphIc(), or by
+ *		    readGraphBin() if the file is a .grphb file or the
+ *		    .grphc file has an up-to-date .grphb companion.
+ *		    GraphML files are imported by readGraphML() and DOT
+ *		    files by readDot().
+ *		    Edge lists (see edgelist.cpp), which are laid out as
+ *		    they are read, and .grphc files of
+ *		    LOAD_IN_BACKGROUND_BYTES or more are handed to the
+ *		    GraphLoader instead (see loadInBackground()), and
+ *		    the graph appears when it is done (see
+ *		    customGraphLoaded()).
+ *		    .grphc files may be gzipped (see compressedfile.cpp).
+ */
+
+void
+MainWindow::select_Custom_Graph(QString graphName)
+{
+    if (graphName.isNull())
+    {
+	qDebug() << "MW::select_Custom_Graph(): graphName is NULL!! ??";
+	return;
+    }
+
+    qDeb() << "MW::select_Custom_Graph(): graphName is\n\t" << graphName;
+
+    // Don't let a graph still being read replace this one.
+    graphLoader->cancel();
+    if (!loadProgress.isNull())
+	loadProgress->hide();
+
+    QString errorMessage;
+    Graph * graph = nullptr;
+    QFileInfo textInfo(graphName);
+    QString companion = binaryCompanion(graphName);
+
+    if (isEdgeListFile(graphName))
+    {
+	// Even a small edge list needs a layout.
+	loadInBackground(graphName);
+	return;
+    }
+
+    if (isDotFile(graphName) || textInfo.suffix() == GRAPHML_FILE_EXTENSION)
+    {
+	if (isDotFile(graphName))
+	    graph = readDot(graphName, errorMessage);
+	else
+	    graph = readGraphML(graphName, errorMessage);
+	if (graph == nullptr)
+	{
+	    QMessageBox::information(0, "Error", errorMessage);
+	    ui->graphType_ComboBox->setCurrentIndex(BasicGraphs::Nothing);
+	    return;
+	}
+    }
+    else if (textInfo.suffix() == GRAPHiCS_BIN_EXTENSION)
+    {
+	graph = readGraphBin(graphName, errorMessage);
+	if (graph == nullptr)
+	{
+	    QMessageBox::information(0, "Error", errorMessage);
+	    ui->graphType_ComboBox->setCurrentIndex(BasicGraphs::Nothing);
+	    return;
+	}
+    }
+    else if (!companion.isNull()
+	     && binaryCompanionIsCurrent(companion, graphName))
+    {
+	// An up-to-date binary companion is much faster to read.
+	// If it is no good, quietly fall back to the text file.
+	graph = readGraphBin(companion, errorMessage);
+	if (graph == nullptr)
+	    qDeb() << "    ignoring companion: " << errorMessage;
+    }
+
+    if (graph == nullptr)
+    {
+	CompressedFile file(graphName);
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+	    QMessageBox::information(0,
+				     "Error",
+				     "File: " + graphName
+				     + ": " + file.errorString());
+	    // Reset the combo box to the "Select Graph Type" item (#0).
+	    ui->graphType_ComboBox->setCurrentIndex(BasicGraphs::Nothing);
+	    return;
+	}
+
+	if (file.size() * (file.isCompressed() ? GZIP_RATIO : 1)
+	    >= LOAD_IN_BACKGROUND_BYTES)
+	{
+	    // Too big to read without freezing the window.
+	    file.close();
+	    loadInBackground(graphName);
+	    return;
+	}
+
+	QTextStream in(&file);
+	graph = readGraphIc(in, graphName, errorMessage);
+	file.close();
+	if (graph == nullptr)
+	{
+	    QMessageBox::information(0, "Error", errorMessage);
+	    return;
+	}
+    }
+
+    customGraphLoaded(graph);
+}
+
+
+
+/*
+ * Name:	loadInBackground()
+ * Purpose:	Have the GraphLoader read a file, and show how it is
+ *		getting on.
+ * Arguments:	The name of the file.
+ * Outputs:	A progress dialog (if it takes a while).
+ * Modifies:	loadProgress.
+ * Returns:	Nothing.
+ * Assumptions:	The GraphLoader can read the file (see
+ *		GraphLoader::load()).
+ * Bugs:	None.
+ * Notes:	The old graph stays in the preview until the new one
+ *		is ready (see customGraphLoaded()).
+ */
+
+void
+MainWindow::loadInBackground(QString graphName)
+{
+    if (loadProgress.isNull())
     {
-	Node * n = nodes.at(i);
-	n->setPreviewCoords(n->x() / width / currentPhysicalDPI_X,
-			    n->y() / height / currentPhysicalDPI_Y);
-	qDebu("    nodes[%s] coords: screen (%.4f, %.4f); "
-	      "preview set to (%.4f, %.4f)", n->getLabel().toLatin1().data(),
-	      n->x(), n->y(), n->getPreviewX(), n->getPreviewY());
+	loadProgress = new QProgressDialog(this);
+	loadProgress->setWindowTitle("Graphic");
+	loadProgress->setCancelButtonText("Cancel");
+	loadProgress->setRange(0, 100);
+	loadProgress->setMinimumDuration(500);
+	loadProgress->setAutoClose(false);
+	loadProgress->setAutoReset(false);
+	connect(graphLoader, SIGNAL(progress(int)),
+		loadProgress, SLOT(setValue(int)));
+	connect(loadProgress, SIGNAL(canceled()),
+		this, SLOT(cancelCustomGraph()));
     }
+    loadProgress->setLabelText("Reading "
+			       + QFileInfo(graphName).fileName() + " ...");
+    loadProgress->reset();
+    graphLoader->load(graphName);
+}
+
 
-    qDeb() << "MW::select_Custom_Graph: graph->childItems().length() ="
+
+/*
+ * Name:	customGraphLoaded()
+ * Purpose:	Put a graph read from a file into the preview.
+ * Arguments:	The graph.
+ * Outputs:	Nothing.
+ * Modifies:	The preview scene.
+ * Returns:	Nothing.
+ * Assumptions:	The graph is not in any scene.
+ * Bugs:	?
+ * Notes:	Called by select_Custom_Graph() for files it reads
+ *		itself, and by the GraphLoader for the others.
+ */
+
+void
+MainWindow::customGraphLoaded(Graph * graph)
+{
+    // With autoClose off (so that it can be reused), reset() alone
+    // leaves the dialog on the screen.
+    if (!loadProgress.isNull())
+    {
+	loadProgress->reset();
+	loadProgress->hide();
+    }
+
+    qDeb() << "MW::customGraphLoaded: graph->childItems().length() ="
 	   << graph->childItems().length();
 
     // Apparently we have to center the graph in the viewport.
@@ -2154,6 +2539,59 @@ MainWindow::select_Custom_Graph(QString graphName)
 
 
 
+/*
+ * Name:	customGraphFailed()
+ * Purpose:	Report a file which the GraphLoader could not read.
+ * Arguments:	The error message.
+ * Outputs:	The message, in a message box.
+ * Modifies:	The graph type combo box.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	None.
+ */
+
+void
+MainWindow::customGraphFailed(QString errorMessage)
+{
+    if (!loadProgress.isNull())
+    {
+	loadProgress->reset();
+	loadProgress->hide();
+    }
+
+    QMessageBox::information(0, "Error", errorMessage);
+    ui->graphType_ComboBox->setCurrentIndex(BasicGraphs::Nothing);
+}
+
+
+
+/*
+ * Name:	cancelCustomGraph()
+ * Purpose:	Stop reading a graph when the user presses Cancel.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	The graph type combo box.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	The preview still shows the previous graph, which no
+ *		longer matches the combo box, so it is cleared.
+ */
+
+void
+MainWindow::cancelCustomGraph()
+{
+    if (!graphLoader->isBusy())
+	return;
+
+    graphLoader->cancel();
+    ui->preview->scene()->clear();
+    ui->graphType_ComboBox->setCurrentIndex(BasicGraphs::Nothing);
+}
+
+
+
 /*
  * Name:	style_Graph()
  * Purpose:
@@ -2251,12 +2689,18 @@ MainWindow::generate_Graph(enum widget_ID changed_widget)
 
     qDeb() << "\nMW::generate_Graph(widget " << changed_widget << ") called.";
 
-    if (ui->preview->items().count() == 0)
+    // (While a big library graph is being read the preview may be
+    // empty, but reading it again would not help.)
+    if (ui->preview->items().count() == 0 && !graphLoader->isBusy())
     {
 	qDeb() << "\tpreview is empty, resetting cGI to -1";
 	currentGraphIndex = -1;
     }
 
+    // A library graph still being read is no longer wanted.
+    if (graphIndex != currentGraphIndex)
+	graphLoader->cancel();
+
     if (graphIndex < BasicGraphs::Count)
     {
 	int numOfNodes1 = ui->numOfNodes1->value();
@@ -2295,9 +2739,14 @@ MainWindow::generate_Graph(enum widget_ID changed_widget)
 	    qDeb() << "\tmaking a '"
 		   << ui->graphType_ComboBox->currentText()
 		   << "' graph";
-	    select_Custom_Graph(fileDirectory + "/"
-				+ ui->graphType_ComboBox->currentText()
-				+ "." + GRAPHiCS_FILE_EXTENSION);
+	    QString graphName = fileDirectory + "/"
+		+ ui->graphType_ComboBox->currentText()
+		+ "." + GRAPHiCS_FILE_EXTENSION;
+	    // The library may only have it compressed.
+	    if (!QFile::exists(graphName)
+		&& QFile::exists(graphName + "." GZIP_FILE_EXTENSION))
+		graphName += "." GZIP_FILE_EXTENSION;
+	    select_Custom_Graph(graphName);
 	}
 	else
 	{
@@ -2892,280 +3341,62 @@ MainWindow::on_freestyleMode_radioButton_clicked()
 }
 
 
+/*
+ * Name:	updateEditTab() (Formerly on_tabWidget_currentChanged())
+ * Purpose:	Bring the list on the "Edit Graph" tab up to date after
+ *		items have been added to or removed from the canvas.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	The edit tab model.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	The rebuild is deferred to the event loop, so several
+ *		calls in a row cost the same as one.
+ */
+
 void
-MainWindow::updateEditTab() // Quick, ugly, dirty fix
+MainWindow::updateEditTab()
 {
-    updateEditTab(0);
-    updateEditTab(1);
+    qDeb() << "MW::updateEditTab()";
+    editTabModel->queueRebuild();
 }
 
 
+
 /*
- * Name:	updateEditTab (Formerly on_tabWidget_currentChanged())
- * Purpose:	Redraw the UI for the tabbed section at the left of
- *		the main UI window.
- * Arguments:	The tab index.
+ * Name:	canvasFocusChanged()
+ * Purpose:	When a label is being edited on the canvas, show the
+ *		row of its node or edge (in bold) on the edit tab.
+ * Arguments:	The items gaining and losing focus, and the reason.
  * Outputs:	Nothing.
- * Modifies:	The user view.
+ * Modifies:	The edit tab model and view.
  * Returns:	Nothing.
- * Assumptions:	?
- * Bugs:	?
- * Notes:	JD Q: what actually draws the UI for tab 0?  ui_mainwindow? YES
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	When a label loses the focus its text may have been
+ *		changed, so the old item's row is refreshed.
  */
 
 void
-MainWindow::updateEditTab(int index)
-{
-    qDeb() << "MW::updateEditTab(" << index << ")";
-    switch(index)
-    {
-      case 0:
-      {
-	  QLayoutItem * wItem;
-	  while ((wItem = ui->scrollAreaWidgetContents->layout()->takeAt(0))
-		 != 0)
-	  {
-	      if (wItem->widget())
-		  wItem->widget()->setParent(NULL);
-	      delete wItem;
-	  }
-	  break;
-      }
-      case 1:
-      {
-	  int i = 0;
-	  foreach (QGraphicsItem * item, ui->canvas->scene()->items())
-	  {
-	      // Q: when would item be a 0 or nullptr?
-	      if (item != 0 || item != nullptr)
-	      {   // Only creates headers for "root" graphs
-		  if (item->type() == Graph::Type && item->parentItem() == nullptr
-			  && !item->childItems().isEmpty())
-		  {
-		      Graph * graph = qgraphicsitem_cast<Graph*>(item);
-
-		      QLabel * label = new QLabel("Graph");
-		      gridLayout->addWidget(label, i, 0);
-		      i++;
-
-		      QLabel * label2 = new QLabel("N width");
-		      gridLayout->addWidget(label2, i, 2);
-		      QLabel * label3 = new QLabel("E width");
-		      gridLayout->addWidget(label3, i+1, 2);
-		      QLabel * label4 = new QLabel("N diam");
-		      gridLayout->addWidget(label4, i, 3);
-		      QLabel * label5 = new QLabel("Label");
-		      gridLayout->addWidget(label5, i, 4);
-		      QLabel * label6 = new QLabel("Text");
-		      gridLayout->addWidget(label6, i, 5);
-		      QLabel * label7 = new QLabel("Size");
-		      gridLayout->addWidget(label7, i+1, 5);
-		      QLabel * label8 = new QLabel("Line");
-		      gridLayout->addWidget(label8, i, 6);
-		      QLabel * label9 = new QLabel("Color");
-		      gridLayout->addWidget(label9, i+1, 6);
-		      QLabel * label10 = new QLabel("Fill");
-		      gridLayout->addWidget(label10, i, 7);
-		      QLabel * label11 = new QLabel("Color");
-		      gridLayout->addWidget(label11, i+1, 7);
-		      i += 2;
-
-		      // Horrible, ugly connects....
-		      connect(graph, SIGNAL(destroyed(QObject*)),
-			      label, SLOT(deleteLater()));
-		      connect(graph, SIGNAL(destroyed(QObject*)),
-			      label2, SLOT(deleteLater()));
-		      connect(graph, SIGNAL(destroyed(QObject*)),
-			      label3, SLOT(deleteLater()));
-		      connect(graph, SIGNAL(destroyed(QObject*)),
-			      label4, SLOT(deleteLater()));
-		      connect(graph, SIGNAL(destroyed(QObject*)),
-			      label5, SLOT(deleteLater()));
-		      connect(graph, SIGNAL(destroyed(QObject*)),
-			      label6, SLOT(deleteLater()));
-		      connect(graph, SIGNAL(destroyed(QObject*)),
-			      label7, SLOT(deleteLater()));
-		      connect(graph, SIGNAL(destroyed(QObject*)),
-			      label8, SLOT(deleteLater()));
-		      connect(graph, SIGNAL(destroyed(QObject*)),
-			      label9, SLOT(deleteLater()));
-		      connect(graph, SIGNAL(destroyed(QObject*)),
-			      label10, SLOT(deleteLater()));
-		      connect(graph, SIGNAL(destroyed(QObject*)),
-			      label11, SLOT(deleteLater()));
-
-		      QList<QGraphicsItem *> list;
-		      foreach (QGraphicsItem * gItem, graph->childItems())
-			  list.append(gItem);
-
-		      while (!list.isEmpty())
-		      {
-			  foreach (QGraphicsItem * gItem, list)
-			  {
-			      if (gItem != nullptr)
-			      {
-				  if (gItem->type() == Graph::Type)
-				      list.append(gItem->childItems());
-
-				  else if (gItem->type() == Node::Type)
-				  {
-				      Node * node = qgraphicsitem_cast<Node*>(gItem);
-				      QLineEdit * nodeEdit = new QLineEdit();
-				      // Q: what was the point of this?
-				      // nodeEdit->setText("Node\n");
-				      // gridLayout->addWidget(nodeEdit);
-
-				      QLabel * label = new QLabel("Node");
-				      // When this node is deleted, also
-				      // delete its label in the edit tab.
-				      connect(node, SIGNAL(destroyed(QObject*)),
-					      label, SLOT(deleteLater()));
-
-				      node->htmlLabel->editTabLabel = label;
-
-				      QDoubleSpinBox * diamBox
-					  = new QDoubleSpinBox();
-
-				      QDoubleSpinBox * thicknessBox
-					  = new QDoubleSpinBox();
-
-				      QPushButton * lineColorButton
-					  = new QPushButton();
-				      QPushButton * fillColorButton
-					  = new QPushButton();
-
-				      QSpinBox * fontSizeBox
-					  = new QSpinBox();
-
-				      nodeEdit->installEventFilter(node);
-				      diamBox->installEventFilter(node);
-				      thicknessBox->installEventFilter(node);
-				      fontSizeBox->installEventFilter(node);
-
-				      // All controllers handle deleting of widgets
-				      SizeController * sizeController
-					  = new SizeController(node, diamBox, thicknessBox);
-				      ColorLineController * colorLineController
-					  = new ColorLineController(node,
-								    lineColorButton);
-				      LabelController * weightController
-					  = new LabelController(node, nodeEdit);
-				      LabelSizeController * weightSizeController
-					  = new LabelSizeController(node,
-								    fontSizeBox);
-				      ColorFillController * colorFillController
-					  = new ColorFillController(node,
-								    fillColorButton);
-
-				      gridLayout->addWidget(label, i, 1);
-				      gridLayout->addWidget(thicknessBox, i, 2);
-				      gridLayout->addWidget(diamBox, i, 3);
-				      gridLayout->addWidget(nodeEdit,  i, 4);
-				      gridLayout->addWidget(fontSizeBox, i, 5);
-				      gridLayout->addWidget(lineColorButton, i, 6);
-				      gridLayout->addWidget(fillColorButton, i, 7);
-				      Q_UNUSED(sizeController);
-				      Q_UNUSED(colorLineController);
-				      Q_UNUSED(colorFillController);
-				      Q_UNUSED(weightController);
-				      Q_UNUSED(weightSizeController);
-				      i++;
-				  }
-				  else if (gItem->type() == Edge::Type)
-				  {
-				      Edge * edge
-					  = qgraphicsitem_cast<Edge*>(gItem);
-				      QLineEdit * edgeEdit = new QLineEdit();
-				      // Q: what were these for??
-				      // editEdge->setText("Edge\n");
-				      // gridLayout->addWidget(editEdge);
-
-				      QLabel * label = new QLabel("Edge");
-				      // When this edge is deleted, also
-				      // delete its label in the edit tab.
-				      connect(edge, SIGNAL(destroyed(QObject*)),
-					      label, SLOT(deleteLater()));
-
-				      edge->htmlLabel->editTabLabel = label;
-
-				      QPushButton * button
-					  = new QPushButton();
-
-				      QDoubleSpinBox * sizeBox
-					  = new QDoubleSpinBox();
-
-				      QSpinBox * fontSizeBox
-					  = new QSpinBox();
-
-				      edgeEdit->installEventFilter(edge);
-				      sizeBox->installEventFilter(edge);
-				      fontSizeBox->installEventFilter(edge);
-
-				      // All controllers handle deleting of widgets
-				      SizeController * sizeController
-					  = new SizeController(edge, sizeBox);
-				      ColorLineController * colorController
-					  = new ColorLineController(edge, button);
-				      LabelController * weightController
-					  = new LabelController(edge, edgeEdit);
-				      LabelSizeController * weightSizeController
-					  = new LabelSizeController(edge,
-								    fontSizeBox);
-
-				      gridLayout->addWidget(label, i, 1);
-				      gridLayout->addWidget(sizeBox, i, 2);
-				      gridLayout->addWidget(edgeEdit, i, 4);
-				      gridLayout->addWidget(fontSizeBox, i, 5);
-				      gridLayout->addWidget(button, i, 6);
-				      Q_UNUSED(sizeController);
-				      Q_UNUSED(colorController);
-				      Q_UNUSED(weightController);
-				      Q_UNUSED(weightSizeController);
-				      i++;
-				  }
-			      }
-			      list.removeFirst();
-			  }
-		      }
-		  }
-	      }
-	  }
-	  // TODO: the setRowStretch() was added 2019/11/18 because
-	  // the extra vertical space was being distributed *between*
-	  // the rows, rather than at the end.
-	  // Dumps core if setRowStretch(i - 1, 40) is called when i == 0.
-	  // So to get it to work I added a label with a blank at the
-	  // end of the section, and then it works.  Kludge.
-	  if (i > 0)
-	  {
-	      // printf("Setting row stretch for row %d to 40\n", i - 1);
-	      // gridLayout->setRowStretch(i - 1, 40);
-	      // TODO: JD could not figure out any way to get a spacer
-	      // in here.
-	      // QSpacerItem * verticalSpacer;
-	      //QSpacerItem verticalSpacer = QSpacerItem(40, 20, QSizePolicy::Minimum, QSizePolicy::Expanding);
-	      //auto widget = new QWidget();
-	      //widget->setLayout( verticalSpacer );
-	      //gridLayout->addWidget(widget, 0, 1);
-	      //QLineEdit * editEdge = new QLineEdit();
-	      //gridLayout->addWidget(editEdge, i, 1);
-	      //gridLayout->addItem(verticalSpacer, i/2, 1, 1, 1, Qt::AlignTop);
-	      //gridLayout->addItem(verticalSpacer);//, 12, 1, 0, 0, 0);
-	      //gridLayout->addItem(verticalSpacer);
-// compile error	      gridLayout->addItem(new QSpacerItem((1, 1, QSizePolicy::Expanding, QSizePolicy::Preferred), 3,1,1,4, Qt::AlignTop);
-	      // This is a horrible kludge that makes the stretch work
-	      // before anything is deleted from the Edit Graph tab.
-	      // With this the setRowStretch() for i-1 is not needed.
-	      // The horror, the horror.
-	      QLabel * label = new QLabel(" ");
-	      gridLayout->addWidget(label, 1000, 1);
-	      gridLayout->setRowStretch(1000, 40);
-	  }
-	  break;
-      }
-      default:
-	break;
+MainWindow::canvasFocusChanged(QGraphicsItem * newFocus,
+			       QGraphicsItem * oldFocus,
+			       Qt::FocusReason reason)
+{
+    Q_UNUSED(reason);
+
+    if (oldFocus != nullptr && oldFocus->type() == HTML_Label::Type)
+	editTabModel->itemChanged(oldFocus->parentItem());
+
+    if (newFocus != nullptr && newFocus->type() == HTML_Label::Type)
+    {
+	editTabModel->setHighlighted(newFocus->parentItem());
+	int row = editTabModel->rowOf(newFocus->parentItem());
+	if (row >= 0)
+	    ui->editTableView->scrollTo(editTabModel->index(row, 0));
     }
+    else
+	editTabModel->setHighlighted(nullptr);
 }
 
 
@@ -3215,6 +3446,603 @@ MainWindow::dumpGraphIc()
 }
 
 
+
+/*
+ * Name:	runLayout()
+ * Purpose:	Run the force-directed layout of one graph.
+ * Arguments:	The job.
+ * Outputs:	Nothing.
+ * Modifies:	job.positions
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	Called on a pool thread via QtConcurrent; it only
+ *		touches the job's copy of the coordinates, never the
+ *		nodes themselves.
+ */
+
+static void
+runLayout(Layout_Job &job)
+{
+    ForceLayout layout(job.positions, job.edges, job.edgeLength);
+
+    layout.run();
+    job.positions = layout.positions();
+}
+
+
+
+/*
+ * Name:	layout_Graphs()
+ * Purpose:	Start a force-directed layout of each graph on the canvas.
+ * Arguments:	None.
+ * Outputs:	A message in the status bar.
+ * Modifies:	layoutJobs
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	The node coordinates (relative to the top-level graph, so
+ *		that nested graphs are laid out as part of their parent)
+ *		and the edges (including those in EdgeBundles) are copied
+ *		into a Layout_Job, and the layouts are run in the
+ *		background; layoutDone() moves the nodes afterwards.
+ *		The ideal edge length is four node diameters, but at least
+ *		half an inch.
+ *		Does nothing if a layout is already running.
+ */
+
+void
+MainWindow::layout_Graphs()
+{
+    if (layoutWatcher->isRunning())
+	return;
+
+    layoutJobs.clear();
+    int numOfNodes = 0;
+    foreach (QGraphicsItem * item, ui->canvas->scene()->items())
+    {
+	if (item->type() != Graph::Type || item->parentItem() != nullptr)
+	    continue;
+
+	Graph * root = qgraphicsitem_cast<Graph *>(item);
+	Layout_Job job;
+	QHash<Node *, int> index;
+	QList<EdgeBundle *> bundles;
+	QList<QGraphicsItem *> children = root->childItems();
+	qreal diameters = 0;
+
+	job.root = root;
+	while (!children.isEmpty())
+	{
+	    QGraphicsItem * child = children.takeFirst();
+	    if (child->type() == Graph::Type)
+		children.append(child->childItems());
+	    else if (child->type() == EdgeBundle::Type)
+		bundles.append(qgraphicsitem_cast<EdgeBundle *>(child));
+	    else if (child->type() == Node::Type)
+	    {
+		Node * node = qgraphicsitem_cast<Node *>(child);
+		index.insert(node, job.nodes.count());
+		job.nodes.append(node);
+		job.positions.append(root->mapFromScene(node->scenePos()));
+		diameters += node->style()->diameter;
+	    }
+	}
+	if (job.nodes.count() < 2)
+	    continue;
+
+	// Each Edge is in the edgeList of both of its nodes.
+	for (int i = 0; i < job.nodes.count(); i++)
+	{
+	    foreach (Edge * edge, job.nodes.at(i)->edgeList)
+	    {
+		if (edge->sourceNode() != job.nodes.at(i))
+		    continue;
+		Layout_Edge e;
+		e.source = i;
+		e.dest = index.value(edge->destNode(), -1);
+		if (e.dest >= 0)
+		    job.edges.append(e);
+	    }
+	}
+	foreach (EdgeBundle * bundle, bundles)
+	{
+	    for (int i = 0; i < bundle->count(); i++)
+	    {
+		Layout_Edge e;
+		e.source = index.value(bundle->sourceAt(i), -1);
+		e.dest = index.value(bundle->destAt(i), -1);
+		if (e.source >= 0 && e.dest >= 0)
+		    job.edges.append(e);
+	    }
+	}
+
+	job.edgeLength = qMax(4 * diameters / job.nodes.count(),
+			      currentPhysicalDPI / 2);
+	numOfNodes += job.nodes.count();
+	layoutJobs.append(job);
+    }
+
+    if (layoutJobs.isEmpty())
+	return;
+
+    qDeb() << "MW::layout_Graphs(): " << layoutJobs.count()
+	   << " graphs, " << numOfNodes << " nodes";
+    ui->actionLayout_Graphs->setEnabled(false);
+    ui->statusBar->showMessage(QString("Laying out %1 nodes...")
+			       .arg(numOfNodes));
+    layoutWatcher->setFuture(QtConcurrent::map(layoutJobs, runLayout));
+}
+
+
+
+/*
+ * Name:	layoutDone()
+ * Purpose:	Move the nodes to the positions found by the layouts.
+ * Arguments:	None.
+ * Outputs:	A message in the status bar.
+ * Modifies:	The positions of the nodes; layoutJobs.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Graphs and nodes deleted while the layout was running are
+ *		skipped (hence the QPointers), as are nodes which are no
+ *		longer in the same top-level graph.
+ */
+
+void
+MainWindow::layoutDone()
+{
+    foreach (Layout_Job job, layoutJobs)
+    {
+	Graph * root = job.root;
+	if (root == nullptr)
+	    continue;
+
+	for (int i = 0; i < job.nodes.count(); i++)
+	{
+	    Node * node = job.nodes.at(i);
+	    if (node == nullptr || node->findRootParent() != root)
+		continue;
+	    node->setPos(node->parentItem()->mapFromScene(
+			     root->mapToScene(job.positions.at(i))));
+	}
+	somethingChanged();
+    }
+    layoutJobs.clear();
+
+    ui->actionLayout_Graphs->setEnabled(true);
+    ui->statusBar->showMessage("Layout finished.", 5000);
+}
+
+
+
+/*
+ * Name:	snapshotScene()
+ * Purpose:	Describe all of the nodes and edges in a scene.
+ * Arguments:	The scene and the description to fill in.
+ * Outputs:	Nothing.
+ * Modifies:	description.
+ * Returns:	Nothing.
+ * Assumptions:	The edge geometries are up to date.
+ * Bugs:	None known.
+ * Notes:	The description is a plain copy of the values, so it
+ *		can be given to other threads while the scene changes.
+ *		The positions are scene positions in inches.
+ *		Compact edges (see edgebundle.cpp) are described as
+ *		they would be if they were expanded (see
+ *		describeEdges()), without expanding them.
+ */
+
+static void
+snapshotScene(QGraphicsScene * scene, Graph_Description &description)
+{
+    QVector<Node *> nodes;
+
+    description.nodes.clear();
+    foreach (QGraphicsItem * item, scene->items())
+    {
+	if (item->type() == Node::Type)
+	{
+	    Node * node = qgraphicsitem_cast<Node *>(item);
+	    Node_Description d;
+	    describeNode(node, d);
+	    nodes.append(node);
+	    description.nodes.append(d);
+	}
+    }
+
+    describeEdges(nodes, description.edges);
+}
+
+
+
+/*
+ * Name:	isImageExport()
+ * Purpose:	Tell whether an "Export all" format is drawn from a
+ *		scene.
+ * Arguments:	The format (file extension).
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	True for SVG and raster images.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	Everything else is written from the description.
+ */
+
+static bool
+isImageExport(QString format)
+{
+    return format == "svg" || format == "png" || format == "jpg";
+}
+
+
+
+/*
+ * Name:	exportText()
+ * Purpose:	Write one "Export all" text file.
+ * Arguments:	The job.
+ * Outputs:	The file (and, for .grphc files in the library, its
+ *		.grphb companion).
+ * Modifies:	job.ok and job.errorMessage.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Called on a pool thread (see runExport()).  The file is
+ *		written straight from the (read-only) snapshot, with
+ *		the same writers as save_Graph() uses, so no items are
+ *		made.
+ */
+
+static void
+exportText(Export_Job &job)
+{
+    job.ok = false;
+    QFile outputFile(job.fileName);
+    if (!outputFile.open(QIODevice::WriteOnly))
+    {
+	job.errorMessage = outputFile.errorString();
+	return;
+    }
+
+    if (job.format == GRAPHML_FILE_EXTENSION)
+	job.ok = saveGraphML(&outputFile, job.snapshot);
+    else if (job.format == DOT_FILE_EXTENSION)
+	job.ok = saveDot(&outputFile, job.snapshot);
+    else
+    {
+	QTextStream outStream(&outputFile);
+	if (job.format == "tikz")
+	    job.ok = saveTikZ(outStream, job.snapshot);
+	else if (job.format == EDGES_FILE_EXTENSION)
+	    job.ok = saveEdgelist(outStream, job.snapshot);
+	else
+	    job.ok = saveGraphIc(outStream, job.snapshot, false);
+	outStream.flush();
+	job.ok = job.ok && outStream.status() == QTextStream::Ok;
+    }
+    outputFile.close();
+    if (!job.ok)
+    {
+	job.errorMessage = "unable to write the file";
+	return;
+    }
+
+    if (job.companion)
+    {
+	// As in save_Graph(), never leave a stale companion behind.
+	QString errorMessage;
+	QString companion = binaryCompanion(job.fileName);
+	if (!saveGraphBin(companion, job.snapshot, errorMessage, job.fileName))
+	{
+	    qDeb() << "exportText(): " << errorMessage;
+	    QFile::remove(companion);
+	}
+    }
+}
+
+
+
+/*
+ * Name:	exportImages()
+ * Purpose:	Write the "Export all" SVG and raster image files.
+ * Arguments:	The jobs (which all have the same snapshot).
+ * Outputs:	The files.
+ * Modifies:	The jobs' ok and errorMessage.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Called on a pool thread (see runExport()).  As in the
+ *		batch renderer, the graph(s) are built from the
+ *		snapshot in a scene of their own, so nothing but the
+ *		(read-only) snapshot is shared between threads or with
+ *		the canvas.  The one scene is used for all of the
+ *		images; exportTiledImage() draws each image's tiles in
+ *		parallel anyway.
+ */
+
+static void
+exportImages(Export_Task &task)
+{
+    GraphBuilder builder(task.at(0)->snapshot);
+    builder.build(builder.itemCount());
+
+    QGraphicsScene scene;
+    scene.setItemIndexMethod(QGraphicsScene::NoIndex);
+    scene.addItem(builder.takeGraph());
+    Graph::setExporting(&scene, true);
+    QRectF bounds = scene.itemsBoundingRect();
+
+    foreach (Export_Job * job, task)
+    {
+	if (job->format == "svg")
+	{
+	    QSvgGenerator svgGen;
+	    svgGen.setFileName(job->fileName);
+	    svgGen.setSize(bounds.size().toSize());
+	    QPainter painter(&svgGen);
+	    scene.render(&painter,
+			 QRectF(0, 0, bounds.width(), bounds.height()),
+			 bounds, Qt::IgnoreAspectRatio);
+	    job->ok = painter.end();
+	    if (!job->ok)
+		job->errorMessage = "unable to write the SVG file";
+	}
+	else
+	    job->ok = exportTiledImage(&scene, bounds,
+				       job->dpi / currentPhysicalDPI_X,
+				       job->dpi, job->background,
+				       job->fileName, job->format,
+				       job->errorMessage);
+    }
+}
+
+
+
+/*
+ * Name:	runExport()
+ * Purpose:	Do one part of "Export all".
+ * Arguments:	The task: one text file, or all of the images.
+ * Outputs:	The file(s).
+ * Modifies:	The jobs' ok and errorMessage.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Called on a pool thread via QtConcurrent.  Only the
+ *		images need a scene (see export_All()), so at most one
+ *		is built, however many formats are chosen.
+ */
+
+static void
+runExport(Export_Task &task)
+{
+    if (isImageExport(task.at(0)->format))
+	exportImages(task);
+    else
+	exportText(*task.at(0));
+}
+
+
+
+/*
+ * Name:	export_All()
+ * Purpose:	Save the canvas in each of the formats the user picks.
+ * Arguments:	None.
+ * Outputs:	A dialog to pick the formats, a file chooser for the
+ *		base name, and a message in the status bar.
+ * Modifies:	exportJobs and exportTasks; the "exportAllFormats" and
+ *		"exportAllDPI" settings.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	The canvas is described once (see snapshotScene()) and
+ *		then the files are written by runExport() on pool
+ *		threads, so the user can carry on while the files are
+ *		written; exportDone() reports the results.  The text
+ *		formats are written straight from the snapshot, one
+ *		task per file; the images all share one task (and one
+ *		scene).
+ *		promptSave is left alone, since the canvas may well
+ *		have changed by the time the files are written.
+ *		Does nothing if an export is already running.
+ */
+
+void
+MainWindow::export_All()
+{
+    if (exportWatcher->isRunning())
+	return;
+
+    QStringList formats;
+    formats << GRAPHiCS_FILE_EXTENSION << "tikz" << EDGES_FILE_EXTENSION
+	    << GRAPHML_FILE_EXTENSION << DOT_FILE_EXTENSION << "svg"
+	    << "png" << "jpg";
+    QStringList wanted = settings.value("exportAllFormats",
+					QStringList() << GRAPHiCS_FILE_EXTENSION
+					<< "tikz" << "svg" << "png")
+	.toStringList();
+
+    QDialog dialog(this);
+    dialog.setWindowTitle("Export all");
+    QVBoxLayout * layout = new QVBoxLayout(&dialog);
+    QList<QCheckBox *> boxes;
+    foreach (QString format, formats)
+    {
+	QCheckBox * box = new QCheckBox("." + format, &dialog);
+	box->setChecked(wanted.contains(format));
+	layout->addWidget(box);
+	boxes.append(box);
+    }
+    QFormLayout * form = new QFormLayout();
+    QSpinBox * dpiBox = new QSpinBox(&dialog);
+    dpiBox->setRange(10, 10000);
+    dpiBox->setValue(settings.value("exportAllDPI",
+				    qRound(currentPhysicalDPI_X)).toInt());
+    form->addRow("Image resolution (dots per inch):", dpiBox);
+    layout->addLayout(form);
+    QDialogButtonBox * buttons
+	= new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel,
+			       &dialog);
+    connect(buttons, SIGNAL(accepted()), &dialog, SLOT(accept()));
+    connect(buttons, SIGNAL(rejected()), &dialog, SLOT(reject()));
+    layout->addWidget(buttons);
+    if (dialog.exec() != QDialog::Accepted)
+	return;
+
+    wanted.clear();
+    for (int i = 0; i < formats.count(); i++)
+	if (boxes.at(i)->isChecked())
+	    wanted << formats.at(i);
+    if (wanted.isEmpty())
+	return;
+    settings.setValue("exportAllFormats", wanted);
+    settings.setValue("exportAllDPI", dpiBox->value());
+
+    QString fileName = QFileDialog::getSaveFileName(this,
+						    "Export all: base name",
+						    fileDirectory,
+						    "All Files (*)");
+    if (fileName.isNull())
+	return;
+    // "fig" and "fig.png" both mean fig.grphc, fig.tikz, ...
+    QFileInfo fi(fileName);
+    QString base = fi.absolutePath() + "/"
+	+ (formats.contains(fi.suffix()) ? fi.completeBaseName()
+	   : fi.fileName());
+
+    Edge::adjustQueuedEdges();
+    Graph_Description snapshot;
+    snapshotScene(ui->canvas->scene(), snapshot);
+    if (snapshot.nodes.isEmpty())
+    {
+	QMessageBox::information(0, "Error",
+				 "There is nothing on the canvas to export.");
+	return;
+    }
+
+    exportJobs.clear();
+    foreach (QString format, wanted)
+    {
+	Export_Job job;
+	job.snapshot = snapshot;	// Implicitly shared, not copied.
+	job.fileName = base + "." + format;
+	job.format = format;
+	job.companion = format == GRAPHiCS_FILE_EXTENSION
+	    && libraryIndex->contains(job.fileName);
+	job.dpi = dpiBox->value();
+	job.background = Qt::transparent;
+	if (format == "jpg")
+	{
+	    if (settings.contains("jpgBgColour"))
+		job.background = settings.value("jpgBgColour").toString();
+	    else
+		job.background = Qt::white;
+	}
+	else if (settings.contains("otherImageBgColour"))
+	    job.background = settings.value("otherImageBgColour").toString();
+	job.ok = false;
+	exportJobs.append(job);
+    }
+
+    // Each text file is a task of its own; the images share one, which
+    // goes first since it takes longest.  exportJobs is not touched
+    // again until exportDone(), so the pointers stay good.
+    exportTasks.clear();
+    Export_Task images;
+    for (int i = 0; i < exportJobs.count(); i++)
+    {
+	if (isImageExport(exportJobs.at(i).format))
+	    images.append(&exportJobs[i]);
+	else
+	    exportTasks.append(Export_Task() << &exportJobs[i]);
+    }
+    if (!images.isEmpty())
+	exportTasks.prepend(images);
+
+    qDeb() << "MW::export_All(): " << exportJobs.count() << " files, "
+	   << snapshot.nodes.count() << " nodes, "
+	   << snapshot.edges.count() << " edges";
+    ui->actionExport_All->setEnabled(false);
+    ui->statusBar->showMessage(QString("Exporting %1 files...")
+			       .arg(exportJobs.count()));
+    exportWatcher->setFuture(QtConcurrent::map(exportTasks, runExport));
+}
+
+
+
+/*
+ * Name:	exportDone()
+ * Purpose:	Report the results of export_All().
+ * Arguments:	None.
+ * Outputs:	A message in the status bar, and a message box if any
+ *		file could not be written.
+ * Modifies:	exportJobs and exportTasks.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	The library index is told about any .grphc files, as
+ *		save_Graph() does.
+ */
+
+void
+MainWindow::exportDone()
+{
+    QString errors;
+    int written = 0;
+
+    foreach (const Export_Job &job, exportJobs)
+    {
+	if (job.ok)
+	{
+	    written++;
+	    if (job.format == GRAPHiCS_FILE_EXTENSION)
+		libraryIndex->fileSaved(job.fileName);
+	}
+	else
+	    errors += job.fileName + ": " + job.errorMessage + "\n";
+    }
+    exportTasks.clear();
+    exportJobs.clear();
+
+    ui->actionExport_All->setEnabled(true);
+    ui->statusBar->showMessage(QString("Exported %1 files.").arg(written),
+			       5000);
+    if (!errors.isEmpty())
+	QMessageBox::information(0, "Error", "Unable to export:\n" + errors);
+}
+
+
+
+/*
+ * Name:	recoverAutosave()
+ * Purpose:	Offer the user the canvas of a session which crashed.
+ * Arguments:	None.
+ * Outputs:	A question, and possibly the graph in the preview.
+ * Modifies:	The preview scene, or the file system.
+ * Returns:	Nothing.
+ * Assumptions:	autoSaver->hasRecovery() was true at startup.
+ * Bugs:	None known.
+ * Notes:	The graph is loaded like any other graph-ic file, so
+ *		it shows up in the preview pane, from where the user
+ *		can drag it onto the canvas.  If the user declines,
+ *		the autosave file is removed.
+ */
+
+void
+MainWindow::recoverAutosave()
+{
+    QMessageBox::StandardButton button
+	= QMessageBox::question(this, "Graphic",
+				tr("Graphic did not exit normally last "
+				   "time.\nRecover the canvas it autosaved?"),
+				QMessageBox::No | QMessageBox::Yes);
+    if (button == QMessageBox::Yes)
+	select_Custom_Graph(autoSaver->fileName());
+    else
+	autoSaver->discard();
+}
+
+
 void
 MainWindow::loadSettings()
 {
@@ -3286,12 +4114,14 @@ MainWindow::closeEvent (QCloseEvent *event)
             if (closeBtn == QMessageBox::Yes)
                 save_Graph();
             saveSettings();
+	    autoSaver->discard();
             event->accept();
         }
     }
     else
     {
         saveSettings();
+	autoSaver->discard();
         event->accept();
     }
 }
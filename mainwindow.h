@@ -2,7 +2,7 @@
  * File:	mainwindow.h
  * Author:	Rachel Bood
  * Date:	January 25, 2015.
- * Version:	1.16
+ * Version:	1.28
  *
  * Purpose:	Define the MainWindow class.
  *
@@ -54,23 +54,106 @@
  * August 21, 2020 (IC V1.16)
  *  (a) Added the ability to number edge labels similar to nodes so
  *      on_EdgeNumLabelCheckBox_clicked was added as well.
+ * Oct 18, 2026 (agent V1.17)
+ *  (a) Declare the non-class functions saveEdgelist(), saveTikZ(),
+ *      saveGraphIc() and readGraphIc() so that the batch renderer
+ *      can use them.
+ * Oct 18, 2026 (agent V1.18)
+ *  (a) Replace gridLayout and scroll with editTabModel, remove
+ *	updateEditTab(int) and add canvasFocusChanged().
+ * Oct 18, 2026 (agent V1.19)
+ *  (a) Add layout_Graphs(), layoutDone() and the state of a running
+ *	force-directed layout.
+ * Oct 18, 2026 (agent V1.20)
+ *  (a) Add the GraphLoader and progress dialog used by
+ *	select_Custom_Graph() for big files, and the slots
+ *	customGraphLoaded(), customGraphFailed() and
+ *	cancelCustomGraph().
+ * Oct 18, 2026 (agent V1.21)
+ *  (a) Add libraryIndex and libraryChanged().
+ * Oct 18, 2026 (agent V1.22)
+ *  (a) Add thumbnailCache, thumbnailsWanted, eventFilter(),
+ *	requestThumbnails() and thumbnailReady().
+ * Oct 18, 2026 (agent V1.23)
+ *  (a) Add export_All(), exportDone() and the state of running
+ *	"Export all" jobs.
+ * Oct 18, 2026 (agent V1.24)
+ *  (a) Add autoSaver and recoverAutosave().
+ * Oct 18, 2026 (agent V1.25)
+ *  (a) Declare the saveGraphIc() which writes a Graph_Description.
+ * Oct 18, 2026 (agent V1.26)
+ *  (a) Add Export_Job.companion.
+ * Oct 18, 2026 (agent V1.27)
+ *  (a) Declare the saveEdgelist() and saveTikZ() which write a
+ *	Graph_Description, and add Export_Task and exportTasks.
+ * Oct 18, 2026 (agent V1.28)
+ *  (a) Add loadInBackground().
  */
 
 
 #ifndef MAINWINDOW_H
 #define MAINWINDOW_H
 
+#include <QFutureWatcher>
 #include <QMainWindow>
+#include <QPointer>
+#include <QProgressDialog>
 #include <QtCore>
 #include <QtGui>
-#include <QGridLayout>
-#include <QScrollArea>
 
 #include "defuns.h"
+#include "edittabmodel.h"
+#include "forcelayout.h"
+#include "graphloader.h"
 #include "graph.h"
 #include "settingsdialog.h"
 #include "ui_settingsdialog.h"
 
+class AutoSaver;
+class GraphLoader;
+class LibraryIndex;
+class Node;
+class ThumbnailCache;
+
+// Non-class functions defined in mainwindow.cpp.
+bool saveEdgelist(QTextStream &outfile, QVector<Node *> nodes);
+bool saveEdgelist(QTextStream &outfile, const Graph_Description &description);
+bool saveTikZ(QTextStream &outfile, QVector<Node *> nodes);
+bool saveTikZ(QTextStream &outfile, const Graph_Description &description);
+bool saveGraphIc(QTextStream &outfile, QVector<Node *> nodes,
+		 bool outputExtra);
+bool saveGraphIc(QTextStream &outfile, const Graph_Description &description,
+		 bool outputExtra);
+Graph * readGraphIc(QTextStream &in, QString graphName,
+		    QString &errorMessage);
+
+// One graph being laid out by layout_Graphs().
+typedef struct layoutJob
+{
+    QPointer<Graph>	    root;	// The graph on the canvas.
+    QVector<QPointer<Node>> nodes;	// All of its nodes.
+    QVector<QPointF>	    positions;	// Their centres, in root's coords.
+    QVector<Layout_Edge>    edges;	// Indices into nodes.
+    qreal		    edgeLength;
+} Layout_Job;
+
+// One file being written by export_All().
+typedef struct exportJob
+{
+    Graph_Description	snapshot;	// The canvas; shared by all jobs.
+    QString		fileName;
+    QString		format;		// The file extension.
+    bool		companion;	// Also write a .grphb (library).
+    qreal		dpi;		// Of raster images.
+    QColor		background;	// Of raster images.
+    bool		ok;
+    QString		errorMessage;
+} Export_Job;
+
+// What one pool thread does for export_All(): write one text file, or
+// draw all of the images (which share one scene).
+typedef QVector<Export_Job *> Export_Task;
+
 namespace Ui
 {
     class MainWindow;
@@ -87,11 +170,14 @@ class MainWindow : public QMainWindow
 
   protected:
     virtual void closeEvent (QCloseEvent *event);
+    virtual bool eventFilter(QObject * obj, QEvent * event);
 
   private slots:
     bool save_Graph();
     bool load_Graphic_File();
     void load_Graphic_Library();
+    void libraryChanged();
+    void thumbnailReady(QString path);
     void select_Custom_Graph(QString graphName);
     void generate_Graph();
     void generate_Graph(enum widget_ID changed_widget);
@@ -99,6 +185,14 @@ class MainWindow : public QMainWindow
     void generate_Combobox_Titles();
     void dumpGraphIc();
     void dumpTikZ();
+    void layout_Graphs();
+    void layoutDone();
+    void export_All();
+    void exportDone();
+    void recoverAutosave();
+    void customGraphLoaded(Graph * graph);
+    void customGraphFailed(QString errorMessage);
+    void cancelCustomGraph();
 
     void set_Font_Sizes();
     void on_NodeOutlineColor_clicked();
@@ -124,8 +218,10 @@ class MainWindow : public QMainWindow
 
     void on_freestyleMode_radioButton_clicked();
 
-    void updateEditTab(int index);
     void updateEditTab();
+    void canvasFocusChanged(QGraphicsItem * newFocus,
+			    QGraphicsItem * oldFocus,
+			    Qt::FocusReason reason);
 
     void somethingChanged();
     void updateDpiAndPreview();
@@ -133,15 +229,27 @@ class MainWindow : public QMainWindow
 private:
     void loadSettings();
     void saveSettings();
+    void requestThumbnails();
+    void loadInBackground(QString graphName);
 
     Ui::MainWindow * ui;
     QDir dir;
     QString fileDirectory;
-    QGridLayout * gridLayout;
-    QScrollArea * scroll;
+    EditTabModel * editTabModel;
     QList<Graph *> graphList;
     bool promptSave = false;
     SettingsDialog * settingsDialog;
+    QVector<Layout_Job> layoutJobs;
+    QFutureWatcher<void> * layoutWatcher;
+    QVector<Export_Job> exportJobs;
+    QVector<Export_Task> exportTasks;
+    QFutureWatcher<void> * exportWatcher;
+    GraphLoader * graphLoader;
+    QPointer<QProgressDialog> loadProgress;
+    LibraryIndex * libraryIndex = nullptr;
+    ThumbnailCache * thumbnailCache = nullptr;
+    bool thumbnailsWanted = false;
+    AutoSaver * autoSaver;
 };
 
 #endif // MAINWINDOW_H
@@ -2,7 +2,7 @@
  * File:    node.cpp
  * Author:  Rachel Bood
  * Date:    2014/11/07
- * Version: 1.14
+ * Version: 1.22
  *
  * Purpose: creates a node for the users graph
  *
@@ -76,8 +76,47 @@
  *  (a) Removed the June 18th change and replaced the connection with one
  *      that updates the label when the user is done editting it from the
  *      canvas.
+ * Oct 18, 2026 (agent V1.15)
+ *  (a) itemChange() now queues the node's edges with Edge::queueAdjust()
+ *	rather than adjust()ing each of them on every move, and tells
+ *	the parent graph via Graph::childMoved() instead of removing
+ *	and re-adding the node to it.
+ * Oct 18, 2026 (agent V1.16)
+ *  (a) The node's HTML_Label is now only created (by createHtmlLabel())
+ *	when a non-empty label is set or the label is to be edited,
+ *	since most nodes of generated graphs are never labelled.
+ *	The label font size is kept in labelSize so that it can be
+ *	set and read without a label.  editLabel(false) deletes a
+ *	label which is (still) empty.
+ * Oct 18, 2026 (agent V1.17)
+ *  (a) The node's appearance (diameter, pen width, colours, label
+ *	size and the DPI used for the diameter) is now kept in a
+ *	NodeStyle which is shared with the other nodes of its graph.
+ *	The setters copy the style first if it is shared (so only
+ *	this node changes); setStyle() points the node at a new one.
+ * Oct 18, 2026 (agent V1.18)
+ *  (a) paint() draws a node which is tiny on the screen as a square
+ *	(or a point), without antialiasing.
+ * Oct 18, 2026 (agent V1.19)
+ *  (a) paint() no longer moves the label (which made the scene
+ *	repaint it again); setDiameter() and setStyle() tell the
+ *	label where the middle of the node is, and the label keeps
+ *	itself centred there as its text changes.
+ * Oct 18, 2026 (agent V1.20)
+ *  (a) paint() tells an export from a view by isExporting() (see
+ *	defuns.h), not by the widget, which is null in a view too
+ *	when the node's graph is cached.
+ * Oct 18, 2026 (agent V1.21)
+ *  (a) Corrected the notes of editLabel(): it is now only called
+ *	for nodes which have a label, or which were clicked on.
+ * Oct 18, 2026 (agent V1.22)
+ *  (a) The setters and itemChange() tell the autosaver (see
+ *	AutoSaver::nodeChanged()) when the node changes, and
+ *	itemChange() and the (revived) destructor tell it when the
+ *	node joins or leaves a scene.
  */
 
+#include "autosave.h"
 #include "defuns.h"
 #include "edge.h"
 #include "node.h"
@@ -117,14 +156,44 @@ Node::Node()
     setZValue(2);
     nodeID = -1;
     penStyle = 0;	// What type of pen style to use when drawing outline.
-    penSize = 1;        // Size of node outline
-    nodeDiameter = 1;
+    nodeStyle = NodeStyle::defaultStyle();  // Diameter, pen size, ...
     rotation = 0;
-    htmlLabel = new HTML_Label(this);
+    htmlLabel = nullptr;	// See createHtmlLabel().
     setHandlesChildEvents(true);
     select = false;		    // TODO: is 'select' of any use?
-    physicalDotsPerInchX = currentPhysicalDPI_X;
     checked = 0;
+}
+
+
+
+/*
+ * Name:	createHtmlLabel()
+ * Purpose:	Create the HTML_Label of this node, if it doesn't
+ *		already have one.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	htmlLabel.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	Each HTML_Label has its own QTextDocument, so creating
+ *		one for every node made big unlabelled graphs slow to
+ *		build and needlessly large.  The new label gets the
+ *		current label text and font size.
+ */
+
+void
+Node::createHtmlLabel()
+{
+    if (htmlLabel != nullptr)
+	return;
+
+    qDeb() << "N::createHtmlLabel() called for node " << nodeID;
+
+    htmlLabel = new HTML_Label(this);
+    QFont font = htmlLabel->font();
+    font.setPointSize(nodeStyle->labelSize);
+    htmlLabel->setFont(font);
 
     connect(htmlLabel, SIGNAL(editDone(QString)),
             this, SLOT(setNodeLabel(QString)));
@@ -183,7 +252,7 @@ bool Node::removeEdge(Edge * edge)
  *		Notifies its edges that one of their nodes changed.
  * Arguments:   qreal
  * Output:      Nothing.
- * Modifies:    nodeDiameter
+ * Modifies:    nodeStyle (which is first copied if it is shared).
  * Returns:     Nothing.
  * Assumptions: none
  * Bugs:        none
@@ -195,10 +264,14 @@ bool Node::removeEdge(Edge * edge)
 void
 Node::setDiameter(qreal diameter)
 {
-    nodeDiameter = diameter * physicalDotsPerInchX;
+    nodeStyle.detach();
+    nodeStyle->diameter = diameter * nodeStyle->physicalDPI;
+    if (htmlLabel != nullptr)
+	htmlLabel->setCentre(boundingRect().center());
     foreach (Edge * edge, edgeList)
 	edge->adjust();
     update();
+    AutoSaver::nodeChanged(this);
 }
 
 
@@ -221,7 +294,7 @@ Node::setDiameter(qreal diameter)
 
 qreal Node::getDiameter()
 {
-    return nodeDiameter / physicalDotsPerInchX;
+    return nodeStyle->diameter / nodeStyle->physicalDPI;
 }
 
 
@@ -275,7 +348,7 @@ Node::getRotation()
  * Purpose:     Sets the fill colour of the node.
  * Arguments:   QColor
  * Output:      Nothing.
- * Modifies:    nodeFill
+ * Modifies:    nodeStyle (which is first copied if it is shared).
  * Returns:     Nothing.
  * Assumptions: none
  * Bugs:        none
@@ -285,8 +358,10 @@ Node::getRotation()
 void
 Node::setFillColour(QColor fColor)
 {
-    nodeFill = fColor;
+    nodeStyle.detach();
+    nodeStyle->fillColour = fColor;
     update();
+    AutoSaver::nodeChanged(this);
 }
 
 
@@ -306,7 +381,7 @@ Node::setFillColour(QColor fColor)
 QColor
 Node::getFillColour()
 {
-    return nodeFill;
+    return nodeStyle->fillColour;
 }
 
 
@@ -316,7 +391,7 @@ Node::getFillColour()
  * Purpose:     Sets the outline colour of the node.
  * Arguments:   QColor
  * Output:      Nothing.
- * Modifies:    nodeLine
+ * Modifies:    nodeStyle (which is first copied if it is shared).
  * Returns:     Nothing.
  * Assumptions: none
  * Bugs:        none
@@ -326,8 +401,10 @@ Node::getFillColour()
 void
 Node::setLineColour(QColor lColor)
 {
-    nodeLine = lColor;
+    nodeStyle.detach();
+    nodeStyle->lineColour = lColor;
     update();
+    AutoSaver::nodeChanged(this);
 }
 
 
@@ -347,7 +424,7 @@ Node::setLineColour(QColor lColor)
 QColor
 Node::getLineColour()
 {
-    return nodeLine;
+    return nodeStyle->lineColour;
 }
 
 
@@ -509,16 +586,26 @@ Node::setNodeLabel(QString aLabel, QString subscript)
  * Returns:     Nothing.
  * Assumptions: none
  * Bugs:        none
- * Notes:       This is (apparently) called from the labelcontroller.cpp
- *		callback, which doesn't distinguish between integer and
- *		string.  So do a test to choose the correct font.
+ * Notes:       This is called from EditTabModel::setData() (formerly
+ *		from the labelcontroller.cpp callback), which doesn't
+ *		distinguish between integer and string.  So do a test
+ *		to choose the correct font.
  *		TODO: eh??
+ *		Clearing the label of a node which has no HTML_Label
+ *		does not create one.
  */
 
 void
 Node::setNodeLabel(QString aLabel)
 {
     label = aLabel;
+    AutoSaver::nodeChanged(this);
+    if (htmlLabel == nullptr)
+    {
+	if (aLabel.isEmpty())
+	    return;
+	createHtmlLabel();
+    }
     htmlLabel->texLabelText = aLabel;
     labelToHtml();
 }
@@ -591,7 +678,8 @@ Node::labelToHtml()
  * Purpose:     Sets the font size of the node's label.
  * Arguments:   qreal
  * Output:      Nothing.
- * Modifies:    The node's text and fontsize.
+ * Modifies:    nodeStyle (which is first copied if it is shared), and
+ *		the font size of htmlLabel (if any).
  * Returns:     Nothing.
  * Assumptions: none
  * Bugs:        none
@@ -599,10 +687,16 @@ Node::labelToHtml()
  */
 
 void
-Node::setNodeLabelSize(qreal labelSize)
+Node::setNodeLabelSize(qreal aLabelSize)
 {
+    nodeStyle.detach();
+    nodeStyle->labelSize = aLabelSize;
+    AutoSaver::nodeChanged(this);
+    if (htmlLabel == nullptr)
+	return;
+
     QFont font = htmlLabel->font();
-    font.setPointSize(labelSize);
+    font.setPointSize(aLabelSize);
     htmlLabel->setFont(font);
 }
 
@@ -643,7 +737,7 @@ Node::getLabel() const
 qreal
 Node::getLabelSize() const
 {
-    return htmlLabel->font().pointSizeF();
+    return nodeStyle->labelSize;
 }
 
 
@@ -664,6 +758,7 @@ QRectF
 Node::boundingRect() const
 {
     qreal adjust = 2;
+    qreal nodeDiameter = nodeStyle->diameter;
 
     return QRectF( (-1 * nodeDiameter / 2) - adjust,
                    (-1 * nodeDiameter / 2) - adjust,
@@ -700,16 +795,39 @@ Node::chosen(int pen_style)
  * Arguments:   boolean
  * Output:      Nothing.
  * Modifies:    ItemIsFocusable, ItemIsSelectable, setHandlesChildEvents flags
+ *		htmlLabel (which may be created or deleted).
  * Returns:     Nothing.
  * Assumptions: none
  * Bugs:        none
- * Notes:       none
+ * Notes:       editLabel(true) gives the node a label if it has none,
+ *		so that it can be typed into; CanvasScene does that
+ *		only for a node which is clicked on in edit mode.
+ *		When edit mode is left, any label still being edited
+ *		is finished first (so that its text is not lost), and
+ *		then an empty label is thrown away again.
  */
 
 void
 Node::editLabel(bool edit)
 {
     setHandlesChildEvents(!edit);
+
+    if (edit)
+	createHtmlLabel();
+    else if (htmlLabel == nullptr)
+	return;
+    else
+    {
+	if (htmlLabel->hasFocus())
+	    htmlLabel->clearFocus();
+	if (label.isEmpty())
+	{
+	    delete htmlLabel;
+	    htmlLabel = nullptr;
+	    return;
+	}
+    }
+
     htmlLabel->setFlag(QGraphicsItem::ItemIsFocusable, edit);
     htmlLabel->setFlag(ItemIsSelectable, edit);
 }
@@ -725,8 +843,17 @@ Node::editLabel(bool edit)
  * Returns:     none
  * Assumptions: none
  * Bugs:        none
- * Notes:       none
+ * Notes:       A node deleted while it is on the canvas is taken out
+ *		of the scene by ~QGraphicsItem(), which doesn't call
+ *		itemChange(), so the autosaver is told here.
+ *		The old version is below.
  */
+
+Node::~Node()
+{
+    AutoSaver::itemsChanged(scene());
+}
+
 //Node::~Node()
 //{
 //    emit nodeDeleted();
@@ -766,7 +893,7 @@ Node::nodeDeleted()
  * Purpose:     Sets the width (penSize) of the node.
  * Arguments:   The new width.
  * Output:      Nothing.
- * Modifies:    The node's penSize.
+ * Modifies:    nodeStyle (which is first copied if it is shared).
  * Returns:     Nothing.
  * Assumptions: ?
  * Bugs:        ?
@@ -778,8 +905,10 @@ Node::nodeDeleted()
 void
 Node::setPenWidth(qreal aPenWidth)
 {
-    penSize = aPenWidth;
+    nodeStyle.detach();
+    nodeStyle->penWidth = aPenWidth;
     update();
+    AutoSaver::nodeChanged(this);
 }
 
 
@@ -800,7 +929,70 @@ Node::setPenWidth(qreal aPenWidth)
 qreal
 Node::getPenWidth()
 {
-    return penSize;
+    return nodeStyle->penWidth;
+}
+
+
+
+/*
+ * Name:	style()
+ * Purpose:	Return this node's style entry.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The (possibly shared) NodeStyle.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	Nodes with the same entry look the same, so callers can
+ *		deal with each distinct entry once rather than with
+ *		each node (see findDefaults() and Style_Graph()).
+ */
+
+const NodeStyle *
+Node::style() const
+{
+    return nodeStyle.constData();
+}
+
+
+
+/*
+ * Name:	setStyle()
+ * Purpose:	Make this node use the given style entry.
+ * Arguments:	The new entry.
+ * Outputs:	Nothing.
+ * Modifies:	nodeStyle, and the node's label font and edges if the
+ *		label size or diameter changed.
+ * Returns:	Nothing.
+ * Assumptions:	aStyle is not null.
+ * Bugs:	None.
+ * Notes:	The entry is shared, not copied, so any later change to
+ *		it (by whoever made it) is seen by this node too.
+ */
+
+void
+Node::setStyle(NodeStylePtr aStyle)
+{
+    bool resized = aStyle->diameter != nodeStyle->diameter;
+
+    if (resized)
+	prepareGeometryChange();
+    if (htmlLabel != nullptr && aStyle->labelSize != nodeStyle->labelSize)
+    {
+	QFont font = htmlLabel->font();
+	font.setPointSize(aStyle->labelSize);
+	htmlLabel->setFont(font);
+    }
+    nodeStyle = aStyle;
+    if (resized)
+    {
+	if (htmlLabel != nullptr)
+	    htmlLabel->setCentre(boundingRect().center());
+	foreach (Edge * edge, edgeList)
+	    edge->adjust();
+    }
+    update();
+    AutoSaver::nodeChanged(this);
 }
 
 
@@ -815,6 +1007,13 @@ Node::getPenWidth()
  * Assumptions: none
  * Bugs:        none
  * Notes:       Currently only draws nodes as circles.
+ *		When a view is zoomed out so far that the node is less
+ *		than LOD_MIN_NODE_PIXELS across, an antialiased circle
+ *		is a waste of time, so it is drawn as a square (or, if
+ *		less than a pixel across, a point) in its outline
+ *		colour, which is what such a small circle looks like
+ *		anyway.  Exported images (see isExporting()) are
+ *		always drawn in full.
  */
 
 void
@@ -825,7 +1024,29 @@ Node::paint(QPainter * painter, const QStyleOptionGraphicsItem * option,
     Q_UNUSED(widget);
     QColor brushColor;
 
-    brushColor = nodeFill;
+    if (!isExporting(scene()))
+    {
+	qreal lod = QStyleOptionGraphicsItem::levelOfDetailFromTransform(
+	    painter->worldTransform());
+	qreal d = nodeStyle->diameter;
+	if (d * lod < LOD_MIN_NODE_PIXELS)
+	{
+	    bool antialiased = painter->testRenderHint(QPainter::Antialiasing);
+	    painter->setRenderHint(QPainter::Antialiasing, false);
+	    if (d * lod < 1)
+	    {
+		painter->setPen(nodeStyle->lineColour);
+		painter->drawPoint(QPointF(0, 0));
+	    }
+	    else
+		painter->fillRect(QRectF(-d / 2, -d / 2, d, d),
+				  nodeStyle->lineColour);
+	    painter->setRenderHint(QPainter::Antialiasing, antialiased);
+	    return;
+	}
+    }
+
+    brushColor = nodeStyle->fillColour;
     painter->setBrush(brushColor);
 
     QPen pen;
@@ -837,36 +1058,41 @@ Node::paint(QPainter * painter, const QStyleOptionGraphicsItem * option,
     else
         pen.setStyle(Qt::SolidLine);
 
-    pen.setColor(nodeLine);
-    pen.setWidthF(penSize);
+    pen.setColor(nodeStyle->lineColour);
+    pen.setWidthF(nodeStyle->penWidth);
     painter->setPen(pen);
 
+    qreal nodeDiameter = nodeStyle->diameter;
     painter->drawEllipse(-1 * nodeDiameter / 2,
                          -1 * nodeDiameter / 2,
                          nodeDiameter, nodeDiameter);
-
-    htmlLabel->setPos(this->boundingRect().center().x()
-		      - htmlLabel->boundingRect().width() / 2.,
-		      this->boundingRect().center().y()
-		      - htmlLabel->boundingRect().height() / 2.);
 }
 
 
 
 /*
  * Name:        itemChange()
- * Purpose:     Send a signal to the node's edges to re-adjust their
- *		geometries when a node is moved or rotated.
+ * Purpose:     Queue the node's edges to have their geometries
+ *		re-adjusted when a node is moved or rotated.
  * Arguments:   GraphicsItemChange, QVariant value
  * Output:      Nothing.
  * Modifies:    The node's edges' geometries and selection boxes (indirectly).
  * Returns:     A QVariant
  * Assumptions: ?
  * Bugs:        ?
- * Notes:       TODO: what is going on in the parent == graph block?
- *		If I don't execute that code, I get the whinage from
- *		the "else qDeb() << does not have parent" message below,
- *		but in quick tests nothing else seemed to be a problem.
+ * Notes:       The edges are adjusted by Edge::adjustQueuedEdges() the
+ *		next time through the event loop, so dragging a node
+ *		with many edges costs one adjust() per edge per repaint.
+ *		This also means that the ItemRotationChange case (which
+ *		is sent before the rotation is applied) now sees the
+ *		new rotation.
+ *		The parent graph used to be told about the move by
+ *		removing the node from it and adding it back, which
+ *		made Qt recompute the graph's childrenBoundingRect().
+ *		Graph::childMoved() does that directly.
+ *		The autosaver is told about moves, rotations and new
+ *		parents (which move the node in the scene), and about
+ *		the node joining or leaving a scene.
  */
 
 QVariant
@@ -883,22 +1109,31 @@ Node::itemChange(GraphicsItemChange change, const QVariant &value)
             if (parentItem()->type() == Graph::Type)
             {
                 Graph * graph = qgraphicsitem_cast<Graph*>(parentItem());
-                Graph * tempGraph = graph;
-                graph = qgraphicsitem_cast<Graph*>(graph->getRootParent());
-                this->setParentItem(nullptr);  // ???????????
-                this->setParentItem(tempGraph);// Whats the point of this?
+                graph->childMoved();
             }
 	    else
 		qDeb() << "itemChange(): node does not have a "
 		       << "graph item parent; Very Bad!";
         }
         foreach (Edge * edge, edgeList)
-            edge->adjust();
+            Edge::queueAdjust(edge);
+        AutoSaver::nodeChanged(this);
         break;
 
       case ItemRotationChange:
         foreach (Edge * edge, edgeList)
-            edge->adjust();
+            Edge::queueAdjust(edge);
+        break;
+
+      case ItemRotationHasChanged:
+      case ItemParentHasChanged:
+        AutoSaver::nodeChanged(this);
+        break;
+
+      // Before the change scene() is the old scene, after it the new.
+      case ItemSceneChange:
+      case ItemSceneHasChanged:
+        AutoSaver::itemsChanged(scene());
         break;
 
       default:
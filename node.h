@@ -2,7 +2,7 @@
  * File:    node.cpp
  * Author:  Rachel Bood
  * Date:    2014/11/07
- * Version: 1.9
+ * Version: 1.12
  *
  * Purpose: Declare the node class.
  * 
@@ -38,6 +38,19 @@
  * July 29, 2020 (IC V1.9)
  *  (a) Added eventFilter() to receive edit tab events so we can identify
  *      the node being edited/looked at.
+ * Oct 18, 2026 (agent V1.10)
+ *  (a) Add createHtmlLabel() and a labelSize member (which holds the
+ *	label font size while there is no label; see V1.11); htmlLabel
+ *	is now nullptr until the node is given a label or its label is
+ *	edited.
+ * Oct 18, 2026 (agent V1.11)
+ *  (a) The diameter, pen width, colours, label size and DPI are now
+ *	kept in a (shared) NodeStyle; add style() and setStyle().
+ *	The labelSize member is gone (it is the style's labelSize),
+ *	and so is physicalDotsPerInchX (it is the style's
+ *	physicalDPI).
+ * Oct 18, 2026 (agent V1.12)
+ *  (a) Declare the destructor (again), which tells the autosaver.
  */
 
 
@@ -45,6 +58,7 @@
 #define NODE_H
 
 #include "html-label.h"
+#include "styletable.h"
 #include <QGraphicsItem>
 #include <QList>
 #include <QGraphicsSceneMouseEvent>
@@ -106,11 +120,13 @@ class Node : public QGraphicsObject
     void chosen(int group1);
 
     void editLabel(bool edit);
-    // ~Node();
+    ~Node();
 
-    HTML_Label * htmlLabel;
+    const NodeStyle * style() const;
+    void setStyle(NodeStylePtr aStyle);
+
+    HTML_Label * htmlLabel;	// nullptr if the node has no label.
     int checked;
-    qreal physicalDotsPerInchX; // should be private with getter/setter
 
   public slots:
     void setNodeLabel(QString aLabel);
@@ -128,14 +144,14 @@ class Node : public QGraphicsObject
 
   private:
     QPointF	newPos;
-    qreal	nodeDiameter, rotation;
+    qreal	rotation;
     QString	label;
-    QColor	nodeLine, nodeFill;
+    NodeStylePtr nodeStyle;	    // Diameter, colours, ...; shared.
     int		nodeID;		    // The (internal) number of the node.
     int		penStyle;
-    qreal	penSize;
     bool	select;
     void	labelToHtml();
+    void	createHtmlLabel();
     qreal	previewX;
     qreal	previewY;
 };
@@ -2,7 +2,7 @@
  * File:    preview.cpp
  * Author:  Rachel Bood 100088769
  * Date:    2014/11/07
- * Version: 1.13
+ * Version: 1.17
  *
  * Purpose: Initializes a QGraphicsView that is used to house the QGraphicsScene
  *
@@ -72,11 +72,25 @@
  * August 21, 2020 (IC V1.13)
  *  (a) Added the ability to number edge labels similar to nodes so style_graph
  *      was updated to accomodate the numbering.
+ * Oct 18, 2026 (agent V1.14)
+ *  (a) Style_Graph() styles the graph's EdgeBundle (if any), and
+ *      expands it into Edges first if the edges are to be labelled.
+ * Oct 18, 2026 (agent V1.15)
+ *  (a) Style_Graph() restyles each distinct (shared) node and edge
+ *      style of the graph once, and points the items at the results,
+ *      rather than setting each style property of each item.
+ * Oct 18, 2026 (agent V1.16)
+ *  (a) Mark the scene as exporting (see isExporting()) while the
+ *      drag image is drawn, so that it is drawn in full.
+ * Oct 18, 2026 (agent V1.17)
+ *  (a) Use Graph::setExporting() for that, so that the graphs are
+ *      not drawn from their caches.
  */
 
 #include "basicgraphs.h"
 #include "defuns.h"
 #include "edge.h"
+#include "edgebundle.h"
 #include "node.h"
 #include "graph.h"
 #include "graphmimedata.h"
@@ -87,6 +101,7 @@
 #include <QDrag>
 #include <QDebug>
 #include <QGraphicsSceneMouseEvent>
+#include <QHash>
 #include <QPointF>
 #include <QMessageBox>
 #include <QFileDialog>
@@ -282,12 +297,14 @@ PreView::mousePressEvent(QMouseEvent * event)
 				       QPainter::HighQualityAntialiasing |
 				       QPainter::NonCosmeticDefaultPen,
 				       true);
+		Graph::setExporting(scene(), true);
 		scene()->render(&painter,
 				QRectF(0, 0,
 				       scene()->itemsBoundingRect().width(),
 				       scene()->itemsBoundingRect().height()),
 				scene()->itemsBoundingRect(),
 				Qt::IgnoreAspectRatio);
+		Graph::setExporting(scene(), false);
 		painter.end();
 
 		drag->setPixmap(*image);
@@ -472,6 +489,10 @@ PreView::Create_Basic_Graph(int graphType, int numOfNodes1, int numOfNodes2,
  *		centered on (0, 0).  When styling the graph, we use
  *		this information, the width and height, and the DPI
  *		information to scale the node location accordingly.
+ *		The nodes (edges) of a graph normally share one style
+ *		entry, so the style properties are applied once to a
+ *		copy of each distinct entry and then each item is
+ *		pointed at the copy of its entry.
  */
 
 #define GUARD(x) if ((what_changed == ALL_WGT) || ((x) == what_changed))
@@ -515,6 +536,15 @@ PreView::Style_Graph(Graph * graph,		    int graphType,
 	   << "; desired center height " << centerHeight
 	   << "\n\theightScaleFactor: " << heightScaleFactor;
 
+    // Compact edges have no labels, so if the edges are to be labelled
+    // the graph needs real Edges.
+    if (edgeLabelsNumbered || edgeLabel.length() != 0)
+	graph->expandEdges();
+
+    // Old style entry -> its restyled copy.
+    QHash<const NodeStyle *, NodeStylePtr> nodeStyles;
+    QHash<const EdgeStyle *, EdgeStylePtr> edgeStyles;
+
     foreach (QGraphicsItem * item, graph->childItems())
     {
         if (item->type() == Node::Type)
@@ -522,13 +552,20 @@ PreView::Style_Graph(Graph * graph,		    int graphType,
 	    Node * node = qgraphicsitem_cast<Node *>(item);
 	    node->setParentItem(nullptr);	    // ?? Eh?
 
-	    node->physicalDotsPerInchX = currentPhysicalDPI_X;
-
-	    GUARD(nodeThickness_WGT) node->setPenWidth(nodeThickness);
-	    GUARD(nodeDiam_WGT) node->setDiameter(nodeDiameter);
-	    GUARD(nodeFillColour_WGT) node->setFillColour(nodeFillColor);
-	    GUARD(nodeOutlineColour_WGT) node->setLineColour(nodeOutlineColor);
-	    GUARD(nodeLabelSize_WGT) node->setNodeLabelSize(nodeLabelSize);
+	    NodeStylePtr &style = nodeStyles[node->style()];
+	    if (!style)
+	    {
+		style = NodeStylePtr(new NodeStyle(*node->style()));
+		style->physicalDPI = currentPhysicalDPI_X;
+		GUARD(nodeThickness_WGT) style->penWidth = nodeThickness;
+		GUARD(nodeDiam_WGT)
+		    style->diameter = nodeDiameter * currentPhysicalDPI_X;
+		GUARD(nodeFillColour_WGT) style->fillColour = nodeFillColor;
+		GUARD(nodeOutlineColour_WGT)
+		    style->lineColour = nodeOutlineColor;
+		GUARD(nodeLabelSize_WGT) style->labelSize = nodeLabelSize;
+	    }
+	    node->setStyle(style);
 	    node->setPos(node->getPreviewX() * widthScaleFactor,
 			 node->getPreviewY() * heightScaleFactor);
 
@@ -569,10 +606,16 @@ PreView::Style_Graph(Graph * graph,		    int graphType,
         {
 	    Edge * edge = qgraphicsitem_cast<Edge *>(item);
 	    edge->setParentItem(nullptr);	// ?? Eh?
-	    GUARD(edgeThickness_WGT) edge->setPenWidth(edgeSize);
-	    GUARD(edgeLineColour_WGT) edge->setColour(edgeLineColor);
-	    GUARD(edgeLabelSize_WGT)
-		edge->setEdgeLabelSize((edgeLabelSize > 0) ? edgeLabelSize : 1);
+	    EdgeStylePtr &style = edgeStyles[edge->style()];
+	    if (!style)
+	    {
+		style = EdgeStylePtr(new EdgeStyle(*edge->style()));
+		GUARD(edgeThickness_WGT) style->penWidth = edgeSize;
+		GUARD(edgeLineColour_WGT) style->colour = edgeLineColor;
+		GUARD(edgeLabelSize_WGT)
+		    style->labelSize = (edgeLabelSize > 0) ? edgeLabelSize : 1;
+	    }
+	    edge->setStyle(style);
 	    if (what_changed == ALL_WGT
 		|| what_changed == edgeLabel_WGT
 		|| what_changed == edgeNumLabelCheckBox_WGT
@@ -592,6 +635,17 @@ PreView::Style_Graph(Graph * graph,		    int graphType,
 	    edge->setParentItem(graph);
         }
     }
+
+    EdgeBundle * bundle = graph->getEdgeBundle();
+    if (bundle != nullptr)
+    {
+	GUARD(edgeThickness_WGT) bundle->setPenWidth(edgeSize);
+	GUARD(edgeLineColour_WGT) bundle->setColour(edgeLineColor);
+	GUARD(edgeLabelSize_WGT)
+	    bundle->setEdgeLabelSize((edgeLabelSize > 0) ? edgeLabelSize : 1);
+	// The nodes were moved while they had no parent.
+	bundle->nodesMoved();
+    }
     qDeb() << "   graph currently located at " << graph->x() << ", "
 	   << graph->y(); 
     graph->setPos(mapToScene(viewport()->rect().center()));
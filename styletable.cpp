@@ -0,0 +1,180 @@
+/*
+ * File:	styletable.cpp
+ * Author:	agent
+ * Date:	2026-10-18
+ * Version:	1.0
+ *
+ * Purpose:	The shared style entries of nodes and edges.
+ *		A node or edge used to carry its own copy of its
+ *		diameter, pen width, colours, label size (and, for a
+ *		node, the DPI its diameter was computed with), even
+ *		though every node (edge) of a generated graph has the
+ *		same values.  Now each one points at a NodeStyle
+ *		(EdgeStyle), and all of the items of a graph normally
+ *		share a single entry.
+ *
+ *		Setting a property of one item copies the entry first
+ *		if anything else is using it (see the Node and Edge
+ *		setters), so items can still be styled individually.
+ *		Restyling a whole graph (PreView::Style_Graph()) makes
+ *		one new entry per distinct old entry and points the
+ *		items at it.
+ *
+ * Modification history:
+ * Oct 18, 2026 (agent V1.0)
+ *  (a) Initial version.
+ */
+
+#include "styletable.h"
+#include "defuns.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+
+
+
+/*
+ * Name:	NodeStyle()
+ * Purpose:	Constructor.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	These are the values a new Node used to set in its
+ *		constructor.  The colours are deliberately invalid.
+ */
+
+NodeStyle::NodeStyle()
+{
+    diameter = 1;
+    physicalDPI = currentPhysicalDPI_X;
+    penWidth = 1;
+    labelSize = 12;		// The HTML_Label default.
+}
+
+
+
+/*
+ * Name:	defaultStyle()
+ * Purpose:	Return the entry which new nodes start out with.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	The saved default entry, if the DPI has changed.
+ * Returns:	The default entry.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	A new default is made when the physical DPI changes
+ *		(the window moved to a different screen), since a node
+ *		used to capture the DPI in effect when it was created.
+ *		Nodes are created on the batch renderer's worker threads
+ *		as well, hence the mutex.
+ */
+
+NodeStylePtr
+NodeStyle::defaultStyle()
+{
+    static QMutex mutex;
+    static NodeStylePtr def;
+
+    QMutexLocker locker(&mutex);
+    if (!def || def->physicalDPI != currentPhysicalDPI_X)
+	def = NodeStylePtr(new NodeStyle());
+    return def;
+}
+
+
+
+/*
+ * Name:	operator==()
+ * Purpose:	Compare two node styles.
+ * Arguments:	The other style.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	True iff all of the properties are the same.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	Used (with hash()) by StyleTable.
+ */
+
+bool
+NodeStyle::operator==(const NodeStyle &other) const
+{
+    return diameter == other.diameter
+	&& physicalDPI == other.physicalDPI
+	&& penWidth == other.penWidth
+	&& labelSize == other.labelSize
+	&& fillColour == other.fillColour
+	&& lineColour == other.lineColour;
+}
+
+
+
+uint
+NodeStyle::hash() const
+{
+    return qHash(diameter) ^ qHash(physicalDPI) ^ qHash(penWidth) * 3
+	^ qHash(labelSize) * 5 ^ fillColour.rgba() ^ lineColour.rgba() * 7;
+}
+
+
+
+/*
+ * Name:	EdgeStyle()
+ * Purpose:	Constructor.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	As for NodeStyle().
+ */
+
+EdgeStyle::EdgeStyle()
+{
+    penWidth = 1;
+    labelSize = 12;
+}
+
+
+
+/*
+ * Name:	defaultStyle()
+ * Purpose:	Return the entry which new edges start out with.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The default entry.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	The initialization of a static local is thread-safe.
+ */
+
+EdgeStylePtr
+EdgeStyle::defaultStyle()
+{
+    static EdgeStylePtr def(new EdgeStyle());
+
+    return def;
+}
+
+
+
+bool
+EdgeStyle::operator==(const EdgeStyle &other) const
+{
+    return penWidth == other.penWidth
+	&& labelSize == other.labelSize
+	&& colour == other.colour;
+}
+
+
+
+uint
+EdgeStyle::hash() const
+{
+    return qHash(penWidth) ^ qHash(labelSize) * 5 ^ colour.rgba();
+}
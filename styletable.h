@@ -0,0 +1,93 @@
+/*
+ * File:	styletable.h
+ * Author:	agent
+ * Date:	2026-10-18
+ * Version:	1.0
+ *
+ * Purpose:	Declare the shared (reference-counted) style entries which
+ *		nodes and edges point into for their appearance.
+ *
+ * Modification history:
+ * Oct 18, 2026 (agent V1.0)
+ *  (a) Initial version.
+ */
+
+#ifndef STYLETABLE_H
+#define STYLETABLE_H
+
+#include <QColor>
+#include <QExplicitlySharedDataPointer>
+#include <QMultiHash>
+#include <QSharedData>
+
+class NodeStyle : public QSharedData
+{
+  public:
+    NodeStyle();
+
+    static QExplicitlySharedDataPointer<NodeStyle> defaultStyle();
+    bool operator==(const NodeStyle &other) const;
+    uint hash() const;
+
+    qreal	diameter;	// Pixels, i.e., inches * physicalDPI.
+    qreal	physicalDPI;	// The DPI the diameter was converted with.
+    qreal	penWidth;	// Pixels.
+    qreal	labelSize;	// Points.
+    QColor	fillColour, lineColour;
+};
+
+typedef QExplicitlySharedDataPointer<NodeStyle> NodeStylePtr;
+
+
+
+class EdgeStyle : public QSharedData
+{
+  public:
+    EdgeStyle();
+
+    static QExplicitlySharedDataPointer<EdgeStyle> defaultStyle();
+    bool operator==(const EdgeStyle &other) const;
+    uint hash() const;
+
+    qreal	penWidth;	// Pixels.
+    qreal	labelSize;	// Points.
+    QColor	colour;
+};
+
+typedef QExplicitlySharedDataPointer<EdgeStyle> EdgeStylePtr;
+
+
+
+/*
+ * A StyleTable holds one entry for each distinct style it has been
+ * given, so that items which were styled one at a time (e.g., when
+ * a file is read) can be made to share their entries.
+ */
+
+template <class Style>
+class StyleTable
+{
+  public:
+    // Return the table's entry equal to *style, adding style if the
+    // table does not have one yet.
+    QExplicitlySharedDataPointer<Style> intern(const Style * style)
+    {
+	uint h = style->hash();
+	typename QMultiHash<uint, QExplicitlySharedDataPointer<Style>>
+	    ::const_iterator it = entries.constFind(h);
+	for ( ; it != entries.constEnd() && it.key() == h; ++it)
+	{
+	    if (*it.value() == *style)
+		return it.value();
+	}
+
+	QExplicitlySharedDataPointer<Style> entry(const_cast<Style *>(style));
+	entries.insert(h, entry);
+	return entry;
+    }
+
+  private:
+    QMultiHash<uint, QExplicitlySharedDataPointer<Style>> entries;
+};
+
+#endif // STYLETABLE_H
@@ -0,0 +1,23 @@
+#-------------------------------------------------
+#
+# QtTest QBENCHMARK suite for Graphic.  This builds the application
+# sources (less main.cpp; see graphic.pri) together with tst_bench.cpp.
+# "make check" runs it; see tst_bench.cpp for where the results go.
+#
+#-------------------------------------------------
+
+QT       += core gui svg concurrent testlib
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+
+TARGET = tst_bench
+TEMPLATE = app
+
+CONFIG += c++11 \
+    thread \
+    console \
+    testcase
+
+SOURCES += tst_bench.cpp
+
+include($$PWD/../../graphic.pri)
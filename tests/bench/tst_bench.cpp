@@ -0,0 +1,921 @@
+/*
+ * File:	tst_bench.cpp
+ * Author:	agent
+ * Date:	2026-10-18
+ * Version:	1.9
+ *
+ * Purpose:	QBENCHMARK cases for the parts of Graphic whose speed we
+ *		care about: the graph generators, Style_Graph(), the
+ *		text savers, loading a .grphc file, searchAndSeparate(),
+ *		rendering a scene, the force-directed layout,
+ *		importing edge lists and the GraphML and DOT round trip.
+ *		The checks that the file formats give back what was
+ *		written to them are in tests/formats, so that only
+ *		benchmark results go into graphic-bench.xml.
+ *
+ *		Unless -o is given on the command line the results are
+ *		written (in the QtTest XML format, which includes a
+ *		BenchmarkResult element for each case) to
+ *		graphic-bench.xml in the current directory, as well as
+ *		to stdout, so that runs from different releases can be
+ *		compared.  Any other QtTest options (e.g., -iterations,
+ *		-callgrind, or the names of the cases to run) may be given.
+ *
+ *		The windowing system is not needed; the "offscreen" Qt
+ *		platform is used unless QT_QPA_PLATFORM is set.  The
+ *		DPI is fixed at BENCH_DPI so that the results do not
+ *		depend on the screen.
+ *
+ * Modification history:
+ * Oct 18, 2026 (agent V1.0)
+ *  (a) Initial version.
+ * Oct 18, 2026 (agent V1.1)
+ *  (a) Add forceLayout.
+ * Oct 18, 2026 (agent V1.2)
+ *  (a) selectCustomGraph also times loading .grphb files.
+ * Oct 18, 2026 (agent V1.3)
+ *  (a) selectCustomGraph waits for the GraphLoader when a file is
+ *	big enough to be read in the background.
+ * Oct 18, 2026 (agent V1.4)
+ *  (a) Add readEdgeList.
+ * Oct 18, 2026 (agent V1.5)
+ *  (a) Add exchangeFormats.
+ * Oct 18, 2026 (agent V1.6)
+ *  (a) selectCustomGraph also times loading gzipped .grphc files.
+ * Oct 18, 2026 (agent V1.7)
+ *  (a) Add exchangeLabels.
+ * Oct 18, 2026 (agent V1.8)
+ *  (a) Add roundTrip.  numberNodes() can leave compact edges alone.
+ * Oct 18, 2026 (agent V1.9)
+ *  (a) Moved exchangeLabels and roundTrip (which are not benchmarks)
+ *	to tests/formats/tst_formats.cpp; numberNodes() always expands
+ *	compact edges again.
+ */
+
+#include "basicgraphs.h"
+#include "binaryformat.h"
+#include "canvasscene.h"
+#include "compressedfile.h"
+#include "defuns.h"
+#include "dotformat.h"
+#include "edge.h"
+#include "edgelist.h"
+#include "forcelayout.h"
+#include "graph.h"
+#include "graphloader.h"
+#include "graphml.h"
+#include "mainwindow.h"
+#include "node.h"
+#include "preview.h"
+
+#include <QApplication>
+#include <QBuffer>
+#include <QFile>
+#include <QFontDatabase>
+#include <QGraphicsScene>
+#include <QImage>
+#include <QPainter>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QtTest>
+
+#include <zlib.h>
+
+#define BENCH_DPI	96
+#define BENCH_RESULTS	"graphic-bench.xml"
+
+class GraphicBench : public QObject
+{
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void generate_data();
+    void generate();
+    void styleGraph_data();
+    void styleGraph();
+    void save_data();
+    void save();
+    void selectCustomGraph_data();
+    void selectCustomGraph();
+    void searchAndSeparate_data();
+    void searchAndSeparate();
+    void renderScene_data();
+    void renderScene();
+    void forceLayout_data();
+    void forceLayout();
+    void readEdgeList_data();
+    void readEdgeList();
+    void exchangeFormats_data();
+    void exchangeFormats();
+
+  private:
+    Graph * makeGraph(int graphType, int n1, int n2);
+    void styleAll(Graph * graph, int graphType, bool labelled);
+    QVector<Node *> numberNodes(Graph * graph);
+
+    PreView * preview;
+    MainWindow * mainWindow;
+    QTemporaryDir * tmpDir;
+};
+
+
+
+void
+GraphicBench::initTestCase()
+{
+    preview = new PreView();
+    mainWindow = nullptr;
+    tmpDir = new QTemporaryDir();
+    QVERIFY(tmpDir->isValid());
+}
+
+
+
+void
+GraphicBench::cleanupTestCase()
+{
+    delete mainWindow;
+    delete preview;
+    delete tmpDir;
+}
+
+
+
+/*
+ * Name:	makeGraph()
+ * Purpose:	Generate a graph with the BasicGraphs generator for the
+ *		given type, as PreView::Create_Basic_Graph() does.
+ * Arguments:	The BasicGraphs::Graph_Type and the one or two sizes.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The new graph (not in any scene).
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	Circulant graphs always get the offsets "1,2,5".
+ */
+
+Graph *
+GraphicBench::makeGraph(int graphType, int n1, int n2)
+{
+    Graph * g = new Graph();
+    BasicGraphs basicG;
+
+    switch (graphType)
+    {
+      case BasicGraphs::Antiprism:
+	basicG.generate_antiprism(g, n1, true);
+	break;
+      case BasicGraphs::BBTree:
+	basicG.generate_balanced_binary_tree(g, n1, true);
+	break;
+      case BasicGraphs::Bipartite:
+	basicG.generate_bipartite(g, n1, n2, true);
+	break;
+      case BasicGraphs::Circulant:
+	basicG.generate_circulant(g, n1, "1,2,5", true);
+	break;
+      case BasicGraphs::Complete:
+	basicG.generate_complete(g, n1, true);
+	break;
+      case BasicGraphs::Crown:
+	basicG.generate_crown(g, n1, true);
+	break;
+      case BasicGraphs::Cycle:
+	basicG.generate_cycle(g, n1, true);
+	break;
+      case BasicGraphs::Dutch_Windmill:
+	basicG.generate_dutch_windmill(g, n1, n2, true);
+	break;
+      case BasicGraphs::Gear:
+	basicG.generate_gear(g, n1, true);
+	break;
+      case BasicGraphs::Grid:
+	basicG.generate_grid(g, n1, n2, true);
+	break;
+      case BasicGraphs::Helm:
+	basicG.generate_helm(g, n1, true);
+	break;
+      case BasicGraphs::Path:
+	basicG.generate_path(g, n1, true);
+	break;
+      case BasicGraphs::Petersen:
+	basicG.generate_petersen(g, n1, n2, true);
+	break;
+      case BasicGraphs::Prism:
+	basicG.generate_prism(g, n1, true);
+	break;
+      case BasicGraphs::Star:
+	basicG.generate_star(g, n1, true);
+	break;
+      case BasicGraphs::Wheel:
+	basicG.generate_wheel(g, n1, true);
+	break;
+    }
+    return g;
+}
+
+
+
+/*
+ * Name:	styleAll()
+ * Purpose:	Give a graph the look of a freshly generated preview graph.
+ * Arguments:	The graph, its type, and whether to number the labels.
+ * Outputs:	Nothing.
+ * Modifies:	The graph.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	The values are the UI defaults.
+ */
+
+void
+GraphicBench::styleAll(Graph * graph, int graphType, bool labelled)
+{
+    preview->Style_Graph(graph, graphType, ALL_WGT, 0.2, "", "", labelled,
+			 12, Qt::white, Qt::black, 1, "", 12, Qt::black,
+			 8, 8, 0, 0, 1, labelled, 0);
+}
+
+
+
+/*
+ * Name:	numberNodes()
+ * Purpose:	Collect the nodes of a graph and number them, as
+ *		save_Graph() does before calling the savers.
+ * Arguments:	The graph.
+ * Outputs:	Nothing.
+ * Modifies:	The nodes' IDs.
+ * Returns:	The nodes.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	The graph's compact edges (if any) are expanded first,
+ *		since several of the cases look at (or count) the
+ *		nodes' edge lists.
+ */
+
+QVector<Node *>
+GraphicBench::numberNodes(Graph * graph)
+{
+    QVector<Node *> nodes;
+
+    graph->expandEdges();
+    foreach (QGraphicsItem * item, graph->childItems())
+    {
+	if (item->type() == Node::Type)
+	{
+	    Node * node = qgraphicsitem_cast<Node *>(item);
+	    node->setID(nodes.count());
+	    nodes.append(node);
+	}
+    }
+    Edge::adjustQueuedEdges();
+    return nodes;
+}
+
+
+
+void
+GraphicBench::generate_data()
+{
+    QTest::addColumn<int>("graphType");
+    QTest::addColumn<int>("n1");
+    QTest::addColumn<int>("n2");
+
+    QTest::newRow("antiprism-5000") << int(BasicGraphs::Antiprism) << 5000 << 0;
+    QTest::newRow("bbtree-8191") << int(BasicGraphs::BBTree) << 8191 << 0;
+    QTest::newRow("bipartite-300x300")
+	<< int(BasicGraphs::Bipartite) << 300 << 300;
+    QTest::newRow("circulant-5000") << int(BasicGraphs::Circulant) << 5000 << 0;
+    QTest::newRow("complete-500") << int(BasicGraphs::Complete) << 500 << 0;
+    QTest::newRow("crown-2000") << int(BasicGraphs::Crown) << 2000 << 0;
+    QTest::newRow("cycle-10000") << int(BasicGraphs::Cycle) << 10000 << 0;
+    QTest::newRow("dutch_windmill-500x10")
+	<< int(BasicGraphs::Dutch_Windmill) << 500 << 10;
+    QTest::newRow("gear-5000") << int(BasicGraphs::Gear) << 5000 << 0;
+    QTest::newRow("grid-100x100") << int(BasicGraphs::Grid) << 100 << 100;
+    QTest::newRow("helm-5000") << int(BasicGraphs::Helm) << 5000 << 0;
+    QTest::newRow("path-10000") << int(BasicGraphs::Path) << 10000 << 0;
+    QTest::newRow("petersen-5000") << int(BasicGraphs::Petersen) << 5000 << 2;
+    QTest::newRow("prism-5000") << int(BasicGraphs::Prism) << 5000 << 0;
+    QTest::newRow("star-10000") << int(BasicGraphs::Star) << 10000 << 0;
+    QTest::newRow("wheel-10000") << int(BasicGraphs::Wheel) << 10000 << 0;
+}
+
+
+
+void
+GraphicBench::generate()
+{
+    QFETCH(int, graphType);
+    QFETCH(int, n1);
+    QFETCH(int, n2);
+
+    QBENCHMARK
+    {
+	Graph * g = makeGraph(graphType, n1, n2);
+	delete g;
+    }
+}
+
+
+
+void
+GraphicBench::styleGraph_data()
+{
+    QTest::addColumn<int>("widget");
+
+    QTest::newRow("ALL") << int(ALL_WGT);
+    QTest::newRow("nodeDiam") << int(nodeDiam_WGT);
+    QTest::newRow("nodeLabel1") << int(nodeLabel1_WGT);
+    QTest::newRow("nodeLabel2") << int(nodeLabel2_WGT);
+    QTest::newRow("nodeLabelSize") << int(nodeLabelSize_WGT);
+    QTest::newRow("nodeNumLabelCheckBox") << int(nodeNumLabelCheckBox_WGT);
+    QTest::newRow("nodeFillColour") << int(nodeFillColour_WGT);
+    QTest::newRow("nodeOutlineColour") << int(nodeOutlineColour_WGT);
+    QTest::newRow("edgeThickness") << int(edgeThickness_WGT);
+    QTest::newRow("edgeLabel") << int(edgeLabel_WGT);
+    QTest::newRow("edgeLabelSize") << int(edgeLabelSize_WGT);
+    QTest::newRow("edgeLineColour") << int(edgeLineColour_WGT);
+    QTest::newRow("graphRotation") << int(graphRotation_WGT);
+    QTest::newRow("graphHeight") << int(graphHeight_WGT);
+    QTest::newRow("graphWidth") << int(graphWidth_WGT);
+    QTest::newRow("nodeNumLabelStart") << int(nodeNumLabelStart_WGT);
+    QTest::newRow("nodeThickness") << int(nodeThickness_WGT);
+    QTest::newRow("edgeNumLabelCheckBox") << int(edgeNumLabelCheckBox_WGT);
+    QTest::newRow("edgeNumLabelStart") << int(edgeNumLabelStart_WGT);
+}
+
+
+
+void
+GraphicBench::styleGraph()
+{
+    QFETCH(int, widget);
+
+    Graph * g = makeGraph(BasicGraphs::Grid, 50, 50);
+    preview->scene()->clear();
+    preview->scene()->addItem(g);
+    styleAll(g, BasicGraphs::Grid, false);
+
+    QBENCHMARK
+    {
+	preview->Style_Graph(g, BasicGraphs::Grid, (enum widget_ID)widget,
+			     0.25, "v", "w", true, 10, Qt::yellow, Qt::blue,
+			     2, "e", 10, Qt::red, 10, 10, 15, 1, 2, true, 1);
+    }
+    preview->scene()->clear();
+}
+
+
+
+void
+GraphicBench::save_data()
+{
+    QTest::addColumn<int>("format");
+    QTest::addColumn<int>("graphType");
+    QTest::addColumn<int>("n1");
+    QTest::addColumn<int>("n2");
+
+    // Format 0 is .grphc, 1 is TikZ, 2 is an edge list.
+    QTest::newRow("grphc-grid-100x100") << 0 << int(BasicGraphs::Grid)
+					 << 100 << 100;
+    QTest::newRow("grphc-complete-200") << 0 << int(BasicGraphs::Complete)
+					 << 200 << 0;
+    QTest::newRow("tikz-grid-100x100") << 1 << int(BasicGraphs::Grid)
+					<< 100 << 100;
+    QTest::newRow("tikz-complete-200") << 1 << int(BasicGraphs::Complete)
+					<< 200 << 0;
+    QTest::newRow("edgelist-grid-100x100") << 2 << int(BasicGraphs::Grid)
+					    << 100 << 100;
+    QTest::newRow("edgelist-complete-200") << 2 << int(BasicGraphs::Complete)
+					    << 200 << 0;
+}
+
+
+
+void
+GraphicBench::save()
+{
+    QFETCH(int, format);
+    QFETCH(int, graphType);
+    QFETCH(int, n1);
+    QFETCH(int, n2);
+
+    Graph * g = makeGraph(graphType, n1, n2);
+    styleAll(g, graphType, true);
+    QVector<Node *> nodes = numberNodes(g);
+
+    QBENCHMARK
+    {
+	QString text;
+	QTextStream out(&text);
+	if (format == 0)
+	    saveGraphIc(out, nodes, false);
+	else if (format == 1)
+	    saveTikZ(out, nodes);
+	else
+	    saveEdgelist(out, nodes);
+	out.flush();
+    }
+    delete g;
+}
+
+
+
+void
+GraphicBench::selectCustomGraph_data()
+{
+    QTest::addColumn<int>("graphType");
+    QTest::addColumn<int>("n1");
+    QTest::addColumn<int>("n2");
+    QTest::addColumn<bool>("labelled");
+    QTest::addColumn<bool>("binary");
+    QTest::addColumn<bool>("gzipped");
+
+    QTest::newRow("grid-100x100") << int(BasicGraphs::Grid)
+				   << 100 << 100 << true << false << false;
+    QTest::newRow("complete-200") << int(BasicGraphs::Complete)
+				   << 200 << 0 << true << false << false;
+    QTest::newRow("cycle-10000") << int(BasicGraphs::Cycle)
+				  << 10000 << 0 << true << false << false;
+    QTest::newRow("grid-100x100-grphb") << int(BasicGraphs::Grid)
+					 << 100 << 100 << true << true
+					 << false;
+    QTest::newRow("complete-200-grphb") << int(BasicGraphs::Complete)
+					 << 200 << 0 << true << true << false;
+    QTest::newRow("cycle-10000-grphb") << int(BasicGraphs::Cycle)
+					<< 10000 << 0 << true << true << false;
+    QTest::newRow("grid-100x100-gz") << int(BasicGraphs::Grid)
+				      << 100 << 100 << true << false << true;
+    QTest::newRow("cycle-10000-gz") << int(BasicGraphs::Cycle)
+				     << 10000 << 0 << true << false << true;
+    // About 100,000 unlabelled edges.
+    QTest::newRow("complete-450") << int(BasicGraphs::Complete)
+				   << 450 << 0 << false << false << false;
+    QTest::newRow("complete-450-grphb") << int(BasicGraphs::Complete)
+					 << 450 << 0 << false << true << false;
+    QTest::newRow("complete-450-gz") << int(BasicGraphs::Complete)
+				      << 450 << 0 << false << false << true;
+}
+
+
+
+/*
+ * Name:	selectCustomGraph()
+ * Purpose:	Time loading a .grphc (.grphb, .grphc.gz) file into
+ *		the preview, the way a library graph is loaded.
+ * Arguments:	None (see selectCustomGraph_data()).
+ * Outputs:	Nothing.
+ * Modifies:	The preview of mainWindow.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	select_Custom_Graph() is a private slot, so it is
+ *		called through the meta-object system.
+ *		Big .grphc files are read by the main window's
+ *		GraphLoader, so the time includes waiting for it.
+ */
+
+void
+GraphicBench::selectCustomGraph()
+{
+    QFETCH(int, graphType);
+    QFETCH(int, n1);
+    QFETCH(int, n2);
+    QFETCH(bool, labelled);
+    QFETCH(bool, binary);
+    QFETCH(bool, gzipped);
+
+    QString fileName = tmpDir->filePath(
+	QString(QTest::currentDataTag()) + "." GRAPHiCS_FILE_EXTENSION);
+    Graph * g = makeGraph(graphType, n1, n2);
+    styleAll(g, graphType, labelled);
+    QVector<Node *> nodes = numberNodes(g);
+    if (binary)
+    {
+	QString errorMessage;
+	fileName = binaryCompanion(fileName);
+	QVERIFY2(saveGraphBin(fileName, nodes, errorMessage),
+		 qPrintable(errorMessage));
+    }
+    else if (gzipped)
+    {
+	QBuffer buffer;
+	QVERIFY(buffer.open(QIODevice::WriteOnly | QIODevice::Text));
+	QTextStream out(&buffer);
+	QVERIFY(saveGraphIc(out, nodes, false));
+	out.flush();
+	fileName += "." GZIP_FILE_EXTENSION;
+	gzFile gz = gzopen(QFile::encodeName(fileName).constData(), "wb");
+	QVERIFY(gz != nullptr);
+	QCOMPARE(gzwrite(gz, buffer.data().constData(), buffer.data().size()),
+		 buffer.data().size());
+	QCOMPARE(gzclose(gz), Z_OK);
+    }
+    else
+    {
+	QFile file(fileName);
+	QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Text));
+	QTextStream out(&file);
+	QVERIFY(saveGraphIc(out, nodes, false));
+	out.flush();
+	file.close();
+    }
+    delete g;
+
+    if (mainWindow == nullptr)
+    {
+	mainWindow = new MainWindow();
+	currentPhysicalDPI = currentPhysicalDPI_X = currentPhysicalDPI_Y
+	    = BENCH_DPI;
+    }
+
+    QBENCHMARK
+    {
+	QVERIFY(QMetaObject::invokeMethod(mainWindow, "select_Custom_Graph",
+					  Qt::DirectConnection,
+					  Q_ARG(QString, fileName)));
+	GraphLoader * loader = mainWindow->findChild<GraphLoader *>();
+	if (loader != nullptr && loader->isBusy())
+	{
+	    QSignalSpy spy(loader, SIGNAL(loaded(Graph *)));
+	    QVERIFY(spy.wait(60000));
+	}
+    }
+}
+
+
+
+void
+GraphicBench::searchAndSeparate_data()
+{
+    QTest::addColumn<int>("graphType");
+    QTest::addColumn<int>("n1");
+    QTest::addColumn<int>("n2");
+    QTest::addColumn<int>("edge");
+
+    // Deleting any grid edge leaves the grid connected, so the whole
+    // grid is searched and nothing is separated.  Deleting the middle
+    // edge of a path splits it in two.
+    QTest::newRow("grid-100x100-connected") << int(BasicGraphs::Grid)
+					     << 100 << 100 << 0;
+    QTest::newRow("path-20000-split") << int(BasicGraphs::Path)
+				       << 20000 << 0 << 10000;
+}
+
+
+
+/*
+ * Name:	searchAndSeparate()
+ * Purpose:	Time CanvasScene::searchAndSeparate() after an edge is
+ *		deleted.
+ * Arguments:	None (see searchAndSeparate_data()).
+ * Outputs:	Nothing.
+ * Modifies:	Nothing outside the local scene.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	The edge is deleted (as CanvasScene does in delete mode)
+ *		once; every pass then does the same search and (in the
+ *		split case) moves the same component to a new graph.
+ */
+
+void
+GraphicBench::searchAndSeparate()
+{
+    QFETCH(int, graphType);
+    QFETCH(int, n1);
+    QFETCH(int, n2);
+    QFETCH(int, edge);
+
+    CanvasScene scene;
+    Graph * g = makeGraph(graphType, n1, n2);
+    styleAll(g, graphType, false);
+    scene.addItem(g);
+    QVector<Node *> nodes = numberNodes(g);
+
+    QList<Edge *> edges;
+    foreach (QGraphicsItem * item, g->childItems())
+	if (item->type() == Edge::Type)
+	    edges.append(qgraphicsitem_cast<Edge *>(item));
+    QVERIFY(edge < edges.count());
+
+    Edge * victim = edges.at(edge);
+    QList<Node *> ends;
+    ends << victim->sourceNode() << victim->destNode();
+    victim->sourceNode()->removeEdge(victim);
+    victim->destNode()->removeEdge(victim);
+    delete victim;
+
+    QBENCHMARK
+    {
+	scene.searchAndSeparate(ends);
+    }
+}
+
+
+
+void
+GraphicBench::renderScene_data()
+{
+    QTest::addColumn<int>("graphType");
+    QTest::addColumn<int>("n1");
+    QTest::addColumn<int>("n2");
+    QTest::addColumn<bool>("labelled");
+
+    QTest::newRow("grid-100x100") << int(BasicGraphs::Grid)
+				   << 100 << 100 << false;
+    QTest::newRow("grid-100x100-labelled") << int(BasicGraphs::Grid)
+					    << 100 << 100 << true;
+    QTest::newRow("complete-300") << int(BasicGraphs::Complete)
+				   << 300 << 0 << false;
+    QTest::newRow("cycle-10000") << int(BasicGraphs::Cycle)
+				  << 10000 << 0 << false;
+}
+
+
+
+/*
+ * Name:	renderScene()
+ * Purpose:	Time drawing a whole scene into an image, as an image
+ *		export does.
+ * Arguments:	None (see renderScene_data()).
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	None.
+ */
+
+void
+GraphicBench::renderScene()
+{
+    QFETCH(int, graphType);
+    QFETCH(int, n1);
+    QFETCH(int, n2);
+    QFETCH(bool, labelled);
+
+    QGraphicsScene scene;
+    Graph * g = makeGraph(graphType, n1, n2);
+    styleAll(g, graphType, labelled);
+    scene.addItem(g);
+    Edge::adjustQueuedEdges();
+
+    QImage image(2000, 2000, QImage::Format_ARGB32_Premultiplied);
+    QRectF source = scene.itemsBoundingRect();
+
+    QBENCHMARK
+    {
+	image.fill(Qt::white);
+	QPainter painter(&image);
+	painter.setRenderHint(QPainter::Antialiasing);
+	scene.render(&painter, QRectF(), source);
+    }
+}
+
+
+
+void
+GraphicBench::forceLayout_data()
+{
+    QTest::addColumn<int>("graphType");
+    QTest::addColumn<int>("n1");
+    QTest::addColumn<int>("n2");
+
+    QTest::newRow("bbtree-1023") << int(BasicGraphs::BBTree) << 1023 << 0;
+    QTest::newRow("grid-100x100") << int(BasicGraphs::Grid) << 100 << 100;
+    QTest::newRow("cycle-10000") << int(BasicGraphs::Cycle) << 10000 << 0;
+    QTest::newRow("petersen-2500") << int(BasicGraphs::Petersen) << 2500 << 2;
+}
+
+
+
+/*
+ * Name:	forceLayout()
+ * Purpose:	Time a ForceLayout run (FL_ITERATIONS iterations) on the
+ *		nodes and edges of a generated graph.
+ * Arguments:	None (see forceLayout_data()).
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	Only the engine is timed, not the copying of the
+ *		coordinates in and out which MainWindow::layout_Graphs()
+ *		and layoutDone() do.  The edge length is that used for
+ *		nodes of diameter 0.2".
+ */
+
+void
+GraphicBench::forceLayout()
+{
+    QFETCH(int, graphType);
+    QFETCH(int, n1);
+    QFETCH(int, n2);
+
+    Graph * g = makeGraph(graphType, n1, n2);
+    QVector<Node *> nodes = numberNodes(g);
+    QVector<QPointF> positions;
+    QVector<Layout_Edge> edges;
+
+    foreach (Node * node, nodes)
+    {
+	positions.append(node->pos());
+	foreach (Edge * edge, node->edgeList)
+	{
+	    if (edge->sourceNode() != node)
+		continue;
+	    Layout_Edge e;
+	    e.source = node->getID();
+	    e.dest = edge->destNode()->getID();
+	    edges.append(e);
+	}
+    }
+    delete g;
+
+    QBENCHMARK
+    {
+	ForceLayout layout(positions, edges, 0.8 * BENCH_DPI);
+	layout.run();
+    }
+}
+
+
+
+void
+GraphicBench::readEdgeList_data()
+{
+    QTest::addColumn<int>("nodes");
+    QTest::addColumn<int>("degree");
+    QTest::addColumn<bool>("snap");
+
+    QTest::newRow("edges-10000x10") << 10000 << 10 << false;
+    QTest::newRow("snap-10000x10") << 10000 << 10 << true;
+    QTest::newRow("snap-100000x10") << 100000 << 10 << true;
+}
+
+
+
+/*
+ * Name:	readEdgeList()
+ * Purpose:	Time importing an edge list file.
+ * Arguments:	None (see readEdgeList_data()).
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	Each node i is joined to the next "degree" nodes (mod
+ *		the number of nodes), so there are nodes * degree edges.
+ *		The SNAP files use sparse IDs (10 * i + 7) separated by
+ *		tabs, with a comment header; the others are in the
+ *		format written by saveEdgelist().  The time includes
+ *		the initial layout and making the items.
+ */
+
+void
+GraphicBench::readEdgeList()
+{
+    QFETCH(int, nodes);
+    QFETCH(int, degree);
+    QFETCH(bool, snap);
+
+    QString fileName = tmpDir->filePath(QString(QTest::currentDataTag())
+					+ (snap ? "." SNAP_FILE_EXTENSION
+					   : "." EDGES_FILE_EXTENSION));
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Text));
+    QTextStream out(&file);
+    if (snap)
+	out << "# Undirected graph: " << fileName << "\n"
+	    << "# FromNodeId\tToNodeId\n";
+    else
+	out << nodes << "\n";
+    for (int i = 0; i < nodes; i++)
+    {
+	for (int j = 1; j <= degree; j++)
+	{
+	    int k = (i + j) % nodes;
+	    if (snap)
+		out << 10 * i + 7 << "\t" << 10 * k + 7 << "\n";
+	    else
+		out << i << "," << k << "\n";
+	}
+    }
+    out.flush();
+    file.close();
+
+    QBENCHMARK
+    {
+	QString errorMessage;
+	Graph * g = ::readEdgeList(fileName, errorMessage);
+	QVERIFY2(g != nullptr, qPrintable(errorMessage));
+	delete g;
+    }
+}
+
+
+
+void
+GraphicBench::exchangeFormats_data()
+{
+    QTest::addColumn<bool>("dot");
+    QTest::addColumn<int>("graphType");
+    QTest::addColumn<int>("n1");
+    QTest::addColumn<int>("n2");
+
+    QTest::newRow("graphml-grid-100x100") << false << int(BasicGraphs::Grid)
+					   << 100 << 100;
+    QTest::newRow("graphml-complete-200") << false
+					   << int(BasicGraphs::Complete)
+					   << 200 << 0;
+    QTest::newRow("dot-grid-100x100") << true << int(BasicGraphs::Grid)
+				       << 100 << 100;
+    QTest::newRow("dot-complete-200") << true << int(BasicGraphs::Complete)
+				       << 200 << 0;
+}
+
+
+
+/*
+ * Name:	exchangeFormats()
+ * Purpose:	Time writing a graph as GraphML or DOT and reading it
+ *		back.
+ * Arguments:	None (see exchangeFormats_data()).
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	The text is kept in memory, so only the formatting and
+ *		parsing are timed.  The graph read back must have the
+ *		same numbers of nodes and edges.
+ */
+
+void
+GraphicBench::exchangeFormats()
+{
+    QFETCH(bool, dot);
+    QFETCH(int, graphType);
+    QFETCH(int, n1);
+    QFETCH(int, n2);
+
+    Graph * g = makeGraph(graphType, n1, n2);
+    styleAll(g, graphType, true);
+    QVector<Node *> nodes = numberNodes(g);
+    int numOfEdges = 0;
+    foreach (Node * node, nodes)
+	numOfEdges += node->edgeList.count();
+    numOfEdges /= 2;
+
+    QBENCHMARK
+    {
+	QBuffer buffer;
+	buffer.open(QIODevice::ReadWrite);
+	QVERIFY(dot ? saveDot(&buffer, nodes) : saveGraphML(&buffer, nodes));
+	buffer.seek(0);
+
+	Graph_Description description;
+	QString errorMessage;
+	bool ok = dot
+	    ? parseDot(&buffer, "bench", description, errorMessage)
+	    : parseGraphML(&buffer, "bench", description, errorMessage);
+	QVERIFY2(ok, qPrintable(errorMessage));
+	QCOMPARE(description.nodes.count(), nodes.count());
+	QCOMPARE(description.edges.count(), numOfEdges);
+    }
+    delete g;
+}
+
+
+int
+main(int argc, char * argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+	qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+
+    QFontDatabase::addApplicationFont(":/fonts/cmmi10.ttf");
+    QFontDatabase::addApplicationFont(":/fonts/cmr10.ttf");
+    QFontDatabase::addApplicationFont(":/fonts/cmsy10.ttf");
+    QFontDatabase::addApplicationFont(":/fonts/cmtt10.ttf");
+    QFontDatabase::addApplicationFont(":/fonts/arimo.ttf");
+
+    currentPhysicalDPI = currentPhysicalDPI_X = currentPhysicalDPI_Y
+	= BENCH_DPI;
+
+    QStringList args = app.arguments();
+    if (!args.contains("-o"))
+	args << "-o" << BENCH_RESULTS ",xml" << "-o" << "-,txt";
+
+    GraphicBench bench;
+    return QTest::qExec(&bench, args);
+}
+
+#include "tst_bench.moc"
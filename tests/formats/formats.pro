@@ -0,0 +1,24 @@
+#-------------------------------------------------
+#
+# QtTest checks that Graphic's file formats give back what was written
+# to them.  Like tests/bench, this builds the application sources
+# (less main.cpp; see graphic.pri) together with tst_formats.cpp.
+# "make check" runs it.
+#
+#-------------------------------------------------
+
+QT       += core gui svg concurrent testlib
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+
+TARGET = tst_formats
+TEMPLATE = app
+
+CONFIG += c++11 \
+    thread \
+    console \
+    testcase
+
+SOURCES += tst_formats.cpp
+
+include($$PWD/../../graphic.pri)
@@ -0,0 +1,597 @@
+/*
+ * File:	tst_formats.cpp
+ * Author:	agent
+ * Date:	2026-10-18
+ * Version:	1.2
+ *
+ * Purpose:	QtTest cases which check that the file formats give back
+ *		what was written to them: labels with backslashes and
+ *		quotes survive GraphML and DOT (exchangeLabels), and a
+ *		graph with plain or compact edges comes back from
+ *		.grphb, edge list, GraphML, DOT and .grphc.gz files as
+ *		it was written (roundTrip).  svgExport checks that SVG
+ *		files get the edges as lines, not as an image, and
+ *		binaryCompanion that a .grphb companion is only used
+ *		while the .grphc file is unchanged.
+ *
+ *		These are kept apart from the benchmarks (tests/bench),
+ *		whose output is used to compare the speed of releases.
+ *		As there, the "offscreen" Qt platform is used unless
+ *		QT_QPA_PLATFORM is set, and the DPI is fixed.
+ *
+ * Modification history:
+ * Oct 18, 2026 (agent V1.0)
+ *  (a) Initial version (exchangeLabels and roundTrip, which used to
+ *	be in tst_bench.cpp).
+ * Oct 18, 2026 (agent V1.1)
+ *  (a) Add svgExport.
+ * Oct 18, 2026 (agent V1.2)
+ *  (a) Add binaryCompanion.
+ */
+
+#include "basicgraphs.h"
+#include "binaryformat.h"
+#include "compressedfile.h"
+#include "defuns.h"
+#include "dotformat.h"
+#include "edge.h"
+#include "edgelist.h"
+#include "graph.h"
+#include "graphloader.h"
+#include "graphml.h"
+#include "mainwindow.h"
+#include "node.h"
+#include "preview.h"
+
+#include <QApplication>
+#include <QBuffer>
+#include <QFile>
+#include <QFileInfo>
+#include <QFontDatabase>
+#include <QGraphicsScene>
+#include <QMap>
+#include <QPainter>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QtSvg/QSvgGenerator>
+#include <QtTest>
+
+#include <zlib.h>
+
+#define FORMATS_DPI	96
+
+class GraphicFormats : public QObject
+{
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void exchangeLabels_data();
+    void exchangeLabels();
+    void roundTrip_data();
+    void roundTrip();
+    void svgExport();
+    void binaryCompanion();
+
+  private:
+    Graph * makeGraph(int graphType, int n1, int n2);
+    void styleAll(Graph * graph, int graphType, bool labelled);
+    QVector<Node *> graphNodes(Graph * graph);
+    void describeGraph(Graph * graph, Graph_Description &description);
+    void compareGraphs(const Graph_Description &expected,
+		       const Graph_Description &actual, bool details);
+
+    PreView * preview;
+    QTemporaryDir * tmpDir;
+};
+
+
+
+void
+GraphicFormats::initTestCase()
+{
+    preview = new PreView();
+    tmpDir = new QTemporaryDir();
+    QVERIFY(tmpDir->isValid());
+}
+
+
+
+void
+GraphicFormats::cleanupTestCase()
+{
+    delete preview;
+    delete tmpDir;
+}
+
+
+
+/*
+ * Name:	makeGraph()
+ * Purpose:	Generate a graph with the BasicGraphs generator for the
+ *		given type, as PreView::Create_Basic_Graph() does.
+ * Arguments:	The BasicGraphs::Graph_Type and the one or two sizes.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The new graph (not in any scene).
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	Only the types the cases use are known (see
+ *		tst_bench.cpp for the rest); anything else gives an
+ *		empty graph.
+ */
+
+Graph *
+GraphicFormats::makeGraph(int graphType, int n1, int n2)
+{
+    Graph * g = new Graph();
+    BasicGraphs basicG;
+
+    switch (graphType)
+    {
+      case BasicGraphs::Complete:
+	basicG.generate_complete(g, n1, true);
+	break;
+      case BasicGraphs::Grid:
+	basicG.generate_grid(g, n1, n2, true);
+	break;
+      case BasicGraphs::Path:
+	basicG.generate_path(g, n1, true);
+	break;
+    }
+    return g;
+}
+
+
+
+/*
+ * Name:	styleAll()
+ * Purpose:	Give a graph the look of a freshly generated preview graph.
+ * Arguments:	The graph, its type, and whether to number the labels.
+ * Outputs:	Nothing.
+ * Modifies:	The graph.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	The values are the UI defaults.
+ */
+
+void
+GraphicFormats::styleAll(Graph * graph, int graphType, bool labelled)
+{
+    preview->Style_Graph(graph, graphType, ALL_WGT, 0.2, "", "", labelled,
+			 12, Qt::white, Qt::black, 1, "", 12, Qt::black,
+			 8, 8, 0, 0, 1, labelled, 0);
+}
+
+
+
+/*
+ * Name:	graphNodes()
+ * Purpose:	Collect the nodes of a graph and number them, as
+ *		save_Graph() does before calling the savers.
+ * Arguments:	The graph.
+ * Outputs:	Nothing.
+ * Modifies:	The nodes' IDs.
+ * Returns:	The nodes.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	The compact edges (if any) are left alone, as
+ *		save_Graph() leaves them.
+ */
+
+QVector<Node *>
+GraphicFormats::graphNodes(Graph * graph)
+{
+    QVector<Node *> nodes;
+
+    foreach (QGraphicsItem * item, graph->childItems())
+    {
+	if (item->type() == Node::Type)
+	{
+	    Node * node = qgraphicsitem_cast<Node *>(item);
+	    node->setID(nodes.count());
+	    nodes.append(node);
+	}
+    }
+    Edge::adjustQueuedEdges();
+    return nodes;
+}
+
+
+
+void
+GraphicFormats::exchangeLabels_data()
+{
+    QTest::addColumn<bool>("dot");
+    QTest::addColumn<QString>("label");
+
+    QStringList labels;
+    labels << "a\\b" << "trailing\\" << "\\\\" << "say \"hi\""
+	   << "\\\"" << "\\N" << "x_{\\alpha}";
+    foreach (QString label, labels)
+    {
+	QTest::newRow(qPrintable("graphml " + label)) << false << label;
+	QTest::newRow(qPrintable("dot " + label)) << true << label;
+    }
+}
+
+
+
+/*
+ * Name:	exchangeLabels()
+ * Purpose:	Check that node and edge labels are read back from
+ *		GraphML and DOT as they were written.
+ * Arguments:	None (see exchangeLabels_data()).
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	The labels are full of the characters the writers have
+ *		to escape (backslashes and quotes).
+ */
+
+void
+GraphicFormats::exchangeLabels()
+{
+    QFETCH(bool, dot);
+    QFETCH(QString, label);
+
+    Graph * g = makeGraph(BasicGraphs::Path, 2, 0);
+    QVector<Node *> nodes = graphNodes(g);
+    QCOMPARE(nodes.count(), 2);
+    QCOMPARE(nodes.at(0)->edgeList.count(), 1);
+    nodes.at(0)->setNodeLabel(label);
+    nodes.at(1)->setNodeLabel(label + label);
+    nodes.at(0)->edgeList.at(0)->setEdgeLabel(label);
+
+    QBuffer buffer;
+    buffer.open(QIODevice::ReadWrite);
+    QVERIFY(dot ? saveDot(&buffer, nodes) : saveGraphML(&buffer, nodes));
+    buffer.seek(0);
+
+    Graph_Description description;
+    QString errorMessage;
+    bool ok = dot
+	? parseDot(&buffer, "labels", description, errorMessage)
+	: parseGraphML(&buffer, "labels", description, errorMessage);
+    QVERIFY2(ok, qPrintable(errorMessage));
+    QCOMPARE(description.nodes.count(), 2);
+    QCOMPARE(description.edges.count(), 1);
+    QCOMPARE(description.nodes.at(0).label, label);
+    QCOMPARE(description.nodes.at(1).label, label + label);
+    QCOMPARE(description.edges.at(0).label, label);
+    delete g;
+}
+
+
+
+/*
+ * Name:	describeGraph()
+ * Purpose:	Describe a graph which a reader made, as the savers
+ *		see it.
+ * Arguments:	The graph and the description to fill in.
+ * Outputs:	Nothing.
+ * Modifies:	The description, and the nodes' IDs.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	The compact edges (if any) are not expanded.
+ */
+
+void
+GraphicFormats::describeGraph(Graph * graph, Graph_Description &description)
+{
+    QVector<Node *> nodes = graphNodes(graph);
+
+    description.nodes.resize(nodes.count());
+    for (int i = 0; i < nodes.count(); i++)
+	describeNode(nodes.at(i), description.nodes[i]);
+    describeEdges(nodes, description.edges);
+}
+
+
+
+/*
+ * Name:	compareGraphs()
+ * Purpose:	Check that a graph read back from a file is the graph
+ *		which was written.
+ * Arguments:	The two descriptions, and whether to compare the node
+ *		positions, sizes and labels as well as the structure.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	The nodes are in the same order in both.
+ * Bugs:	None.
+ * Notes:	Edges are compared as unordered pairs of nodes, in any
+ *		order.  The files are centred differently (and DOT
+ *		positions are rounded), so the node positions are
+ *		compared relative to the first node, to 0.01 inch.
+ */
+
+void
+GraphicFormats::compareGraphs(const Graph_Description &expected,
+			      const Graph_Description &actual, bool details)
+{
+    QCOMPARE(actual.nodes.count(), expected.nodes.count());
+    QCOMPARE(actual.edges.count(), expected.edges.count());
+
+    QMap<QPair<int, int>, QString> expectedEdges, actualEdges;
+    foreach (const Edge_Description &e, expected.edges)
+	expectedEdges.insertMulti(qMakePair(qMin(e.source, e.dest),
+					    qMax(e.source, e.dest)),
+				  details ? e.label : QString());
+    foreach (const Edge_Description &e, actual.edges)
+	actualEdges.insertMulti(qMakePair(qMin(e.source, e.dest),
+					  qMax(e.source, e.dest)),
+				details ? e.label : QString());
+    QVERIFY(actualEdges == expectedEdges);
+
+    if (!details || expected.nodes.isEmpty())
+	return;
+
+    const Node_Description &e0 = expected.nodes.at(0);
+    const Node_Description &a0 = actual.nodes.at(0);
+    for (int i = 0; i < expected.nodes.count(); i++)
+    {
+	const Node_Description &e = expected.nodes.at(i);
+	const Node_Description &a = actual.nodes.at(i);
+	QVERIFY(qAbs((a.x - a0.x) - (e.x - e0.x)) < 0.01);
+	QVERIFY(qAbs((a.y - a0.y) - (e.y - e0.y)) < 0.01);
+	QVERIFY(qAbs(a.diameter - e.diameter) < 0.01);
+	QCOMPARE(a.label, e.label);
+    }
+}
+
+
+
+void
+GraphicFormats::roundTrip_data()
+{
+    QTest::addColumn<QString>("format");
+    QTest::addColumn<int>("graphType");
+    QTest::addColumn<int>("n1");
+    QTest::addColumn<int>("n2");
+
+    // Grids have plain (labelled) edges; complete graphs are made
+    // with compact edges (see BasicGraphs::generate_complete()).
+    QStringList formats;
+    formats << "grphb" << "edges" << "graphml" << "dot" << "grphc.gz";
+    foreach (QString format, formats)
+    {
+	QTest::newRow(qPrintable(format + "-grid-4x5")) << format
+	    << int(BasicGraphs::Grid) << 4 << 5;
+	QTest::newRow(qPrintable(format + "-complete-12")) << format
+	    << int(BasicGraphs::Complete) << 12 << 0;
+    }
+}
+
+
+
+/*
+ * Name:	roundTrip()
+ * Purpose:	Check that each file format gives back the graph which
+ *		was written to it.
+ * Arguments:	None (see roundTrip_data()).
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	The graph is written with its compact edges
+ *		(if any) left alone, as save_Graph() does.  Edge lists
+ *		only hold the structure, so for them the positions and
+ *		labels are not compared.
+ */
+
+void
+GraphicFormats::roundTrip()
+{
+    QFETCH(QString, format);
+    QFETCH(int, graphType);
+    QFETCH(int, n1);
+    QFETCH(int, n2);
+
+    Graph * g = makeGraph(graphType, n1, n2);
+    styleAll(g, graphType, true);
+    Graph_Description expected;
+    describeGraph(g, expected);
+    QVector<Node *> nodes = graphNodes(g);
+
+    QString fileName = tmpDir->filePath(QString(QTest::currentDataTag())
+					+ "." + format);
+    QString errorMessage;
+    Graph_Description actual;
+    Graph * readBack = nullptr;
+    bool ok;
+
+    if (format == GRAPHiCS_BIN_EXTENSION)
+    {
+	QVERIFY2(saveGraphBin(fileName, nodes, errorMessage),
+		 qPrintable(errorMessage));
+	readBack = readGraphBin(fileName, errorMessage);
+	QVERIFY2(readBack != nullptr, qPrintable(errorMessage));
+    }
+    else if (format == EDGES_FILE_EXTENSION)
+    {
+	QFile file(fileName);
+	QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Text));
+	QTextStream out(&file);
+	QVERIFY(saveEdgelist(out, nodes));
+	out.flush();
+	file.close();
+	readBack = ::readEdgeList(fileName, errorMessage);
+	QVERIFY2(readBack != nullptr, qPrintable(errorMessage));
+    }
+    else if (format == "graphml" || format == "dot")
+    {
+	QBuffer buffer;
+	buffer.open(QIODevice::ReadWrite);
+	QVERIFY(format == "dot" ? saveDot(&buffer, nodes)
+		: saveGraphML(&buffer, nodes));
+	buffer.seek(0);
+	ok = format == "dot"
+	    ? parseDot(&buffer, "roundtrip", actual, errorMessage)
+	    : parseGraphML(&buffer, "roundtrip", actual, errorMessage);
+	QVERIFY2(ok, qPrintable(errorMessage));
+    }
+    else
+    {
+	QBuffer buffer;
+	QVERIFY(buffer.open(QIODevice::WriteOnly | QIODevice::Text));
+	QTextStream out(&buffer);
+	QVERIFY(saveGraphIc(out, nodes, false));
+	out.flush();
+	gzFile gz = gzopen(QFile::encodeName(fileName).constData(), "wb");
+	QVERIFY(gz != nullptr);
+	QCOMPARE(gzwrite(gz, buffer.data().constData(), buffer.data().size()),
+		 buffer.data().size());
+	QCOMPARE(gzclose(gz), Z_OK);
+
+	CompressedFile file(fileName);
+	QVERIFY(file.open(QIODevice::ReadOnly));
+	QTextStream in(&file);
+	ok = parseGraphIc(in, "roundtrip", actual, errorMessage);
+	QVERIFY2(ok, qPrintable(errorMessage));
+	QVERIFY(!file.failed());
+    }
+
+    if (readBack != nullptr)
+    {
+	describeGraph(readBack, actual);
+	delete readBack;
+    }
+    delete g;
+    compareGraphs(expected, actual, format != EDGES_FILE_EXTENSION);
+}
+
+
+
+
+/*
+ * Name:	svgExport()
+ * Purpose:	Check that an SVG export of a graph has no images in it.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	A graph draws its edges itself, from a cache on the
+ *		screen; if that cache were used in an export, the SVG
+ *		file would get an <image> of it.  The cache has to be
+ *		back on when the export is over.
+ */
+
+void
+GraphicFormats::svgExport()
+{
+    Graph * g = makeGraph(BasicGraphs::Grid, 4, 5);
+    styleAll(g, BasicGraphs::Grid, true);
+    QGraphicsScene scene;
+    scene.addItem(g);
+
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    QRectF bounds = scene.itemsBoundingRect();
+    QSvgGenerator svgGen;
+    svgGen.setOutputDevice(&buffer);
+    svgGen.setSize(bounds.size().toSize());
+    QPainter painter(&svgGen);
+    Graph::setExporting(&scene, true);
+    QCOMPARE(g->cacheMode(), QGraphicsItem::NoCache);
+    scene.render(&painter, QRectF(0, 0, bounds.width(), bounds.height()),
+		 bounds, Qt::IgnoreAspectRatio);
+    Graph::setExporting(&scene, false);
+    QVERIFY(painter.end());
+    QCOMPARE(g->cacheMode(), QGraphicsItem::DeviceCoordinateCache);
+
+    QVERIFY(buffer.data().contains("<svg"));
+    QVERIFY(!buffer.data().contains("<image"));
+}
+
+
+
+
+/*
+ * Name:	binaryCompanion()
+ * Purpose:	Check when a .grphb companion may be read in place of
+ *		its .grphc file.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	The text file is changed without changing its size, so
+ *		only the CRC can tell.
+ */
+
+void
+GraphicFormats::binaryCompanion()
+{
+    QCOMPARE(::binaryCompanion("/a/b.grphc"),
+	     QString("/a/b." GRAPHiCS_BIN_EXTENSION));
+    QVERIFY(::binaryCompanion("/a/b.grphc.gz").isNull());
+
+    Graph * g = makeGraph(BasicGraphs::Grid, 3, 3);
+    styleAll(g, BasicGraphs::Grid, true);
+    QVector<Node *> nodes = graphNodes(g);
+    QString textName = tmpDir->filePath("companion.grphc");
+    QString binName = ::binaryCompanion(textName);
+    QString errorMessage;
+
+    QFile text(textName);
+    QVERIFY(text.open(QIODevice::WriteOnly | QIODevice::Text));
+    QTextStream out(&text);
+    QVERIFY(saveGraphIc(out, nodes, false));
+    out.flush();
+    text.close();
+
+    QVERIFY2(saveGraphBin(binName, nodes, errorMessage),
+	     qPrintable(errorMessage));
+    QVERIFY(!binaryCompanionIsCurrent(binName, textName));
+    QVERIFY2(saveGraphBin(binName, nodes, errorMessage, textName),
+	     qPrintable(errorMessage));
+    QVERIFY(binaryCompanionIsCurrent(binName, textName));
+
+    // Change one digit of the text file.
+    QVERIFY(text.open(QIODevice::ReadWrite));
+    QByteArray contents = text.readAll();
+    int i = contents.lastIndexOf('1');
+    QVERIFY(i >= 0);
+    text.seek(i);
+    text.putChar('2');
+    text.close();
+    QCOMPARE(QFileInfo(textName).size(), qint64(contents.size()));
+    QVERIFY(!binaryCompanionIsCurrent(binName, textName));
+    delete g;
+}
+
+
+
+int
+main(int argc, char * argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+	qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+
+    QFontDatabase::addApplicationFont(":/fonts/cmmi10.ttf");
+    QFontDatabase::addApplicationFont(":/fonts/cmr10.ttf");
+    QFontDatabase::addApplicationFont(":/fonts/cmsy10.ttf");
+    QFontDatabase::addApplicationFont(":/fonts/cmtt10.ttf");
+    QFontDatabase::addApplicationFont(":/fonts/arimo.ttf");
+
+    currentPhysicalDPI = currentPhysicalDPI_X = currentPhysicalDPI_Y
+	= FORMATS_DPI;
+
+    GraphicFormats formats;
+    return QTest::qExec(&formats, argc, argv);
+}
+
+#include "tst_formats.moc"
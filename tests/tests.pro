@@ -0,0 +1,13 @@
+#-------------------------------------------------
+#
+# Tests for Graphic: the file format checks (formats) and the
+# benchmarks (bench).
+# Build them with "qmake tests/tests.pro && make"; the application
+# itself is still built from Graphic.pro.
+#
+#-------------------------------------------------
+
+TEMPLATE = subdirs
+
+SUBDIRS += formats \
+    bench
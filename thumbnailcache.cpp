@@ -0,0 +1,296 @@
+/*
+ * File:	thumbnailcache.cpp
+ * Author:	agent
+ * Date:	2026-10-18
+ * Version:	1.1
+ *
+ * Purpose:	Make small pictures of the graphs in the graph library
+ *		for the graph type menu, so that the library can be
+ *		browsed without loading each graph into the preview.
+ *
+ *		A thumbnail is drawn straight from the Graph_Description
+ *		made by parseGraphIc() with a QPainter on a QImage, so
+ *		no QGraphicsItems are needed and the whole job can be
+ *		done on a worker thread.  Only one job runs at a time,
+ *		so that browsing a big library doesn't tie up the whole
+ *		thread pool.
+ *
+ *		Each thumbnail is saved as a PNG in the "thumbs"
+ *		subdirectory of the library's cache directory (next to
+ *		its index; see libraryindex.cpp), with the path and mtime
+ *		of the .grphc file in PNG text chunks.  A saved thumbnail
+ *		is only used if they match, so a graph whose file has
+ *		changed gets a new thumbnail.
+ *
+ * Modification history:
+ * Oct 18, 2026 (agent V1.0)
+ *  (a) Initial version.
+ * Oct 18, 2026 (agent V1.1)
+ *  (a) Read the graphs through a CompressedFile, so that gzipped
+ *	library files get thumbnails too.
+ */
+
+#include "thumbnailcache.h"
+#include "compressedfile.h"
+#include "defuns.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QPainter>
+#include <QSaveFile>
+#include <QTextStream>
+#include <QtConcurrent>
+
+#define THUMBNAIL_SUBDIR    "thumbs"
+
+
+
+/*
+ * Name:	renderThumbnail()
+ * Purpose:	Draw a small picture of a graph.
+ * Arguments:	The graph and the width (and height) of the picture.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The picture (with a transparent background).
+ * Assumptions:	None.
+ * Bugs:	Labels are not drawn; they would be unreadable anyway.
+ * Notes:	Safe to call on any thread.
+ *		The graph is scaled to fit, keeping its shape.  The
+ *		lines are all one pixel wide, and each node is at least
+ *		a few pixels across so that it can be seen.
+ */
+
+QImage
+renderThumbnail(const Graph_Description &description, int size)
+{
+    QImage image(size, size, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+
+    if (description.nodes.isEmpty())
+	return image;
+
+    qreal minX = 1E10, maxX = -1E10, minY = 1E10, maxY = -1E10;
+    foreach (const Node_Description &n, description.nodes)
+    {
+	qreal r = n.diameter / 2.;
+	minX = qMin(minX, n.x - r);
+	maxX = qMax(maxX, n.x + r);
+	minY = qMin(minY, n.y - r);
+	maxY = qMax(maxY, n.y + r);
+    }
+
+    qreal extent = qMax(maxX - minX, maxY - minY);
+    qreal scale = extent > 0 ? (size - 2) / extent : 1;
+    QPointF offset((size - (maxX - minX) * scale) / 2 - minX * scale,
+		   (size - (maxY - minY) * scale) / 2 - minY * scale);
+
+    QVector<QPointF> centres;
+    centres.reserve(description.nodes.count());
+    foreach (const Node_Description &n, description.nodes)
+	centres.append(QPointF(n.x, n.y) * scale + offset);
+
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    QPen pen;
+    pen.setCosmetic(true);
+    foreach (const Edge_Description &e, description.edges)
+    {
+	pen.setColor(e.colour);
+	painter.setPen(pen);
+	painter.drawLine(centres.at(e.source), centres.at(e.dest));
+    }
+
+    for (int i = 0; i < description.nodes.count(); i++)
+    {
+	const Node_Description &n = description.nodes.at(i);
+	qreal r = qMax(n.diameter / 2. * scale, qreal(1.5));
+	pen.setColor(n.lineColour);
+	painter.setPen(pen);
+	painter.setBrush(n.fillColour);
+	painter.drawEllipse(centres.at(i), r, r);
+    }
+
+    return image;
+}
+
+
+
+/*
+ * Name:	ThumbnailCache()
+ * Purpose:	Constructor.
+ * Arguments:	The library directory, the directory its index is in,
+ *		and the parent object.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	Nothing is read until a thumbnail is asked for.
+ */
+
+ThumbnailCache::ThumbnailCache(QString libraryDirectory,
+			       QString cacheDirectory, QObject * parent)
+    : QObject(parent)
+{
+    this->libraryDirectory = libraryDirectory;
+    this->cacheDirectory = cacheDirectory + "/" THUMBNAIL_SUBDIR;
+    connect(&watcher, SIGNAL(finished()), this, SLOT(jobDone()));
+}
+
+
+
+/*
+ * Name:	request()
+ * Purpose:	Ask for the thumbnail of a library graph.
+ * Arguments:	The library entry of the graph.
+ * Outputs:	Nothing.
+ * Modifies:	queue, queued.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	If we already have a thumbnail for this version of the
+ *		file nothing is done; otherwise thumbnailReady() is
+ *		emitted once it has been read from the cache or made.
+ */
+
+void
+ThumbnailCache::request(const Library_Entry &entry)
+{
+    if (thumbnails.contains(entry.path)
+	&& thumbnails.value(entry.path).mtime == entry.mtime)
+	return;
+    if (queued.contains(entry.path))
+	return;
+
+    queued.insert(entry.path);
+    queue.append(entry);
+    startNext();
+}
+
+
+
+/*
+ * Name:	thumbnail()
+ * Purpose:	Return the thumbnail of a library graph.
+ * Arguments:	The path of the graph, relative to the library.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The thumbnail, or a null image if there isn't one (yet).
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	None.
+ */
+
+QImage
+ThumbnailCache::thumbnail(QString path) const
+{
+    return thumbnails.value(path).image;
+}
+
+
+
+void
+ThumbnailCache::startNext()
+{
+    if (watcher.isRunning() || queue.isEmpty())
+	return;
+
+    Library_Entry entry = queue.takeFirst();
+    QByteArray hash = QCryptographicHash::hash(entry.path.toUtf8(),
+					       QCryptographicHash::Md5);
+    Thumbnail_Job job;
+    job.fileName = libraryDirectory + "/" + entry.path;
+    job.cacheFile = cacheDirectory + "/" + QString(hash.toHex()) + ".png";
+    job.path = entry.path;
+    job.mtime = entry.mtime;
+
+    watcher.setFuture(QtConcurrent::run(make, job));
+}
+
+
+
+/*
+ * Name:	make()
+ * Purpose:	Find or make one thumbnail.
+ * Arguments:	The job.
+ * Outputs:	The thumbnail, to the cache, if it had to be made.
+ * Modifies:	Nothing.
+ * Returns:	The job, with its image set (null if the file could
+ *		not be read).
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	Runs on a pool thread via QtConcurrent.
+ */
+
+ThumbnailCache::Thumbnail_Job
+ThumbnailCache::make(Thumbnail_Job job)
+{
+    QImage cached(job.cacheFile);
+    if (!cached.isNull() && cached.text("path") == job.path
+	&& cached.text("mtime") == QString::number(job.mtime))
+    {
+	job.image = cached;
+	return job;
+    }
+
+    CompressedFile file(job.fileName);
+    if (!file.open(QIODevice::ReadOnly))
+	return job;
+
+    QTextStream in(&file);
+    Graph_Description description;
+    QString errorMessage;
+    if (!parseGraphIc(in, job.fileName, description, errorMessage))
+    {
+	qDeb() << "TC::make(): " << errorMessage;
+	return job;
+    }
+
+    job.image = renderThumbnail(description, THUMBNAIL_SIZE);
+    job.image.setText("path", job.path);
+    job.image.setText("mtime", QString::number(job.mtime));
+
+    QDir().mkpath(QFileInfo(job.cacheFile).path());
+    QSaveFile out(job.cacheFile);
+    if (out.open(QIODevice::WriteOnly) && job.image.save(&out, "PNG"))
+	out.commit();
+    else
+	qDeb() << "TC::make(): can't write " << job.cacheFile;
+
+    return job;
+}
+
+
+
+/*
+ * Name:	jobDone()
+ * Purpose:	Record a finished thumbnail and start the next one.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	thumbnails, queued.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None.
+ * Notes:	A file which could not be read is remembered (with a
+ *		null image) so that it isn't tried again until it
+ *		changes.
+ */
+
+void
+ThumbnailCache::jobDone()
+{
+    Thumbnail_Job job = watcher.result();
+    Thumbnail_Entry t;
+
+    t.mtime = job.mtime;
+    t.image = job.image;
+    thumbnails.insert(job.path, t);
+    queued.remove(job.path);
+
+    if (!job.image.isNull())
+	emit thumbnailReady(job.path);
+    startNext();
+}
@@ -0,0 +1,79 @@
+/*
+ * File:	thumbnailcache.h
+ * Author:	agent
+ * Date:	2026-10-18
+ * Version:	1.0
+ *
+ * Purpose:	Declare the ThumbnailCache class, which makes (and keeps)
+ *		small pictures of the graphs in the graph library.
+ *
+ * Modification history:
+ * Oct 18, 2026 (agent V1.0)
+ *  (a) Initial version.
+ */
+
+#ifndef THUMBNAILCACHE_H
+#define THUMBNAILCACHE_H
+
+#include "graphloader.h"
+#include "libraryindex.h"
+
+#include <QFutureWatcher>
+#include <QHash>
+#include <QImage>
+#include <QList>
+#include <QObject>
+#include <QSet>
+#include <QString>
+
+// The width and height of a thumbnail, in pixels.
+#define THUMBNAIL_SIZE	32
+
+QImage renderThumbnail(const Graph_Description &description, int size);
+
+class ThumbnailCache : public QObject
+{
+    Q_OBJECT
+
+  public:
+    ThumbnailCache(QString libraryDirectory, QString cacheDirectory,
+		   QObject * parent = 0);
+
+    void request(const Library_Entry &entry);
+    QImage thumbnail(QString path) const;
+
+  signals:
+    void thumbnailReady(QString path);
+
+  private slots:
+    void jobDone();
+
+  private:
+    // One thumbnail being found (or made) on a worker thread.
+    typedef struct thumbnailJob
+    {
+	QString	    fileName;	// The .grphc file.
+	QString	    cacheFile;	// Where its thumbnail is kept.
+	QString	    path;	// Relative to the library directory.
+	qint64	    mtime;
+	QImage	    image;	// The result.
+    } Thumbnail_Job;
+
+    typedef struct thumbnailEntry
+    {
+	qint64	    mtime;	// Of the file the image was made from.
+	QImage	    image;	// Null if the file could not be read.
+    } Thumbnail_Entry;
+
+    void startNext();
+    static Thumbnail_Job make(Thumbnail_Job job);
+
+    QString			    libraryDirectory;
+    QString			    cacheDirectory;
+    QHash<QString, Thumbnail_Entry> thumbnails;
+    QList<Library_Entry>	    queue;
+    QSet<QString>		    queued;
+    QFutureWatcher<Thumbnail_Job>   watcher;
+};
+
+#endif // THUMBNAILCACHE_H
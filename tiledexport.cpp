@@ -0,0 +1,602 @@
+/*
+ * File:	tiledexport.cpp
+ * Author:	agent
+ * Date:	2026-10-18
+ * Version:	1.5
+ *
+ * Purpose:	Render (part of) a scene to a raster image file at an
+ *		arbitrary scale, without ever holding more than a band
+ *		of the output image in memory (for TIFF and PNG output),
+ *		or more than the output image itself (for the other
+ *		formats).
+ *
+ *		The output is cut into bands BAND_HEIGHT pixels high,
+ *		and each band into tiles at most TILE_WIDTH pixels wide.
+ *		The part of the scene under each tile of a band is
+ *		recorded (on the thread which owns the scene) into the
+ *		tile's own QPicture, whose size depends on the number of
+ *		items the tile shows, not on the output resolution.  The
+ *		tiles are then played back in parallel, one QImage per
+ *		tile, and the band is either appended to the TIFF
+ *		file (as one PackBits-compressed strip), fed to the
+ *		zlib stream of the PNG file's IDAT chunks, or copied into
+ *		the output QImage.
+ *
+ * Modification history:
+ * Oct 18, 2026 (agent V1.0)
+ *  (a) Initial version.
+ * Oct 18, 2026 (agent V1.1)
+ *  (a) Give each tile its own copy of the recording.  Copies of a
+ *	QPicture share one buffer, which drawPicture() reads from
+ *	(and seeks in), so playing back one recording on several
+ *	threads at once was a data race.
+ *  (b) Write PNG files a band at a time too (with zlib), rather
+ *	than through a QImage of the whole output.
+ * Oct 18, 2026 (agent V1.2)
+ *  (a) Corrected the Assumptions of exportTiledImage(): Export All
+ *	calls it on pool threads, with scenes built there.
+ * Oct 18, 2026 (agent V1.3)
+ *  (a) Mark the scene as exporting (see isExporting()) while it is
+ *	recorded.
+ * Oct 18, 2026 (agent V1.4)
+ *  (a) Use Graph::setExporting() for that, so that the graphs are
+ *	recorded as lines rather than as their cache pixmaps.
+ * Oct 18, 2026 (agent V1.5)
+ *  (a) Record each tile's part of the scene separately (so that the
+ *	scene only draws the items under the tile) rather than giving
+ *	every tile a copy of a recording of the whole scene, which
+ *	took a lot of memory, and time to play back, for big scenes
+ *	at high resolutions.
+ */
+
+#include "tiledexport.h"
+#include "defuns.h"
+#include "graph.h"
+
+#include <QDataStream>
+#include <QFile>
+#include <QImage>
+#include <QPainter>
+#include <QPicture>
+#include <QtConcurrent>
+#include <qmath.h>
+
+#include <zlib.h>
+
+#define TILE_WIDTH	1024
+#define BAND_HEIGHT	256
+
+// Formats other than TIFF and PNG are written by QImage::save(), which
+// needs the whole image in memory.  Refuse to make images bigger than
+// this.
+#define MAX_IMAGE_BYTES	(Q_INT64_C(1024) * 1024 * 1024)
+
+// The most compressed data put into one PNG IDAT chunk.
+#define PNG_IDAT_SIZE	(64 * 1024)
+
+// PNG row filter type 1: each byte less the one 4 bytes (a pixel) before.
+#define PNG_FILTER_SUB	1
+
+// TIFF field types and the tags we use.
+#define TIFF_SHORT	3
+#define TIFF_LONG	4
+#define TIFF_RATIONAL	5
+
+typedef struct exportTile
+{
+    QPicture	picture;	// The part of the scene under this tile.
+    QRect	area;		// The part of the output this tile covers.
+    qreal	scale;
+    QColor	background;
+    bool	rgba;		// Convert to non-premultiplied RGBA (TIFF, PNG).
+    QImage	image;
+} Export_Tile;
+
+
+
+/*
+ * Name:	renderTile()
+ * Purpose:	Play back the recording of a tile into its image.
+ * Arguments:	The tile.
+ * Outputs:	Nothing.
+ * Modifies:	tile.image
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Called on a pool thread via QtConcurrent.  Each tile has
+ *		its own QPicture (playing a picture back moves its
+ *		buffer's read position, so pictures can't be shared),
+ *		its own QImage and its own QPainter, so nothing is
+ *		written to by more than one thread.  The recording has
+ *		the tile's top-left corner at (0, 0), in scene units.
+ */
+
+static void
+renderTile(Export_Tile &tile)
+{
+    tile.image = QImage(tile.area.size(), QImage::Format_ARGB32_Premultiplied);
+    tile.image.fill(tile.background);
+
+    QPainter painter(&tile.image);
+    painter.setRenderHints(QPainter::Antialiasing
+			   | QPainter::TextAntialiasing
+			   | QPainter::HighQualityAntialiasing
+			   | QPainter::NonCosmeticDefaultPen, true);
+    painter.scale(tile.scale, tile.scale);
+    painter.drawPicture(0, 0, tile.picture);
+    painter.end();
+
+    if (tile.rgba)
+	tile.image = tile.image.convertToFormat(QImage::Format_RGBA8888);
+}
+
+
+
+/*
+ * Name:	packBits()
+ * Purpose:	Append the PackBits encoding of some bytes to a buffer.
+ * Arguments:	The bytes, how many there are, and the buffer.
+ * Outputs:	Nothing.
+ * Modifies:	out
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	TIFF requires each row to be encoded separately.
+ *		A run of n (2..128) equal bytes is stored as 1-n and the
+ *		byte; n (1..128) literal bytes are stored as n-1 and the
+ *		bytes.  Literals are ended by a run of 3 or more, since
+ *		breaking a literal for a run of 2 gains nothing.
+ */
+
+static void
+packBits(const uchar * data, int n, QByteArray &out)
+{
+    int i = 0;
+
+    while (i < n)
+    {
+	int run = 1;
+	while (i + run < n && run < 128 && data[i + run] == data[i])
+	    run++;
+	if (run > 1)
+	{
+	    out.append(char(1 - run));
+	    out.append(char(data[i]));
+	    i += run;
+	    continue;
+	}
+
+	int start = i;
+	while (i < n && i - start < 128)
+	{
+	    if (i + 2 < n && data[i] == data[i + 1] && data[i] == data[i + 2])
+		break;
+	    i++;
+	}
+	out.append(char(i - start - 1));
+	out.append((const char *)data + start, i - start);
+    }
+}
+
+
+
+/*
+ * Name:	tiffEntry()
+ * Purpose:	Write one 12-byte TIFF directory entry.
+ * Arguments:	The stream, the tag, the field type, the count and
+ *		either the value or the offset of the values.
+ * Outputs:	The entry.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	The stream is little-endian.
+ * Bugs:	None known.
+ * Notes:	A single SHORT is left-justified in the value field.
+ */
+
+static void
+tiffEntry(QDataStream &out, quint16 tag, quint16 type, quint32 count,
+	  quint32 value)
+{
+    out << tag << type << count;
+    if (type == TIFF_SHORT && count == 1)
+	out << quint16(value) << quint16(0);
+    else
+	out << value;
+}
+
+
+
+/*
+ * Name:	tiffFinish()
+ * Purpose:	Write the TIFF image file directory (and the data it
+ *		refers to) at the end of the file, and point the header
+ *		at it.
+ * Arguments:	The file and stream, the image size, the rows per
+ *		strip, the strip offsets and sizes, and the DPI.
+ * Outputs:	The IFD.
+ * Modifies:	The file.
+ * Returns:	Nothing.
+ * Assumptions:	The strips have all been written.
+ * Bugs:	None known.
+ * Notes:	The image is 8-bit RGBA, with unassociated alpha.
+ */
+
+static void
+tiffFinish(QFile &file, QDataStream &out, int width, int height,
+	   int rowsPerStrip, const QVector<quint32> &stripOffsets,
+	   const QVector<quint32> &stripByteCounts, qreal dpi)
+{
+    const int numEntries = 14;
+    int numStrips = stripOffsets.count();
+
+    if (file.pos() & 1)
+	out << quint8(0);		// The IFD must be word-aligned.
+    quint32 ifdOffset = file.pos();
+    quint32 extra = ifdOffset + 2 + numEntries * 12 + 4;
+    quint32 bitsOffset = extra;
+    quint32 xResOffset = bitsOffset + 8;
+    quint32 yResOffset = xResOffset + 8;
+    quint32 offsetsOffset = yResOffset + 8;
+    quint32 countsOffset = offsetsOffset + 4 * numStrips;
+
+    out << quint16(numEntries);
+    tiffEntry(out, 256, TIFF_LONG, 1, width);		// ImageWidth
+    tiffEntry(out, 257, TIFF_LONG, 1, height);		// ImageLength
+    tiffEntry(out, 258, TIFF_SHORT, 4, bitsOffset);	// BitsPerSample
+    tiffEntry(out, 259, TIFF_SHORT, 1, 32773);		// PackBits
+    tiffEntry(out, 262, TIFF_SHORT, 1, 2);		// RGB
+    tiffEntry(out, 273, TIFF_LONG, numStrips,		// StripOffsets
+	      numStrips == 1 ? stripOffsets.at(0) : offsetsOffset);
+    tiffEntry(out, 277, TIFF_SHORT, 1, 4);		// SamplesPerPixel
+    tiffEntry(out, 278, TIFF_LONG, 1, rowsPerStrip);	// RowsPerStrip
+    tiffEntry(out, 279, TIFF_LONG, numStrips,		// StripByteCounts
+	      numStrips == 1 ? stripByteCounts.at(0) : countsOffset);
+    tiffEntry(out, 282, TIFF_RATIONAL, 1, xResOffset);	// XResolution
+    tiffEntry(out, 283, TIFF_RATIONAL, 1, yResOffset);	// YResolution
+    tiffEntry(out, 284, TIFF_SHORT, 1, 1);		// Chunky
+    tiffEntry(out, 296, TIFF_SHORT, 1, 2);		// Inches
+    tiffEntry(out, 338, TIFF_SHORT, 1, 2);		// Unassoc. alpha
+    out << quint32(0);					// No more IFDs
+
+    out << quint16(8) << quint16(8) << quint16(8) << quint16(8);
+    quint32 res = qRound(dpi * 100);
+    out << res << quint32(100) << res << quint32(100);
+    if (numStrips > 1)
+    {
+	foreach (quint32 offset, stripOffsets)
+	    out << offset;
+	foreach (quint32 count, stripByteCounts)
+	    out << count;
+    }
+
+    file.seek(4);
+    out << ifdOffset;
+}
+
+
+
+/*
+ * Name:	pngChunk()
+ * Purpose:	Write one PNG chunk.
+ * Arguments:	The stream, the chunk type and the chunk data.
+ * Outputs:	The chunk.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	The stream is big-endian.
+ * Bugs:	None known.
+ * Notes:	The CRC covers the type and the data, not the length.
+ */
+
+static void
+pngChunk(QDataStream &out, const char * type, const QByteArray &data)
+{
+    uLong crc = crc32(0L, Z_NULL, 0);
+    crc = crc32(crc, (const Bytef *)type, 4);
+    crc = crc32(crc, (const Bytef *)data.constData(), data.size());
+
+    out << quint32(data.size());
+    out.writeRawData(type, 4);
+    out.writeRawData(data.constData(), data.size());
+    out << quint32(crc);
+}
+
+
+
+/*
+ * Name:	pngStart()
+ * Purpose:	Write the PNG signature and the chunks which come
+ *		before the image data.
+ * Arguments:	The stream, the image size and the DPI.
+ * Outputs:	The signature and the IHDR and pHYs chunks.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	The stream is big-endian.
+ * Bugs:	None known.
+ * Notes:	The image is 8-bit RGBA, not interlaced.
+ */
+
+static void
+pngStart(QDataStream &out, int width, int height, qreal dpi)
+{
+    static const char signature[] = "\x89PNG\r\n\x1a\n";
+    out.writeRawData(signature, 8);
+
+    QByteArray data;
+    QDataStream chunk(&data, QIODevice::WriteOnly);
+    chunk << quint32(width) << quint32(height)
+	  << quint8(8)			// Bit depth
+	  << quint8(6)			// RGBA
+	  << quint8(0) << quint8(0)	// Deflate, adaptive filtering
+	  << quint8(0);			// Not interlaced
+    pngChunk(out, "IHDR", data);
+
+    QByteArray phys;
+    QDataStream physChunk(&phys, QIODevice::WriteOnly);
+    quint32 dpm = qRound(dpi / 0.0254);
+    physChunk << dpm << dpm << quint8(1);	// Pixels per metre
+    pngChunk(out, "pHYs", phys);
+}
+
+
+
+/*
+ * Name:	pngDeflate()
+ * Purpose:	Compress some (filtered) rows and write whatever zlib
+ *		has ready as IDAT chunks.
+ * Arguments:	The stream, the zlib stream, the rows, and Z_NO_FLUSH
+ *		or (for the last rows) Z_FINISH.
+ * Outputs:	Zero or more IDAT chunks.
+ * Modifies:	The zlib stream.
+ * Returns:	True on success.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	All the IDAT chunks together make one zlib stream.
+ */
+
+static bool
+pngDeflate(QDataStream &out, z_stream &zs, const QByteArray &rows, int flush)
+{
+    QByteArray idat(PNG_IDAT_SIZE, 0);
+    int ret;
+
+    zs.next_in = (Bytef *)rows.constData();
+    zs.avail_in = rows.size();
+    do
+    {
+	zs.next_out = (Bytef *)idat.data();
+	zs.avail_out = idat.size();
+	ret = deflate(&zs, flush);
+	if (ret == Z_STREAM_ERROR)
+	    return false;
+	int n = idat.size() - zs.avail_out;
+	if (n > 0)
+	    pngChunk(out, "IDAT", idat.left(n));
+    } while (zs.avail_out == 0 || (flush == Z_FINISH && ret != Z_STREAM_END));
+
+    return true;
+}
+
+
+
+/*
+ * Name:	exportTiledImage()
+ * Purpose:	Render part of a scene to an image file, tile by tile.
+ * Arguments:	The scene, the part of it to render (in scene coords),
+ *		the scale (output pixels per scene unit), the DPI to
+ *		record in the file, the background colour, the output
+ *		file name and format (a QImageWriter format name, such
+ *		as "png"), and a string to hold an error message.
+ * Outputs:	The image file.
+ * Modifies:	errorMessage, on failure.
+ * Returns:	True on success.
+ * Assumptions:	Called on the thread which owns the scene: the GUI
+ *		thread for the canvas, or (for Export All) the pool
+ *		thread which built it.  The scene is only touched
+ *		there, never by the worker threads which render the
+ *		tiles.
+ * Bugs:	TIFF files bigger than 4GB can't be written, since
+ *		this only knows about classic (not Big)TIFF.
+ * Notes:	"tif", "tiff" and "png" are written by this code, a band
+ *		at a time; anything else goes through QImage::save().
+ *		PNG rows are written with the "Sub" filter, which
+ *		needs no other row, and suits the large areas of one
+ *		colour in a drawing of a graph.
+ */
+
+bool
+exportTiledImage(QGraphicsScene * scene, QRectF source, qreal scale,
+		 qreal dpi, QColor background, QString fileName,
+		 QString format, QString &errorMessage)
+{
+    int width = qCeil(source.width() * scale);
+    int height = qCeil(source.height() * scale);
+    bool tiff = format.toLower() == "tif" || format.toLower() == "tiff";
+    bool png = format.toLower() == "png";
+    bool streamed = tiff || png;
+
+    qDeb() << "exportTiledImage(" << fileName << ") at scale " << scale
+	   << " is " << width << " x " << height;
+
+    if (width <= 0 || height <= 0)
+    {
+	errorMessage = "There is nothing to save.";
+	return false;
+    }
+    if (!streamed && qint64(width) * height * 4 > MAX_IMAGE_BYTES)
+    {
+	errorMessage = QString("An image of %1 x %2 pixels is too big to "
+			       "build in memory.  Use a lower resolution, "
+			       "or save it as a PNG or TIF file, which are "
+			       "written a piece at a time.")
+	    .arg(width).arg(height);
+	return false;
+    }
+
+    QImage whole;
+    QFile file(fileName);
+    QDataStream out;
+    QVector<quint32> stripOffsets, stripByteCounts;
+    z_stream zs;
+
+    if (streamed)
+    {
+	if (!file.open(QIODevice::WriteOnly))
+	{
+	    errorMessage = "Unable to open " + fileName + " for output: "
+		+ file.errorString();
+	    return false;
+	}
+	out.setDevice(&file);
+    }
+    if (tiff)
+    {
+	out.setByteOrder(QDataStream::LittleEndian);
+	out << quint8('I') << quint8('I') << quint16(42) << quint32(0);
+    }
+    else if (png)
+    {
+	zs.zalloc = Z_NULL;
+	zs.zfree = Z_NULL;
+	zs.opaque = Z_NULL;
+	if (deflateInit(&zs, Z_DEFAULT_COMPRESSION) != Z_OK)
+	{
+	    file.close();
+	    file.remove();
+	    errorMessage = "Unable to initialize zlib.";
+	    return false;
+	}
+	out.setByteOrder(QDataStream::BigEndian);
+	pngStart(out, width, height, dpi);
+    }
+    else
+    {
+	whole = QImage(width, height, QImage::Format_ARGB32_Premultiplied);
+	if (whole.isNull())
+	{
+	    errorMessage = "Unable to allocate the image.";
+	    return false;
+	}
+	whole.setDotsPerMeterX(qRound(dpi / 0.0254));
+	whole.setDotsPerMeterY(qRound(dpi / 0.0254));
+    }
+
+    bool wasExporting = isExporting(scene);
+    Graph::setExporting(scene, true);
+
+    QByteArray row;
+    for (int y = 0; y < height; y += BAND_HEIGHT)
+    {
+	int bandHeight = qMin(BAND_HEIGHT, height - y);
+	QVector<Export_Tile> tiles;
+	for (int x = 0; x < width; x += TILE_WIDTH)
+	{
+	    tiles.append(Export_Tile());
+	    Export_Tile &tile = tiles.last();
+	    tile.area = QRect(x, y, qMin(TILE_WIDTH, width - x), bandHeight);
+	    tile.scale = scale;
+	    tile.background = background;
+	    tile.rgba = streamed;
+
+	    // The scene only draws the items under the tile.
+	    QRectF tileSource(source.x() + tile.area.x() / scale,
+			      source.y() + tile.area.y() / scale,
+			      tile.area.width() / scale,
+			      tile.area.height() / scale);
+	    QPainter recorder(&tile.picture);
+	    scene->render(&recorder,
+			  QRectF(QPointF(0, 0), tileSource.size()),
+			  tileSource, Qt::IgnoreAspectRatio);
+	    recorder.end();
+	}
+
+	QtConcurrent::blockingMap(tiles, renderTile);
+
+	if (tiff)
+	{
+	    QByteArray strip;
+	    for (int r = 0; r < bandHeight; r++)
+	    {
+		row.clear();
+		foreach (const Export_Tile &tile, tiles)
+		    row.append((const char *)tile.image.constScanLine(r),
+			       tile.area.width() * 4);
+		packBits((const uchar *)row.constData(), row.size(), strip);
+	    }
+	    if (file.pos() + strip.size() > Q_INT64_C(0xFFFF0000))
+	    {
+		Graph::setExporting(scene, wasExporting);
+		file.close();
+		file.remove();
+		errorMessage = "The TIF file would be bigger than 4GB.  "
+		    "Use a lower resolution.";
+		return false;
+	    }
+	    stripOffsets.append(file.pos());
+	    stripByteCounts.append(strip.size());
+	    out.writeRawData(strip.constData(), strip.size());
+	}
+	else if (png)
+	{
+	    QByteArray rows;
+	    rows.reserve(bandHeight * (width * 4 + 1));
+	    for (int r = 0; r < bandHeight; r++)
+	    {
+		row.clear();
+		foreach (const Export_Tile &tile, tiles)
+		    row.append((const char *)tile.image.constScanLine(r),
+			       tile.area.width() * 4);
+		const uchar * p = (const uchar *)row.constData();
+		int start = rows.size();
+		rows.resize(start + 1 + row.size());
+		uchar * q = (uchar *)rows.data() + start;
+		*q++ = PNG_FILTER_SUB;
+		for (int i = 0; i < row.size(); i++)
+		    q[i] = i < 4 ? p[i] : uchar(p[i] - p[i - 4]);
+	    }
+	    if (!pngDeflate(out, zs, rows,
+			    y + bandHeight < height ? Z_NO_FLUSH : Z_FINISH))
+	    {
+		Graph::setExporting(scene, wasExporting);
+		deflateEnd(&zs);
+		file.close();
+		file.remove();
+		errorMessage = "Error compressing " + fileName + ".";
+		return false;
+	    }
+	}
+	else
+	{
+	    QPainter painter(&whole);
+	    painter.setCompositionMode(QPainter::CompositionMode_Source);
+	    foreach (const Export_Tile &tile, tiles)
+		painter.drawImage(tile.area.topLeft(), tile.image);
+	}
+    }
+    Graph::setExporting(scene, wasExporting);
+
+    if (!streamed)
+    {
+	if (!whole.save(fileName, format.toLatin1().constData()))
+	{
+	    errorMessage = "Unable to write " + fileName + ".";
+	    return false;
+	}
+	return true;
+    }
+
+    if (tiff)
+	tiffFinish(file, out, width, height, BAND_HEIGHT,
+		   stripOffsets, stripByteCounts, dpi);
+    else
+    {
+	deflateEnd(&zs);
+	pngChunk(out, "IEND", QByteArray());
+    }
+    file.close();
+    if (out.status() != QDataStream::Ok || file.error() != QFile::NoError)
+    {
+	errorMessage = "Error writing " + fileName + ": " + file.errorString();
+	return false;
+    }
+    return true;
+}
@@ -0,0 +1,27 @@
+/*
+ * File:	tiledexport.h
+ * Author:	agent
+ * Date:	2026-10-18
+ * Version:	1.0
+ *
+ * Purpose:	Declare the tiled raster exporter used by
+ *		MainWindow::save_Graph() for image output.
+ *
+ * Modification history:
+ * Oct 18, 2026 (agent V1.0)
+ *  (a) Initial version.
+ */
+
+#ifndef TILEDEXPORT_H
+#define TILEDEXPORT_H
+
+#include <QColor>
+#include <QGraphicsScene>
+#include <QRectF>
+#include <QString>
+
+bool exportTiledImage(QGraphicsScene * scene, QRectF source, qreal scale,
+		      qreal dpi, QColor background, QString fileName,
+		      QString format, QString &errorMessage);
+
+#endif // TILEDEXPORT_H